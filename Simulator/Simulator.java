@@ -11,8 +11,8 @@ class Main {
  * SMC Simulator (8 regs, 32-bit, word-addressed) — filename via main(args)
  * Usage: java Simulator <machine-code.txt>
  *
- * - One signed 32-bit decimal per line in the input file.
- * - numMemory = number of lines.
+ * - One signed 32-bit decimal per line in the input file, or "*N value" for N words of value.
+ * - numMemory = number of words loaded.
  * - Registers init to 0; R0 is always 0 (writes ignored).
  * - PC starts at 0.
  * - printState is called before each instruction executes, and once more before exit.
@@ -46,29 +46,38 @@ public class Simulator {
         sim.run();
     }
 
-    /** Load machine code (one integer per line) from a file path */
+    /** Load machine code from a file path: one integer per line, or a run-length record
+     *  "*N value" = N words of value (written by the assembler for .space/.block) */
     private void loadFromFile(String path) throws IOException {
         try (BufferedReader br = new BufferedReader(new FileReader(path))) {
-            ArrayList<Integer> lines = new ArrayList<>();
             String s;
             int lineNo = 0;
+            numMemory = 0;
             while ((s = br.readLine()) != null) {
                 lineNo++;
                 s = s.trim();
                 if (s.isEmpty()) continue;                  // allow blank lines
-                String first = s.split("\\s+")[0];          // tolerate trailing comments/tokens
+                String[] tok = s.split("\\s+");             // tolerate trailing comments/tokens
                 try {
-                    int val = Integer.parseInt(first);
-                    lines.add(val);
-                } catch (NumberFormatException nfe) {
-                    System.err.println("error in reading address " + (lines.size()) + " (line " + lineNo + ")");
+                    if (tok[0].startsWith("*")) {
+                        int count = Integer.parseInt(tok[0].substring(1));
+                        int val = Integer.parseInt(tok[1]);
+                        if (count < 1 || count > NUMMEMORY - numMemory) throw new NumberFormatException();
+                        // mem starts zeroed, so zero runs only move numMemory
+                        if (val != 0) Arrays.fill(mem, numMemory, numMemory + count, val);
+                        numMemory += count;
+                    } else {
+                        int val = Integer.parseInt(tok[0]);
+                        if (numMemory >= NUMMEMORY) throw new NumberFormatException();
+                        mem[numMemory++] = val;
+                    }
+                } catch (NumberFormatException | ArrayIndexOutOfBoundsException e) {
+                    System.err.println("error in reading address " + numMemory + " (line " + lineNo + ")");
                     System.exit(1);
                 }
             }
-            numMemory = lines.size();
-            //mem = new int[numMemory];
+            // echo every word so output matches the same program written with .fill lines
             for (int i = 0; i < numMemory; i++) {
-                mem[i] = lines.get(i);
                 System.out.println("memory[" + i + "]=" + mem[i]);  // <— echo 
                 }
                       Arrays.fill(regs, 0);
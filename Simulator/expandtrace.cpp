@@ -0,0 +1,146 @@
+// expandtrace.cpp
+// ขยาย delta trace (simulator --delta) กลับเป็น output เต็มแบบเดียวกับ "simulator file.mc" / Simulator.java ทุก byte
+//   snapshot แรก → echo "memory[i]=v" ทุก word + printState แรก
+//   บรรทัด delta → ตั้ง pc / register / word ที่เปลี่ยนแล้ว printState
+//   snapshot ท้าย (หลัง halt / ชน guard) → ตั้ง state ทั้งหมดตาม snapshot แล้ว printState
+// พิมพ์ state ด้วย LcSim::printState ตัวเดียวกับ simulator (ข้อความ error ของ simulator อยู่ทาง stderr ไม่อยู่ใน trace)
+//
+// Compile : g++ -std=c++17 -O2 expandtrace.cpp -o expandtrace
+// Run : .\simulator --delta ..\programs\multiply.mc > multiply.delta   แล้ว   .\expandtrace multiply.delta > multiply_sim.txt
+
+#include "lc_sim.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// อ่านทีละบรรทัดจาก buffer ทั้งไฟล์ (trace ยาวได้เป็นล้านบรรทัด)
+struct Reader {
+    string buf;
+    size_t pos = 0;
+    long lineNo = 0;
+
+    bool next(const char *&line, const char *&end) {
+        if (pos >= buf.size()) return false;
+        size_t eol = buf.find('\n', pos);
+        if (eol == string::npos) eol = buf.size();
+        line = buf.data() + pos;
+        end = buf.data() + eol;
+        if (end > line && end[-1] == '\r') --end;
+        pos = eol + 1;
+        lineNo++;
+        return true;
+    }
+    [[noreturn]] void fail(const string &msg) const { throw runtime_error("line " + to_string(lineNo) + ": " + msg); }
+
+    // เลขฐานสิบ 32 บิตที่ p (ข้ามช่องว่างนำหน้า)
+    int32_t number(const char *&p, const char *end) const {
+        while (p < end && *p == ' ') ++p;
+        char *stop;
+        errno = 0;
+        const long long v = strtoll(p, &stop, 10);
+        if (stop == p || stop > end || errno || v < INT32_MIN || v > INT32_MAX) fail("bad number");
+        p = stop;
+        return int32_t(v);
+    }
+    // บรรทัดถัดไปต้องขึ้นต้นด้วย word
+    const char *expect(const char *word, const char *&end) {
+        const char *line;
+        const size_t n = strlen(word);
+        if (!next(line, end) || size_t(end - line) < n || memcmp(line, word, n) != 0) fail(string("expected '") + word + "'");
+        return line + n;
+    }
+};
+
+struct Snapshot {
+    int32_t pc = 0;
+    int32_t regs[LcSim::NUM_REGS] = {0};
+    vector<int32_t> mem;
+};
+
+// "state <pc> <n>" / "regs ..." / "mem ..." (บรรทัด state อ่านไปแล้ว ส่งส่วนที่เหลือมา)
+static Snapshot readSnapshot(Reader &in, const char *p, const char *end) {
+    Snapshot s;
+    s.pc = in.number(p, end);
+    const int32_t n = in.number(p, end);
+    if (n < 0 || n > LcSim::NUMMEMORY) in.fail("bad memory size");
+    p = in.expect("regs", end);
+    for (int i = 0; i < LcSim::NUM_REGS; ++i) s.regs[i] = in.number(p, end);
+    p = in.expect("mem", end);
+    s.mem.resize(n);
+    for (int32_t i = 0; i < n; ++i) s.mem[i] = in.number(p, end);
+    return s;
+}
+
+int main(int argc, char **argv) {
+    if (argc != 2) {
+        cerr << "usage: " << argv[0] << " <delta trace>\n";
+        return 1;
+    }
+    try {
+        Reader in;
+        {
+            ifstream ifs(argv[1], ios::binary);
+            if (!ifs) throw runtime_error(string("cannot open ") + argv[1]);
+            ostringstream ss;
+            ss << ifs.rdbuf();
+            in.buf = ss.str();
+        }
+        const char *line, *end;
+        if (!in.next(line, end) || string(line, end) != LcSim::DELTA_HEADER) in.fail("not a delta trace (missing header)");
+        const char *p = in.expect("state", end);
+        const Snapshot start = readSnapshot(in, p, end);
+
+        OutBuffer out(stdout);
+        LcSim sim(out);
+        SparseImage image;
+        for (int32_t w : start.mem) image.push(w);
+        sim.load(image);
+        sim.pc = start.pc;
+        for (int i = 0; i < LcSim::NUM_REGS; ++i) sim.regs[i] = start.regs[i];
+        sim.echoMemory();
+        sim.printState();
+
+        while (in.next(line, end)) {
+            if (line == end) continue;
+            if (end - line >= 6 && memcmp(line, "state ", 6) == 0) {
+                const Snapshot s = readSnapshot(in, line + 6, end);
+                if (int32_t(s.mem.size()) != sim.numMemory) in.fail("snapshot memory size differs from the first snapshot");
+                sim.pc = s.pc;
+                for (int i = 0; i < LcSim::NUM_REGS; ++i) sim.regs[i] = s.regs[i];
+                for (int32_t i = 0; i < sim.numMemory; ++i)
+                    if (sim.mem[i] != s.mem[i]) sim.poke(i, s.mem[i]);
+                sim.printState();
+                continue;
+            }
+            p = line;
+            sim.pc = in.number(p, end);
+            while (p < end) {
+                while (p < end && *p == ' ') ++p;
+                if (p == end) break;
+                const char kind = *p++;
+                const int32_t at = in.number(p, end);
+                if (p >= end || *p++ != '=') in.fail("expected '='");
+                const int32_t v = in.number(p, end);
+                if (kind == 'r' && at >= 0 && at < LcSim::NUM_REGS) sim.regs[at] = v;
+                else if (kind == 'm' && at >= 0 && at < sim.numMemory) sim.poke(at, v);
+                else in.fail("bad change entry");
+            }
+            sim.printState();
+        }
+    } catch (const exception &e) {
+        fflush(stdout);
+        cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
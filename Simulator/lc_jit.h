@@ -0,0 +1,651 @@
+// lc_jit.h
+// JIT ของ simulator: แปล basic block ที่ "ร้อน" ของโปรแกรม LC เป็นโค้ด x86-64 ในหน่วยความจำที่ execute ได้
+// ผลลัพธ์ (state สุดท้าย, steps, executed, ข้อความ error) เหมือน LcSim::run<false>() ทุกอย่าง
+//
+//   - register ของ LC: r1..r7 อยู่ใน r9d..r15d ตลอดเวลาที่อยู่ในโค้ด JIT (r0 ไม่มีที่เก็บ อ่านได้ 0 เสมอ เขียนทิ้ง)
+//     rdi = JitCtx, rsi = mem, rbx = codeMap, rbp = ตาราง entry ต่อ PC, r8 = step ที่ยังเหลือก่อนชน guard
+//   - block = คำสั่งต่อกันจาก PC หนึ่งจนถึง beq/jalr (รวมตัวมันด้วย) ไม่เกิน MAX_BLOCK คำสั่ง
+//     หยุดก่อน halt และก่อนเลย numMemory (halt กับ PC หลุดช่วงให้ interpreter ทำ ข้อความจะได้เหมือนเดิม)
+//   - guard 1,000,000 step: ต้นของแต่ละ block เช็คว่า r8 >= จำนวนคำสั่งใน block แล้วหักทีเดียว
+//     ไม่พอ → ออกไปให้ interpreter รันที่เหลือทีละคำสั่ง (จุดที่ชน guard และ PC ตอนนั้นจึงตรงเป๊ะ)
+//   - beq → cmp + jcc ไปยังปลายทางที่รู้แล้ว: ตอนแรกชี้ไป stub ที่ออกไปหา dispatcher
+//     เมื่อปลายทางถูกแปลแล้ว dispatcher patch rel32 ให้กระโดดเข้า block ปลายทางตรง ๆ (block chaining)
+//   - jalr → เป้าหมายรู้ตอนรันเท่านั้น: เปิดตาราง entry[PC] ถ้ามี block กระโดดเข้าเลย ไม่มีก็ออกไป dispatcher
+//   - lw/sw ที่ address หลุดช่วง → คืน step ของคำสั่งที่ยังไม่ได้ทำแล้วออกไปให้ interpreter ทำคำสั่งนั้น (พิมพ์ error)
+//   - sw: codeMap[addr] != 0 (word นั้นอยู่ใน block ที่แปลแล้ว หรือ interpreter ถอดไว้) → หลังเขียนออกไปให้
+//     dispatcher ทิ้ง block ที่ครอบ word นั้น (ถอน chain ที่ชี้เข้ามา) และล้าง decode ของ interpreter แล้วทำต่อที่ PC+1
+//   - โค้ดเย็น (ถูกเรียกไม่ถึง HOT_THRESHOLD ครั้ง) รันด้วย LcSim::step() ซึ่งเป็น interpreter ตัวเดิม
+//   - โค้ดที่สร้างไม่มี address สัมบูรณ์ (jump เป็น rel32 ภายใน buffer, ที่เหลือผ่าน JitCtx / ตาราง entry)
+//     จึงเก็บลง JitCache (lc_jitcache.h) แล้วโหลดกลับมาที่ offset เดิมในการรันครั้งหน้าได้ตรง ๆ
+//
+// ใช้ได้เฉพาะ x86-64 (Linux/macOS ผ่าน mmap, Windows ผ่าน VirtualAlloc) — LC_SIM_HAS_JIT ถูก define เมื่อใช้ได้
+// หน่วยความจำโค้ดเป็น RWX ก้อนเดียว (ต้อง patch ตอนรัน) ถ้าระบบไม่ยอมให้จอง LcJit จะ throw runtime_error
+// ผู้เรียก (simulator.cpp) ถอยไปใช้ interpreter แทน
+
+#ifndef LC_JIT_H
+#define LC_JIT_H
+
+#include "lc_jitcache.h"
+#include "lc_sim.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#  if defined(_WIN32)
+#    include <windows.h>
+#    define LC_SIM_HAS_JIT 1
+#  elif defined(__unix__) || defined(__APPLE__)
+#    include <sys/mman.h>
+#    define LC_SIM_HAS_JIT 1
+#  endif
+#endif
+
+#ifdef LC_SIM_HAS_JIT
+
+// สถานะที่โค้ด JIT อ่าน/เขียน (offset ถูกใช้ในโค้ดที่สร้าง ห้ามสลับลำดับ)
+struct JitCtx {
+    int32_t regs[8];
+    int32_t *mem;
+    const uint8_t *codeMap;
+    void *const *entries;      // entries[pc] = จุดเข้าของ block ที่เริ่มที่ pc (nullptr = ยังไม่มี)
+    int64_t remaining;
+    int32_t exitPc;
+    int32_t reason;
+    int32_t linkId;            // link ที่ทำให้ออก (-1 = ไม่ใช่ chain)
+    int32_t storeAddr;         // address ของ sw ที่ทับโค้ด (reason SMC)
+};
+
+class LcJit {
+public:
+    static constexpr int MAX_BLOCK = 64;
+    static constexpr int HOT_THRESHOLD = 4;
+    static constexpr size_t CODE_BYTES = size_t(16) << 20;
+    static constexpr uint32_t VERSION = 1;   // เปลี่ยนเมื่อโค้ดที่สร้างหรือรูปแบบ payload ของ cache เปลี่ยน
+
+    long blocksTranslated = 0;
+    long blocksInvalidated = 0;
+    long chainsPatched = 0;
+    long codeFlushes = 0;
+    long blocksLoaded = 0;     // block ที่ได้จาก JitCache
+
+    LcJit() {
+#if defined(_WIN32)
+        void *p = VirtualAlloc(nullptr, CODE_BYTES, MEM_COMMIT | MEM_RESERVE, PAGE_EXECUTE_READWRITE);
+        if (!p) throw std::runtime_error("jit: cannot allocate executable memory");
+#else
+        void *p = mmap(nullptr, CODE_BYTES, PROT_READ | PROT_WRITE | PROT_EXEC, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (p == MAP_FAILED) throw std::runtime_error("jit: cannot allocate executable memory");
+#endif
+        code = static_cast<uint8_t *>(p);
+        emitThunk();
+    }
+    ~LcJit() {
+#if defined(_WIN32)
+        VirtualFree(code, 0, MEM_RELEASE);
+#else
+        munmap(code, CODE_BYTES);
+#endif
+    }
+    LcJit(const LcJit &) = delete;
+    LcJit &operator=(const LcJit &) = delete;
+
+    // รัน sim ต่อจาก state ปัจจุบัน (ปกติหลัง load) จนหยุด แล้วแต่ละ field ของ sim เหมือน run<false>()
+    // cache != nullptr: เริ่มจาก block ที่เคยแปลไว้สำหรับ image นี้ (ถ้ามี) และเก็บ block ที่แปลเพิ่มกลับลงไป
+    LcSim::Stop run(LcSim &sim, JitCache *cache = nullptr) {
+        reset(sim);
+        std::string key;
+        if (cache) {
+            key = JitCache::makeKey(origin.data(), numMemory, engineId());
+            cache->lookup(key, [&](const uint8_t *p, size_t n) { return importTranslations(p, n); });
+        }
+        const LcSim::Stop stop = dispatch(sim);
+        if (cache && blocksTranslated > 0) cache->store(key, exportTranslations());
+        return stop;
+    }
+
+private:
+    LcSim::Stop dispatch(LcSim &sim) {
+        int32_t pc = sim.pc;
+        LcSim::Stop stop;
+        while (true) {
+            void *entry = blockFor(sim, pc);
+            if (!entry) {
+                // interpreter ทำคำสั่งเดียว (โค้ดเย็น, halt, PC หลุดช่วง)
+                sim.pc = pc;
+                if (!interpretOne(sim, stop)) return stop;
+                pc = sim.pc;
+                continue;
+            }
+            for (int i = 0; i < 8; ++i) ctx.regs[i] = sim.regs[i];
+            const int64_t before = LcSim::MAX_STEPS - sim.steps;
+            ctx.remaining = before;
+            enter(&ctx, entry);
+            sim.steps += before - ctx.remaining;
+            sim.executed += before - ctx.remaining;
+            for (int i = 1; i < 8; ++i) sim.regs[i] = ctx.regs[i];
+            pc = ctx.exitPc;
+
+            switch (ctx.reason) {
+                case EXIT_NEXT:
+                    if (ctx.linkId >= 0) {
+                        // ปลายทางของ chain พร้อมแล้ว → ต่อ jump ตรงเข้าไป ครั้งหน้าไม่ต้องออกมาอีก
+                        // (ถ้าการแปลทำให้ต้อง flush โค้ด link เดิมหายไปแล้ว ไม่ต้อง patch)
+                        const long flushes = codeFlushes;
+                        void *target = blockFor(sim, pc);
+                        if (target && flushes == codeFlushes) patchLink(ctx.linkId, pc);
+                    }
+                    break;
+                case EXIT_INTERP:
+                    sim.pc = pc;
+                    if (!interpretOne(sim, stop)) return stop;
+                    pc = sim.pc;
+                    break;
+                case EXIT_SMC:
+                    invalidateWord(sim, ctx.storeAddr);
+                    break;
+                case EXIT_BUDGET:
+                    // step ที่เหลือไม่พอสำหรับ block ถัดไป: ที่เหลือให้ interpreter ไล่จนชน guard / หยุด
+                    sim.pc = pc;
+                    while (interpretOne(sim, stop)) {}
+                    return stop;
+            }
+        }
+    }
+
+    enum : int32_t { EXIT_NEXT = 0, EXIT_INTERP = 1, EXIT_SMC = 2, EXIT_BUDGET = 3 };
+
+    // x86-64 register numbers
+    enum : int { RAX = 0, RCX = 1, RDX = 2, RBX = 3, RSP = 4, RBP = 5, RSI = 6, RDI = 7,
+                 R8 = 8, R9 = 9, R10 = 10, R11 = 11, R12 = 12, R13 = 13, R14 = 14, R15 = 15 };
+    static int host(int g) { return R8 + g; }   // r1..r7 → r9..r15
+
+    static constexpr int OFF_REGS = offsetof(JitCtx, regs);
+    static constexpr int OFF_MEM = offsetof(JitCtx, mem);
+    static constexpr int OFF_CODEMAP = offsetof(JitCtx, codeMap);
+    static constexpr int OFF_ENTRIES = offsetof(JitCtx, entries);
+    static constexpr int OFF_REMAINING = offsetof(JitCtx, remaining);
+    static constexpr int OFF_EXITPC = offsetof(JitCtx, exitPc);
+    static constexpr int OFF_REASON = offsetof(JitCtx, reason);
+    static constexpr int OFF_LINK = offsetof(JitCtx, linkId);
+    static constexpr int OFF_STORE = offsetof(JitCtx, storeAddr);
+
+    struct Block {
+        int32_t start = 0, length = 0;
+        uint8_t *entry = nullptr;
+        std::vector<int32_t> incoming;   // link ที่ patch ให้ชี้มาที่ block นี้แล้ว
+        bool pristine = false;           // แปลจาก word ที่ยังตรงกับ image ตอนโหลด (เก็บลง cache ได้)
+    };
+    struct Link {
+        uint8_t *site;    // ตำแหน่ง rel32 ของ jmp/jcc
+        uint8_t *stub;    // stub เดิมที่ออกไป dispatcher
+        int32_t target;
+        int32_t block;    // block ที่ patch ไปหา (-1 = ยังชี้ stub)
+    };
+
+    using EnterFn = void (*)(JitCtx *, void *);
+
+    uint8_t *code = nullptr;
+    size_t used = 0;
+    size_t codeStart = 0;          // โค้ดของ block เริ่มหลัง thunk
+    uint8_t *epilogue = nullptr;
+    EnterFn enter = nullptr;
+
+    JitCtx ctx{};
+    std::vector<void *> entries;           // ตาราง entry ต่อ PC (โค้ด JIT อ่านตอน jalr)
+    std::vector<int32_t> blockAt;          // index ใน blocks ของ block ที่เริ่มที่ PC นี้ (-1 = ไม่มี)
+    std::vector<uint8_t> codeMap;          // 1 = word นี้เป็นโค้ด (อยู่ใน block หรือ interpreter ถอดไว้)
+    std::vector<uint16_t> heat;
+    std::vector<Block> blocks;
+    std::vector<Link> links;
+    std::vector<int32_t> origin;           // word ของ image ตอนเริ่มรัน (key ของ cache และเช็ค pristine)
+    int32_t numMemory = 0;
+
+    // ---------------- ตัวเขียนคำสั่ง x86-64 ----------------
+    void b(uint8_t v) { code[used++] = v; }
+    void d32(uint32_t v) { memcpy(code + used, &v, 4); used += 4; }
+    uint8_t *here() { return code + used; }
+
+    void rex(bool w, int reg, int index, int base) {
+        uint8_t r = uint8_t(0x40 | (w ? 8 : 0) | ((reg >> 3) & 1) << 2 | ((index >> 3) & 1) << 1 | ((base >> 3) & 1));
+        if (r != 0x40) b(r);
+    }
+    // op reg, rm (register-register)
+    void rr(uint8_t op, int reg, int rm, bool w = false) {
+        rex(w, reg, 0, rm);
+        b(op);
+        b(uint8_t(0xC0 | (reg & 7) << 3 | (rm & 7)));
+    }
+    // op reg, [base + index*2^scale + disp] (index < 0 = ไม่มี)
+    void rm(uint8_t op, int reg, int base, int index, int scale, int32_t disp, bool w = false) {
+        rex(w, reg, index < 0 ? 0 : index, base);
+        b(op);
+        const int mod = (disp == 0 && (base & 7) != RBP) ? 0 : (disp >= -128 && disp <= 127 ? 1 : 2);
+        if (index < 0 && (base & 7) != RSP) {
+            b(uint8_t(mod << 6 | (reg & 7) << 3 | (base & 7)));
+        } else {
+            b(uint8_t(mod << 6 | (reg & 7) << 3 | 4));
+            b(uint8_t(scale << 6 | ((index < 0 ? RSP : index) & 7) << 3 | (base & 7)));
+        }
+        if (mod == 1) b(uint8_t(int8_t(disp)));
+        else if (mod == 2) d32(uint32_t(disp));
+    }
+    void movRR(int dst, int src) { rr(0x89, src, dst); }
+    void movRI(int dst, int32_t imm) {
+        rex(false, 0, 0, dst);
+        b(uint8_t(0xB8 + (dst & 7)));
+        d32(uint32_t(imm));
+    }
+    void aluRI(int ext, int dst, int32_t imm, bool w = false) { rr(0x81, ext, dst, w); d32(uint32_t(imm)); }
+    void storeCtxImm(int off, int32_t imm) { rm(0xC7, 0, RDI, -1, 0, off); d32(uint32_t(imm)); }
+    void push(int r) { if (r >= 8) b(0x41); b(uint8_t(0x50 + (r & 7))); }
+    void pop(int r) { if (r >= 8) b(0x41); b(uint8_t(0x58 + (r & 7))); }
+    // jmp/jcc rel32 คืนตำแหน่งของ rel32 ไว้ patch ทีหลัง (cc < 0 = jmp)
+    uint8_t *jump(int cc) {
+        if (cc < 0) b(0xE9);
+        else { b(0x0F); b(uint8_t(0x80 + cc)); }
+        uint8_t *site = here();
+        d32(0);
+        return site;
+    }
+    static void patch(uint8_t *site, const uint8_t *target) {
+        const int32_t rel = int32_t(target - (site + 4));
+        memcpy(site, &rel, 4);
+    }
+    // โหลด r_g ของ LC ลง register host (r0 = 0)
+    void loadGuest(int dst, int g) {
+        if (g == 0) rr(0x31, dst, dst);   // xor dst, dst
+        else movRR(dst, host(g));
+    }
+
+    static constexpr int CC_B = 2, CC_AE = 3, CC_E = 4, CC_NE = 5, CC_L = 0xC;
+
+    // thunk: enter(ctx, entry) บันทึก register ของ host โหลด state แล้วกระโดดเข้า block, epilogue ทำกลับกัน
+    void emitThunk() {
+        used = 0;
+        enter = reinterpret_cast<EnterFn>(here());
+        static const int SAVED[8] = {RBX, RBP, RDI, RSI, R12, R13, R14, R15};
+        for (int r : SAVED) push(r);
+#if defined(_WIN32)
+        rr(0x89, RDX, RAX, true);   // Win64: rcx = ctx, rdx = entry
+        rr(0x89, RCX, RDI, true);
+#else
+        rr(0x89, RSI, RAX, true);   // SysV: rdi = ctx, rsi = entry
+#endif
+        rm(0x8B, RSI, RDI, -1, 0, OFF_MEM, true);
+        rm(0x8B, RBX, RDI, -1, 0, OFF_CODEMAP, true);
+        rm(0x8B, RBP, RDI, -1, 0, OFF_ENTRIES, true);
+        rm(0x8B, R8, RDI, -1, 0, OFF_REMAINING, true);
+        for (int g = 1; g < 8; ++g) rm(0x8B, host(g), RDI, -1, 0, OFF_REGS + 4 * g);
+        rr(0xFF, 4, RAX, false);   // jmp rax
+
+        epilogue = here();
+        for (int g = 1; g < 8; ++g) rm(0x89, host(g), RDI, -1, 0, OFF_REGS + 4 * g);
+        rm(0x89, R8, RDI, -1, 0, OFF_REMAINING, true);
+        for (int k = 7; k >= 0; --k) pop(SAVED[k]);
+        b(0xC3);
+        codeStart = used;
+    }
+
+    // ตารางต่อ PC ใช้แค่ช่วง [0, numMemory) (block ไม่เคยเลยช่วงที่โหลด) จึงมีขนาดเท่าที่เคยโหลดใหญ่สุด
+    // และล้างแค่ช่วงที่รอบก่อนกับรอบนี้ใช้ ส่วน codeMap ถูกเปิดด้วย address ของ sw จึงต้องครบ 65536
+    void reset(LcSim &sim) {
+        const size_t n = size_t(std::max(numMemory, sim.numMemory));
+        if (entries.size() < size_t(sim.numMemory)) {
+            entries.resize(size_t(sim.numMemory));
+            blockAt.resize(size_t(sim.numMemory));
+            heat.resize(size_t(sim.numMemory));
+        }
+        if (codeMap.empty()) codeMap.assign(LcSim::NUMMEMORY, 0);
+        std::fill(entries.begin(), entries.begin() + n, nullptr);
+        std::fill(blockAt.begin(), blockAt.begin() + n, -1);
+        std::fill(codeMap.begin(), codeMap.begin() + n, 0);
+        std::fill(heat.begin(), heat.begin() + n, 0);
+        numMemory = sim.numMemory;
+        origin.assign(sim.mem.begin(), sim.mem.begin() + numMemory);
+        blocks.clear();
+        links.clear();
+        used = codeStart;
+        blocksTranslated = blocksInvalidated = chainsPatched = codeFlushes = blocksLoaded = 0;
+        ctx = JitCtx{};
+        ctx.mem = sim.mem.data();
+        ctx.codeMap = codeMap.data();
+        ctx.entries = entries.data();
+    }
+
+    // โค้ดเต็ม: ทิ้งทุก block แล้วเริ่มเขียนใหม่ (เรียกจาก dispatcher เท่านั้น ตอนนั้นไม่มีโค้ด JIT กำลังรัน)
+    void flushCode() {
+        std::fill(entries.begin(), entries.begin() + numMemory, nullptr);
+        std::fill(blockAt.begin(), blockAt.begin() + numMemory, -1);
+        blocks.clear();
+        links.clear();
+        used = codeStart;
+        codeFlushes++;
+    }
+
+    bool interpretOne(LcSim &sim, LcSim::Stop &stop) {
+        const int32_t at = sim.pc;
+        int32_t storeAddr = -1;
+        if (at >= 0 && at < numMemory) {
+            codeMap[at] = 1;   // interpreter จะถอด word นี้เก็บไว้ → sw จากโค้ด JIT ต้องออกมาล้างให้
+            const DecodedInstr d = decodeWord(sim.mem[at]);
+            if (d.opcode == OPC_SW) storeAddr = int32_t(uint32_t(sim.regs[d.regA]) + uint32_t(d.imm));
+        }
+        const bool more = sim.step(stop);
+        // sw ของ interpreter ทับ block ที่แปลไว้ → ทิ้ง block นั้น (decode ของ interpreter เองถูกล้างใน step แล้ว)
+        if (storeAddr >= 0 && storeAddr < LcSim::NUMMEMORY && codeMap[storeAddr]) invalidateBlocks(storeAddr);
+        return more;
+    }
+
+    void *blockFor(LcSim &sim, int32_t pc) {
+        if (pc < 0 || pc >= numMemory) return nullptr;
+        if (entries[pc]) return entries[pc];
+        if (heat[pc] < HOT_THRESHOLD) { heat[pc]++; return nullptr; }
+        return translate(sim, pc);
+    }
+
+    void patchLink(int32_t id, int32_t target) {
+        Link &l = links[id];
+        const int32_t bi = blockAt[target];
+        if (l.block >= 0 || bi < 0) return;
+        patch(l.site, blocks[bi].entry);
+        l.block = bi;
+        blocks[bi].incoming.push_back(id);
+        chainsPatched++;
+    }
+
+    void invalidateWord(LcSim &sim, int32_t addr) {
+        sim.noteCodeWrite(addr);
+        invalidateBlocks(addr);
+    }
+
+    // ทิ้งทุก block ที่ครอบ addr: ลบออกจากตาราง entry และถอน chain ที่ชี้เข้ามากลับไปที่ stub
+    // (codeMap ไม่ลบ — word นั้นยังเป็นโค้ดที่อาจถูกแปลใหม่)
+    void invalidateBlocks(int32_t addr) {
+        for (int32_t s = addr; s >= 0 && s > addr - MAX_BLOCK; --s) {
+            const int32_t bi = blockAt[s];
+            if (bi < 0 || s + blocks[bi].length <= addr) continue;
+            for (int32_t id : blocks[bi].incoming) {
+                if (links[id].block != bi) continue;
+                patch(links[id].site, links[id].stub);
+                links[id].block = -1;
+            }
+            blocks[bi].incoming.clear();
+            blockAt[s] = -1;
+            entries[s] = nullptr;
+            heat[s] = 0;
+            blocksInvalidated++;
+        }
+    }
+
+    // ---------------- แปล block ----------------
+    struct PendingExit {
+        uint8_t *site;
+        int kind;          // 0 = link (target), 1 = fault ที่คำสั่ง idx, 2 = SMC หลังคำสั่ง idx, 3 = jalr ไปเป้าหมายที่ยังไม่มี
+        int32_t target;
+        int idx;
+    };
+
+    void *translate(LcSim &sim, int32_t start) {
+        const int32_t *mem = sim.mem.data();
+        // หาความยาว block ก่อน (ต้องรู้จำนวน step ตั้งแต่ต้น block)
+        int len = 0;
+        bool endsWithBranch = false;
+        for (int32_t pc = start; pc < numMemory && len < MAX_BLOCK; ++pc) {
+            const int op = decodeWord(mem[pc]).opcode;
+            if (op == OPC_HALT) break;
+            len++;
+            if (op == OPC_BEQ || op == OPC_JALR) { endsWithBranch = true; break; }
+        }
+        if (len == 0) return nullptr;   // block เริ่มที่ halt: ให้ interpreter ทำ
+        if (CODE_BYTES - used < size_t(len) * 160 + 256) flushCode();
+
+        const int32_t bi = int32_t(blocks.size());
+        blocks.push_back(Block{start, len, here(), {}, std::equal(mem + start, mem + start + len, origin.begin() + start)});
+        std::vector<PendingExit> exits;
+        const int32_t remainingAfter = len;   // ใช้คำนวณ step ที่ต้องคืน
+
+        // ต้น block: step พอไหม
+        aluRI(7, R8, len, true);          // cmp r8, len
+        exits.push_back({jump(CC_L), 4, start, 0});
+        aluRI(5, R8, len, true);          // sub r8, len
+
+        for (int idx = 0; idx < len; ++idx) {
+            const int32_t pc = start + idx;
+            const DecodedInstr d = decodeWord(mem[pc]);
+            codeMap[pc] = 1;
+            switch (d.opcode) {
+                case OPC_ADD:
+                case OPC_NAND:
+                    if (d.dest == 0) break;
+                    loadGuest(RAX, d.regA);
+                    loadGuest(RCX, d.regB);
+                    if (d.opcode == OPC_ADD) rr(0x01, RCX, RAX);   // add eax, ecx
+                    else { rr(0x21, RCX, RAX); rr(0xF7, 2, RAX); }   // and eax, ecx; not eax
+                    movRR(host(d.dest), RAX);
+                    break;
+                case OPC_LW:
+                case OPC_SW: {
+                    loadGuest(RAX, d.regA);
+                    if (d.imm) aluRI(0, RAX, d.imm);                 // add eax, imm
+                    aluRI(7, RAX, LcSim::NUMMEMORY);                 // cmp eax, 65536 (unsigned)
+                    exits.push_back({jump(CC_AE), 1, pc, idx});
+                    if (d.opcode == OPC_LW) {
+                        if (d.regB) rm(0x8B, host(d.regB), RSI, RAX, 2, 0);   // mov rB, [rsi+rax*4]
+                        break;
+                    }
+                    loadGuest(RCX, d.regB);
+                    rm(0x39, RCX, RSI, RAX, 2, 0);                   // cmp [rsi+rax*4], ecx
+                    uint8_t *same = jump(CC_E);
+                    rm(0x89, RCX, RSI, RAX, 2, 0);                   // mov [rsi+rax*4], ecx
+                    rm(0x80, 7, RBX, RAX, 0, 0); b(0);               // cmp byte [rbx+rax], 0
+                    exits.push_back({jump(CC_NE), 2, pc + 1, idx});
+                    patch(same, here());
+                    break;
+                }
+                case OPC_BEQ: {
+                    const int32_t taken = int32_t(uint32_t(pc) + 1u + uint32_t(d.imm));
+                    if (d.regA == d.regB) {
+                        exits.push_back({jump(-1), 0, taken, idx});
+                        break;
+                    }
+                    if (d.regA == 0 || d.regB == 0) {
+                        const int r = host(d.regA ? d.regA : d.regB);
+                        rr(0x85, r, r);                               // test r, r
+                    } else {
+                        rr(0x39, host(d.regB), host(d.regA));         // cmp rA, rB
+                    }
+                    exits.push_back({jump(CC_E), 0, taken, idx});
+                    exits.push_back({jump(-1), 0, pc + 1, idx});
+                    break;
+                }
+                case OPC_JALR: {
+                    const int32_t ret = pc + 1;
+                    if (d.regA == d.regB) {
+                        if (d.regB) movRI(host(d.regB), ret);
+                        exits.push_back({jump(-1), 0, ret, idx});
+                        break;
+                    }
+                    loadGuest(RAX, d.regA);                          // อ่านเป้าหมายก่อนเขียน link
+                    if (d.regB) movRI(host(d.regB), ret);
+                    aluRI(7, RAX, numMemory);                        // cmp eax, numMemory (unsigned)
+                    exits.push_back({jump(CC_AE), 3, 0, idx});
+                    rm(0x8B, RCX, RBP, RAX, 3, 0, true);             // mov rcx, [rbp+rax*8]
+                    rr(0x85, RCX, RCX, true);                        // test rcx, rcx
+                    exits.push_back({jump(CC_E), 3, 0, idx});
+                    rr(0xFF, 4, RCX);                                // jmp rcx
+                    break;
+                }
+                default:   // noop
+                    break;
+            }
+        }
+        if (!endsWithBranch) exits.push_back({jump(-1), 0, start + len, len - 1});
+
+        // stub ขาออก (อยู่ท้าย block ไม่ปนกับทางที่รันบ่อย)
+        for (const PendingExit &e : exits) {
+            uint8_t *stub = here();
+            patch(e.site, stub);
+            switch (e.kind) {
+                case 0: {
+                    const int32_t id = int32_t(links.size());
+                    links.push_back(Link{e.site, stub, e.target, -1});
+                    storeCtxImm(OFF_EXITPC, e.target);
+                    storeCtxImm(OFF_REASON, EXIT_NEXT);
+                    storeCtxImm(OFF_LINK, id);
+                    break;
+                }
+                case 1:   // คำสั่ง idx ยังไม่ได้ทำ: คืน step ของมันและที่เหลือ
+                    aluRI(0, R8, remainingAfter - e.idx, true);
+                    storeCtxImm(OFF_EXITPC, e.target);
+                    storeCtxImm(OFF_REASON, EXIT_INTERP);
+                    break;
+                case 2:   // sw ที่ idx ทำแล้ว: คืนเฉพาะที่เหลือหลังจากนั้น
+                    if (remainingAfter - e.idx - 1) aluRI(0, R8, remainingAfter - e.idx - 1, true);
+                    rm(0x89, RAX, RDI, -1, 0, OFF_STORE);
+                    storeCtxImm(OFF_EXITPC, e.target);
+                    storeCtxImm(OFF_REASON, EXIT_SMC);
+                    break;
+                case 3:
+                    rm(0x89, RAX, RDI, -1, 0, OFF_EXITPC);
+                    storeCtxImm(OFF_REASON, EXIT_NEXT);
+                    storeCtxImm(OFF_LINK, -1);
+                    break;
+                case 4:
+                    storeCtxImm(OFF_EXITPC, e.target);
+                    storeCtxImm(OFF_REASON, EXIT_BUDGET);
+                    break;
+            }
+            patch(jump(-1), epilogue);
+        }
+
+        blockAt[start] = bi;
+        entries[start] = blocks[bi].entry;
+        blocksTranslated++;
+        return blocks[bi].entry;
+    }
+
+    // ---------------- เก็บ/โหลดผลการแปล (payload ของ JitCache) ----------------
+    // payload (int32 ทั้งหมด): codeStart codeBytes nBlocks nLinks | code | ต่อ block: start length entryOff saved nIncoming ids...
+    //                          | ต่อ link: siteOff stubOff target block
+    // เก็บเฉพาะ block ที่ยังใช้อยู่และแปลจาก word เดิมของ image (saved = 1) block อื่นเก็บไว้แค่ให้ลำดับ index ตรงกับ
+    // link id ที่ฝังอยู่ใน stub ส่วน chain ที่ชี้ไป block ที่ไม่ได้เก็บถูกคืนเป็น stub ในสำเนา
+
+    // ตัวตนของ engine: โค้ดจาก build อื่น (thunk/ABI/ค่าคงที่ต่างกัน) จะได้ key ต่างกัน
+    std::string engineId() const {
+        std::string id(reinterpret_cast<const char *>(code), codeStart);
+        const uint32_t consts[4] = {VERSION, uint32_t(MAX_BLOCK), uint32_t(sizeof(JitCtx)), uint32_t(codeStart)};
+        id.append(reinterpret_cast<const char *>(consts), sizeof consts);
+        return id;
+    }
+
+    std::string exportTranslations() const {
+        std::vector<char> saved(blocks.size(), 0);
+        for (size_t i = 0; i < blocks.size(); ++i)
+            saved[i] = blockAt[blocks[i].start] == int32_t(i) && blocks[i].pristine;
+        std::string codeCopy(reinterpret_cast<const char *>(code + codeStart), used - codeStart);
+        std::vector<int32_t> linkBlock(links.size());
+        for (size_t id = 0; id < links.size(); ++id) {
+            const Link &l = links[id];
+            linkBlock[id] = l.block;
+            if (l.block >= 0 && !saved[l.block]) {
+                const int32_t rel = int32_t(l.stub - (l.site + 4));
+                memcpy(&codeCopy[l.site - (code + codeStart)], &rel, 4);
+                linkBlock[id] = -1;
+            }
+        }
+        std::vector<int32_t> out = {int32_t(codeStart), int32_t(codeCopy.size()), int32_t(blocks.size()), int32_t(links.size())};
+        std::vector<int32_t> tailWords;
+        for (size_t i = 0; i < blocks.size(); ++i) {
+            const Block &bl = blocks[i];
+            tailWords.insert(tailWords.end(), {bl.start, bl.length, int32_t(bl.entry - code), int32_t(saved[i])});
+            std::vector<int32_t> inc;
+            if (saved[i])
+                for (int32_t id : bl.incoming)
+                    if (linkBlock[id] == int32_t(i)) inc.push_back(id);
+            tailWords.push_back(int32_t(inc.size()));
+            tailWords.insert(tailWords.end(), inc.begin(), inc.end());
+        }
+        for (size_t id = 0; id < links.size(); ++id)
+            tailWords.insert(tailWords.end(), {int32_t(links[id].site - code), int32_t(links[id].stub - code),
+                                               links[id].target, linkBlock[id]});
+        std::string payload(reinterpret_cast<const char *>(out.data()), out.size() * 4);
+        payload += codeCopy;
+        payload.append(reinterpret_cast<const char *>(tailWords.data()), tailWords.size() * 4);
+        return payload;
+    }
+
+    // เช็คทุก offset/index ก่อนใช้ ผิดข้อใดคืน false โดยไม่แตะ state (ยังเป็นสภาพหลัง reset)
+    bool importTranslations(const uint8_t *p, size_t n) {
+        size_t at = 0;
+        auto word = [&](int32_t &v) {
+            if (n - at < 4) return false;
+            memcpy(&v, p + at, 4);
+            at += 4;
+            return true;
+        };
+        int32_t start = 0, codeBytes = 0, nBlocks = 0, nLinks = 0;
+        if (!word(start) || !word(codeBytes) || !word(nBlocks) || !word(nLinks)) return false;
+        if (size_t(start) != codeStart || codeBytes < 0 || size_t(codeBytes) > CODE_BYTES - codeStart - 65536 ||
+            size_t(codeBytes) > n - at || nBlocks < 0 || nLinks < 0)
+            return false;
+        const uint8_t *codeBytesPtr = p + at;
+        at += size_t(codeBytes);
+        const int64_t lo = int64_t(codeStart), hi = int64_t(codeStart) + codeBytes;
+
+        if (size_t(nBlocks) > (n - at) / 20) return false;
+        std::vector<Block> nb(static_cast<size_t>(nBlocks));
+        std::vector<char> saved(nb.size(), 0);
+        for (Block &bl : nb) {
+            int32_t entryOff = 0, isSaved = 0, nInc = 0;
+            if (!word(bl.start) || !word(bl.length) || !word(entryOff) || !word(isSaved) || !word(nInc)) return false;
+            if (bl.start < 0 || bl.length < 1 || bl.length > MAX_BLOCK || bl.start + bl.length > numMemory ||
+                entryOff < lo || entryOff >= hi || nInc < 0 || size_t(nInc) > (n - at) / 4)
+                return false;
+            bl.entry = code + entryOff;
+            bl.pristine = true;
+            saved[&bl - nb.data()] = isSaved != 0;
+            bl.incoming.resize(size_t(nInc));
+            for (int32_t &id : bl.incoming)
+                if (!word(id) || id < 0 || id >= nLinks) return false;
+        }
+        if (size_t(nLinks) > (n - at) / 16) return false;
+        std::vector<Link> nl(static_cast<size_t>(nLinks));
+        for (Link &l : nl) {
+            int32_t siteOff = 0, stubOff = 0;
+            if (!word(siteOff) || !word(stubOff) || !word(l.target) || !word(l.block)) return false;
+            if (siteOff < lo || siteOff + 4 > hi || stubOff < lo || stubOff >= hi || l.block < -1 || l.block >= nBlocks ||
+                (l.block >= 0 && !saved[l.block]))
+                return false;
+            l.site = code + siteOff;
+            l.stub = code + stubOff;
+        }
+        if (at != n) return false;
+        std::vector<char> taken(size_t(numMemory), 0);   // สอง block ที่เก็บไว้ต้องไม่เริ่มที่ PC เดียวกัน
+        for (size_t i = 0; i < nb.size(); ++i) {
+            if (!saved[i]) continue;
+            if (taken[nb[i].start]) return false;
+            taken[nb[i].start] = 1;
+        }
+
+        memcpy(code + codeStart, codeBytesPtr, size_t(codeBytes));
+        used = codeStart + size_t(codeBytes);
+        blocks = std::move(nb);
+        links = std::move(nl);
+        for (size_t i = 0; i < blocks.size(); ++i) {
+            if (!saved[i]) continue;
+            blockAt[blocks[i].start] = int32_t(i);
+            entries[blocks[i].start] = blocks[i].entry;
+            for (int32_t k = 0; k < blocks[i].length; ++k) codeMap[blocks[i].start + k] = 1;
+            blocksLoaded++;
+        }
+        return true;
+    }
+};
+
+#endif   // LC_SIM_HAS_JIT
+#endif
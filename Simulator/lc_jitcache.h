@@ -0,0 +1,156 @@
+// lc_jitcache.h
+// cache บนดิสก์ของโค้ดที่ JIT (lc_jit.h) แปลไว้ ใช้ซ้ำข้ามการรันของ image เดียวกัน
+//   key = hash 128 บิตของ word ทั้ง image (รวมจำนวน word) + ตัวตนของ engine (เวอร์ชัน, byte ของ thunk, ค่าคงที่)
+//   image เดียวกันบน simulator build เดียวกัน → โหลด block ที่แปลแล้วพร้อม chain เข้า buffer แล้วรันได้ทันที
+//
+// ไดเรกทอรี, การเขียนแบบ atomic, eviction และ hash ของ key ใช้ lc_diskcache.h ร่วมกับ buildcache ของ assembler
+//   (<dir>/<key 2 หลักแรก>/<key ที่เหลือ>.lcj)
+// รูปแบบ entry (binary):
+//     "LCJT" | uint32 FORMAT | key 32 ตัวอักษร | uint64 ขนาด payload | uint64 checksum (FNV-1a ทีละ 8 byte) ของ payload | payload
+//   payload เป็นของ LcJit (exportTranslations / importTranslations) cache ไม่ตีความ
+// อ่าน: map ไฟล์ทั้งไฟล์ (POSIX mmap, Windows MapViewOfFile) เช็ค magic/key/ขนาด/checksum ก่อนส่ง payload ให้ผู้เรียก
+//        ผู้เรียกเช็คโครงสร้างข้างในอีกชั้น ไม่ผ่านข้อไหน = miss
+// entry เป็นโค้ดเครื่องที่จะถูก execute: ไดเรกทอรีเปิดแบบ DiskCacheDir::PRIVATE — ต้องเป็นของผู้ใช้ที่รัน simulator
+//   และ group/others เขียนไม่ได้ (ไม่งั้น constructor throw) entry ที่ไม่ใช่ของผู้ใช้นั้นหรือคนอื่นเขียนได้ = miss
+
+#ifndef LC_JITCACHE_H
+#define LC_JITCACHE_H
+
+#include "../assembler/lc_diskcache.h"
+
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <stdexcept>
+#include <string>
+
+#if defined(_WIN32)
+#  include <windows.h>
+#else
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#endif
+
+class JitCache {
+public:
+    static constexpr uint32_t FORMAT = 1;
+
+    explicit JitCache(const std::string &dir, uint64_t maxBytes = 64ull << 20)
+        : files(dir, ".lcj", maxBytes, DiskCacheDir::PRIVATE) {}
+
+    // key จาก word ของ image กับตัวตนของ engine (CacheKeyHash ของ lc_diskcache.h)
+    static std::string makeKey(const int32_t *words, int32_t count, const std::string &engineId) {
+        CacheKeyHash k;
+        const uint64_t idLen = engineId.size();
+        k.mix(&idLen, sizeof idLen);
+        k.mix(engineId.data(), engineId.size());
+        k.mix(&count, sizeof count);
+        k.mix(words, size_t(count) * sizeof(int32_t));
+        uint64_t hi, lo;
+        k.finish(hi, lo);
+        return CacheKeyHash::hex(hi, lo);
+    }
+
+    // hit: เรียก accept(payload) แล้วคืนผลของมัน (accept คืน false = payload ใช้ไม่ได้ ถือเป็น miss)
+    bool lookup(const std::string &key, const std::function<bool(const uint8_t *, size_t)> &accept) {
+        const std::string path = files.entryPath(key);
+        MappedFile f(path, files);
+        if (!f.data || f.size < HEADER_BYTES) return false;
+        const uint8_t *p = f.data;
+        uint32_t format = 0;
+        uint64_t payloadSize = 0, checksum = 0;
+        memcpy(&format, p + 4, 4);
+        memcpy(&payloadSize, p + 40, 8);
+        memcpy(&checksum, p + 48, 8);
+        if (memcmp(p, "LCJT", 4) != 0 || format != FORMAT || memcmp(p + 8, key.data(), 32) != 0 ||
+            payloadSize != f.size - HEADER_BYTES || fnv(p + HEADER_BYTES, size_t(payloadSize)) != checksum)
+            return false;
+        if (!accept(p + HEADER_BYTES, size_t(payloadSize))) return false;
+        DiskCacheDir::touch(path);
+        return true;
+    }
+
+    // เขียน entry (แทนของเดิมถ้ามี) แล้ว evict ถ้าเกินขนาด เขียนไม่ได้ก็เงียบ: cache เป็นแค่ทางลัด
+    void store(const std::string &key, const std::string &payload) {
+        try {
+            files.write(files.entryPath(key), [&](std::ostream &os) {
+                const uint64_t size = payload.size();
+                const uint64_t sum = fnv(reinterpret_cast<const uint8_t *>(payload.data()), payload.size());
+                os.write("LCJT", 4);
+                os.write(reinterpret_cast<const char *>(&FORMAT), 4);
+                os.write(key.data(), 32);
+                os.write(reinterpret_cast<const char *>(&size), 8);
+                os.write(reinterpret_cast<const char *>(&sum), 8);
+                os.write(payload.data(), std::streamsize(payload.size()));
+            });
+        } catch (const std::exception &) {
+        }
+    }
+
+    // คืนจำนวน entry ที่ลบ
+    size_t evict() { return files.evict(); }
+
+private:
+    static constexpr size_t HEADER_BYTES = 56;
+
+    DiskCacheDir files;
+
+    // checksum ของ payload: FNV-1a ทีละ 8 byte (payload ระดับ MB ต้องเช็คทุกครั้งที่โหลด) แล้วทีละ byte ที่เหลือ
+    static uint64_t fnv(const uint8_t *p, size_t n) {
+        uint64_t h = 1469598103934665603ULL;
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8) {
+            uint64_t w;
+            memcpy(&w, p + i, 8);
+            h = (h ^ w) * 1099511628211ULL;
+            h ^= h >> 29;
+        }
+        for (; i < n; ++i) h = (h ^ p[i]) * 1099511628211ULL;
+        return h;
+    }
+
+    // map ไฟล์ทั้งไฟล์แบบอ่านอย่างเดียว (data = nullptr ถ้าเปิดไม่ได้ / ว่าง / ไม่ผ่าน trustedEntry)
+    struct MappedFile {
+        const uint8_t *data = nullptr;
+        size_t size = 0;
+#if defined(_WIN32)
+        HANDLE file = INVALID_HANDLE_VALUE, mapping = nullptr;
+        MappedFile(const std::string &path, const DiskCacheDir &) {
+            file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING,
+                               FILE_ATTRIBUTE_NORMAL, nullptr);
+            if (file == INVALID_HANDLE_VALUE) return;
+            LARGE_INTEGER len;
+            if (!GetFileSizeEx(file, &len) || len.QuadPart == 0) return;
+            mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            if (!mapping) return;
+            data = static_cast<const uint8_t *>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+            if (data) size = size_t(len.QuadPart);
+        }
+        ~MappedFile() {
+            if (data) UnmapViewOfFile(data);
+            if (mapping) CloseHandle(mapping);
+            if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+        }
+#else
+        MappedFile(const std::string &path, const DiskCacheDir &files) {
+            const int fd = open(path.c_str(), O_RDONLY | O_NOFOLLOW);
+            if (fd < 0) return;
+            struct stat st;
+            if (files.trustedEntry(fd) && fstat(fd, &st) == 0 && st.st_size > 0) {
+                void *p = mmap(nullptr, size_t(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+                if (p != MAP_FAILED) { data = static_cast<const uint8_t *>(p); size = size_t(st.st_size); }
+            }
+            close(fd);   // mapping ยังอยู่หลังปิด fd (และหลัง entry ถูก rename ทับ / ลบ)
+        }
+        ~MappedFile() {
+            if (data) munmap(const_cast<uint8_t *>(data), size);
+        }
+#endif
+        MappedFile(const MappedFile &) = delete;
+        MappedFile &operator=(const MappedFile &) = delete;
+    };
+};
+
+#endif
@@ -0,0 +1,738 @@
+// lc_sim.h
+// engine ของ simulator แบบ native (simulator.cpp) — semantics ตรงกับ Simulator.java ทุกจุด:
+//   - หน่วยความจำ 65536 word, register 8 ตัวเริ่มที่ 0, R0 ถูกบังคับเป็น 0 หลังทุกคำสั่ง, PC เริ่มที่ 0
+//   - ถอดคำสั่งตาม bit layout เดียวกับ packR/packI/packJ/packO (lc_isa.h) offset 16 บิต sign-extend
+//   - jalr: เขียน link ก่อน ถ้า rs == rt กระโดดไป PC+1, halt ขยับ PC ไป PC+1 แล้วหยุด
+//   - นับ step หลังพิมพ์ state และก่อน fetch เกิน 1,000,000 → ข้อความทาง stderr + พิมพ์ state อีกครั้ง
+//   - fetch นอก [0, numMemory) → ข้อความทาง stderr แล้วหยุดทันที (ไม่พิมพ์ state)
+//   - lw/sw นอก [0, 65536) → ข้อความทาง stderr ข้ามคำสั่งนั้นแล้วทำต่อ
+//   - เลขคณิตเป็น 32 บิตแบบ wrap-around เหมือน int ของ Java
+// โหมด trace พิมพ์ state (printState) ก่อนทุกคำสั่งให้ได้ byte เดียวกับ Simulator.java
+// โหมด fast ไม่พิมพ์อะไรระหว่างรัน (ข้อความ error ทาง stderr ยังเหมือนเดิม)
+// โหมด delta (run<true, false, true>) พิมพ์ state ครบแค่ตอนเริ่มและตอนจบ (halt / ชน guard) ระหว่างนั้นบรรทัดละ step
+// มีแค่ pc กับ register / word ที่เปลี่ยนจากครั้งก่อน expandtrace.cpp ขยายกลับเป็น output แบบ trace ได้ทุก byte:
+//     lcdelta 1
+//     state <pc> <numMemory>        ← snapshot (ต่อด้วย 2 บรรทัดข้างล่าง)
+//     regs <r0> ... <r7>
+//     mem <word 0> ... <word numMemory-1>
+//     <pc>[ r<i>=<ค่า>]...[ m<addr>=<ค่า>]   ← หนึ่งบรรทัดต่อ printState ที่ไม่ใช่ตัวแรก/ตัวสุดท้าย
+//
+// predecode: word ที่ถูก fetch ถอดครั้งเดียวเก็บใน decoded[] (DecodedInstr 8 ไบต์ imm sign-extend แล้ว)
+// รอบถัดไปของ loop ใช้ของที่ถอดไว้เลย หน้า (CODE_PAGE_WORDS word) ที่มีคำสั่งถูกถอดไว้จะถูกตั้งบิตใน codePages
+// sw ที่เปลี่ยนค่า word ในหน้าที่ตั้งบิตไว้ → ล้าง decode ของ word นั้น (fetch ครั้งหน้าถอดใหม่) โปรแกรมที่แก้โค้ดตัวเองจึงทำงานเหมือนเดิม
+// sw ลงหน้าที่เป็น data ล้วนเช็คแค่บิตเดียว
+//
+// dispatch มีสองแบบ (ผลเหมือนกันทุกอย่าง):
+//   run<TRACE>()   — switch (opcode) ตัวเดียว ใช้ได้ทุกคอมไพเลอร์ และเป็นตัวเดียวที่ trace ได้
+//   runThreaded()  — direct-threaded: คำสั่งที่ถอดแล้วเก็บ handler ของตัวเองไว้ (ThreadedInstr) จบ handler แล้ว
+//                    กระโดดไป handler ของคำสั่งถัดไปตรง ๆ ไม่ผ่าน switch กลาง แต่ละ handler จึงมี indirect branch
+//                    ของตัวเองให้ branch predictor เรียนแยกกัน
+//                    GCC: computed goto (&&label)  Clang: handler เป็นฟังก์ชันต่อกันด้วย [[clang::musttail]]
+//                    คอมไพเลอร์อื่นไม่มี (LC_SIM_HAS_THREADED ไม่ถูก define) ให้ใช้ run<false>()
+//   guard 1,000,000 step เช็คตอน dispatch ทุกครั้ง, PC ที่เดินเลยช่วงที่โหลดตกไปที่ช่อง tcode[numMemory]
+//   ซึ่งเป็น handler "PC หลุดช่วง" (beq/jalr ไปนอก [0, numMemory] ก็ส่งมาช่องนี้พร้อม PC จริง)
+//   runFused()     — threaded + superinstruction: รัน PROFILE_STEPS step แรกด้วย step() พร้อมนับ n-gram ที่ execute
+//                    ต่อกันจริง (คู่/สามคำสั่ง) เลือก pattern ที่เจอบ่อยสุดไม่เกิน MAX_FUSED_PATTERNS แบบ แล้วเปลี่ยน handler
+//                    ของคำสั่งแรกในตำแหน่งที่ตรง pattern เป็น handler รวม (สร้างจาก template ทุกแบบใน LC_FUSE_*)
+//                    handler รวมทำทีละคำสั่งตามลำดับ นับ step ของทั้งกลุ่มทีเดียว (guard เหลือไม่พอก็ทำแบบเดี่ยว)
+//                    คำสั่งที่ไม่ใช่ตัวสุดท้ายต้องไม่ใช่ beq/jalr/halt, ช่องของคำสั่งตัวถัด ๆ ไปยังเก็บ handler เดี่ยว
+//                    (กระโดดเข้ากลางกลุ่มได้) sw ทับคำสั่งในกลุ่ม → กลุ่มนั้นกลับเป็น handler เดี่ยว
+
+#ifndef LC_SIM_H
+#define LC_SIM_H
+
+#include "../assembler/lc_image.h"
+#include "../assembler/lc_isa.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+// เลือกวิธี dispatch ของ runThreaded (คอมไพล์ด้วย -DLC_SIM_FORCE_TAILCALL เพื่อทดสอบแบบ tail call บน GCC)
+#if defined(__clang__) && defined(__has_cpp_attribute)
+#  if __has_cpp_attribute(clang::musttail)
+#    define LC_SIM_TAILCALL 1
+#    define LC_SIM_MUSTTAIL [[clang::musttail]]
+#  endif
+#endif
+#if !defined(LC_SIM_TAILCALL) && defined(LC_SIM_FORCE_TAILCALL)
+#  define LC_SIM_TAILCALL 1
+#  define LC_SIM_MUSTTAIL   // ไม่มี musttail: พึ่ง sibling-call optimization ของ -O2
+#endif
+#if !defined(LC_SIM_TAILCALL) && defined(__GNUC__)
+#  define LC_SIM_COMPUTED_GOTO 1
+#endif
+#if defined(LC_SIM_TAILCALL) || defined(LC_SIM_COMPUTED_GOTO)
+#  define LC_SIM_HAS_THREADED 1
+// ตัวทำงานของแต่ละคำสั่งถูกใช้ซ้ำใน handler รวมกว่าร้อยตัว ฟังก์ชัน runThreaded จึงใหญ่จน GCC เลิก inline เอง
+#  define LC_SIM_INLINE __attribute__((always_inline)) inline
+#endif
+
+// ชุด superinstruction ของ runFused(): คำสั่งที่ไม่ใช่ตัวสุดท้ายเป็นได้แค่ FIRST/MID (ไม่เปลี่ยน PC)
+// ตัวสุดท้ายเป็น LAST (รวม beq/jalr) — LC_FUSE_FOR_PAIRS(LEAF) เรียก LEAF(A, Z) ทุกคู่, LC_FUSE_FOR_TRIPLES(LEAF) เรียก LEAF(A, B, Z)
+#define LC_FUSE_FIRST(X, LEAF)    X(ADD, LEAF) X(NAND, LEAF) X(LW, LEAF) X(SW, LEAF) X(NOOP, LEAF)
+#define LC_FUSE_MID(X, A, LEAF)   X(A, ADD, LEAF) X(A, NAND, LEAF) X(A, LW, LEAF) X(A, SW, LEAF) X(A, NOOP, LEAF)
+#define LC_FUSE_LAST(LEAF, ...)   LEAF(__VA_ARGS__, ADD) LEAF(__VA_ARGS__, NAND) LEAF(__VA_ARGS__, LW) LEAF(__VA_ARGS__, SW) \
+                                  LEAF(__VA_ARGS__, NOOP) LEAF(__VA_ARGS__, BEQ) LEAF(__VA_ARGS__, JALR)
+#define LC_FUSE_ROW2(A, LEAF)     LC_FUSE_LAST(LEAF, A)
+#define LC_FUSE_COL3(A, B, LEAF)  LC_FUSE_LAST(LEAF, A, B)
+#define LC_FUSE_ROW3(A, LEAF)     LC_FUSE_MID(LC_FUSE_COL3, A, LEAF)
+#define LC_FUSE_FOR_PAIRS(LEAF)   LC_FUSE_FIRST(LC_FUSE_ROW2, LEAF)
+#define LC_FUSE_FOR_TRIPLES(LEAF) LC_FUSE_FIRST(LC_FUSE_ROW3, LEAF)
+
+// ---------------- เขียน stdout แบบมี buffer ----------------
+// printState ของทั้งหน่วยความจำทุก step เป็นข้อความปริมาณมาก จึงจัดรูปเลขเองลง buffer ก้อนใหญ่แล้ว fwrite ทีเดียว
+// ("\n" ผ่าน stdout โหมด text จึงได้ line separator เดียวกับ println ของ Java บนแต่ละ OS)
+class OutBuffer {
+public:
+    explicit OutBuffer(FILE *f, size_t cap = 1 << 20) : file(f), buf(cap) {}
+    ~OutBuffer() { flush(); }
+
+    void put(const char *s, size_t n) {
+        if (n > buf.size() - len) {
+            flush();
+            if (n > buf.size()) { fwrite(s, 1, n, file); return; }
+        }
+        memcpy(buf.data() + len, s, n);
+        len += n;
+    }
+    void put(const char *s) { put(s, strlen(s)); }
+    void put(const std::string &s) { put(s.data(), s.size()); }
+    void putInt(int32_t v) {
+        char tmp[12];
+        size_t n = formatInt(tmp, v);
+        put(tmp, n);
+    }
+    void flush() {
+        if (len) fwrite(buf.data(), 1, len, file);
+        len = 0;
+        fflush(file);
+    }
+
+    // เลขฐานสิบแบบ Integer.toString (มีเครื่องหมายลบ) คืนจำนวนตัวอักษร
+    static size_t formatInt(char *out, int32_t v) {
+        char tmp[12];
+        size_t n = 0;
+        uint32_t u = v < 0 ? 0u - uint32_t(v) : uint32_t(v);
+        do { tmp[n++] = char('0' + u % 10); u /= 10; } while (u);
+        size_t k = 0;
+        if (v < 0) out[k++] = '-';
+        while (n) out[k++] = tmp[--n];
+        return k;
+    }
+
+private:
+    FILE *file;
+    std::vector<char> buf;
+    size_t len = 0;
+};
+
+struct LcSim {
+    static constexpr int  NUM_REGS  = 8;
+    static constexpr int  NUMMEMORY = 65536;
+    static constexpr long MAX_STEPS = 1000000;
+    static constexpr int  CODE_PAGE_WORDS = 64;
+    static constexpr uint8_t NOT_DECODED = 0xFF;   // opcode ใน decoded[] = ยังไม่ถอด / ถูกล้าง
+    static constexpr long PROFILE_STEPS = 20000;     // runFused: จำนวน step ที่ใช้นับ n-gram
+    static constexpr int  MAX_FUSED_PATTERNS = 8;
+    static constexpr const char *DELTA_HEADER = "lcdelta 1";   // บรรทัดแรกของ delta trace
+
+    enum class Stop { HALT, STEP_LIMIT, PC_OUT_OF_BOUNDS, RUNNING };   // RUNNING: เฉพาะ step() ที่ยังไม่หยุด
+
+    int32_t pc = 0;
+    int32_t regs[NUM_REGS] = {0};
+    std::vector<int32_t> mem = std::vector<int32_t>(NUMMEMORY, 0);
+    int32_t numMemory = 0;
+    long steps = 0;        // ตัวนับแบบเดียวกับ Simulator.java (รวมรอบที่ชน guard)
+    long executed = 0;     // จำนวนคำสั่งที่ execute จริง
+    long decodes = 0;      // จำนวนครั้งที่ถอดคำสั่งจริง (cache miss)
+    long invalidations = 0;   // sw ที่ทับคำสั่งที่ถอดไว้แล้ว
+    bool quiet = false;    // true = ไม่พิมพ์ข้อความ error ทาง stderr (ใช้ตอน benchmark รันซ้ำ)
+    long fusedSites = 0;           // runFused: จำนวนตำแหน่งที่ถูกเปลี่ยนเป็น handler รวม
+    std::string fusedPatterns;     // runFused: pattern ที่เลือก เช่น "add+beq(120000) sw+add(4000)" (จำนวนที่นับได้ตอน profile)
+
+    explicit LcSim(OutBuffer &out) : out(out) {}
+
+    void load(const SparseImage &image) {
+        std::fill(mem.begin(), mem.end(), 0);
+        numMemory = image.size;
+        image.copyTo(mem.data());
+        std::fill(regs, regs + NUM_REGS, 0);
+        pc = 0;
+        steps = executed = decodes = invalidations = 0;
+        memDirty = true;
+        decoded.assign(NUMMEMORY, DecodedInstr{NOT_DECODED, 0, 0, 0, 0});
+        std::fill(codePages, codePages + CODE_PAGES / 64, 0);
+    }
+
+    // image ที่เป็น word ล้วน (เครื่องมือฝั่ง assembler ที่ได้ image จาก encodeIR) ส่วนที่เกิน NUMMEMORY ถูกตัดทิ้ง
+    void load(const std::vector<int32_t> &words) {
+        SparseImage image;
+        for (size_t i = 0; i < words.size() && i < size_t(NUMMEMORY); ++i) image.push(words[i]);
+        load(image);
+    }
+
+    // echo ทุก word หลังโหลด ("memory[i]=v") เหมือน loadFromFile
+    void echoMemory() {
+        for (int32_t i = 0; i < numMemory; ++i) {
+            out.put("memory[");
+            out.putInt(i);
+            out.put("]=");
+            out.putInt(mem[i]);
+            out.put("\n");
+        }
+    }
+
+    // รูปแบบเดียวกับ printState ใน Simulator.java
+    // ส่วน memory เปลี่ยนเฉพาะตอน sw ลงช่วงที่โหลด จึงเก็บข้อความไว้แล้วสร้างใหม่เมื่อมีการเขียนเท่านั้น
+    void printState() {
+        if (memDirty) renderMemory();
+        out.put("@@@\nstate:\n\tpc ");
+        out.putInt(pc);
+        out.put("\n\tmemory:\n");
+        out.put(memText);
+        out.put("\tregisters:\n");
+        for (int i = 0; i < NUM_REGS; ++i) {
+            out.put("\t\treg[ ");
+            out.putInt(i);
+            out.put(" ] ");
+            out.putInt(regs[i]);
+            out.put("\n");
+        }
+        out.put("end state\n \n");
+    }
+
+    // delta trace: snapshot ครบ (ตอนเริ่ม / ตอนจบ) หรือบรรทัดเดียวที่มีแค่สิ่งที่เปลี่ยนตั้งแต่ครั้งก่อน
+    void printSnapshot() {
+        out.put("state ");
+        out.putInt(pc);
+        out.put(" ");
+        out.putInt(numMemory);
+        out.put("\nregs");
+        for (int i = 0; i < NUM_REGS; ++i) {
+            out.put(" ");
+            out.putInt(regs[i]);
+            tracedRegs[i] = regs[i];
+        }
+        out.put("\nmem");
+        for (int32_t i = 0; i < numMemory; ++i) {
+            out.put(" ");
+            out.putInt(mem[i]);
+        }
+        out.put("\n");
+        storedWord = -1;
+    }
+    void printDelta() {
+        out.putInt(pc);
+        for (int i = 0; i < NUM_REGS; ++i) {
+            if (regs[i] == tracedRegs[i]) continue;
+            out.put(" r");
+            out.putInt(i);
+            out.put("=");
+            out.putInt(regs[i]);
+            tracedRegs[i] = regs[i];
+        }
+        // printState ทุกคำสั่ง → ระหว่างสองบรรทัดมี sw ได้อย่างมากหนึ่งครั้ง
+        if (storedWord >= 0) {
+            out.put(" m");
+            out.putInt(storedWord);
+            out.put("=");
+            out.putInt(mem[storedWord]);
+            storedWord = -1;
+        }
+        out.put("\n");
+    }
+
+    // เขียน word จากนอก engine (expandtrace เล่น delta trace ซ้ำ) ให้ printState / fetch ครั้งต่อไปเห็นค่าใหม่
+    void poke(int32_t addr, int32_t value) {
+        mem[addr] = value;
+        memDirty = true;
+        noteCodeWrite(addr);
+    }
+
+    // TRACE = true: printState ก่อนทุกคำสั่ง (และหลัง halt / ชน guard) เหมือน run() ของ Simulator.java
+    // TRACE = false: ไม่พิมพ์ state ระหว่างรัน ผู้เรียกพิมพ์ state สุดท้ายเองถ้าต้องการ
+    // ONCE = true: execute คำสั่งเดียวแล้วคืน Stop::RUNNING (ถ้ายังไม่หยุด) — ใช้ผ่าน step()
+    // DELTA = true (คู่กับ TRACE): พิมพ์แบบ delta trace แทน printState
+    template <bool TRACE, bool ONCE = false, bool DELTA = false>
+    Stop run() {
+        bool first = true;
+        while (true) {
+            if (TRACE) traceState<DELTA>(first);
+            first = false;
+            if (++steps > MAX_STEPS) {
+                error("possible infinite loop (exceeded " + std::to_string(MAX_STEPS) + " steps)");
+                if (TRACE) traceState<DELTA>(true);
+                return Stop::STEP_LIMIT;
+            }
+            if (pc < 0 || pc >= numMemory) {
+                error("error: pc out of bounds: " + std::to_string(pc));
+                return Stop::PC_OUT_OF_BOUNDS;
+            }
+            const DecodedInstr d = fetch(pc);
+            int32_t nextPC = pc + 1;
+            bool halted = false;
+            switch (d.opcode) {
+                case OPC_ADD:  regs[d.dest] = int32_t(uint32_t(regs[d.regA]) + uint32_t(regs[d.regB])); break;
+                case OPC_NAND: regs[d.dest] = ~(regs[d.regA] & regs[d.regB]); break;
+                case OPC_LW: {
+                    int32_t addr = int32_t(uint32_t(regs[d.regA]) + uint32_t(d.imm));
+                    if (addr < 0 || addr >= NUMMEMORY) { error("error: lw address out of bounds: " + std::to_string(addr)); break; }
+                    regs[d.regB] = mem[addr];
+                    break;
+                }
+                case OPC_SW: {
+                    int32_t addr = int32_t(uint32_t(regs[d.regA]) + uint32_t(d.imm));
+                    if (addr < 0 || addr >= NUMMEMORY) { error("error: sw address out of bounds: " + std::to_string(addr)); break; }
+                    const int32_t v = regs[d.regB];
+                    if (mem[addr] == v) break;   // ค่าเดิม: ไม่ต้องล้างอะไร
+                    if (TRACE && addr < numMemory) memDirty = true;
+                    if (DELTA && addr < numMemory) storedWord = addr;
+                    mem[addr] = v;
+                    if (codePages[addr / CODE_PAGE_WORDS / 64] >> (addr / CODE_PAGE_WORDS % 64) & 1) invalidate(addr);
+                    break;
+                }
+                case OPC_BEQ:
+                    if (regs[d.regA] == regs[d.regB]) nextPC = int32_t(uint32_t(pc) + 1u + uint32_t(d.imm));
+                    break;
+                case OPC_JALR: {
+                    int32_t ret = pc + 1;
+                    int32_t target = regs[d.regA];
+                    regs[d.regB] = ret;
+                    nextPC = (d.regA == d.regB) ? ret : target;
+                    break;
+                }
+                case OPC_HALT: halted = true; break;
+                default: break;  // noop
+            }
+            regs[0] = 0;
+            pc = nextPC;
+            executed++;
+            if (halted) {
+                if (TRACE) traceState<DELTA>(true);
+                return Stop::HALT;
+            }
+            if (ONCE) return Stop::RUNNING;
+        }
+    }
+
+    // execute คำสั่งที่ pc หนึ่งคำสั่งแบบ run<false>() คืน false เมื่อหยุด (เหตุผลอยู่ใน stop)
+    // JIT (lc_jit.h) ใช้เป็น interpreter สำรองสำหรับโค้ดที่ยังไม่ร้อน / คำสั่งที่ผิดพลาด / halt
+    bool step(Stop &stop) {
+        stop = run<false, true>();
+        return stop == Stop::RUNNING;
+    }
+
+    // word addr ถูกเขียนจากนอก interpreter (โค้ดที่ JIT แปลไว้) → ล้าง decode ของ word นั้นถ้ามี
+    void noteCodeWrite(int32_t addr) {
+        if (codePages[addr / CODE_PAGE_WORDS / 64] >> (addr / CODE_PAGE_WORDS % 64) & 1) invalidate(addr);
+    }
+
+#ifdef LC_SIM_HAS_THREADED
+    // เหมือน run<false>() ทุกอย่าง (state, ข้อความ error, ตัวนับ) แต่ dispatch แบบ threaded
+    Stop runThreaded() { return runThreadedWith(nullptr); }
+
+    // เหมือน runThreaded() แต่ใช้ superinstruction ที่เลือกจาก profile ของ PROFILE_STEPS step แรก
+    Stop runFused() {
+        fusedSites = 0;
+        fusedPatterns.clear();
+        // 1) profile ด้วย interpreter: seq2[i] = ครั้งที่ i แล้วต่อด้วย i+1 ทันที, seq3[i] = i, i+1, i+2 ต่อกัน
+        std::vector<uint32_t> seq2(size_t(numMemory) + 2, 0), seq3(size_t(numMemory) + 2, 0);
+        int32_t prev1 = -2, prev2 = -2;
+        Stop stop;
+        for (long k = 0; k < PROFILE_STEPS; ++k) {
+            const int32_t at = pc;
+            if (!step(stop)) return stop;
+            if (at == prev1 + 1) {
+                seq2[prev1]++;
+                if (prev1 == prev2 + 1) seq3[prev2]++;
+            }
+            prev2 = prev1;
+            prev1 = at;
+        }
+
+        // 2) รวมจำนวนตาม pattern ของ opcode เลือกที่บ่อยสุด (อย่างน้อย 1% ของ step ที่ profile)
+        std::vector<uint8_t> ops(size_t(numMemory) + 2, OPC_HALT);
+        for (int32_t i = 0; i < numMemory; ++i)
+            if (seq2[i] || (i > 0 && seq2[i - 1]) || (i > 1 && seq3[i - 2])) ops[i] = decodeWord(mem[i]).opcode;
+        auto op = [&](int32_t i) { return int(ops[i]); };
+        auto inner = [](int o) { return o != OPC_BEQ && o != OPC_JALR && o != OPC_HALT; };
+        std::vector<uint64_t> count(8 * 8 * 8 + 8 * 8, 0);   // [0, 64) = คู่, [64, 576) = สามคำสั่ง
+        auto key2 = [&](int32_t i) { return op(i) * 8 + op(i + 1); };
+        auto key3 = [&](int32_t i) { return 64 + (op(i) * 8 + op(i + 1)) * 8 + op(i + 2); };
+        auto ok2 = [&](int32_t i) { return i + 1 < numMemory && inner(op(i)) && op(i + 1) != OPC_HALT; };
+        auto ok3 = [&](int32_t i) { return i + 2 < numMemory && inner(op(i)) && inner(op(i + 1)) && op(i + 2) != OPC_HALT; };
+        for (int32_t i = 0; i < numMemory; ++i) {
+            if (seq2[i] && ok2(i)) count[key2(i)] += seq2[i];
+            if (seq3[i] && ok3(i)) count[key3(i)] += seq3[i];
+        }
+        std::vector<int> keys;
+        for (int k = 0; k < int(count.size()); ++k)
+            if (count[k] * 100 >= uint64_t(PROFILE_STEPS)) keys.push_back(k);
+        std::stable_sort(keys.begin(), keys.end(), [&](int x, int y) { return count[x] > count[y]; });
+        if (keys.size() > size_t(MAX_FUSED_PATTERNS)) keys.resize(MAX_FUSED_PATTERNS);
+        std::vector<char> chosen(count.size(), 0);
+        for (int k : keys) {
+            chosen[k] = 1;
+            std::string name = k < 64 ? std::string(LC_MNEMONIC[k / 8]) + "+" + LC_MNEMONIC[k % 8]
+                                      : std::string(LC_MNEMONIC[(k - 64) / 64]) + "+" + LC_MNEMONIC[(k - 64) / 8 % 8] + "+" +
+                                            LC_MNEMONIC[(k - 64) % 8];
+            fusedPatterns += (fusedPatterns.empty() ? "" : " ") + name + "(" + std::to_string(count[k]) + ")";
+        }
+
+        // 3) ตำแหน่งที่จะเปลี่ยน handler (สามคำสั่งก่อนเพราะครอบได้มากกว่า)
+        std::vector<FusePlan> plan;
+        for (int32_t i = 0; i < numMemory; ++i) {
+            if (seq3[i] && ok3(i) && chosen[key3(i)]) plan.push_back({i, 3});
+            else if (seq2[i] && ok2(i) && chosen[key2(i)]) plan.push_back({i, 2});
+        }
+        return runThreadedWith(&plan);
+    }
+#endif
+
+private:
+#ifdef LC_SIM_HAS_THREADED
+    struct FusePlan {
+        int32_t at;
+        int len;
+    };
+
+    Stop runThreadedWith(const std::vector<FusePlan> *plan) {
+        ThreadedRun r;
+        r.sim = this;
+        tcode.resize(NUMMEMORY + 1);
+        r.base = tcode.data();
+        r.regs = regs;
+        r.mem = mem.data();
+        r.oobPc = numMemory;
+        const long steps0 = steps, budget = MAX_STEPS - steps;
+        r.remaining = budget;
+        ThreadedInstr *ip = nullptr;
+
+#ifdef LC_SIM_COMPUTED_GOTO
+        static const void *const LABELS[8] = {&&op_add, &&op_nand, &&op_lw, &&op_sw,
+                                              &&op_beq, &&op_jalr, &&op_halt, &&op_noop};
+        for (int k = 0; k < 8; ++k) r.handlers[k] = LABELS[k];
+        r.decodeHandler = &&op_decode;
+        r.oobHandler = &&op_oob;
+#define LC_FUSE_ADDR2(A, Z)    r.fuse2[OPC_##A][OPC_##Z] = &&fuse_##A##_##Z;
+#define LC_FUSE_ADDR3(A, B, Z) r.fuse3[OPC_##A][OPC_##B][OPC_##Z] = &&fuse_##A##_##B##_##Z;
+        LC_FUSE_FOR_PAIRS(LC_FUSE_ADDR2)
+        LC_FUSE_FOR_TRIPLES(LC_FUSE_ADDR3)
+#undef LC_FUSE_ADDR2
+#undef LC_FUSE_ADDR3
+        prepareThreaded(r);
+        if (plan) applyFusion(r, *plan);
+        ip = jumpTo(r, pc);
+
+#define LC_DISPATCH() do { if (r.remaining-- == 0) goto step_limit; goto *ip->handler; } while (0)
+        LC_DISPATCH();
+    op_add:    ip = execAdd(r, ip);  LC_DISPATCH();
+    op_nand:   ip = execNand(r, ip); LC_DISPATCH();
+    op_lw:     ip = execLw(r, ip);   LC_DISPATCH();
+    op_sw:     ip = execSw(r, ip);   LC_DISPATCH();
+    op_beq:    ip = execBeq(r, ip);  LC_DISPATCH();
+    op_jalr:   ip = execJalr(r, ip); LC_DISPATCH();
+    op_noop:   ++ip;                 LC_DISPATCH();
+        // superinstruction: นับ step ของคำสั่งที่เหลือในกลุ่มทีเดียวตอนเข้า (เหลือไม่พอ = ทำคำสั่งแรกแบบเดี่ยว)
+        // หลัง sw ถ้าคำสั่งที่เหลือถูกทับ คืน step ที่ยังไม่ได้ใช้แล้ว dispatch ต่อแบบปกติ
+#define LC_FUSE_ENTER(A, N)                                \
+        if (r.remaining < N) goto *r.handlers[OPC_##A];    \
+        r.remaining -= N;
+#define LC_FUSE_PART(OP, LEFT)                             \
+        ip = execOp<OPC_##OP>(r, ip);                      \
+        if (OPC_##OP == OPC_SW && fusedBroken(r, ip)) { r.remaining += LEFT; goto *ip->handler; }
+#define LC_FUSE_LABEL2(A, Z)                                                       \
+    fuse_##A##_##Z:                                                                \
+        LC_FUSE_ENTER(A, 1) LC_FUSE_PART(A, 0)                                     \
+        ip = execOp<OPC_##Z>(r, ip); LC_DISPATCH();
+#define LC_FUSE_LABEL3(A, B, Z)                                                    \
+    fuse_##A##_##B##_##Z:                                                          \
+        LC_FUSE_ENTER(A, 2) LC_FUSE_PART(A, 1) LC_FUSE_PART(B, 0)                  \
+        ip = execOp<OPC_##Z>(r, ip); LC_DISPATCH();
+        LC_FUSE_FOR_PAIRS(LC_FUSE_LABEL2)
+        LC_FUSE_FOR_TRIPLES(LC_FUSE_LABEL3)
+#undef LC_FUSE_ENTER
+#undef LC_FUSE_PART
+#undef LC_FUSE_LABEL2
+#undef LC_FUSE_LABEL3
+    op_decode: ip = execDecode(r, ip); goto *ip->handler;   // step นี้นับไปแล้วตอน dispatch
+    op_halt:   r.stop = Stop::HALT; goto done;
+    op_oob:    r.stop = Stop::PC_OUT_OF_BOUNDS; goto done;
+    step_limit: r.stop = Stop::STEP_LIMIT;
+    done:
+#undef LC_DISPATCH
+#else
+        const Handler byOpcode[8] = {&hAdd, &hNand, &hLw, &hSw, &hBeq, &hJalr, &hHalt, &hNoop};
+        for (int k = 0; k < 8; ++k) r.handlers[k] = reinterpret_cast<const void *>(byOpcode[k]);
+        r.decodeHandler = reinterpret_cast<const void *>(&hDecode);
+        r.oobHandler = reinterpret_cast<const void *>(&hOob);
+#define LC_FUSE_FN2(A, Z)    r.fuse2[OPC_##A][OPC_##Z] = reinterpret_cast<const void *>(&hFuse2<OPC_##A, OPC_##Z>);
+#define LC_FUSE_FN3(A, B, Z) r.fuse3[OPC_##A][OPC_##B][OPC_##Z] = reinterpret_cast<const void *>(&hFuse3<OPC_##A, OPC_##B, OPC_##Z>);
+        LC_FUSE_FOR_PAIRS(LC_FUSE_FN2)
+        LC_FUSE_FOR_TRIPLES(LC_FUSE_FN3)
+#undef LC_FUSE_FN2
+#undef LC_FUSE_FN3
+        prepareThreaded(r);
+        if (plan) applyFusion(r, *plan);
+        ip = jumpTo(r, pc);
+        hEnter(r, ip);
+        ip = r.last;
+#endif
+        // steps นับทุกรอบที่ผ่าน dispatch (รอบที่ชน guard ทำให้ remaining เป็น -1 จึงนับด้วย)
+        steps = steps0 + (budget - r.remaining);
+        executed += (budget - r.remaining) - (r.stop == Stop::HALT ? 0 : 1);
+        if (r.stop == Stop::HALT) {
+            pc = int32_t(ip - r.base) + 1;
+        } else {
+            pc = (ip == r.base + numMemory) ? r.oobPc : int32_t(ip - r.base);
+            if (r.stop == Stop::STEP_LIMIT)
+                error("possible infinite loop (exceeded " + std::to_string(MAX_STEPS) + " steps)");
+            else
+                error("error: pc out of bounds: " + std::to_string(pc));
+        }
+        return r.stop;
+    }
+#endif
+
+    static constexpr int CODE_PAGES = NUMMEMORY / CODE_PAGE_WORDS;
+
+    OutBuffer &out;
+    std::string memText;
+    bool memDirty = true;
+    std::vector<DecodedInstr> decoded;
+    uint64_t codePages[CODE_PAGES / 64] = {0};   // บิต = หน้านั้นมีคำสั่งที่ถอดไว้
+    int32_t tracedRegs[NUM_REGS] = {0};          // delta trace: register ตอนพิมพ์ครั้งก่อน
+    int32_t storedWord = -1;                     // delta trace: word ที่ sw เปลี่ยนหลังพิมพ์ครั้งก่อน (-1 = ไม่มี)
+
+#ifdef LC_SIM_HAS_THREADED
+    // คำสั่งที่ถอดแล้วพร้อม handler (label ของ computed goto หรือ pointer ของฟังก์ชัน handler)
+    struct ThreadedInstr {
+        const void *handler;
+        DecodedInstr d;
+    };
+    struct ThreadedRun {
+        LcSim *sim;
+        ThreadedInstr *base;
+        int32_t *regs;
+        int32_t *mem;
+        long remaining;              // step ที่ยังรันได้ก่อนชน guard
+        int32_t oobPc;               // PC จริงเมื่อกระโดดออกนอกช่วง (ช่อง tcode[numMemory])
+        const void *handlers[8];
+        const void *decodeHandler;
+        const void *oobHandler;
+        const void *fuse2[8][8] = {};        // handler รวม [op1][op2] (nullptr = ไม่มีใน LC_FUSE_*)
+        const void *fuse3[8][8][8] = {};
+        Stop stop = Stop::HALT;
+        ThreadedInstr *last = nullptr;   // ip ตอนหยุด (แบบ tail call)
+    };
+    std::vector<ThreadedInstr> tcode;
+
+    // ทุกช่องในช่วงที่โหลดเริ่มเป็น "ยังไม่ถอด" ช่องถัดจากช่วงเป็น "PC หลุดช่วง"
+    void prepareThreaded(ThreadedRun &r) {
+        for (int32_t i = 0; i < numMemory; ++i) tcode[i].handler = r.decodeHandler;
+        tcode[numMemory].handler = r.oobHandler;
+    }
+
+    // ถอดทุกคำสั่งในกลุ่มแล้วเปลี่ยน handler ของคำสั่งแรกเป็น handler รวมตาม opcode ปัจจุบัน
+    void applyFusion(ThreadedRun &r, const std::vector<FusePlan> &plan) {
+        for (const FusePlan &f : plan) {
+            for (int k = 0; k < f.len; ++k)
+                if (r.base[f.at + k].handler == r.decodeHandler) execDecode(r, r.base + f.at + k);
+            const ThreadedInstr *g = r.base + f.at;
+            const void *h = f.len == 2 ? r.fuse2[g[0].d.opcode][g[1].d.opcode]
+                                       : r.fuse3[g[0].d.opcode][g[1].d.opcode][g[2].d.opcode];
+            if (!h) continue;
+            r.base[f.at].handler = h;
+            fusedSites++;
+        }
+    }
+
+    // หลัง sw ในกลุ่ม: คำสั่งที่เหลือของกลุ่มถูกทับ (กลับเป็น "ยังไม่ถอด") → ทำกลุ่มต่อไม่ได้
+    static LC_SIM_INLINE bool fusedBroken(const ThreadedRun &r, const ThreadedInstr *ip) {
+        return ip[0].handler == r.decodeHandler || ip[1].handler == r.decodeHandler;
+    }
+
+    template <int OP>
+    static LC_SIM_INLINE ThreadedInstr *execOp(ThreadedRun &r, ThreadedInstr *ip) {
+        if constexpr (OP == OPC_ADD) return execAdd(r, ip);
+        else if constexpr (OP == OPC_NAND) return execNand(r, ip);
+        else if constexpr (OP == OPC_LW) return execLw(r, ip);
+        else if constexpr (OP == OPC_SW) return execSw(r, ip);
+        else if constexpr (OP == OPC_BEQ) return execBeq(r, ip);
+        else if constexpr (OP == OPC_JALR) return execJalr(r, ip);
+        else return ip + 1;   // noop
+    }
+
+    static LC_SIM_INLINE ThreadedInstr *jumpTo(ThreadedRun &r, int32_t target) {
+        if (uint32_t(target) <= uint32_t(r.sim->numMemory)) return r.base + target;
+        r.oobPc = target;
+        return r.base + r.sim->numMemory;
+    }
+
+    static ThreadedInstr *execDecode(ThreadedRun &r, ThreadedInstr *ip) {
+        const int32_t at = int32_t(ip - r.base);
+        ip->d = decodeWord(r.mem[at]);
+        ip->handler = r.handlers[ip->d.opcode];
+        r.sim->decodes++;
+        r.sim->codePages[at / CODE_PAGE_WORDS / 64] |= uint64_t(1) << (at / CODE_PAGE_WORDS % 64);
+        return ip;
+    }
+    static LC_SIM_INLINE ThreadedInstr *execAdd(ThreadedRun &r, ThreadedInstr *ip) {
+        const DecodedInstr &d = ip->d;
+        r.regs[d.dest] = int32_t(uint32_t(r.regs[d.regA]) + uint32_t(r.regs[d.regB]));
+        r.regs[0] = 0;
+        return ip + 1;
+    }
+    static LC_SIM_INLINE ThreadedInstr *execNand(ThreadedRun &r, ThreadedInstr *ip) {
+        const DecodedInstr &d = ip->d;
+        r.regs[d.dest] = ~(r.regs[d.regA] & r.regs[d.regB]);
+        r.regs[0] = 0;
+        return ip + 1;
+    }
+    static LC_SIM_INLINE ThreadedInstr *execLw(ThreadedRun &r, ThreadedInstr *ip) {
+        const DecodedInstr &d = ip->d;
+        const int32_t addr = int32_t(uint32_t(r.regs[d.regA]) + uint32_t(d.imm));
+        if (addr < 0 || addr >= NUMMEMORY) {
+            r.sim->error("error: lw address out of bounds: " + std::to_string(addr));
+        } else {
+            r.regs[d.regB] = r.mem[addr];
+            r.regs[0] = 0;
+        }
+        return ip + 1;
+    }
+    static LC_SIM_INLINE ThreadedInstr *execSw(ThreadedRun &r, ThreadedInstr *ip) {
+        const DecodedInstr &d = ip->d;
+        const int32_t addr = int32_t(uint32_t(r.regs[d.regA]) + uint32_t(d.imm));
+        if (addr < 0 || addr >= NUMMEMORY) {
+            r.sim->error("error: sw address out of bounds: " + std::to_string(addr));
+            return ip + 1;
+        }
+        const int32_t v = r.regs[d.regB];
+        if (r.mem[addr] == v) return ip + 1;
+        r.mem[addr] = v;
+        // เขียนทับคำสั่งที่ถอดไว้ → กลับเป็น "ยังไม่ถอด" และกลุ่ม superinstruction ที่ครอบคำสั่งนี้กลับเป็น handler เดี่ยว
+        if (addr < r.sim->numMemory && (r.sim->codePages[addr / CODE_PAGE_WORDS / 64] >> (addr / CODE_PAGE_WORDS % 64) & 1) &&
+            r.base[addr].handler != r.decodeHandler) {
+            r.base[addr].handler = r.decodeHandler;
+            r.sim->invalidations++;
+            for (int32_t k = 1; k <= 2 && addr - k >= 0; ++k) {
+                ThreadedInstr &head = r.base[addr - k];
+                if (head.handler != r.decodeHandler) head.handler = r.handlers[head.d.opcode];
+            }
+        }
+        return ip + 1;
+    }
+    static LC_SIM_INLINE ThreadedInstr *execBeq(ThreadedRun &r, ThreadedInstr *ip) {
+        const DecodedInstr &d = ip->d;
+        if (r.regs[d.regA] != r.regs[d.regB]) return ip + 1;
+        return jumpTo(r, int32_t(uint32_t(ip - r.base) + 1u + uint32_t(d.imm)));
+    }
+    static LC_SIM_INLINE ThreadedInstr *execJalr(ThreadedRun &r, ThreadedInstr *ip) {
+        const DecodedInstr &d = ip->d;
+        const int32_t ret = int32_t(ip - r.base) + 1;
+        const int32_t target = r.regs[d.regA];
+        r.regs[d.regB] = ret;
+        r.regs[0] = 0;
+        return d.regA == d.regB ? ip + 1 : jumpTo(r, target);
+    }
+
+#ifdef LC_SIM_TAILCALL
+    using Handler = void (*)(ThreadedRun &, ThreadedInstr *);
+
+#define LC_TAIL_DISPATCH(r, ip)                                                    \
+    do {                                                                           \
+        if ((r).remaining-- == 0) { (r).stop = Stop::STEP_LIMIT; (r).last = (ip); return; } \
+        LC_SIM_MUSTTAIL return reinterpret_cast<Handler>((ip)->handler)(r, ip);   \
+    } while (0)
+
+    static void hEnter(ThreadedRun &r, ThreadedInstr *ip) { LC_TAIL_DISPATCH(r, ip); }
+    static void hAdd(ThreadedRun &r, ThreadedInstr *ip)  { ip = execAdd(r, ip);  LC_TAIL_DISPATCH(r, ip); }
+    static void hNand(ThreadedRun &r, ThreadedInstr *ip) { ip = execNand(r, ip); LC_TAIL_DISPATCH(r, ip); }
+    static void hLw(ThreadedRun &r, ThreadedInstr *ip)   { ip = execLw(r, ip);   LC_TAIL_DISPATCH(r, ip); }
+    static void hSw(ThreadedRun &r, ThreadedInstr *ip)   { ip = execSw(r, ip);   LC_TAIL_DISPATCH(r, ip); }
+    static void hBeq(ThreadedRun &r, ThreadedInstr *ip)  { ip = execBeq(r, ip);  LC_TAIL_DISPATCH(r, ip); }
+    static void hJalr(ThreadedRun &r, ThreadedInstr *ip) { ip = execJalr(r, ip); LC_TAIL_DISPATCH(r, ip); }
+    static void hNoop(ThreadedRun &r, ThreadedInstr *ip) { ++ip;                 LC_TAIL_DISPATCH(r, ip); }
+    static void hHalt(ThreadedRun &r, ThreadedInstr *ip) { r.stop = Stop::HALT; r.last = ip; }
+    static void hOob(ThreadedRun &r, ThreadedInstr *ip)  { r.stop = Stop::PC_OUT_OF_BOUNDS; r.last = ip; }
+    static void hDecode(ThreadedRun &r, ThreadedInstr *ip) {
+        ip = execDecode(r, ip);
+        LC_SIM_MUSTTAIL return reinterpret_cast<Handler>(ip->handler)(r, ip);
+    }
+    // superinstruction แบบเดียวกับ LC_FUSE_LABEL2/3 ของ computed goto
+    template <int A, int Z>
+    static void hFuse2(ThreadedRun &r, ThreadedInstr *ip) {
+        if (r.remaining < 1) LC_SIM_MUSTTAIL return reinterpret_cast<Handler>(r.handlers[A])(r, ip);
+        r.remaining -= 1;
+        ip = execOp<A>(r, ip);
+        if (A == OPC_SW && fusedBroken(r, ip)) LC_SIM_MUSTTAIL return reinterpret_cast<Handler>(ip->handler)(r, ip);
+        ip = execOp<Z>(r, ip);
+        LC_TAIL_DISPATCH(r, ip);
+    }
+    template <int A, int B, int Z>
+    static void hFuse3(ThreadedRun &r, ThreadedInstr *ip) {
+        if (r.remaining < 2) LC_SIM_MUSTTAIL return reinterpret_cast<Handler>(r.handlers[A])(r, ip);
+        r.remaining -= 2;
+        ip = execOp<A>(r, ip);
+        if (A == OPC_SW && fusedBroken(r, ip)) {
+            r.remaining += 1;
+            LC_SIM_MUSTTAIL return reinterpret_cast<Handler>(ip->handler)(r, ip);
+        }
+        ip = execOp<B>(r, ip);
+        if (B == OPC_SW && fusedBroken(r, ip)) LC_SIM_MUSTTAIL return reinterpret_cast<Handler>(ip->handler)(r, ip);
+        ip = execOp<Z>(r, ip);
+        LC_TAIL_DISPATCH(r, ip);
+    }
+#undef LC_TAIL_DISPATCH
+#endif
+#endif
+
+    const DecodedInstr &fetch(int32_t at) {
+        DecodedInstr &d = decoded[at];
+        if (d.opcode == NOT_DECODED) {
+            d = decodeWord(mem[at]);
+            decodes++;
+            codePages[at / CODE_PAGE_WORDS / 64] |= uint64_t(1) << (at / CODE_PAGE_WORDS % 64);
+        }
+        return d;
+    }
+
+    void invalidate(int32_t at) {
+        if (decoded[at].opcode == NOT_DECODED) return;
+        decoded[at].opcode = NOT_DECODED;
+        invalidations++;
+    }
+
+    template <bool DELTA>
+    void traceState(bool full) {
+        if (!DELTA) printState();
+        else if (full) printSnapshot();
+        else printDelta();
+    }
+
+    void renderMemory() {
+        memText.clear();
+        char num[12];
+        for (int32_t i = 0; i < numMemory; ++i) {
+            memText += "\t\tmem[ ";
+            memText.append(num, OutBuffer::formatInt(num, i));
+            memText += " ] ";
+            memText.append(num, OutBuffer::formatInt(num, mem[i]));
+            memText += '\n';
+        }
+        memDirty = false;
+    }
+
+    // stderr ไม่มี buffer: flush stdout ก่อนให้ลำดับข้อความบนจอเหมือน System.out (autoflush) ของ Java
+    void error(const std::string &msg) {
+        if (quiet) return;
+        out.flush();
+        fprintf(stderr, "%s\n", msg.c_str());
+    }
+};
+
+#endif
@@ -0,0 +1,248 @@
+// mc2cpp.cpp
+// แปลง image (.mc) ล่วงหน้าเป็นไฟล์ C++ หนึ่งไฟล์ คอมไพล์แล้วได้โปรแกรมที่รัน image นั้นแบบ native
+// output ของโปรแกรมที่ได้เหมือน "simulator --fast file.mc" ทุก byte (state สุดท้าย, steps, ข้อความ error)
+//
+// วิธีแปล:
+//   1) หา code ด้วย reachability จาก PC 0 (scanCode ของ lc_isa.h ตัวเดียวกับ disassembler / cfg): beq → target และ PC+1,
+//      jalr → target ที่หาได้จากรูปแบบ "lw 0 R k ... jalr R x" และ PC+1 (ยกเว้น jalr R 0), halt → หยุด
+//   2) แบ่งเป็น basic block: leader = 0, target ของ beq/jalr, คำสั่งถัดจาก beq/jalr/halt, word ที่ word ก่อนหน้าไม่ใช่ code
+//      แต่ละ block เป็น label "b<addr>:" ใน function เดียว beq ไป block ที่รู้ปลายทางด้วย goto ตรง ๆ
+//   3) jalr ที่ target มาจาก register → switch (pc) ที่มี case ของทุก leader ไม่ตรง case ไหน → interpreter
+//   4) interpreter สำรอง (LcSim::step ของ lc_sim.h) รับช่วงเมื่อ
+//        - กระโดดไป address ที่ไม่ใช่ leader / นอก image
+//        - lw/sw address นอก [0, 65536) (interpreter พิมพ์ข้อความ error เอง) หรือ sw ลง word ที่เป็น code
+//        - เข้า block แล้ว step ที่เหลือไม่พอทั้ง block (interpreter หยุดที่ guard 1,000,000 step ให้ตรงเป๊ะ)
+//        - block ที่มี word ถูก sw เปลี่ยนค่าไปแล้ว (โค้ดแก้ตัวเอง) — block นั้นใช้ interpreter ตลอดไป
+//      interpreter รันทีละคำสั่งจนกว่า pc จะตรง leader ของ block ที่ยังใช้ได้ แล้วกลับเข้าโค้ดที่แปลไว้
+//   register r1..r7 เป็นตัวแปร local (r0 = ค่าคงที่ 0), steps นับทีละ block ตอนเข้า block
+//
+// Compile : g++ -std=c++17 -O2 mc2cpp.cpp -o mc2cpp
+// Run : .\mc2cpp ..\programs\multiply.mc multiply_aot.cpp
+//       แล้ว g++ -std=c++17 -O2 -I. multiply_aot.cpp -o multiply_aot  (ต้องเห็น lc_sim.h)  และ .\multiply_aot [--stats]
+
+#include "../assembler/lc_image.h"
+#include "../assembler/lc_isa.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+struct Block {
+    long start, len;
+};
+
+// code และ leader จาก scanCode ของ lc_isa.h (ตัวเดียวกับ disassembler / cfg)
+static vector<Block> findBlocks(const vector<int32_t> &words, vector<uint8_t> &isCode) {
+    const long n = (long)words.size();
+    CodeScan scan = scanCode(words);
+    isCode = move(scan.isCode);
+    const vector<uint8_t> &leader = scan.leader;
+    auto ends = [&](long pc) {
+        const int op = decodeWord(words[pc]).opcode;
+        return op == OPC_BEQ || op == OPC_JALR || op == OPC_HALT;
+    };
+    vector<Block> blocks;
+    for (long pc = 0; pc < n;) {
+        if (!isCode[pc]) { ++pc; continue; }
+        Block b{pc, 0};
+        do { ++pc; ++b.len; } while (pc < n && isCode[pc] && !leader[pc] && !ends(pc - 1));
+        blocks.push_back(b);
+    }
+    return blocks;
+}
+
+// ---------------- เขียนไฟล์ C++ ----------------
+static string reg(int r) { return r == 0 ? "0" : "r" + to_string(r); }
+
+static string render(const SparseImage &img, const vector<int32_t> &words, const string &srcName) {
+    vector<uint8_t> isCode;
+    const vector<Block> blocks = findBlocks(words, isCode);
+    const long n = (long)words.size();
+    vector<uint8_t> leader(n, 0);
+    for (const Block &b : blocks) leader[b.start] = 1;
+    auto isCodeAt = [&](long a) { return a >= 0 && a < n && isCode[a]; };
+    bool usesDone = false;
+    // ไปที่ address a (รู้ตอนแปล): block ที่แปลไว้ หรือ interpreter
+    auto jump = [&](long a) {
+        return a >= 0 && a < n && leader[a] ? "goto b" + to_string(a) + ";" : "{ pc = " + to_string(int32_t(a)) + "; goto interp; }";
+    };
+
+    string o;
+    o += "// generated by mc2cpp from " + srcName + " (" + to_string(n) + " word(s), " + to_string(blocks.size()) +
+         " block(s)) -- do not edit\n";
+    o += "// output เหมือน \"simulator --fast " + srcName + "\" ทุก byte, --stats = จำนวนคำสั่งที่ต้องใช้ interpreter ทาง stderr\n";
+    o += "// Compile : g++ -std=c++17 -O2 -I<ไดเรกทอรีของ lc_sim.h> <ไฟล์นี้> -o <ชื่อโปรแกรม>\n\n";
+    o += "#include \"lc_sim.h\"\n\n#include <algorithm>\n#include <cstdio>\n#include <cstring>\n#include <string>\n#include <vector>\n\n";
+
+    // image: literal ทุก segment ต่อกัน + ตาราง {count, run, value}
+    o += "static const int32_t LITERAL[] = {";
+    size_t lits = 0;
+    for (const auto &s : img.segments)
+        if (!s.run)
+            for (int32_t w : s.words) o += (lits++ % 12 ? " " : "\n    ") + to_string(w) + ",";
+    if (!lits) o += "0";
+    o += "\n};\nstatic const int32_t SEGMENTS[][3] = {";
+    for (const auto &s : img.segments)
+        o += "\n    {" + to_string(s.count) + ", " + (s.run ? "1" : "0") + ", " + to_string(s.value) + "},";
+    if (img.segments.empty()) o += "{0, 1, 0}";
+    o += "\n};\n\n";
+
+    // code word (sw ลง word เหล่านี้ต้องผ่าน interpreter) และจุดเริ่มของ block
+    o += "static const int32_t NUM_WORDS = " + to_string(n) + ";\n";
+    o += "static const uint64_t CODE_BITS[] = {";
+    for (long k = 0; k <= n / 64; ++k) {
+        uint64_t bits = 0;
+        for (long a = k * 64; a < min(n, k * 64 + 64); ++a) bits |= uint64_t(isCode[a]) << (a % 64);
+        o += (k % 6 ? " " : "\n    ") + to_string(bits) + "ull,";
+    }
+    o += "\n};\nstatic const int32_t NUM_BLOCKS = " + to_string(blocks.size()) + ";\n";
+    o += "static const int32_t BLOCK_START[] = {";
+    for (size_t k = 0; k < blocks.size(); ++k) o += (k % 12 ? " " : "\n    ") + to_string(blocks[k].start) + ",";
+    if (blocks.empty()) o += "0";
+    o += "\n};\n\n";
+    o += "static inline bool isCode(uint32_t a) { return a < uint32_t(NUM_WORDS) && (CODE_BITS[a >> 6] >> (a & 63) & 1); }\n\n";
+
+    o += "static LcSim::Stop runCompiled(LcSim &sim, long &interpreted) {\n";
+    o += "    int32_t *const m = sim.mem.data();\n";
+    o += "    std::vector<unsigned char> dead(size_t(NUM_BLOCKS) + 1, 0);   // block ที่มี word ถูกเขียนทับ\n";
+    o += "    int32_t r1, r2, r3, r4, r5, r6, r7, pc;\n    long steps;\n    LcSim::Stop stop;\n";
+    const string load = "r1 = sim.regs[1]; r2 = sim.regs[2]; r3 = sim.regs[3]; r4 = sim.regs[4]; r5 = sim.regs[5]; "
+                        "r6 = sim.regs[6]; r7 = sim.regs[7]; pc = sim.pc; steps = sim.steps;";
+    const string save = "sim.regs[1] = r1; sim.regs[2] = r2; sim.regs[3] = r3; sim.regs[4] = r4; sim.regs[5] = r5; "
+                        "sim.regs[6] = r6; sim.regs[7] = r7; sim.pc = pc; sim.executed += steps - sim.steps; sim.steps = steps;";
+    o += "#define LOAD_STATE() do { " + load + " } while (0)\n";
+    o += "#define SAVE_STATE() do { " + save + " } while (0)\n";
+    o += "    LOAD_STATE();\n    goto dispatch;\n";
+
+    for (size_t id = 0; id < blocks.size(); ++id) {
+        const Block &b = blocks[id];
+        const string len = to_string(b.len);
+        o += "\nb" + to_string(b.start) + ":\n";
+        o += "    if (steps > LcSim::MAX_STEPS - " + len + " || dead[" + to_string(id) + "]) { pc = " + to_string(b.start) +
+             "; goto interp; }\n";
+        o += "    steps += " + len + ";\n";
+        for (long k = 0; k < b.len; ++k) {
+            const long pc = b.start + k;
+            const DecodedInstr d = decodeWord(words[pc]);
+            // คำสั่งนี้ให้ interpreter ทำ: คืน step ของคำสั่งนี้และที่เหลือใน block
+            const string bail = "{ steps -= " + to_string(b.len - k) + "; pc = " + to_string(pc) + "; goto interp; }";
+            const string A = reg(d.regA), B = reg(d.regB), D = reg(d.dest), imm = to_string(d.imm);
+            o += "    // " + to_string(pc) + ": " + LC_MNEMONIC[d.opcode];
+            if (d.opcode == OPC_ADD || d.opcode == OPC_NAND) o += " " + to_string(d.regA) + " " + to_string(d.regB) + " " + to_string(d.dest);
+            else if (d.opcode == OPC_JALR) o += " " + to_string(d.regA) + " " + to_string(d.regB);
+            else if (d.opcode != OPC_HALT && d.opcode != OPC_NOOP) o += " " + to_string(d.regA) + " " + to_string(d.regB) + " " + imm;
+            o += "\n";
+            switch (d.opcode) {
+                case OPC_ADD:
+                    if (d.dest) o += "    " + D + " = int32_t(uint32_t(" + A + ") + uint32_t(" + B + "));\n";
+                    break;
+                case OPC_NAND:
+                    if (d.dest) o += "    " + D + " = ~(" + A + " & " + B + ");\n";
+                    break;
+                case OPC_LW:
+                    if (d.regA == 0) {
+                        if (d.imm < 0) o += "    " + bail + "\n";
+                        else if (d.regB) o += "    " + B + " = m[" + imm + "];\n";
+                    } else {
+                        o += "    { const uint32_t a = uint32_t(" + A + ") + uint32_t(" + imm + "); if (a >= 65536u) " + bail;
+                        o += d.regB ? " " + B + " = m[a]; }\n" : " }\n";
+                    }
+                    break;
+                case OPC_SW:
+                    if (d.regA == 0) {
+                        if (d.imm < 0 || isCodeAt(d.imm)) o += "    " + bail + "\n";
+                        else o += "    m[" + imm + "] = " + B + ";\n";
+                    } else {
+                        o += "    { const uint32_t a = uint32_t(" + A + ") + uint32_t(" + imm + "); if (a >= 65536u || isCode(a)) " +
+                             bail + " m[a] = " + B + "; }\n";
+                    }
+                    break;
+                case OPC_BEQ: {
+                    const long t = pc + 1 + d.imm;
+                    if (d.regA == d.regB) o += "    " + jump(t) + "\n";
+                    else o += "    if (" + A + " == " + B + ") " + jump(t) + "\n    " + jump(pc + 1) + "\n";
+                    break;
+                }
+                case OPC_JALR:
+                    if (d.regA == d.regB) {
+                        if (d.regB) o += "    " + B + " = " + to_string(pc + 1) + ";\n";
+                        o += "    " + jump(pc + 1) + "\n";
+                    } else {
+                        o += "    pc = " + A + ";\n";
+                        if (d.regB) o += "    " + B + " = " + to_string(pc + 1) + ";\n";
+                        o += "    goto dispatch;\n";
+                    }
+                    break;
+                case OPC_HALT:
+                    o += "    pc = " + to_string(pc + 1) + "; stop = LcSim::Stop::HALT; goto done;\n";
+                    usesDone = true;
+                    break;
+                default: break;   // noop
+            }
+        }
+        const long next = b.start + b.len;
+        const int lastOp = decodeWord(words[next - 1]).opcode;
+        if (lastOp != OPC_BEQ && lastOp != OPC_JALR && lastOp != OPC_HALT) o += "    " + jump(next) + "\n";
+    }
+
+    o += "\ndispatch:\n    switch (pc) {\n";
+    for (const Block &b : blocks) o += "        case " + to_string(b.start) + ": goto b" + to_string(b.start) + ";\n";
+    o += "        default: break;\n    }\n";
+    if (!blocks.empty()) o += "interp:\n";
+    o += "    SAVE_STATE();\n";
+    o += "    if (uint32_t(pc) < uint32_t(NUM_WORDS)) {\n";
+    o += "        // sw ที่จะเปลี่ยนค่า code word → block ที่มี word นั้นกลับมาใช้ไม่ได้อีก\n";
+    o += "        const DecodedInstr d = decodeWord(m[pc]);\n";
+    o += "        const uint32_t a = uint32_t(sim.regs[d.regA]) + uint32_t(d.imm);\n";
+    o += "        if (d.opcode == OPC_SW && isCode(a) && m[a] != sim.regs[d.regB])\n";
+    o += "            dead[std::upper_bound(BLOCK_START, BLOCK_START + NUM_BLOCKS, int32_t(a)) - BLOCK_START - 1] = 1;\n";
+    o += "    }\n";
+    o += "    interpreted++;\n";
+    o += "    if (!sim.step(stop)) return stop;\n";
+    o += "    LOAD_STATE();\n";
+    o += "    goto dispatch;\n";
+    if (usesDone) o += "done:\n    SAVE_STATE();\n    return stop;\n";
+    o += "#undef LOAD_STATE\n#undef SAVE_STATE\n}\n\n";
+
+    o += "int main(int argc, char **argv) {\n";
+    o += "    const bool stats = argc > 1 && std::string(argv[1]) == \"--stats\";\n";
+    o += "    SparseImage image;\n";
+    o += "    const int32_t *lit = LITERAL;\n";
+    o += "    for (const auto &s : SEGMENTS) {\n";
+    o += "        if (s[1]) { if (s[0]) image.pushRun(s[0], s[2]); }\n";
+    o += "        else for (int32_t k = 0; k < s[0]; ++k) image.push(*lit++);\n";
+    o += "    }\n";
+    o += "    OutBuffer out(stdout);\n    LcSim sim(out);\n    sim.load(image);\n";
+    o += "    long interpreted = 0;\n    runCompiled(sim, interpreted);\n    sim.printState();\n";
+    o += "    if (stats) {\n        out.flush();\n";
+    o += "        fprintf(stderr, \"executed %ld instruction(s), %ld step(s) through the interpreter\\n\", sim.executed, interpreted);\n";
+    o += "    }\n    return 0;\n}\n";
+    return o;
+}
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        cerr << "usage: " << argv[0] << " <machine-code.mc> [output.cpp]\n";
+        return 1;
+    }
+    const string inPath = argv[1];
+    const string outPath = argc >= 3 ? argv[2] : filesystem::path(inPath).stem().string() + "_aot.cpp";
+    try {
+        const SparseImage img = loadSparseImage(inPath);
+        const string src = render(img, img.expand(), filesystem::path(inPath).filename().string());
+        ofstream ofs(outPath, ios::binary);
+        if (!ofs) throw runtime_error("cannot write " + outPath);
+        ofs << src;
+        cout << "wrote " << outPath << "\n";
+    } catch (const exception &e) {
+        cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,226 @@
+// simbench.cpp
+// วัดความเร็ว (instructions per second) ของ engine: switch, threaded และ fused (lc_sim.h) และ jit (lc_jit.h)
+// คอลัมน์ jit+cache = jit ที่โหลด block จาก JitCache (ไดเรกทอรีชั่วคราว อุ่นไว้ก่อนจับเวลา)
+// รันโปรแกรม .mc ที่ให้มา (ไม่ให้ = ทุกไฟล์ .mc ใน ../programs) และ workload สังเคราะห์ที่สร้างในไฟล์นี้
+// แต่ละงานรันซ้ำจนได้เวลารวมอย่างน้อย --min-time วินาที แล้วเทียบ state สุดท้ายของทุก engine ว่าตรงกัน
+//
+// Compile : g++ -std=c++17 -O2 simbench.cpp -o simbench
+// Run : .\simbench   หรือ   .\simbench --min-time 1 ..\programs\multiply.mc
+
+#include "lc_jit.h"
+#include "lc_sim.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace std;
+namespace fs = std::filesystem;
+
+// ---------------- assembler ขนาดจิ๋วสำหรับ workload สังเคราะห์ ----------------
+// รับ assembly รูปแบบเดียวกับ parser (label ต้นบรรทัด, offset เป็นเลขหรือ label) + .fill / .space N
+static SparseImage assemble(const vector<string> &src) {
+    map<string, int> labels;
+    vector<vector<string>> rows;
+    int at = 0;
+    for (const string &line : src) {
+        istringstream is(line);
+        vector<string> t;
+        for (string w; is >> w;) t.push_back(w);
+        if (t.empty()) continue;
+        static const vector<string> OPS = {"add", "nand", "lw", "sw", "beq", "jalr", "halt", "noop", ".fill", ".space"};
+        if (find(OPS.begin(), OPS.end(), t[0]) == OPS.end()) {
+            labels[t[0]] = at;
+            t.erase(t.begin());
+        }
+        at += t[0] == ".space" ? stoi(t[1]) : 1;
+        rows.push_back(t);
+    }
+    auto value = [&](const string &s) { return labels.count(s) ? labels[s] : stoi(s); };
+    SparseImage img;
+    for (const auto &t : rows) {
+        const string &m = t[0];
+        if (m == ".fill") img.push(value(t[1]));
+        else if (m == ".space") img.pushRun(stoi(t[1]), 0);
+        else if (m == "add") img.push(int32_t(packR(OPC_ADD, stoi(t[1]), stoi(t[2]), stoi(t[3]))));
+        else if (m == "nand") img.push(int32_t(packR(OPC_NAND, stoi(t[1]), stoi(t[2]), stoi(t[3]))));
+        else if (m == "lw") img.push(int32_t(packI(OPC_LW, stoi(t[1]), stoi(t[2]), value(t[3]))));
+        else if (m == "sw") img.push(int32_t(packI(OPC_SW, stoi(t[1]), stoi(t[2]), value(t[3]))));
+        else if (m == "beq") {
+            int off = labels.count(t[3]) ? labels[t[3]] - (img.size + 1) : stoi(t[3]);
+            img.push(int32_t(packI(OPC_BEQ, stoi(t[1]), stoi(t[2]), off)));
+        }
+        else if (m == "jalr") img.push(int32_t(packJ(OPC_JALR, stoi(t[1]), stoi(t[2]))));
+        else if (m == "halt") img.push(int32_t(packO(OPC_HALT)));
+        else img.push(int32_t(packO(OPC_NOOP)));
+    }
+    return img;
+}
+
+// workload สังเคราะห์: ทุกตัวจบด้วย halt ก่อนชน guard 1,000,000 step
+static vector<pair<string, SparseImage>> syntheticWorkloads() {
+    vector<pair<string, SparseImage>> w;
+    // ALU ล้วน: 6 คำสั่งต่อรอบ
+    w.push_back({"synthetic: alu loop", assemble({
+        "        lw 0 1 n", "        lw 0 2 neg1",
+        "loop    add 3 1 3", "        nand 3 1 4", "        add 4 3 5",
+        "        add 1 2 1", "        beq 1 0 done", "        beq 0 0 loop",
+        "done    halt", "n       .fill 160000", "neg1    .fill -1"})});
+    // lw/sw กระจายทั่ว array 32768 word (index = counter AND 32767)
+    w.push_back({"synthetic: load/store", assemble({
+        "        lw 0 1 n", "        lw 0 2 neg1", "        lw 0 7 mask",
+        "loop    nand 1 7 4", "        nand 4 4 4",
+        "        lw 4 3 buf", "        add 3 1 3", "        sw 4 3 buf",
+        "        add 1 2 1", "        beq 1 0 done", "        beq 0 0 loop",
+        "done    halt", "n       .fill 120000", "neg1    .fill -1", "mask    .fill 32767",
+        "buf     .space 32768"})});
+    // เรียก subroutine ผ่าน jalr ทุกรอบ
+    w.push_back({"synthetic: call/return", assemble({
+        "        lw 0 1 n", "        lw 0 2 neg1", "        lw 0 6 subad",
+        "loop    jalr 6 7", "        add 1 2 1", "        beq 1 0 done", "        beq 0 0 loop",
+        "sub     add 3 1 3", "        jalr 7 5",
+        "done    halt", "n       .fill 160000", "neg1    .fill -1", "subad   .fill sub"})});
+    // branch ที่ขึ้นกับข้อมูล (bit ต่ำของ counter สลับทางทุกรอบ)
+    w.push_back({"synthetic: branchy", assemble({
+        "        lw 0 1 n", "        lw 0 2 neg1", "        lw 0 7 one",
+        "loop    nand 1 7 4", "        nand 4 4 4", "        beq 4 0 even",
+        "        add 3 1 3", "        beq 0 0 next",
+        "even    add 5 1 5", "        noop",
+        "next    add 1 2 1", "        beq 1 0 done", "        beq 0 0 loop",
+        "done    halt", "n       .fill 100000", "neg1    .fill -1", "one     .fill 1"})});
+    return w;
+}
+
+struct Result {
+    double ips = 0;
+    long executed = 0;
+    LcSim::Stop stop = LcSim::Stop::HALT;
+    int32_t pc = 0;
+    vector<int32_t> regs, mem;
+};
+
+enum class Engine { SWITCH, THREADED, FUSED, JIT, JIT_CACHED };
+
+static Result measure(const SparseImage &image, Engine engine, double minTime, OutBuffer &out) {
+    LcSim sim(out);
+    sim.quiet = true;
+#ifdef LC_SIM_HAS_JIT
+    // จอง/เตรียมหน่วยความจำโค้ดครั้งเดียว ไม่นับในเวลา (แต่การแปล block ของแต่ละรอบนับ)
+    unique_ptr<LcJit> jit(engine == Engine::JIT || engine == Engine::JIT_CACHED ? new LcJit() : nullptr);
+    unique_ptr<JitCache> cache;
+    if (engine == Engine::JIT_CACHED) {
+        cache.reset(new JitCache((fs::temp_directory_path() / "simbench-jitcache").string()));
+        sim.load(image);
+        jit->run(sim, cache.get());
+    }
+#endif
+    Result r;
+    long total = 0;
+    double elapsed = 0;
+    int reps = 0;
+    // เงื่อนไขหยุดใช้เวลาจริงทั้งหมด (รวม load) ไม่อย่างนั้นโปรแกรมสั้น ๆ จะวนโหลดซ้ำเป็นล้านรอบ
+    const auto start = chrono::steady_clock::now();
+    while (chrono::duration<double>(chrono::steady_clock::now() - start).count() < minTime || reps < 3) {
+        sim.load(image);
+        auto t0 = chrono::steady_clock::now();
+        switch (engine) {
+#ifdef LC_SIM_HAS_THREADED
+            case Engine::THREADED: r.stop = sim.runThreaded(); break;
+            case Engine::FUSED: r.stop = sim.runFused(); break;
+#endif
+#ifdef LC_SIM_HAS_JIT
+            case Engine::JIT: r.stop = jit->run(sim); break;
+            case Engine::JIT_CACHED: r.stop = jit->run(sim, cache.get()); break;
+#endif
+            default: r.stop = sim.run<false>(); break;
+        }
+        elapsed += chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+        total += sim.executed;
+        reps++;
+    }
+    r.ips = elapsed > 0 ? total / elapsed : 0;
+    r.executed = sim.executed;
+    r.pc = sim.pc;
+    r.regs.assign(sim.regs, sim.regs + LcSim::NUM_REGS);
+    r.mem = sim.mem;
+    return r;
+}
+
+static bool sameState(const Result &x, const Result &y) {
+    return x.executed == y.executed && x.stop == y.stop && x.pc == y.pc && x.regs == y.regs && x.mem == y.mem;
+}
+
+int main(int argc, char **argv) {
+    double minTime = 0.3;
+    vector<string> files;
+    for (int i = 1; i < argc; ++i) {
+        string a = argv[i];
+        if (a == "--min-time" && i + 1 < argc) minTime = stod(argv[++i]);
+        else if (!a.empty() && a[0] == '-') {
+            cerr << "usage: " << argv[0] << " [--min-time SEC] [file.mc...]\n";
+            return 1;
+        }
+        else files.push_back(a);
+    }
+    try {
+        vector<pair<string, SparseImage>> work;
+        if (files.empty()) {
+            error_code ec;
+            for (const auto &e : fs::directory_iterator("../programs", ec))
+                if (e.path().extension() == ".mc") files.push_back(e.path().string());
+            sort(files.begin(), files.end());
+        }
+        for (const string &f : files) work.push_back({fs::path(f).filename().string(), loadSparseImage(f)});
+        for (auto &w : syntheticWorkloads()) work.push_back(move(w));
+
+        OutBuffer out(stdout);
+        cout << left << setw(26) << "workload" << right << setw(10) << "instrs" << setw(14) << "switch MIPS";
+#ifdef LC_SIM_HAS_THREADED
+        cout << setw(16) << "threaded MIPS" << setw(10) << "speedup" << setw(13) << "fused MIPS" << setw(10) << "speedup";
+#endif
+#ifdef LC_SIM_HAS_JIT
+        cout << setw(11) << "jit MIPS" << setw(10) << "speedup" << setw(12) << "jit+cache";
+#endif
+        cout << "\n";
+        for (const auto &w : work) {
+            Result sw = measure(w.second, Engine::SWITCH, minTime, out);
+            cout << left << setw(26) << w.first << right << setw(10) << sw.executed << setw(14) << fixed
+                 << setprecision(1) << sw.ips / 1e6;
+#ifdef LC_SIM_HAS_THREADED
+            Result th = measure(w.second, Engine::THREADED, minTime, out);
+            if (!sameState(th, sw)) throw runtime_error(w.first + ": threaded engine state differs from switch engine");
+            cout << setw(16) << setprecision(1) << th.ips / 1e6 << setw(9) << setprecision(2) << th.ips / sw.ips << "x";
+            Result fu = measure(w.second, Engine::FUSED, minTime, out);
+            if (!sameState(fu, sw)) throw runtime_error(w.first + ": fused engine state differs from switch engine");
+            cout << setw(13) << setprecision(1) << fu.ips / 1e6 << setw(9) << setprecision(2) << fu.ips / sw.ips << "x";
+#endif
+#ifdef LC_SIM_HAS_JIT
+            Result jt = measure(w.second, Engine::JIT, minTime, out);
+            if (!sameState(jt, sw)) throw runtime_error(w.first + ": jit engine state differs from switch engine");
+            cout << setw(11) << setprecision(1) << jt.ips / 1e6 << setw(9) << setprecision(2) << jt.ips / sw.ips << "x";
+            Result jc = measure(w.second, Engine::JIT_CACHED, minTime, out);
+            if (!sameState(jc, sw)) throw runtime_error(w.first + ": cached jit state differs from switch engine");
+            cout << setw(12) << setprecision(1) << jc.ips / 1e6;
+#endif
+            cout << "\n";
+        }
+#if defined(LC_SIM_COMPUTED_GOTO)
+        cout << "threaded dispatch: computed goto\n";
+#elif defined(LC_SIM_TAILCALL)
+        cout << "threaded dispatch: tail-call handlers\n";
+#endif
+    } catch (const exception &e) {
+        cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,141 @@
+// simulator.cpp
+// Simulator.java ฉบับ native (C++) ไม่ต้องใช้ JVM รันไฟล์ .mc จาก assembler/linker (รองรับ record "*N value")
+//   ค่าเริ่มต้น: output เหมือน "java Simulator file.mc" ทุก byte (echo memory + printState ก่อนทุกคำสั่ง)
+//   --fast    : ไม่ echo / ไม่ trace พิมพ์ state สุดท้ายครั้งเดียว (ข้อความ error ทาง stderr เหมือนเดิม)
+//   --delta   : trace แบบ delta (รูปแบบดูหัว lc_sim.h) state ครบแค่ตอนเริ่ม/จบ ระหว่างนั้นเฉพาะ pc กับค่าที่เปลี่ยน
+//               ขยายกลับเป็น output เต็มด้วย expandtrace
+//   --engine switch|threaded|fused|jit : engine ของโหมด --fast (ค่าเริ่มต้น jit บน x86-64 ดู lc_jit.h, ไม่มีก็ threaded ดู lc_sim.h)
+//                                  fused = threaded + superinstruction ที่เลือกจาก profile (runFused)
+//                                  ถ้าจองหน่วยความจำ execute ไม่ได้ jit ถอยไปใช้ interpreter เอง
+//   --cache DIR : (engine jit) เก็บ/ใช้โค้ดที่ JIT แปลไว้ใน DIR ตาม hash ของ image (ดู lc_jitcache.h)
+//                 ไม่ใส่ก็ใช้ตัวแปรแวดล้อม LCSIM_CACHE_DIR ถ้าตั้งไว้ หลาย process ใช้ DIR เดียวกันพร้อมกันได้
+//   --stats   : หลังรันพิมพ์จำนวนคำสั่งที่ execute, จำนวนครั้งที่ถอดคำสั่ง และ decode ที่ถูกล้างเพราะ sw ทับโค้ด ทาง stderr
+// semantics ทั้งหมดอยู่ใน lc_sim.h
+//
+// Compile : g++ -std=c++17 -O2 simulator.cpp -o simulator
+// Run : .\simulator ..\programs\multiply.mc > multiply_sim.txt   หรือ   .\simulator --fast ..\programs\multiply.mc
+
+#include "lc_jit.h"
+#include "lc_sim.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <memory>
+#include <string>
+
+using namespace std;
+
+int main(int argc, char **argv) {
+    bool fast = false, delta = false, stats = false;
+#if defined(LC_SIM_HAS_JIT)
+    string engine = "jit";
+#elif defined(LC_SIM_HAS_THREADED)
+    string engine = "threaded";
+#else
+    string engine = "switch";
+#endif
+    string path, cacheDir;
+    if (const char *env = getenv("LCSIM_CACHE_DIR")) cacheDir = env;
+    int files = 0;
+    for (int i = 1; i < argc; ++i) {
+        string a = argv[i];
+        if (a == "--fast") fast = true;
+        else if (a == "--delta") delta = true;
+        else if (a == "--stats") stats = true;
+        else if (a == "--engine" && i + 1 < argc) engine = argv[++i];
+        else if (a == "--cache" && i + 1 < argc) cacheDir = argv[++i];
+        else { path = a; files++; }
+    }
+    if (files != 1 || (fast && delta)) {
+        fprintf(stderr, "error: usage: simulator [--fast | --delta] [--engine switch|threaded|fused|jit] [--cache DIR] [--stats] <machine-code file>\n");
+        return 1;
+    }
+    if (engine != "switch" && engine != "threaded" && engine != "fused" && engine != "jit") {
+        fprintf(stderr, "error: unknown engine '%s'\n", engine.c_str());
+        return 1;
+    }
+#ifndef LC_SIM_HAS_THREADED
+    if (engine == "threaded" || engine == "fused") {
+        fprintf(stderr, "error: %s engine is not available with this compiler\n", engine.c_str());
+        return 1;
+    }
+#endif
+#ifndef LC_SIM_HAS_JIT
+    if (engine == "jit") {
+        fprintf(stderr, "error: jit engine is only available on x86-64\n");
+        return 1;
+    }
+#endif
+
+    SparseImage image;
+    try {
+        image = loadSparseImage(path);
+    } catch (const exception &e) {
+        // ข้อความ "error in reading address N (line L)" ตรงกับ loadFromFile ของ Simulator.java
+        string msg = e.what();
+        fprintf(stderr, "%s%s\n", msg.rfind("error", 0) == 0 ? "" : "error: ", msg.c_str());
+        return 1;
+    }
+
+    OutBuffer out(stdout);
+    LcSim sim(out);
+    sim.load(image);
+#ifdef LC_SIM_HAS_JIT
+    unique_ptr<LcJit> jit;
+#endif
+    if (fast) {
+        bool done = false;
+#ifdef LC_SIM_HAS_JIT
+        if (engine == "jit") {
+            try {
+                jit.reset(new LcJit());
+            } catch (const exception &) {
+                engine = "threaded";   // ระบบไม่ให้หน่วยความจำ execute: ใช้ interpreter
+            }
+            if (jit) {
+                // cache ใช้ไม่ได้ (สร้างไดเรกทอรีไม่ได้ / ไม่ใช่ของผู้ใช้นี้ / คนอื่นเขียนได้) ก็แค่รันแบบไม่มี cache
+                unique_ptr<JitCache> cache;
+                if (!cacheDir.empty()) {
+                    try {
+                        cache.reset(new JitCache(cacheDir));
+                    } catch (const exception &e) {
+                        fprintf(stderr, "warning: jit cache disabled: %s\n", e.what());
+                    }
+                }
+                jit->run(sim, cache.get());
+                done = true;
+            }
+        }
+#endif
+#ifdef LC_SIM_HAS_THREADED
+        if (!done && engine == "fused") { sim.runFused(); done = true; }
+        if (!done && engine != "switch") { sim.runThreaded(); done = true; }
+#endif
+        if (!done) sim.run<false>();
+        sim.printState();
+    } else if (delta) {
+        out.put(LcSim::DELTA_HEADER);
+        out.put("\n");
+        sim.run<true, false, true>();
+    } else {
+        sim.echoMemory();
+        sim.run<true>();
+    }
+    if (stats) {
+        out.flush();
+        fprintf(stderr, "executed %ld instruction(s), decoded %ld word(s), %ld code write(s) invalidated\n",
+                sim.executed, sim.decodes, sim.invalidations);
+#ifdef LC_SIM_HAS_THREADED
+        if (fast && engine == "fused")
+            fprintf(stderr, "fused: %ld site(s), pattern(s) %s\n", sim.fusedSites,
+                    sim.fusedPatterns.empty() ? "-" : sim.fusedPatterns.c_str());
+#endif
+#ifdef LC_SIM_HAS_JIT
+        if (jit)
+            fprintf(stderr, "jit: %ld block(s) loaded from cache, %ld translated, %ld invalidated, %ld chain(s) patched, %ld code flush(es)\n",
+                    jit->blocksLoaded, jit->blocksTranslated, jit->blocksInvalidated, jit->chainsPatched, jit->codeFlushes);
+#endif
+    }
+    return 0;
+}
@@ -4,7 +4,8 @@
 เดินทีละคำสั่ง (IR row)
 แปลงเป็นคำสั่งเครื่อง 32 บิตตามรูปแบบบิตที่กำหนด (R/I/J/O)
 ตรวจ error ต่าง ๆ (label ไม่มี, offset เกิน 16 บิต, เรจิสเตอร์ผิดช่วง ฯลฯ)
-เขียนผลเป็น เลขฐานสิบบรรทัดละ 1 ค่า ลงไฟล์ .mc และพิมพ์ log (ทั้งฐานสิบและ hex) ออกทาง stdout/stderr*/
+เขียนผลเป็น เลขฐานสิบบรรทัดละ 1 ค่า ลงไฟล์ .mc และพิมพ์ log (ทั้งฐานสิบและ hex) ออกทาง stdout/stderr
+.space/.block N value เขียนเป็น record เดียว "*N value" (run-length, ดู lc_image.h) ไม่ใช่ N บรรทัด*/
 
 #include <iostream>      // พิมพ์ข้อความ/ผลลัพธ์พื้นฐาน
 #include <string>        // std::string
@@ -19,6 +20,9 @@
 #include <algorithm>     // find_if ใช้ trim ด้านขวา
 #include <bitset>  // ใช้พิมพ์เลขฐานสอง 3 บิตของ opcode (เช่น 000..111)
 
+#include "assembler.h"
+#include "lc_isa.h" // bit layout + packR/packI/packJ/packO (ใช้ร่วมกับ disassembler/simulator)
+
 
 using namespace std;
 
@@ -66,47 +70,9 @@ static const unordered_map<string, Op> OPCODE_MAP = {
     {"lw",   Op::LW},   {"sw",   Op::SW},
     {"beq",  Op::BEQ},  {"jalr", Op::JALR},
     {"halt", Op::HALT}, {"noop", Op::NOOP},
-    {".fill",Op::FILL}
+    {".fill",Op::FILL}, {".space",Op::FILL}, {".block",Op::FILL}
 };
 
-// -------------------- Bit layout ของคำสั่ง 32 บิต --------------------
-// เราใช้การ shift บิตเข้าตำแหน่งที่สเปกกำหนด:
-// [ opcode(3) | regA(3) | regB(3) | (ที่เหลือ 16 บิต/3 บิตขึ้นกับชนิด) ]
-constexpr int OPCODE_SHIFT = 22; //OPCODE_SHIFT=22
-constexpr int REGA_SHIFT   = 19; //REGA_SHIFT=19
-constexpr int REGB_SHIFT   = 16; //REGB_SHIFT=16
-//opcode อยู่บิต [24..22] (3 บิต)
-//regA บิต [21..19] (3 บิต)
-//regB บิต [18..16] (3 บิต)
-//แล้วที่เหลือขึ้นกับชนิดคำสั่ง
-
-// ฟังก์ชัน pack บิตสำหรับแต่ละฟอร์แมต (ลด duplicate โค้ด)
-inline uint32_t packR(int opcode, int rA, int rB, int dest) {
-    // R-type(add, nand) : ช่องท้ายสุดใช้เพียง 3 บิตสำหรับ destReg (3 บิตที่ [2..0]) ส่วน [15..3] เป็น 0)
-    return (uint32_t(opcode) << OPCODE_SHIFT)
-        | (uint32_t(rA)     << REGA_SHIFT)
-        | (uint32_t(rB)     << REGB_SHIFT)
-        | (uint32_t(dest) & 0x7u); //dest & 0x7u บังคับ 3 บิต
-}
-inline uint32_t packI(int opcode, int rA, int rB, int offset16) {
-    // I-type(lw, sw, beq): 16 บิตท้ายใช้เก็บ offset แบบ two's complement
-    return (uint32_t(opcode) << OPCODE_SHIFT)
-        | (uint32_t(rA)     << REGA_SHIFT)
-        | (uint32_t(rB)     << REGB_SHIFT)
-        | (uint32_t(offset16) & 0xFFFFu); // & 0xFFFFu เพื่อชัดเจนว่าตัดเหลือ 16 บิต
-}
-inline uint32_t packJ(int opcode, int rA, int rB) {
-    // J-type(jalr): ใช้แค่ opcode + regA + regB, ที่เหลือ (16 บิต[15..0]) เป็น 0
-    return (uint32_t(opcode) << OPCODE_SHIFT)
-        | (uint32_t(rA)     << REGA_SHIFT)
-        | (uint32_t(rB)     << REGB_SHIFT);
-}
-inline uint32_t packO(int opcode) {
-    // ใช้กับ halt, noop
-    // O-type: ใช้เฉพาะ opcode, ที่เหลือทั้งหมดเป็น 0
-    return (uint32_t(opcode) << OPCODE_SHIFT);
-}
-
 // -------------------- โครงสร้าง error ที่เราจะรายงาน --------------------
 enum class AsmError {
     NONE = 0,
@@ -129,6 +95,9 @@ inline bool okReg(int r){ return 0<=r && r<=7; } // reg 3 บิต: 0..7 เท
 // .fill จะให้ outOpcode = -1 
 ErrInfo toOpcode(const string& mnemonic, int& outOpcode) {
     auto it = OPCODE_MAP.find(mnemonic);
+    // mulc/.scratch ถูก parser ขยายเป็น add/nand ก่อนเขียน program.ir แล้ว ถ้ามาถึงนี่แสดงว่าไม่ได้ผ่าน parser
+    if (mnemonic == "mulc" || mnemonic == ".scratch")
+        return {AsmError::UNKNOWN_OPCODE, "pseudo-instruction " + mnemonic + " must be expanded by the parser first"};
     if (it == OPCODE_MAP.end())
         return {AsmError::UNKNOWN_OPCODE, "unknown opcode: " + mnemonic};
     if (it->second == Op::FILL) { outOpcode = -1; return {AsmError::NONE,""}; }
@@ -136,45 +105,6 @@ ErrInfo toOpcode(const string& mnemonic, int& outOpcode) {
     return {AsmError::NONE,""};
 }
 
-// -----------------------------------------------------------------------------
-// helper: พิมพ์ opcode จากชื่อคำสั่ง (mnemonic) แบบ CLI
-// การใช้งาน: printOpcodeCLI("add")  → พิมพ์ "add -> opcode 0 (bin 000)"
-// หมายเหตุ:
-//   - ใช้ฟังก์ชันเดิมของโปรเจกต์: toOpcode(mnemonic, outOpcode)
-//   - ถ้าเป็น ".fill" จะถือเป็น directive (ไม่ใช่ instruction) → opcode = -1
-// -----------------------------------------------------------------------------
-static int printOpcodeCLI(const std::string& m) {
-    int opcode = -1;  // ค่าตั้งต้น (-1) เผื่อกรณีไม่ใช่ instruction เช่น .fill
-
-    // เรียก mapping ชื่อคำสั่ง → ตัวเลข opcode
-    //   - สำเร็จ: opcode จะเป็น 0..7 (add..noop) หรือ -1 ถ้าเป็น .fill
-    //   - ล้มเหลว: code != NONE แปลว่าไม่รู้จัก mnemonic นี้
-    ErrInfo e = toOpcode(m, opcode);
-
-    // ถ้าไม่รู้จัก mnemonic → แจ้ง error และจบด้วยรหัส 1 (ผิดพลาด)
-    if (e.code != AsmError::NONE) {
-        std::cerr << "unknown mnemonic: " << m << "\n";
-        return 1;
-    }
-
-    // พิมพ์ชื่อคำสั่งและเลข opcode (แบบฐานสิบ) ออกไปก่อน
-    std::cout << m << " -> opcode " << opcode;
-
-    // ถ้าเป็นคำสั่งจริง (opcode 0..7) แถมรูปแบบฐานสอง 3 บิตให้ดูด้วย
-    // ตัวอย่าง: 4 → "100" (beq)
-    if (opcode >= 0) {
-        std::cout << " (bin " << std::bitset<3>(opcode) << ")";
-    } else {
-        // กรณีพิเศษ: .fill ไม่ใช่ instruction → แสดงว่าเป็น directive ชัดเจน
-        std::cout << " (directive)"; // .fill = -1
-    }
-
-    // ปิดท้ายด้วยขึ้นบรรทัดใหม่ แล้วคืนค่า 0 (สำเร็จ)
-    std::cout << "\n";
-    return 0;
-}
-
-
 // helper เช็คว่า x อยู่ในช่วง signed 16-bit หรือไม่
 inline bool inSigned16(long long x){ return -32768<=x && x<=32767; }
 
@@ -272,18 +202,7 @@ ErrInfo getFieldValue(const unordered_map<string,int>& symtab,
     return {AsmError::NONE,""};
 }
 
-// -------------------- โครงสร้าง IR (รับจาก Part A) --------------------
-// หมายเหตุ: Part A(ปฟ) จะ parse ข้อความ assembly แล้วส่ง IR ให้เรา (Part B (นน)) 
-// - mnemonic: ชื่อคำสั่ง เช่น add/lw/beq/.../.fill
-// - regA/regB/dest: ตำแหน่งเรจิสเตอร์ที่เกี่ยวข้อง (R/J type ใช้ dest)
-// - fieldToken: ค่าฟิลด์ (offset/label) สำหรับ I-type และค่าใน .fill
-// - pc: address ของคำสั่งบรรทัดนั้น (เริ่มนับจาก 0)
-struct IRInstr {
-    string mnemonic; //mnemonic: เช่น add, lw, .fill
-    int    regA{-1}, regB{-1}, dest{-1}; // regA, regB, dest: เลขเรจิสเตอร์ (ถ้าไม่ระบุจะเป็น -1)
-    string fieldToken; // fieldToken: token ของฟิลด์ท้าย (offset/label สำหรับ lw/sw/beq หรือค่าของ .fill)
-    int    pc{-1}; // pc: address ของบรรทัดนี้ (เริ่มที่ 0)
-};
+// โครงสร้าง IRInstr (รับจาก Part A) อยู่ใน assembler.h
 
 // -------------------- helper: ตรวจ register ให้ครบและอยู่ในช่วง --------------------
 // needReg ตรวจว่ามีค่าไหม (ไม่ใช่ -1) และอยู่ในช่วงหรือไม่
@@ -410,6 +329,18 @@ int assembleProgram(const unordered_map<string,int>& symtab,
                 << " (" << ir.mnemonic << "): " << res.error.msg << "\n";
             return 1; // หยุดทันทีตามสเปก
         }
+        // .space/.block → record "*N value" บรรทัดเดียว (loader ขยายเอง ไม่ต้องเขียน N บรรทัด)
+        if (ir.mnemonic == ".space" || ir.mnemonic == ".block") {
+            out << "*" << ir.count << " " << res.word << "\n";
+            if (!out) {
+                cerr << "ERROR: write failed at PC=" << ir.pc << "\n";
+                return 1;
+            }
+            cout << "(address " << ir.pc << ".." << (ir.pc + ir.count - 1) << "): "
+                << ir.count << " x " << res.word << "\n";
+            continue;
+        }
+
         // เขียนเป็นเลขฐาน 10 หนึ่งค่า/บรรทัดตามข้อกำหนด
         out << res.word << "\n";
         if (!out) {
@@ -495,7 +426,20 @@ vector<IRInstr> loadIR(const string& filename){
         //    - lw/sw/beq → ใช้ f2 (offset/label)
         //    - อื่น ๆ → เว้นว่าง
         if (instr == ".fill") {
-            ir.fieldToken = !f0.empty() ? f0 : rtrim(fillstr);
+            // ค่าของ .fill อาจยาวเกิน 8 ตัวอักษร (เช่น -1240057366) ทำให้ล้นคอลัมน์ f0
+            // จึงอ่าน token เต็ม ๆ ที่เริ่มคอลัมน์ 24 แทนการตัดแค่ 8 ตัว
+            string fullF0;
+            istringstream(safeSubstr(line, 24, string::npos)) >> fullF0;
+            ir.fieldToken = !fullF0.empty() ? fullF0 : rtrim(fillstr);
+        } else if (instr == ".space" || instr == ".block") {
+            // f0 = จำนวน word (ไม่เกิน 65536 จึงไม่ล้นคอลัมน์), ค่าอยู่ที่ f1 ซึ่งอาจยาวล้นคอลัมน์ได้เหมือน .fill
+            string value;
+            if (!rtrim(f1).empty()) istringstream(safeSubstr(line, 32, string::npos)) >> value;
+            ir.fieldToken = !value.empty() ? value : "0";
+            if (!tryParseInt(f0, ir.count) || ir.count < 1 || ir.count > 65536) {
+                cerr << "ERROR: bad " << instr << " size '" << f0 << "' at PC=" << ir.pc << "\n";
+                return {};
+            }
         } else if (instr == "lw" || instr == "sw" || instr == "beq") {
             ir.fieldToken = f2;
         } else {
@@ -517,6 +461,46 @@ vector<IRInstr> loadIR(const string& filename){
 //   - ถ้า IR ว่าง → error ทันที
 //   - เรียก assembleProgram เพื่อแปลงและเขียนไฟล์ผลลัพธ์
 //   - คืนค่า 0/1 ตามผล (สอดคล้องสเปก project)
+// เครื่องมืออื่นที่ลิงก์ assembler.cpp เข้าไปด้วย (เช่น lcbuild) ให้คอมไพล์พร้อม -DASSEMBLER_NO_MAIN
+#ifndef ASSEMBLER_NO_MAIN
+// -----------------------------------------------------------------------------
+// helper: พิมพ์ opcode จากชื่อคำสั่ง (mnemonic) แบบ CLI
+// การใช้งาน: printOpcodeCLI("add")  → พิมพ์ "add -> opcode 0 (bin 000)"
+// หมายเหตุ:
+//   - ใช้ฟังก์ชันเดิมของโปรเจกต์: toOpcode(mnemonic, outOpcode)
+//   - ถ้าเป็น ".fill" จะถือเป็น directive (ไม่ใช่ instruction) → opcode = -1
+// -----------------------------------------------------------------------------
+static int printOpcodeCLI(const std::string& m) {
+    int opcode = -1;  // ค่าตั้งต้น (-1) เผื่อกรณีไม่ใช่ instruction เช่น .fill
+
+    // เรียก mapping ชื่อคำสั่ง → ตัวเลข opcode
+    //   - สำเร็จ: opcode จะเป็น 0..7 (add..noop) หรือ -1 ถ้าเป็น .fill
+    //   - ล้มเหลว: code != NONE แปลว่าไม่รู้จัก mnemonic นี้
+    ErrInfo e = toOpcode(m, opcode);
+
+    // ถ้าไม่รู้จัก mnemonic → แจ้ง error และจบด้วยรหัส 1 (ผิดพลาด)
+    if (e.code != AsmError::NONE) {
+        std::cerr << "unknown mnemonic: " << m << "\n";
+        return 1;
+    }
+
+    // พิมพ์ชื่อคำสั่งและเลข opcode (แบบฐานสิบ) ออกไปก่อน
+    std::cout << m << " -> opcode " << opcode;
+
+    // ถ้าเป็นคำสั่งจริง (opcode 0..7) แถมรูปแบบฐานสอง 3 บิตให้ดูด้วย
+    // ตัวอย่าง: 4 → "100" (beq)
+    if (opcode >= 0) {
+        std::cout << " (bin " << std::bitset<3>(opcode) << ")";
+    } else {
+        // กรณีพิเศษ: .fill ไม่ใช่ instruction → แสดงว่าเป็น directive ชัดเจน
+        std::cout << " (directive)"; // .fill = -1
+    }
+
+    // ปิดท้ายด้วยขึ้นบรรทัดใหม่ แล้วคืนค่า 0 (สำเร็จ)
+    std::cout << "\n";
+    return 0;
+}
+
 int main(int argc, char** argv){
     ios::sync_with_stdio(false);
     cin.tie(nullptr);
@@ -569,3 +553,4 @@ int main(int argc, char** argv){
     }
     return code; // 0=สำเร็จ, 1=ล้มเหลว (สอดคล้องกับข้อกำหนด)
 }
+#endif
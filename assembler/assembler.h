@@ -0,0 +1,37 @@
+// assembler.h
+// ส่วน B (IR + symbol table → .mc) ให้เครื่องมืออื่นเรียกใช้ได้โดยไม่ผ่าน main ของ assembler
+// (เช่น lcbuild) คอมไพล์ assembler.cpp พร้อม -DASSEMBLER_NO_MAIN
+
+#ifndef ASSEMBLER_H
+#define ASSEMBLER_H
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+
+// -------------------- โครงสร้าง IR (รับจาก Part A) --------------------
+// หมายเหตุ: Part A(ปฟ) จะ parse ข้อความ assembly แล้วส่ง IR ให้เรา (Part B (นน))
+// - mnemonic: ชื่อคำสั่ง เช่น add/lw/beq/.../.fill
+// - regA/regB/dest: ตำแหน่งเรจิสเตอร์ที่เกี่ยวข้อง (R/J type ใช้ dest)
+// - fieldToken: ค่าฟิลด์ (offset/label) สำหรับ I-type และค่าใน .fill
+// - pc: address ของคำสั่งบรรทัดนั้น (เริ่มนับจาก 0)
+struct IRInstr {
+    string mnemonic; //mnemonic: เช่น add, lw, .fill
+    int    regA{-1}, regB{-1}, dest{-1}; // regA, regB, dest: เลขเรจิสเตอร์ (ถ้าไม่ระบุจะเป็น -1)
+    string fieldToken; // fieldToken: token ของฟิลด์ท้าย (offset/label สำหรับ lw/sw/beq หรือค่าของ .fill)
+    int    pc{-1}; // pc: address ของบรรทัดนี้ (เริ่มที่ 0)
+    int    count{1}; // count: จำนวน word (.space/.block N = N, อื่น ๆ = 1)
+};
+
+// อ่าน program_symbols.txt / program.ir ที่ parser เขียน (อ่านไม่ได้ → คืนค่าว่าง + ข้อความทาง stderr)
+unordered_map<string,int> loadSymbolTable(const string& filename);
+vector<IRInstr> loadIR(const string& filename);
+
+// แปลง IR ทั้งหมดเป็น .mc ที่ outPath: 0 = สำเร็จ, 1 = error (ข้อความทาง stderr, log ทีละบรรทัดทาง stdout)
+int assembleProgram(const unordered_map<string,int>& symtab,
+                    const vector<IRInstr>& irs,
+                    const string& outPath);
+
+#endif
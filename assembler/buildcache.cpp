@@ -0,0 +1,120 @@
+// buildcache.cpp — ดูคำอธิบายใน buildcache.h
+
+#include "buildcache.h"
+
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <vector>
+
+using namespace std;
+namespace fs = std::filesystem;
+
+static const uint64_t FNV_PRIME = 1099511628211ULL;
+
+string CacheKey::hex() const { return CacheKeyHash::hex(hi, lo); }
+
+uint64_t hashFileBytes(const string &path) {
+    ifstream ifs(path, ios::binary);
+    if (!ifs.is_open()) return 0;
+    uint64_t h = 1469598103934665603ULL;
+    char buf[1 << 16];
+    while (ifs.read(buf, sizeof buf) || ifs.gcount() > 0) {
+        for (streamsize i = 0; i < ifs.gcount(); ++i) h = (h ^ (unsigned char)buf[i]) * FNV_PRIME;
+        if (!ifs) break;
+    }
+    return h;
+}
+
+CacheKey makeCacheKey(const string &source, bool countBlankLines, const string &commentChars,
+                      const string &toolVersion) {
+    CacheKeyHash k;
+    // option แต่ละตัวคั่นด้วย '\0' และใส่ความยาวนำหน้า ค่าที่ต่อกันแล้วเหมือนกันจึงไม่ได้ key เดียวกัน
+    auto field = [&](const string &s) {
+        for (char c : to_string(s.size())) k.mix((unsigned char)c);
+        k.mix(0);
+        k.mix(s.data(), s.size());
+        k.mix(0);
+    };
+    field("lcache" + to_string(BuildCache::VERSION));
+    field(toolVersion);
+    field(countBlankLines ? "blank=1" : "blank=0");
+    field(commentChars);
+    field(source);
+
+    CacheKey key;
+    k.finish(key.hi, key.lo);
+    key.sourceSize = source.size();
+    return key;
+}
+
+BuildCache::BuildCache(const string &dir, uint64_t maxBytes) : files(dir, ".lcc", maxBytes, DiskCacheDir::SHARED) {}
+
+bool BuildCache::lookup(const CacheKey &key, BuildArtifacts &out, const string &baseDir) const {
+    const string path = files.entryPath(key.hex());
+    string text;
+    {
+        ifstream ifs(path, ios::binary);
+        if (!ifs.is_open()) return false;
+        ostringstream ss;
+        ss << ifs.rdbuf();
+        text = ss.str();
+    }
+
+    // header แต่ละบรรทัด แล้วตามด้วยเนื้อตามจำนวน byte ที่บอก
+    size_t at = 0;
+    auto header = [&](const string &name, uint64_t &n) {
+        size_t eol = text.find('\n', at);
+        if (eol == string::npos) return false;
+        istringstream is(text.substr(at, eol - at));
+        string tag;
+        at = eol + 1;
+        return bool(is >> tag >> n) && tag == name;
+    };
+    auto body = [&](const string &name, string &dst) {
+        uint64_t n = 0;
+        if (!header(name, n) || n > text.size() - at) return false;
+        dst = text.substr(at, n);
+        at += n;
+        return true;
+    };
+    // dep ทุกตัวต้องยังมีเนื้อเดิม (ไฟล์ที่ include เปลี่ยน → ต้องประกอบใหม่)
+    auto deps = [&](vector<CacheDep> &dst) {
+        uint64_t n = 0;
+        if (!header("deps", n)) return false;
+        for (uint64_t k = 0; k < n; ++k) {
+            size_t eol = text.find('\n', at);
+            if (eol == string::npos || text.compare(at, 4, "dep ") != 0 || eol < at + 22) return false;
+            CacheDep d;
+            istringstream(text.substr(at + 4, 16)) >> std::hex >> d.hash;
+            d.path = text.substr(at + 21, eol - at - 21);
+            at = eol + 1;
+            fs::path p(d.path);
+            if (p.is_relative()) p = fs::path(baseDir) / p;
+            if (hashFileBytes(p.string()) != d.hash) return false;
+            dst.push_back(move(d));
+        }
+        return true;
+    };
+    uint64_t version = 0, size = 0;
+    BuildArtifacts art;
+    if (!header("lcache", version) || version != VERSION || !header("source", size) || size != key.sourceSize ||
+        !deps(art.deps) || !body("ir", art.ir) || !body("symbols", art.symbols) || !body("mc", art.machineCode) || at != text.size())
+        return false;
+    out = move(art);
+    DiskCacheDir::touch(path);
+    return true;
+}
+
+void BuildCache::store(const CacheKey &key, const BuildArtifacts &art) {
+    files.write(files.entryPath(key.hex()), [&](ostream &os) {
+        os << "lcache " << VERSION << "\nsource " << key.sourceSize << "\n";
+        os << "deps " << art.deps.size() << "\n";
+        for (const auto &d : art.deps)
+            os << "dep " << std::hex << setfill('0') << setw(16) << d.hash << std::dec << " " << d.path << "\n";
+        os << "ir " << art.ir.size() << "\n" << art.ir;
+        os << "symbols " << art.symbols.size() << "\n" << art.symbols;
+        os << "mc " << art.machineCode.size() << "\n" << art.machineCode;
+    });
+}
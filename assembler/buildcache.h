@@ -0,0 +1,77 @@
+// buildcache.h
+// cache ผลการประกอบ (IR, symbol table, .mc) บนดิสก์ แบบ content-addressed
+//   key = hash 128 บิตของ byte ต้นฉบับ + option ของ parser (countBlankLines, commentChars) + เวอร์ชันเครื่องมือ
+//   ต้นฉบับเดียวกันกับ option เดียวกัน → ได้ผลเดิมจาก cache เลย ไม่ต้อง parseFile / assembleProgram
+//
+// โครงสร้างไดเรกทอรี:  <dir>/<key 2 หลักแรก>/<key ที่เหลือ>.lcc   (แตกเป็น 256 โฟลเดอร์ย่อย ไม่ให้โฟลเดอร์เดียวใหญ่เกิน)
+// รูปแบบ entry:
+//     lcache 2
+//     source <จำนวน byte ของต้นฉบับ>        (เช็คซ้ำตอนอ่าน กัน hash ชน)
+//     deps <n>           ตามด้วย n บรรทัด "dep <hash 16 หลัก> <path>" ไฟล์ที่ .include เข้ามา
+//                        (path เทียบกับโฟลเดอร์ของต้นฉบับ, hash ไม่ตรงกับไฟล์ปัจจุบัน = miss)
+//     ir <bytes>         ตามด้วยเนื้อไฟล์ program.ir ตรง ๆ <bytes> byte
+//     symbols <bytes>    ตามด้วยเนื้อไฟล์ program_symbols.txt
+//     mc <bytes>         ตามด้วยเนื้อไฟล์ .mc
+//
+// การเขียนแบบ atomic (หลาย process ใช้พร้อมกันได้โดยไม่ต้องล็อก), hash ของ key และ eviction แบบ LRU
+// ใช้ DiskCacheDir / CacheKeyHash ของ lc_diskcache.h ร่วมกับ JitCache ของ simulator
+// entry ที่อ่านไม่ผ่าน (ถูกลบระหว่างอ่าน / เสีย) ถือเป็น miss
+
+#ifndef BUILDCACHE_H
+#define BUILDCACHE_H
+
+#include "lc_diskcache.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// ไฟล์ที่ผลการประกอบขึ้นอยู่ด้วยนอกจากตัวต้นฉบับ (.include)
+struct CacheDep {
+    uint64_t hash;     // hashFileBytes ของเนื้อไฟล์
+    string path;
+};
+
+// ผลการประกอบหนึ่งไฟล์ (เนื้อไฟล์ตามที่ parser/assembler เขียน)
+struct BuildArtifacts {
+    vector<CacheDep> deps;
+    string ir;         // program.ir
+    string symbols;    // program_symbols.txt
+    string machineCode;   // .mc (parseSparseImage ใน lc_image.h อ่านเป็น image ได้)
+};
+
+struct CacheKey {
+    uint64_t hi = 0, lo = 0;
+    uint64_t sourceSize = 0;
+    string hex() const;
+};
+
+// FNV-1a 64 บิตของ byte ทั้งไฟล์ (0 ถ้าอ่านไม่ได้)
+uint64_t hashFileBytes(const string &path);
+
+// toolVersion ต้องเปลี่ยนเมื่อผลของ parser/assembler เปลี่ยน (entry เก่าจะไม่ถูกใช้อีกและค่อย ๆ ถูก evict)
+CacheKey makeCacheKey(const string &source, bool countBlankLines, const string &commentChars,
+                      const string &toolVersion);
+
+class BuildCache {
+public:
+    static constexpr int VERSION = 2;
+
+    explicit BuildCache(const string &dir, uint64_t maxBytes = 256ull << 20);
+
+    // true = hit (เติม out และ touch entry) baseDir = โฟลเดอร์ของต้นฉบับ ใช้หา dep
+    bool lookup(const CacheKey &key, BuildArtifacts &out, const string &baseDir = ".") const;
+    // เขียน entry แล้ว evict ถ้าเกินขนาด (เขียนไม่ได้ → throw runtime_error)
+    void store(const CacheKey &key, const BuildArtifacts &art);
+    // ไล่ทั้งไดเรกทอรีแล้วลบตาม LRU คืนจำนวน entry ที่ลบ
+    size_t evict() { return files.evict(); }
+
+    const string &directory() const { return files.directory(); }
+
+private:
+    DiskCacheDir files;
+};
+
+#endif
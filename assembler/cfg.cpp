@@ -0,0 +1,303 @@
+// cfg.cpp — ดูคำอธิบายใน cfg.h
+
+#include "cfg.h"
+#include "ir_utils.h"
+
+#include <algorithm>
+
+using namespace std;
+
+ControlFlowGraph ControlFlowGraph::fromIR(const vector<IRLine> &ir) {
+    return fromImage(encodeIR(ir));
+}
+
+ControlFlowGraph ControlFlowGraph::fromImage(const vector<int32_t> &img) {
+    ControlFlowGraph g;
+    g.image = img;
+    g.code.resize(img.size());
+    for (size_t i = 0; i < img.size(); ++i) g.code[i] = decodeWord(img[i]);
+    g.build();
+    return g;
+}
+
+void ControlFlowGraph::build() {
+    const long n = (long)code.size();
+    auto inRange = [n](long a) { return a >= 0 && a < n; };
+
+    // 1) reachability จาก PC 0 พร้อม leader (scanCode ของ lc_isa.h) แล้วหา target ของ call
+    const CodeScan scan = scanCode(image);
+    const vector<uint8_t> &reach = scan.isCode, &leader = scan.leader;
+    vector<uint8_t> callTarget(n, 0);
+    for (long pc = 0; pc < n; ++pc) {
+        const DecodedInstr &d = code[pc];
+        if (!reach[pc] || d.opcode != OPC_JALR || d.regA == d.regB || d.regB == 0) continue;
+        long ptr = -1;
+        const long t = findJalrTarget(image, scan.joinPoint, pc, ptr);
+        if (t >= 0) callTarget[t] = 1;
+    }
+
+    // 2) แบ่ง block
+    blockOf.assign(n, -1);
+    blocks.clear();
+    for (long a = 0; a < n; ) {
+        if (!reach[a]) { ++a; continue; }
+        BasicBlock bb{int32_t(a), int32_t(a), EXIT_FALL};
+        long b = a;
+        while (true) {
+            blockOf[b] = (int)blocks.size();
+            const DecodedInstr &d = code[b];
+            bool term = d.opcode == OPC_BEQ || d.opcode == OPC_HALT
+                     || (d.opcode == OPC_JALR && d.regA != d.regB);
+            if (term || !inRange(b + 1) || !reach[b + 1] || leader[b + 1]) break;
+            ++b;
+        }
+        bb.last = int32_t(b);
+        const DecodedInstr &d = code[b];
+        if (d.opcode == OPC_BEQ) bb.exit = (d.regA == d.regB) ? EXIT_JUMP : EXIT_BRANCH;
+        else if (d.opcode == OPC_HALT) bb.exit = EXIT_HALT;
+        else if (d.opcode == OPC_JALR && d.regA != d.regB) bb.exit = (d.regB == 0) ? EXIT_RETURN : EXIT_CALL;
+        else bb.exit = (inRange(b + 1) && reach[b + 1]) ? EXIT_FALL : EXIT_END;
+        blocks.push_back(bb);
+        a = b + 1;
+    }
+    const int B = (int)blocks.size();
+
+    // 3) edge แบบ CSR (นับก่อนแล้วค่อยเติม)
+    succStart.assign(B + 1, 0);
+    succDst.clear();
+    succKnd.clear();
+    succDst.reserve(B * 2);
+    succKnd.reserve(B * 2);
+    auto add = [&](long addr, EdgeKind k) {
+        int dst = inRange(addr) ? blockOf[addr] : -1;
+        if (dst < 0) return;
+        succDst.push_back(dst);
+        succKnd.push_back(uint8_t(k));
+    };
+    for (int b = 0; b < B; ++b) {
+        succStart[b] = (int)succDst.size();
+        const BasicBlock &bb = blocks[b];
+        const DecodedInstr &d = code[bb.last];
+        long next = bb.last + 1;
+        switch (bb.exit) {
+            case EXIT_FALL: add(next, EDGE_FALL); break;
+            case EXIT_BRANCH: add(next + d.imm, EDGE_TAKEN); add(next, EDGE_FALL); break;
+            case EXIT_JUMP: add(next + d.imm, EDGE_JUMP); break;
+            case EXIT_CALL: {
+                long ptr = -1;
+                long t = findJalrTarget(image, scan.joinPoint, bb.last, ptr);
+                if (t >= 0) add(t, EDGE_CALL);
+                add(next, EDGE_RETURN_SITE);
+                break;
+            }
+            case EXIT_RETURN: {
+                long ptr = -1;
+                long t = findJalrTarget(image, scan.joinPoint, bb.last, ptr);
+                if (t >= 0) add(t, EDGE_JUMP);
+                break;
+            }
+            default: break;
+        }
+    }
+    succStart[B] = (int)succDst.size();
+
+    predStart.assign(B + 1, 0);
+    for (int dst : succDst) predStart[dst + 1]++;
+    for (int b = 0; b < B; ++b) predStart[b + 1] += predStart[b];
+    predSrc.assign(succDst.size(), 0);
+    predKnd.assign(succDst.size(), 0);
+    vector<int> fillPos(predStart.begin(), predStart.end() - 1);
+    for (int b = 0; b < B; ++b) {
+        for (int e = succStart[b]; e < succStart[b + 1]; ++e) {
+            int p = fillPos[succDst[e]]++;
+            predSrc[p] = b;
+            predKnd[p] = succKnd[e];
+        }
+    }
+
+    rootBlocks.clear();
+    if (B > 0) rootBlocks.push_back(0);
+    for (long a = 1; a < n; ++a)
+        if (callTarget[a] && blockOf[a] >= 0 && blocks[blockOf[a]].first == a) rootBlocks.push_back(blockOf[a]);
+
+    idoms.clear();
+    loopList.clear();
+    loopBlocks.clear();
+    blockLoop.clear();
+}
+
+// ---------------- Dominators (Cooper–Harvey–Kennedy บน reverse postorder) ----------------
+void ControlFlowGraph::computeDominators() {
+    const int B = numBlocks();
+    const int V = B;  // root เสมือน ต่อไปยังทุก root
+    vector<uint8_t> isRoot(B, 0);
+    for (int r : rootBlocks) isRoot[r] = 1;
+
+    // postorder ด้วย DFS แบบไม่ recursive
+    vector<int> rpoNum(B + 1, -1), order;
+    order.reserve(B + 1);
+    {
+        vector<int> iter(B + 1, 0);
+        vector<uint8_t> seen(B + 1, 0);
+        vector<int> stack;
+        stack.push_back(V);
+        seen[V] = 1;
+        while (!stack.empty()) {
+            int u = stack.back();
+            int next = -1;
+            if (u == V) {
+                while (iter[V] < (int)rootBlocks.size()) {
+                    int r = rootBlocks[iter[V]++];
+                    if (!seen[r]) { next = r; break; }
+                }
+            } else {
+                while (succStart[u] + iter[u] < succStart[u + 1]) {
+                    int e = succStart[u] + iter[u]++;
+                    if (!isIntraEdge(e)) continue;
+                    int v = succDst[e];
+                    if (!seen[v]) { next = v; break; }
+                }
+            }
+            if (next >= 0) { seen[next] = 1; stack.push_back(next); }
+            else { order.push_back(u); stack.pop_back(); }
+        }
+    }
+    reverse(order.begin(), order.end());   // ตอนนี้เป็น reverse postorder (V อยู่หน้าสุด)
+    for (int i = 0; i < (int)order.size(); ++i) rpoNum[order[i]] = i;
+
+    vector<int> dom(B + 1, -1);
+    dom[V] = V;
+    auto intersect = [&](int a, int b) {
+        while (a != b) {
+            while (rpoNum[a] > rpoNum[b]) a = dom[a];
+            while (rpoNum[b] > rpoNum[a]) b = dom[b];
+        }
+        return a;
+    };
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (size_t i = 1; i < order.size(); ++i) {
+            int b = order[i];
+            int nd = isRoot[b] ? V : -1;
+            for (int e = predStart[b]; e < predStart[b + 1]; ++e) {
+                if (predKnd[e] == EDGE_CALL) continue;
+                int p = predSrc[e];
+                if (dom[p] < 0) continue;
+                nd = (nd < 0) ? p : intersect(p, nd);
+            }
+            if (nd >= 0 && dom[b] != nd) { dom[b] = nd; changed = true; }
+        }
+    }
+
+    idoms.assign(B, -1);
+    for (int b = 0; b < B; ++b) idoms[b] = (dom[b] == V) ? -1 : dom[b];
+
+    // เลขลำดับ pre/post บน dominator tree
+    vector<int> childStart(B + 2, 0), child(B);
+    int nChild = 0;
+    for (int b = 0; b < B; ++b) if (dom[b] >= 0) { childStart[dom[b] + 1]++; nChild++; }
+    for (int i = 0; i <= B; ++i) childStart[i + 1] += childStart[i];
+    child.assign(nChild, 0);
+    vector<int> pos(childStart.begin(), childStart.end() - 1);
+    for (int b = 0; b < B; ++b) if (dom[b] >= 0) child[pos[dom[b]]++] = b;
+
+    domPre.assign(B + 1, -1);
+    domPost.assign(B + 1, -1);
+    int counter = 0;
+    vector<pair<int,int>> st;   // (node, child index)
+    st.push_back({V, childStart[V]});
+    domPre[V] = counter++;
+    while (!st.empty()) {
+        auto &top = st.back();
+        if (top.second < childStart[top.first + 1]) {
+            int c = child[top.second++];
+            domPre[c] = counter++;
+            st.push_back({c, childStart[c]});
+        } else {
+            domPost[top.first] = counter++;
+            st.pop_back();
+        }
+    }
+}
+
+bool ControlFlowGraph::dominates(int a, int b) const {
+    if (a == b) return true;
+    if (domPre.empty() || domPre[a] < 0 || domPre[b] < 0) return false;
+    return domPre[a] <= domPre[b] && domPost[b] <= domPost[a];
+}
+
+// ---------------- Natural loops ----------------
+void ControlFlowGraph::findLoops() {
+    const int B = numBlocks();
+    if (idoms.size() != (size_t)B) computeDominators();
+    loopList.clear();
+    loopBlocks.clear();
+    blockLoop.assign(B, -1);
+
+    // back edge u -> h (h dominate u) จัดกลุ่มตาม header
+    vector<int> headerLoop(B, -1);
+    vector<NaturalLoop> found;
+    for (int u = 0; u < B; ++u) {
+        for (int e = succStart[u]; e < succStart[u + 1]; ++e) {
+            if (!isIntraEdge(e)) continue;
+            int h = succDst[e];
+            if (!dominates(h, u)) continue;
+            if (headerLoop[h] < 0) {
+                headerLoop[h] = (int)found.size();
+                found.push_back(NaturalLoop{h, -1, 0, 0, 0, {}});
+            }
+            found[headerLoop[h]].latches.push_back(u);
+        }
+    }
+
+    // body: ย้อนจาก latch ตาม predecessor จนถึง header
+    vector<int> stamp(B, -1), body, work;
+    vector<vector<int>> bodies(found.size());
+    for (size_t i = 0; i < found.size(); ++i) {
+        NaturalLoop &L = found[i];
+        body.clear();
+        stamp[L.header] = (int)i;
+        body.push_back(L.header);
+        work.clear();
+        for (int u : L.latches) if (stamp[u] != (int)i) { stamp[u] = (int)i; body.push_back(u); work.push_back(u); }
+        while (!work.empty()) {
+            int u = work.back();
+            work.pop_back();
+            for (int e = predStart[u]; e < predStart[u + 1]; ++e) {
+                if (predKnd[e] == EDGE_CALL) continue;
+                int p = predSrc[e];
+                if (stamp[p] == (int)i) continue;
+                stamp[p] = (int)i;
+                body.push_back(p);
+                work.push_back(p);
+            }
+        }
+        bodies[i] = body;
+    }
+
+    // เรียงจาก loop ใหญ่ไปเล็ก: loop ที่มาทีหลังจะทับ blockLoop ทำให้ได้ loop ในสุด
+    vector<int> idx(found.size());
+    for (size_t i = 0; i < idx.size(); ++i) idx[i] = (int)i;
+    sort(idx.begin(), idx.end(), [&](int a, int b) {
+        if (bodies[a].size() != bodies[b].size()) return bodies[a].size() > bodies[b].size();
+        return found[a].header < found[b].header;
+    });
+    for (int k : idx) {
+        NaturalLoop L = found[k];
+        int id = (int)loopList.size();
+        L.parent = blockLoop[L.header];
+        L.depth = (L.parent >= 0) ? loopList[L.parent].depth + 1 : 1;
+        sort(bodies[k].begin(), bodies[k].end());
+        L.bodyStart = (int)loopBlocks.size();
+        L.bodyCount = (int)bodies[k].size();
+        loopBlocks.insert(loopBlocks.end(), bodies[k].begin(), bodies[k].end());
+        for (int b : bodies[k]) blockLoop[b] = id;
+        loopList.push_back(L);
+    }
+}
+
+int ControlFlowGraph::loopDepth(int b) const {
+    int l = innermostLoop(b);
+    return l >= 0 ? loopList[l].depth : 0;
+}
@@ -0,0 +1,126 @@
+// cfg.h
+// Control-flow graph ของโปรแกรม LC สร้างได้ทั้งจาก IR ของ parser และจาก image (.mc) ที่ decode แล้ว
+//
+// กติกาการแบ่ง block / edge:
+//   - beq r r X  → JUMP ไป X (กระโดดแน่นอน)
+//   - beq a b X  → TAKEN ไป X และ FALL ไปคำสั่งถัดไป
+//   - jalr a b (a != b, b != 0) → call: CALL ไป target (ถ้าหาได้จาก "lw 0 a ptr": findJalrTarget ของ lc_isa.h)
+//                                  และ RETURN_SITE ไป PC+1
+//   - jalr a 0   → return ตามแบบ programs/combination.asm (jalr 4 0) ถ้าหา target ได้จาก "lw 0 a ptr"
+//                  (กระโดดผ่าน pointer ไม่ใช่ return จริง) ได้ JUMP ไป target นั้น ถ้าหาไม่ได้ไม่มี successor ภายใน
+//   - jalr a a   → ไป PC+1 เสมอ (เหมือน simulator) ถือเป็นคำสั่งธรรมดา
+//   - halt       → exit
+// block ที่เป็นจุดเริ่ม (root) คือ PC 0 และ target ของทุก call
+//
+// ทุกอย่างเก็บแบบ array ต่อเนื่อง (CSR) ไม่มี pointer ต่อ node: สร้างและวิเคราะห์ได้ในเวลาเชิงเส้น
+// กับโปรแกรมระดับล้านคำสั่ง
+
+#ifndef CFG_H
+#define CFG_H
+
+#include "lc_isa.h"
+#include "parser.h"
+
+#include <cstdint>
+#include <vector>
+
+enum EdgeKind : uint8_t {
+    EDGE_FALL = 0,       // ไหลต่อไปคำสั่งถัดไป
+    EDGE_TAKEN = 1,      // beq ตอนเงื่อนไขเป็นจริง
+    EDGE_JUMP = 2,       // กระโดดแน่นอน (beq r r)
+    EDGE_CALL = 3,       // jalr เข้า callee (ข้าม procedure)
+    EDGE_RETURN_SITE = 4 // จาก block ที่ call ไปยังจุดที่ callee return กลับมา
+};
+
+enum BlockExit : uint8_t {
+    EXIT_FALL = 0,       // จบเพราะคำสั่งถัดไปเป็น leader
+    EXIT_BRANCH,         // beq มีเงื่อนไข
+    EXIT_JUMP,           // beq r r
+    EXIT_CALL,           // jalr a b (call)
+    EXIT_RETURN,         // jalr a 0
+    EXIT_HALT,           // halt
+    EXIT_END             // ไหลออกนอก image
+};
+
+struct BasicBlock {
+    int32_t first;       // address แรก
+    int32_t last;        // address สุดท้าย (รวม)
+    uint8_t exit;        // BlockExit
+};
+
+struct NaturalLoop {
+    int header;          // block หัว loop
+    int parent;          // loop ที่ครอบอยู่ (-1 ถ้าไม่มี)
+    int depth;           // 1 = loop นอกสุด
+    int bodyStart;       // ช่วงใน loopBlocks
+    int bodyCount;
+    std::vector<int> latches;  // block ที่มี back edge กลับมาที่ header
+};
+
+class ControlFlowGraph {
+public:
+    // จาก IR ของ parser (encode ด้วยฟิลด์ที่ resolve แล้ว)
+    static ControlFlowGraph fromIR(const std::vector<IRLine> &ir);
+    // จาก image ที่โหลดจาก .mc
+    static ControlFlowGraph fromImage(const std::vector<int32_t> &image);
+
+    // ---- โครงสร้างพื้นฐาน ----
+    int numBlocks() const { return (int)blocks.size(); }
+    const BasicBlock &block(int b) const { return blocks[b]; }
+    const DecodedInstr &instr(int addr) const { return code[addr]; }
+    int imageSize() const { return (int)code.size(); }
+    // block ที่มี address นี้ (-1 ถ้าไม่ใช่ code ที่ไปถึงได้)
+    int blockAt(int addr) const { return (addr >= 0 && addr < (int)blockOf.size()) ? blockOf[addr] : -1; }
+    const std::vector<int> &roots() const { return rootBlocks; }
+    int32_t word(int addr) const { return image[addr]; }
+
+    // successor/predecessor แบบ CSR: for (int e = succBegin(b); e < succEnd(b); ++e) succ(e), succKind(e)
+    int succBegin(int b) const { return succStart[b]; }
+    int succEnd(int b) const { return succStart[b + 1]; }
+    int succ(int e) const { return succDst[e]; }
+    EdgeKind succKind(int e) const { return EdgeKind(succKnd[e]); }
+    int predBegin(int b) const { return predStart[b]; }
+    int predEnd(int b) const { return predStart[b + 1]; }
+    int pred(int e) const { return predSrc[e]; }
+    EdgeKind predKind(int e) const { return EdgeKind(predKnd[e]); }
+    int numEdges() const { return (int)succDst.size(); }
+
+    // ---- dominator (ภายใน procedure: ไม่นับ CALL edge, root ทุกตัวต่อจาก root เสมือน) ----
+    void computeDominators();
+    // idom ของ block (-1 ถ้าเป็น root)
+    int idom(int b) const { return idoms[b]; }
+    bool dominates(int a, int b) const;
+
+    // ---- natural loop (ต้อง computeDominators ก่อน) ----
+    void findLoops();
+    const std::vector<NaturalLoop> &loops() const { return loopList; }
+    // block ใน loop i
+    const int *loopBody(int i) const { return loopBlocks.data() + loopList[i].bodyStart; }
+    // loop ในสุดที่ block อยู่ (-1 ถ้าไม่อยู่ใน loop)
+    int innermostLoop(int b) const { return blockLoop.empty() ? -1 : blockLoop[b]; }
+    int loopDepth(int b) const;
+
+private:
+    std::vector<int32_t> image;
+    std::vector<DecodedInstr> code;
+    std::vector<BasicBlock> blocks;
+    std::vector<int> blockOf;
+    std::vector<int> rootBlocks;
+
+    std::vector<int> succStart, succDst;
+    std::vector<uint8_t> succKnd;
+    std::vector<int> predStart, predSrc;
+    std::vector<uint8_t> predKnd;
+
+    std::vector<int> idoms;
+    std::vector<int> domPre, domPost;   // ลำดับ DFS บน dominator tree ใช้ตอบ dominates() ใน O(1)
+
+    std::vector<NaturalLoop> loopList;
+    std::vector<int> loopBlocks;
+    std::vector<int> blockLoop;
+
+    void build();
+    bool isIntraEdge(int e) const { return succKnd[e] != EDGE_CALL; }
+};
+
+#endif
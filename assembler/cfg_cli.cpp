@@ -0,0 +1,87 @@
+// cfg_cli.cpp
+// พิมพ์ control-flow graph (cfg.h) ของโปรแกรม: basic block, edge, idom และ natural loop
+// รับได้ทั้ง .asm (ผ่าน Parser) และ .mc (image ที่ assemble แล้ว)
+//
+// Compile : g++ -std=c++17 -O2 -DPARSER_NO_MAIN cfg_cli.cpp cfg.cpp parser.cpp ir_utils.cpp -o cfg
+// Run : .\cfg ..\programs\combination.asm   หรือ   .\cfg --summary machineCode.mc
+
+#include "cfg.h"
+#include "ir_utils.h"
+#include "lc_image.h"
+#include "parser.h"
+
+#include <chrono>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+static const char *EDGE_NAMES[] = {"fall", "taken", "jump", "call", "return-site"};
+static const char *EXIT_NAMES[] = {"fall", "branch", "jump", "call", "return", "halt", "end"};
+
+static bool endsWith(const string &s, const string &suffix) {
+    return s.size() >= suffix.size() && s.compare(s.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+int main(int argc, char **argv) {
+    bool summary = false;
+    string input;
+    for (int i = 1; i < argc; ++i) {
+        string a = argv[i];
+        if (a == "--summary") summary = true;
+        else input = a;
+    }
+    if (input.empty()) {
+        cerr << "usage: " << argv[0] << " [--summary] <input.asm | input.mc>\n";
+        return 1;
+    }
+
+    try {
+        vector<int32_t> image;
+        if (endsWith(input, ".mc")) {
+            image = loadMachineCode(input);
+        } else {
+            Parser prog;
+            prog.parseFile(input);
+            image = encodeIR(prog.getIR());
+        }
+
+        auto t0 = chrono::steady_clock::now();
+        ControlFlowGraph g = ControlFlowGraph::fromImage(image);
+        auto t1 = chrono::steady_clock::now();
+        g.computeDominators();
+        auto t2 = chrono::steady_clock::now();
+        g.findLoops();
+        auto t3 = chrono::steady_clock::now();
+        auto ms = [](chrono::steady_clock::duration d) {
+            return chrono::duration<double, milli>(d).count();
+        };
+
+        if (!summary) {
+            for (int b = 0; b < g.numBlocks(); ++b) {
+                const BasicBlock &bb = g.block(b);
+                cout << "B" << b << " [" << bb.first << ".." << bb.last << "] exit=" << EXIT_NAMES[bb.exit]
+                     << " idom=" << g.idom(b) << " loop-depth=" << g.loopDepth(b) << "\n";
+                for (int e = g.succBegin(b); e < g.succEnd(b); ++e)
+                    cout << "    -> B" << g.succ(e) << " (" << EDGE_NAMES[g.succKind(e)] << ")\n";
+            }
+            for (size_t i = 0; i < g.loops().size(); ++i) {
+                const NaturalLoop &L = g.loops()[i];
+                cout << "loop " << i << ": header B" << L.header << " depth " << L.depth
+                     << " parent " << L.parent << " blocks {";
+                for (int k = 0; k < L.bodyCount; ++k) cout << (k ? " B" : "B") << g.loopBody((int)i)[k];
+                cout << "}\n";
+            }
+        }
+        cout << "words: " << g.imageSize() << ", blocks: " << g.numBlocks() << ", edges: " << g.numEdges()
+             << ", roots: " << g.roots().size() << ", loops: " << g.loops().size() << "\n";
+        cout << "time: build " << ms(t1 - t0) << " ms, dominators " << ms(t2 - t1)
+             << " ms, loops " << ms(t3 - t2) << " ms\n";
+    } catch (const exception &e) {
+        cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,127 @@
+// constpool.cpp — ดูเงื่อนไขใน constpool.h
+
+#include "constpool.h"
+#include "ir_utils.h"
+#include "lc_isa.h"
+
+#include <algorithm>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+
+// execMask[i] = 1 ถ้าบรรทัด i อาจถูก execute ด้วยการ fall through จากบรรทัดก่อนหน้า
+// halt และ beq r r ไม่ fall through; jalr ถือว่า fall through (เป็นจุด return ของ callee)
+static vector<char> fallThroughMask(const vector<IRLine> &ir) {
+    vector<char> mask(ir.size(), 0);
+    bool falls = true;  // บรรทัดแรกคือจุดเริ่มโปรแกรม
+    for (size_t i = 0; i < ir.size(); ++i) {
+        mask[i] = falls;
+        int op = irOpcode(ir[i]);
+        if (op < 0) continue;  // .fill ที่ถูก execute ได้ก็ยังไหลต่อ ส่วนที่ไม่ได้ก็ไม่ไหล
+        if (op == OPC_HALT) falls = false;
+        else if (op == OPC_BEQ && ir[i].regA == ir[i].regB) falls = false;
+        else falls = true;
+    }
+    return mask;
+}
+
+ConstPoolStats runConstPool(Parser &prog, bool placeNearUsers) {
+    ConstPoolStats st;
+    vector<IRLine> ir = prog.getIR();
+    symbolizeIR(ir);
+
+    // 1) การใช้งานของแต่ละ label: ต้องเป็น lw ฐาน r0 เท่านั้น
+    unordered_map<string,int> lwUses;
+    unordered_map<string,bool> otherUse;
+    unordered_map<string,size_t> firstUser;
+    for (size_t i = 0; i < ir.size(); ++i) {
+        const string *ref = irLabelRef(ir[i]);
+        if (!ref) continue;
+        if (irOpcode(ir[i]) == OPC_LW && ir[i].regA == 0) {
+            lwUses[*ref]++;
+            if (!firstUser.count(*ref)) firstUser[*ref] = i;
+        } else {
+            otherUse[*ref] = true;
+        }
+    }
+
+    // 2) หา candidate แล้วจัดกลุ่มตามค่า (ช่องแรกของแต่ละค่าเป็นตัวแทน)
+    vector<char> execMask = fallThroughMask(ir);
+    vector<char> kill(ir.size(), 0);
+    vector<char> inPool(ir.size(), 0);
+    map<int,string> canonical;                 // ค่า → label ตัวแทน
+    unordered_map<string,string> rename;       // label ที่ถูกรวม → label ตัวแทน
+    for (size_t i = 0; i < ir.size(); ++i) {
+        const IRLine &L = ir[i];
+        if (L.instr != ".fill" || L.rawLabel.empty() || !isNumber(L.f0)) continue;
+        if (execMask[i] || otherUse.count(L.rawLabel) || !lwUses.count(L.rawLabel)) continue;
+        st.candidates++;
+        auto it = canonical.find(L.fillValue);
+        if (it == canonical.end()) {
+            canonical[L.fillValue] = L.rawLabel;
+            inPool[i] = 1;
+        } else {
+            rename[L.rawLabel] = it->second;
+            kill[i] = 1;
+            st.merged++;
+            // ผู้ใช้ของช่องที่ถูกรวมอาจมาก่อนผู้ใช้ของตัวแทน
+            if (firstUser[L.rawLabel] < firstUser[it->second]) firstUser[it->second] = firstUser[L.rawLabel];
+        }
+    }
+    st.pooled = (int)canonical.size();
+
+    for (auto &L : ir) {
+        string *ref = irLabelRef(L);
+        if (!ref) continue;
+        auto it = rename.find(*ref);
+        if (it != rename.end()) *ref = it->second;
+    }
+
+    // 3) (ทางเลือก) ย้าย pool ไปไว้เป็นกลุ่มเดียวหลัง code ที่ใช้มัน
+    if (placeNearUsers && st.pooled > 0) {
+        size_t lastUser = 0;
+        vector<pair<size_t,size_t>> order;     // (ผู้ใช้ครั้งแรก, index ของช่อง)
+        for (size_t i = 0; i < ir.size(); ++i) {
+            if (!inPool[i]) continue;
+            order.push_back({firstUser[ir[i].rawLabel], i});
+        }
+        for (size_t i = 0; i < ir.size(); ++i) {
+            const string *ref = irLabelRef(ir[i]);
+            if (ref && irOpcode(ir[i]) == OPC_LW && ir[i].regA == 0) {
+                for (const auto &kv : canonical)
+                    if (kv.second == *ref) { lastUser = i; break; }
+            }
+        }
+        // จุดวาง: บรรทัดแรกหลังผู้ใช้คนสุดท้ายที่ไม่มีทาง fall through เข้ามา
+        size_t at = ir.size();
+        for (size_t i = lastUser + 1; i < ir.size(); ++i) {
+            if (!execMask[i]) { at = i; break; }
+        }
+        sort(order.begin(), order.end());
+
+        vector<IRLine> out;
+        out.reserve(ir.size());
+        auto emitPool = [&]() {
+            for (const auto &p : order) out.push_back(ir[p.second]);
+        };
+        for (size_t i = 0; i < ir.size(); ++i) {
+            if (i == at) emitPool();
+            if (kill[i] || inPool[i]) continue;
+            out.push_back(ir[i]);
+        }
+        if (at == ir.size()) emitPool();
+        ir.swap(out);
+        st.placed = true;
+    } else {
+        // label ของช่องที่ถูกรวมไม่มีใครอ้างแล้ว ไม่ต้องย้ายไปบรรทัดถัดไป
+        for (size_t i = 0; i < ir.size(); ++i)
+            if (kill[i]) ir[i].rawLabel.clear();
+        eraseIRLines(ir, kill);
+    }
+
+    prog.replaceIR(ir);
+    return st;
+}
@@ -0,0 +1,24 @@
+// constpool.h
+// รวม .fill ที่เป็นค่าคงที่ซ้ำกันให้เหลือช่องเดียว (constant pool)
+// .fill ที่จะเข้า pool ได้ต้อง:
+//   - มี label และค่าเป็นตัวเลข
+//   - ถูกอ้างถึงด้วย "lw 0 X label" เท่านั้น (ไม่มี sw, beq, .fill label หรือ lw ที่ฐานไม่ใช่ r0)
+//   - ไม่มีทางถูก execute (คำสั่งก่อนหน้าไม่ fall through เข้ามา)
+// ค่าที่ซ้ำกันจะใช้ label ของช่องแรก แล้วลบช่องที่เหลือ
+// ถ้าเปิด placeNearUsers จะย้ายช่องใน pool ทั้งหมดไปต่อท้าย code ส่วนที่ใช้มันเป็นกลุ่มเดียว (เรียงตามลำดับที่ใช้ครั้งแรก)
+
+#ifndef CONSTPOOL_H
+#define CONSTPOOL_H
+
+#include "parser.h"
+
+struct ConstPoolStats {
+    int candidates = 0;   // .fill ที่เข้า pool ได้
+    int merged = 0;       // ช่องที่ถูกรวมเข้ากับค่าที่ซ้ำแล้วลบทิ้ง
+    int pooled = 0;       // ค่าไม่ซ้ำที่เหลือใน pool
+    bool placed = false;  // ย้าย pool ไปไว้ใกล้ผู้ใช้แล้วหรือไม่
+};
+
+ConstPoolStats runConstPool(Parser &prog, bool placeNearUsers);
+
+#endif
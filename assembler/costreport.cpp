@@ -0,0 +1,182 @@
+// costreport.cpp
+// รายงานต้นทุนแบบ static ก่อนรันจริง (staticcost.h): listing ที่บอก cycle/จำนวนครั้ง/ต้นทุนรวมของทุกบรรทัด
+// ต้นทุนของแต่ละ block และแต่ละ loop พร้อม trip count แบบ symbolic
+// ใช้ --max-cost เพื่อปัดตกโปรแกรมที่แพงเกินไป (หรือหาขอบเขตไม่ได้) ก่อนเสียเวลารัน simulator
+//
+// Compile : g++ -std=c++17 -O2 -DPARSER_NO_MAIN costreport.cpp staticcost.cpp cfg.cpp parser.cpp ir_utils.cpp -o costreport
+// Run : .\costreport ..\programs\multiply.asm   หรือ   .\costreport --max-cost 100000 --cost lw=3,sw=3 machineCode.mc
+//
+// exit code: 0 = ผ่าน, 1 = error, 2 = ต้นทุนเกิน --max-cost หรือหาขอบเขตไม่ได้
+
+#include "staticcost.h"
+#include "ir_utils.h"
+#include "lc_image.h"
+#include "parser.h"
+
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+static bool endsWith(const string &s, const string &suffix) {
+    return s.size() >= suffix.size() && s.compare(s.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+static string countText(long long v) {
+    return v < 0 ? "?" : to_string(v);
+}
+
+// ข้อความของคำสั่งจาก word ที่ decode แล้ว (ใช้ตอนอ่าน .mc)
+static string decodedText(int32_t w) {
+    if (!isCanonicalWord(w)) return ".fill " + to_string(w);
+    DecodedInstr d = decodeWord(w);
+    ostringstream os;
+    os << LC_MNEMONIC[d.opcode];
+    switch (d.opcode) {
+        case OPC_ADD: case OPC_NAND: os << " " << int(d.regA) << " " << int(d.regB) << " " << int(d.dest); break;
+        case OPC_LW: case OPC_SW: case OPC_BEQ: os << " " << int(d.regA) << " " << int(d.regB) << " " << d.imm; break;
+        case OPC_JALR: os << " " << int(d.regA) << " " << int(d.regB); break;
+        default: break;
+    }
+    return os.str();
+}
+
+int main(int argc, char **argv) {
+    CostModel model;
+    long long maxCost = -1;
+    string input;
+    try {
+        for (int i = 1; i < argc; ++i) {
+            string a = argv[i];
+            if (a == "--cost" && i + 1 < argc) model.parse(argv[++i]);
+            else if (a == "--max-cost" && i + 1 < argc) maxCost = stoll(argv[++i]);
+            else if (!a.empty() && a[0] == '-') input.clear(), i = argc;
+            else input = a;
+        }
+    } catch (const exception &e) {
+        cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+    if (input.empty()) {
+        cerr << "usage: " << argv[0] << " [--cost op=cycles,...] [--max-cost N] <input.asm | input.mc>\n";
+        return 1;
+    }
+
+    try {
+        vector<int32_t> image;
+        vector<string> source, labelAt;
+        vector<int> span;   // จำนวน word ของบรรทัดที่เริ่มที่ address นั้น (.space = N)
+        vector<MulcExpansion> mulcs;
+        if (endsWith(input, ".mc")) {
+            image = loadMachineCode(input);
+            for (int32_t w : image) source.push_back(decodedText(w));
+            labelAt.assign(image.size(), "");
+            span.assign(image.size(), 1);
+        } else {
+            Parser prog;
+            prog.parseFile(input);
+            const vector<IRLine> &ir = prog.getIR();
+            image = encodeIR(ir);
+            mulcs = prog.getMulcExpansions();
+            for (const auto &L : ir) {
+                string s = L.rawLabel.empty() ? "" : L.rawLabel + " ";
+                s += L.instr;
+                for (const string *f : {&L.f0, &L.f1, &L.f2})
+                    if (!f->empty()) s += " " + *f;
+                source.push_back(s);
+                labelAt.push_back(L.rawLabel);
+                span.push_back(L.words);
+                source.resize(source.size() + L.words - 1);
+                labelAt.resize(labelAt.size() + L.words - 1);
+                span.resize(span.size() + L.words - 1, 1);
+            }
+        }
+
+        ControlFlowGraph g = ControlFlowGraph::fromImage(image);
+        StaticCostReport rep = analyzeStaticCost(g, model, labelAt);
+
+        // 1) listing: address, cycle ต่อครั้ง, จำนวนครั้ง, cycle รวม
+        cout << right << setw(6) << "addr" << setw(7) << "cyc" << setw(14) << "count" << setw(16) << "total"
+             << "  | source\n";
+        for (int a = 0; a < (int)image.size(); ++a) {
+            int b = g.blockAt(a);
+            cout << setw(6) << a;
+            if (b < 0) {
+                cout << setw(7) << "-" << setw(14) << "-" << setw(16) << "-";
+            } else {
+                int cyc = model.of(g.instr(a).opcode);
+                long long cnt = rep.blockCount[b];
+                cout << setw(7) << cyc << setw(14) << countText(cnt)
+                     << setw(16) << countText(cnt < 0 ? -1 : cnt * cyc);
+            }
+            cout << "  | " << (g.blockAt(a) >= 0 && a == g.block(b).first ? "B" + to_string(b) + ": " : "")
+                 << source[a] << "\n";
+            if (b < 0) a += span[a] - 1;   // .space แสดงบรรทัดเดียว
+        }
+
+        // 2) block
+        cout << "\nblocks:\n";
+        for (int b = 0; b < g.numBlocks(); ++b) {
+            const BasicBlock &bb = g.block(b);
+            cout << "  B" << b << " [" << bb.first << ".." << bb.last << "] " << rep.blockInstrs[b]
+                 << " instr, " << rep.blockCycles[b] << " cycle(s) x " << countText(rep.blockCount[b]);
+            if (g.innermostLoop(b) >= 0) cout << "  (loop " << g.innermostLoop(b) << ")";
+            cout << "\n";
+        }
+
+        // 3) loop
+        if (!rep.loops.empty()) cout << "\nloops:\n";
+        for (size_t m = 0; m < rep.loops.size(); ++m) {
+            const NaturalLoop &L = g.loops()[m];
+            const LoopCost &lc = rep.loops[m];
+            cout << "  loop " << m << ": header B" << L.header << " depth " << L.depth;
+            if (L.parent >= 0) cout << " (inside loop " << L.parent << ")";
+            cout << ", " << lc.cyclesPerIter << " cycle(s)/iteration\n";
+            if (lc.analyzed) {
+                cout << "    counter r" << lc.counter << " += r" << lc.stepReg << " (" << lc.step << ")"
+                     << ", exit when r" << lc.counter << " == r" << lc.boundReg << " (" << lc.bound.c << ")"
+                     << ", start " << lc.init.text;
+                if (lc.init.kind == SymVal::CONST) cout << " = " << lc.init.c;
+                else cout << " (counter of loop " << lc.init.loop << ", k = its iteration)";
+                cout << "\n    tests per entry = " << lc.tripText << "\n";
+            } else {
+                cout << "    not a counted loop: " << lc.why << "\n";
+            }
+            cout << "    entered " << countText(lc.entries) << " time(s), header runs " << countText(lc.headerRuns)
+                 << ", total " << countText(lc.instrs) << " instr / " << countText(lc.cycles) << " cycle(s)\n";
+        }
+
+        // 4) mulc ที่ถูกขยาย: ความยาวคงที่ เทียบกับ binary shift-and-add
+        if (!mulcs.empty()) cout << "\nmulc expansions:\n";
+        for (const auto &m : mulcs) {
+            int cyc = 0;
+            for (int a = m.address; a < m.address + m.cost; ++a) cyc += model.of(decodeWord(image[a]).opcode);
+            cout << "  line " << m.sourceLine << " @" << m.address << ": r" << m.dest << " = r" << m.src
+                 << " * " << m.k << " -> " << m.cost << " instr / " << cyc << " cycle(s), " << m.method
+                 << " (binary " << m.binaryCost << ")\n";
+        }
+
+        cout << "\nestimated dynamic instructions: " << countText(rep.totalInstrs) << "\n";
+        cout << "estimated cycles: " << countText(rep.totalCycles) << "\n";
+
+        if (maxCost >= 0) {
+            if (rep.totalCycles < 0) {
+                cout << "REJECT: cost cannot be bounded statically\n";
+                return 2;
+            }
+            if (rep.totalCycles > maxCost) {
+                cout << "REJECT: estimated " << rep.totalCycles << " cycle(s) > --max-cost " << maxCost << "\n";
+                return 2;
+            }
+            cout << "OK: within --max-cost " << maxCost << "\n";
+        }
+    } catch (const exception &e) {
+        cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,83 @@
+// dce.cpp — ดูเงื่อนไขใน dce.h
+
+#include "dce.h"
+#include "cfg.h"
+#include "ir_utils.h"
+#include "lc_isa.h"
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+
+DceStats runDeadCodeElim(Parser &prog) {
+    DceStats st;
+    vector<IRLine> ir = prog.getIR();
+    if (ir.empty()) return st;
+
+    // 1) code ที่ไปถึงได้จาก CFG (บรรทัด code = หนึ่ง word ที่ ir[i].address) แล้วค่อยแปลงตัวเลขเป็น label จาก code ส่วนนั้น
+    ControlFlowGraph g = ControlFlowGraph::fromIR(ir);
+    const size_t n = ir.size();
+    vector<char> reached(n, 0);
+    for (size_t i = 0; i < n; ++i) reached[i] = g.blockAt(ir[i].address) >= 0;
+    symbolizeIR(ir, &reached);
+    for (int b = 0; b < g.numBlocks(); ++b) {
+        if (g.block(b).exit != EXIT_CALL) continue;
+        bool known = false;
+        for (int e = g.succBegin(b); e < g.succEnd(b); ++e)
+            if (g.succKind(e) == EDGE_CALL) known = true;
+        if (!known) { st.skipped = true; return st; }
+    }
+
+    unordered_map<string,size_t> labelRow;
+    for (size_t i = 0; i < n; ++i)
+        if (!ir[i].rawLabel.empty()) labelRow[ir[i].rawLabel] = i;
+
+    // 2) ไล่การอ้าง label จากบรรทัดที่มีชีวิต (code ที่ไปถึง + data ที่ถูกอ้าง) แบบ worklist
+    vector<char> live(n, 0), marked(n, 0), extended(n, 0);
+    vector<size_t> work;
+    auto makeLive = [&](size_t i) {
+        if (!live[i]) { live[i] = 1; work.push_back(i); }
+    };
+    auto markObject = [&](size_t row, bool wholeRun) {
+        if (wholeRun ? extended[row] : marked[row]) return;
+        marked[row] = 1;
+        if (wholeRun) extended[row] = 1;
+        makeLive(row);
+        for (size_t j = row + 1; j < n && !reached[j]; ++j) {
+            if (!wholeRun && !ir[j].rawLabel.empty()) break;
+            makeLive(j);
+        }
+        // address ที่ถูกคำนวณอาจเดินถอยหลังจาก label ได้ด้วย (stack ที่โตลง: "stack .fill stktop")
+        if (wholeRun)
+            for (size_t j = row; j-- > 0 && !reached[j]; ) makeLive(j);
+    };
+    for (size_t i = 0; i < n; ++i)
+        if (reached[i]) makeLive(i);
+    while (!work.empty()) {
+        size_t i = work.back();
+        work.pop_back();
+        const string *ref = irLabelRef(ir[i]);
+        if (!ref) continue;
+        auto it = labelRow.find(*ref);
+        if (it == labelRow.end() || reached[it->second]) continue;
+        int op = irOpcode(ir[i]);
+        bool addressTaken = (op < 0) || ((op == OPC_LW || op == OPC_SW) && ir[i].regA != 0);
+        markObject(it->second, addressTaken);
+    }
+
+    // 3) ลบส่วนที่เหลือ label ของบรรทัดที่ถูกลบไม่มีบรรทัดที่มีชีวิตอ้างถึงแล้ว จึงทิ้งได้เลย
+    vector<char> kill(n, 0);
+    for (size_t i = 0; i < n; ++i) {
+        if (live[i]) continue;
+        kill[i] = 1;
+        if (irOpcode(ir[i]) >= 0) st.deadCode++;
+        else st.deadData++;
+        ir[i].rawLabel.clear();
+    }
+    if (st.deadCode + st.deadData == 0) return st;
+    eraseIRLines(ir, kill);
+    prog.replaceIR(ir);
+    return st;
+}
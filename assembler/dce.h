@@ -0,0 +1,26 @@
+// dce.h
+// ลบ code ที่ไม่มีทางถูก execute และ data ที่ไม่มีใครอ้างถึง (dead-code / unreachable-block elimination)
+//   - code: บรรทัดที่ไปไม่ถึงจาก PC 0 ตาม CFG (cfg.h) เช่นหลัง "beq 0 0 X" หรือหลัง halt
+//   - data: "object" = บรรทัดที่มี label + บรรทัดไม่มี label ที่ต่อท้ายและไม่ถูก execute
+//           object ที่ไม่มี label ของมันถูกอ้างจากบรรทัดที่ยังมีชีวิตอยู่ (beq/lw/sw/.fill) จะถูกลบทั้ง object
+//           ถ้า object ถูกใช้เป็น address (.fill label หรือ lw/sw ที่ฐานไม่ใช่ r0) อาจมีการ index เลย object
+//           ไปได้ทั้งสองทาง (เช่น stack ที่โตลงจาก "stktop") จึงเก็บ data ที่ติดกันทั้งก่อนและหลัง label
+//           จนถึง code ที่อยู่ติดกันทั้งสองฝั่ง
+// ก่อนลบจะแปลงการอ้าง address แบบตัวเลขใน image เป็น label (symbolizeIR) แล้วให้ Parser::replaceIR จัด
+// address ใหม่ ดังนั้น address ที่คำนวณตอน runtime ต้องมาจาก label เท่านั้น
+// ถ้ามี call (jalr) ที่หา target ไม่ได้ จะไม่ลบอะไรเลยเพราะไม่รู้ว่า code ส่วนไหนถูกเรียก
+
+#ifndef DCE_H
+#define DCE_H
+
+#include "parser.h"
+
+struct DceStats {
+    int deadCode = 0;        // คำสั่งที่ไปไม่ถึงแล้วถูกลบ
+    int deadData = 0;        // .fill ที่ไม่มีใครอ้างแล้วถูกลบ
+    bool skipped = false;    // ไม่ได้ลบเพราะมี call ที่หา target ไม่ได้
+};
+
+DceStats runDeadCodeElim(Parser &prog);
+
+#endif
@@ -0,0 +1,192 @@
+// disassembler.cpp
+// แปลงไฟล์ machine code (.mc) กลับเป็น assembly ที่ parser + assembler ประกอบกลับได้ค่าเดิมทุกบิต
+//
+// วิธีคิดโดยรวม:
+//   1) โหลด word ทั้งหมด (lc_image.h) แล้วถอดด้วยตาราง DECODE_TABLE (lc_isa.h)
+//   2) แยก code/data ด้วย reachability จาก PC 0 (scanCode ของ lc_isa.h ตัวเดียวกับ cfg):
+//        - beq  → ไปได้ทั้ง target และ PC+1 (ถ้า regA == regB ไปแค่ target)
+//        - jalr → target ที่หาได้จากรูปแบบ "lw 0 R k ... jalr R x" และ PC+1 (จุด return) ถ้าไม่ใช่ jalr R 0
+//        - halt → หยุด
+//   3) ตั้ง label ให้ target ของ beq และ address ที่ lw/sw ฐาน 0 อ้างถึง (ชื่อ L<addr>)
+//   4) word ที่ไม่ถูกเรียกถึง หรือ pack กลับแล้วไม่ได้ค่าเดิม (มีบิตขยะ) → พิมพ์เป็น .fill
+//      ยกเว้น data ที่มาจาก record "*N value" ในไฟล์ .mc → พิมพ์กลับเป็น .space (ตัดช่วงตรงที่มี label)
+//
+// Compile : g++ -std=c++17 -O2 disassembler.cpp -o disassembler
+// Run : .\disassembler machineCode.mc [disassembled.asm]
+
+#include "lc_isa.h"
+#include "lc_image.h"
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// label ต้องยาวไม่เกิน 6 ตัวอักษร (กติกา validLabelName ของ parser) → "L" + เลขไม่เกิน 5 หลัก
+static const long MAX_LABEL_ADDR = 99999;
+
+// ผลการวิเคราะห์ image: word ไหนเป็น code, address ไหนต้องมี label
+struct Classification {
+    vector<uint8_t> isCode;     // 1 = ถูกเรียกถึงจาก PC 0
+    vector<uint8_t> needLabel;  // 1 = มีคำสั่งอ้างถึง address นี้
+    vector<uint8_t> codePtr;    // 1 = .fill นี้เก็บ address ของ code ที่ jalr กระโดดไป
+    size_t codeWords = 0;
+};
+
+static Classification classify(const vector<int32_t> &words) {
+    const long n = (long)words.size();
+    Classification c;
+    c.needLabel.assign(n, 0);
+    c.codePtr.assign(n, 0);
+
+    const CodeScan scan = scanCode(words);
+    c.isCode = scan.isCode;
+    for (long pc = 0; pc < n; ++pc) {
+        if (!c.isCode[pc]) continue;
+        c.codeWords++;
+        DecodedInstr d = decodeWord(words[pc]);
+        if (d.opcode != OPC_JALR || d.regA == d.regB) continue;
+        long ptr = -1;
+        long target = findJalrTarget(words, scan.joinPoint, pc, ptr);
+        if (target >= 0) {
+            c.codePtr[ptr] = 1;
+            c.needLabel[target] = 1;
+        }
+    }
+
+    // ตั้ง label ให้ address ที่คำสั่งใน code อ้างถึง
+    for (long pc = 0; pc < n; ++pc) {
+        if (!c.isCode[pc] || !isCanonicalWord(words[pc])) continue;
+        DecodedInstr d = decodeWord(words[pc]);
+        if (d.opcode == OPC_BEQ) {
+            long target = pc + 1 + d.imm;
+            if (target >= 0 && target < n) c.needLabel[target] = 1;
+        } else if ((d.opcode == OPC_LW || d.opcode == OPC_SW) && d.regA == 0) {
+            if (d.imm >= 0 && d.imm < n) c.needLabel[d.imm] = 1;
+        }
+    }
+    for (long a = MAX_LABEL_ADDR + 1; a < n; ++a) c.needLabel[a] = 0;
+    return c;
+}
+
+// ---------- เขียนผลลัพธ์ลง buffer (หลีกเลี่ยง iostream ต่อ token เพื่อความเร็ว) ----------
+static inline void putInt(string &out, long v) {
+    char tmp[24];
+    auto res = to_chars(tmp, tmp + sizeof(tmp), v);
+    out.append(tmp, res.ptr);
+}
+static inline void putLabel(string &out, long addr) {
+    out.push_back('L');
+    putInt(out, addr);
+}
+static inline void padTo(string &out, size_t lineStart, size_t col) {
+    size_t len = out.size() - lineStart;
+    out.append(len < col ? col - len : 1, ' ');
+}
+
+static string renderAsm(const vector<int32_t> &words, const Classification &c, const string &srcName,
+                        const SparseImage &img) {
+    const long n = (long)words.size();
+    // runEnd[a] = address ถัดจากท้าย run ที่ a อยู่ (-1 = ไม่ได้อยู่ใน run)
+    vector<long> runEnd(n, -1);
+    for (const auto &s : img.segments)
+        if (s.run) fill(runEnd.begin() + s.start, runEnd.begin() + s.start + s.count, long(s.start) + s.count);
+    string out;
+    out.reserve(words.size() * 32 + 128);
+    out += "; disassembled from " + srcName + ": " + to_string(n) + " word(s), "
+         + to_string(c.codeWords) + " reachable\n";
+
+    auto hasLabel = [&](long a) { return a >= 0 && a < n && c.needLabel[a]; };
+
+    for (long pc = 0; pc < n; ++pc) {
+        size_t lineStart = out.size();
+        if (c.needLabel[pc]) putLabel(out, pc);
+        padTo(out, lineStart, 8);
+
+        int32_t w = words[pc];
+        if (!c.isCode[pc] && !c.codePtr[pc] && runEnd[pc] > pc + 1) {
+            long k = pc + 1;
+            while (k < runEnd[pc] && !c.isCode[k] && !c.needLabel[k] && !c.codePtr[k]) ++k;
+            if (k - pc >= 2) {
+                out += ".space ";
+                putInt(out, k - pc);
+                out.push_back(' ');
+                putInt(out, w);
+                out.push_back('\n');
+                pc = k - 1;
+                continue;
+            }
+        }
+        if (!c.isCode[pc] || !isCanonicalWord(w)) {
+            out += ".fill ";
+            if (c.codePtr[pc] && hasLabel(w)) putLabel(out, w);
+            else putInt(out, w);
+            if (c.isCode[pc]) out += "\t; executed, non-canonical encoding";
+            out.push_back('\n');
+            continue;
+        }
+
+        DecodedInstr d = decodeWord(w);
+        out += LC_MNEMONIC[d.opcode];
+        if (d.opcode == OPC_HALT || d.opcode == OPC_NOOP) { out.push_back('\n'); continue; }
+        padTo(out, lineStart, 13);
+        putInt(out, d.regA);
+        padTo(out, lineStart, 17);
+        putInt(out, d.regB);
+        if (d.opcode == OPC_JALR) { out.push_back('\n'); continue; }
+        padTo(out, lineStart, 21);
+        if (d.opcode == OPC_ADD || d.opcode == OPC_NAND) {
+            putInt(out, d.dest);
+        } else if (d.opcode == OPC_BEQ) {
+            long target = pc + 1 + d.imm;
+            if (hasLabel(target)) putLabel(out, target);
+            else putInt(out, d.imm);
+        } else {  // lw / sw
+            if (d.regA == 0 && hasLabel(d.imm)) putLabel(out, d.imm);
+            else putInt(out, d.imm);
+        }
+        out.push_back('\n');
+    }
+    return out;
+}
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        cerr << "usage: " << argv[0] << " <machine-code.mc> [output.asm]\n";
+        return 1;
+    }
+    string inPath = argv[1];
+    string outPath = (argc >= 3 ? argv[2] : "disassembled.asm");
+
+    try {
+        auto t0 = chrono::steady_clock::now();
+        SparseImage img = loadSparseImage(inPath);
+        vector<int32_t> words = img.expand();
+        Classification c = classify(words);
+        string text = renderAsm(words, c, inPath, img);
+
+        ofstream ofs(outPath, ios::binary);
+        if (!ofs.is_open()) throw runtime_error("cannot write output file: " + outPath);
+        ofs.write(text.data(), (streamsize)text.size());
+        if (!ofs) throw runtime_error("write failed: " + outPath);
+        auto t1 = chrono::steady_clock::now();
+
+        size_t labels = 0;
+        for (uint8_t b : c.needLabel) labels += b;
+        cerr << "Disassembled " << words.size() << " word(s): " << c.codeWords << " code, "
+             << (words.size() - c.codeWords) << " data, " << labels << " label(s) in "
+             << chrono::duration<double, milli>(t1 - t0).count() << " ms\n";
+        cout << "Output written to: " << outPath << "\n";
+    } catch (const exception &e) {
+        cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
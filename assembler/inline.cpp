@@ -0,0 +1,361 @@
+// inline.cpp — ดูเงื่อนไขใน inline.h
+
+#include "inline.h"
+#include "cfg.h"
+#include "ir_utils.h"
+#include "lc_isa.h"
+
+#include <map>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+using namespace std;
+
+static const unsigned ALL_REGS = 0xFE;   // r1..r7 (r0 เป็น 0 เสมอ ไม่ต้องติดตาม)
+
+static unsigned useMask(const IRLine &L) {
+    switch (irOpcode(L)) {
+        case OPC_ADD: case OPC_NAND: case OPC_SW: case OPC_BEQ: return ((1u << L.regA) | (1u << L.regB)) & ALL_REGS;
+        case OPC_LW: case OPC_JALR: return (1u << L.regA) & ALL_REGS;
+        default: return 0;
+    }
+}
+
+static unsigned defMask(const IRLine &L) {
+    switch (irOpcode(L)) {
+        case OPC_ADD: case OPC_NAND: return (1u << L.dest) & ALL_REGS;
+        case OPC_LW: case OPC_JALR: return (1u << L.regB) & ALL_REGS;
+        default: return 0;
+    }
+}
+
+static unordered_map<string, size_t> labelRows(const vector<IRLine> &ir) {
+    unordered_map<string, size_t> rows;
+    for (size_t i = 0; i < ir.size(); ++i)
+        if (!ir[i].rawLabel.empty()) rows[ir[i].rawLabel] = i;
+    return rows;
+}
+
+// liveness ของ register ทั้งโปรแกรม (backward fixpoint บนบรรทัด IR) คืน live-in ของแต่ละบรรทัด
+//   call (jalr a b, b != 0, a != b): callee อาจอ่านทุก register ยกเว้น b ที่ jalr เขียนเอง
+//   return (jalr a 0) / beq ที่ target อยู่นอก image / ตกเข้า .fill: ถือว่าทุก register live
+//   halt / ไหลออกท้าย image: ไม่มีอะไร live
+static vector<unsigned> liveIn(const vector<IRLine> &ir) {
+    const size_t n = ir.size();
+    auto rows = labelRows(ir);
+    vector<unsigned> in(n, 0);
+    auto at = [&](size_t j) { return j < n ? in[j] : 0u; };
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (size_t k = n; k-- > 0;) {
+            const IRLine &L = ir[k];
+            int op = irOpcode(L);
+            unsigned out = 0, v;
+            if (op < 0) {
+                v = ALL_REGS;   // ตกเข้า data: ไม่รู้ว่าจะทำอะไร
+            } else if (op == OPC_HALT) {
+                v = 0;
+            } else if (op == OPC_JALR && L.regA != L.regB) {
+                v = L.regB == 0 ? ALL_REGS : ((ALL_REGS & ~defMask(L)) | useMask(L));
+            } else {
+                if (op == OPC_BEQ) {
+                    auto it = rows.find(L.f2);
+                    out |= it == rows.end() ? ALL_REGS : at(it->second);
+                }
+                if (!(op == OPC_BEQ && L.regA == L.regB)) out |= at(k + 1);
+                v = useMask(L) | (out & ~defMask(L));
+            }
+            if (v != in[k]) { in[k] = v; changed = true; }
+        }
+    }
+    return in;
+}
+
+struct Routine {
+    bool ok = false;
+    string why;
+    size_t first = 0, last = 0;
+    bool needsLink = false;        // อ่านค่า return address นอกจากตอน return
+    vector<char> isReturn;         // ต่อบรรทัดในช่วง first..last
+};
+
+// return address อยู่ที่ไหนบ้าง ณ จุดหนึ่งใน routine
+struct RaState {
+    bool top = true;               // ยังไม่มีเส้นทางมาถึง
+    unsigned regs = 0;
+    set<string> mem;
+    bool meet(const RaState &o) {
+        if (top) { *this = o; top = false; return true; }
+        unsigned r = regs & o.regs;
+        set<string> m;
+        for (const auto &x : mem) if (o.mem.count(x)) m.insert(x);
+        bool changed = r != regs || m != mem;
+        regs = r;
+        mem = m;
+        return changed;
+    }
+};
+
+static Routine analyzeRoutine(const vector<IRLine> &ir, const unordered_map<string, size_t> &rows,
+                              size_t entry, int link) {
+    Routine R;
+    const size_t n = ir.size();
+    auto target = [&](const IRLine &L) -> long {
+        auto it = rows.find(L.f2);
+        return it == rows.end() ? -1 : (long)it->second;
+    };
+
+    // 1) code ที่ไปถึงได้ต้องเป็นช่วงติดกันที่เริ่มจากจุดเข้า
+    vector<char> seen(n, 0);
+    vector<size_t> work{entry};
+    seen[entry] = 1;
+    size_t last = entry;
+    while (!work.empty()) {
+        size_t k = work.back();
+        work.pop_back();
+        const IRLine &L = ir[k];
+        int op = irOpcode(L);
+        if (op < 0) { R.why = "runs into data"; return R; }
+        vector<long> next;
+        if (op == OPC_BEQ) {
+            long t = target(L);
+            if (t < 0) { R.why = "branches outside the image"; return R; }
+            next.push_back(t);
+            if (L.regA != L.regB) next.push_back((long)k + 1);
+        } else if (op == OPC_JALR) {
+            if (L.regB != 0 || L.regA == 0) { R.why = "not a leaf (calls through jalr)"; return R; }
+        } else if (op != OPC_HALT) {
+            next.push_back((long)k + 1);
+        }
+        for (long t : next) {
+            if (t >= (long)n) { R.why = "falls off the end of the image"; return R; }
+            if ((size_t)t < entry) { R.why = "branches before its entry"; return R; }
+            if (!seen[t]) { seen[t] = 1; work.push_back(t); last = max(last, (size_t)t); }
+        }
+    }
+    for (size_t k = entry; k <= last; ++k)
+        if (!seen[k]) { R.why = "body is not contiguous"; return R; }
+
+    // 2) label ภายใน (ยกเว้นจุดเข้า) ต้องถูกอ้างจาก beq ของ routine เท่านั้น
+    set<string> inner;
+    for (size_t k = entry + 1; k <= last; ++k)
+        if (!ir[k].rawLabel.empty()) inner.insert(ir[k].rawLabel);
+    for (size_t k = 0; k < n; ++k) {
+        const string *ref = irLabelRef(ir[k]);
+        if (!ref || !inner.count(*ref)) continue;
+        if (k < entry || k > last || irOpcode(ir[k]) != OPC_BEQ) {
+            R.why = "inner label '" + *ref + "' is used from outside";
+            return R;
+        }
+    }
+
+    // 3) dataflow ของ return address: ทุก return ต้องกระโดดไปที่ค่าที่ jalr ของผู้เรียกใส่ไว้
+    const size_t len = last - entry + 1;
+    vector<RaState> state(len);
+    R.isReturn.assign(len, 0);
+    RaState init;
+    init.top = false;
+    init.regs = (1u << link) & ALL_REGS;
+    state[0].meet(init);
+    vector<size_t> queue{0};
+    vector<char> queued(len, 0);
+    queued[0] = 1;
+    while (!queue.empty()) {
+        size_t j = queue.back();
+        queue.pop_back();
+        queued[j] = 0;
+        const IRLine &L = ir[entry + j];
+        RaState s = state[j];
+        int op = irOpcode(L);
+        if (op == OPC_JALR) {
+            if (!(s.regs >> L.regA & 1)) { R.why = "returns through a computed address"; return R; }
+            R.isReturn[j] = 1;
+            continue;
+        }
+        if (useMask(L) & s.regs) R.needsLink = true;
+        if (op == OPC_ADD && ((L.regB == 0 && (s.regs >> L.regA & 1)) || (L.regA == 0 && (s.regs >> L.regB & 1))))
+            s.regs |= defMask(L);
+        else if (op == OPC_LW && L.regA == 0 && s.mem.count(L.f2))
+            s.regs |= defMask(L);
+        else
+            s.regs &= ~defMask(L);
+        if (op == OPC_SW) {
+            if (L.regA != 0) s.mem.clear();
+            else if (s.regs >> L.regB & 1) s.mem.insert(L.f2);
+            else s.mem.erase(L.f2);
+        }
+        vector<long> next;
+        if (op == OPC_BEQ) {
+            next.push_back(target(L));
+            if (L.regA != L.regB) next.push_back((long)(entry + j + 1));
+        } else if (op != OPC_HALT) {
+            next.push_back((long)(entry + j + 1));
+        }
+        for (long t : next) {
+            size_t tj = (size_t)t - entry;
+            if (state[tj].meet(s) && !queued[tj]) { queued[tj] = 1; queue.push_back(tj); }
+        }
+    }
+    R.ok = true;
+    R.first = entry;
+    R.last = last;
+    return R;
+}
+
+struct CallSite {
+    size_t load, call, entry;
+    int callReg, link, depth;
+};
+
+// หา "lw 0 R ptr ... jalr R L" ในเส้นทางตรงเดียวกัน และ ptr เป็น .fill label ที่ไม่มี sw เขียนทับ
+static vector<CallSite> findCallSites(const vector<IRLine> &ir, const unordered_map<string, size_t> &rows,
+                                      const ControlFlowGraph &g) {
+    unordered_set<string> referenced, stored;
+    for (const auto &L : ir) {
+        if (const string *ref = irLabelRef(L)) {
+            referenced.insert(*ref);
+            if (irOpcode(L) == OPC_SW) stored.insert(*ref);
+        }
+    }
+    vector<CallSite> sites;
+    for (size_t i = 0; i < ir.size(); ++i) {
+        const IRLine &J = ir[i];
+        if (irOpcode(J) != OPC_JALR || J.regB == 0 || J.regA == J.regB) continue;
+        for (size_t j = i; j-- > 0;) {
+            const IRLine &L = ir[j];
+            if (!ir[j + 1].rawLabel.empty() && referenced.count(ir[j + 1].rawLabel)) break;
+            int op = irOpcode(L);
+            if (op < 0 || op == OPC_BEQ || op == OPC_JALR || op == OPC_HALT) break;
+            if (!(defMask(L) >> J.regA & 1)) continue;
+            if (op != OPC_LW || L.regA != 0 || stored.count(L.f2)) break;
+            auto p = rows.find(L.f2);
+            if (p == rows.end() || irOpcode(ir[p->second]) >= 0 || isNumber(ir[p->second].f0)) break;
+            auto e = rows.find(ir[p->second].f0);
+            if (e == rows.end()) break;
+            int b = g.blockAt(ir[i].address);
+            sites.push_back({j, i, e->second, J.regA, J.regB, b >= 0 ? g.loopDepth(b) : 0});
+            break;
+        }
+    }
+    return sites;
+}
+
+static IRLine makeLine(const string &label, const string &instr, const string &f0, const string &f1,
+                       const string &f2) {
+    IRLine L;
+    L.rawLabel = label;
+    L.instr = instr;
+    L.f0 = f0;
+    L.f1 = f1;
+    L.f2 = f2;
+    return L;
+}
+
+InlineStats runInline(Parser &prog, int budget) {
+    InlineStats st;
+    vector<IRLine> ir = prog.getIR();
+    symbolizeIR(ir);
+    prog.replaceIR(ir);
+    set<string> noted;
+    bool first = true;
+
+    while (true) {
+        ir = prog.getIR();
+        auto rows = labelRows(ir);
+        ControlFlowGraph g = ControlFlowGraph::fromIR(ir);
+        g.computeDominators();
+        g.findLoops();
+        vector<CallSite> sites = findCallSites(ir, rows, g);
+        if (first) { st.callSites = (int)sites.size(); first = false; }
+        vector<unsigned> live = liveIn(ir);
+
+        // เลือก call site ที่อยู่ใน loop ลึกสุด (เท่ากันเลือกตัวแรก) ที่ยังอยู่ใน budget
+        map<pair<size_t, int>, Routine> cache;
+        const CallSite *best = nullptr;
+        const Routine *bestR = nullptr;
+        bool bestLink = false;
+        for (const CallSite &s : sites) {
+            auto key = make_pair(s.entry, s.link);
+            if (!cache.count(key)) cache[key] = analyzeRoutine(ir, rows, s.entry, s.link);
+            const Routine &R = cache[key];
+            const string &name = ir[s.entry].rawLabel;
+            if (!R.ok) {
+                if (noted.insert(name).second) st.notes.push_back(name + ": " + R.why);
+                continue;
+            }
+            if (s.call + 1 >= ir.size()) continue;
+            bool keepLink = R.needsLink || (live[s.call + 1] >> s.link & 1);
+            int cost = int(R.last - R.first + 1) - 1 - (R.isReturn.back() ? 1 : 0) + (keepLink ? 2 : 0);
+            if (st.growth + cost > budget) {
+                if (noted.insert(name).second) st.notes.push_back(name + ": over the size budget");
+                continue;
+            }
+            if (!best || s.depth > best->depth) { best = &s; bestR = &R; bestLink = keepLink; }
+        }
+        if (!best) break;
+
+        // สร้างสำเนา: label ภายในตั้งชื่อใหม่, return → beq 0 0 cont
+        const CallSite s = *best;
+        const Routine &R = *bestR;
+        LabelGen gen(ir);
+        const string cont = ensureLabel(ir, s.call + 1, gen);
+        set<string> usedInside;
+        for (size_t k = R.first; k <= R.last; ++k)
+            if (irOpcode(ir[k]) == OPC_BEQ) usedInside.insert(ir[k].f2);
+        map<string, string> rename;
+        for (size_t k = R.first; k <= R.last; ++k)
+            if (!ir[k].rawLabel.empty() && usedInside.count(ir[k].rawLabel)) rename[ir[k].rawLabel] = gen.next();
+
+        vector<IRLine> body;
+        string ptrLabel;
+        if (bestLink) {
+            ptrLabel = gen.next();
+            body.push_back(makeLine("", "lw", "0", to_string(s.link), ptrLabel));
+        }
+        for (size_t k = R.first; k <= R.last; ++k) {
+            IRLine L = ir[k];
+            auto nl = rename.find(L.rawLabel);
+            L.rawLabel = nl == rename.end() ? "" : nl->second;
+            if (R.isReturn[k - R.first]) {
+                if (k == R.last && L.rawLabel.empty()) continue;
+                L = makeLine(L.rawLabel, "beq", "0", "0", cont);
+            } else if (irOpcode(L) == OPC_BEQ) {
+                L.f2 = rename.at(L.f2);
+            }
+            body.push_back(L);
+        }
+        // label ของ jalr เดิมย้ายไปบรรทัดแรกของสำเนา (ถ้าบรรทัดนั้นมี label อยู่แล้วให้ใช้ชื่อของ jalr แทน)
+        const string &callLabel = ir[s.call].rawLabel;
+        if (!callLabel.empty()) {
+            if (body.empty()) body.push_back(makeLine("", "noop", "", "", ""));
+            const string old = body[0].rawLabel;
+            for (auto &L : body)
+                if (!old.empty() && irOpcode(L) == OPC_BEQ && L.f2 == old) L.f2 = callLabel;
+            body[0].rawLabel = callLabel;
+        }
+
+        vector<IRLine> out(ir.begin(), ir.begin() + s.call);
+        out.insert(out.end(), body.begin(), body.end());
+        out.insert(out.end(), ir.begin() + s.call + 1, ir.end());
+        if (bestLink) out.push_back(makeLine(ptrLabel, ".fill", cont, "", ""));
+
+        // lw ที่โหลด address ของ routine ไม่จำเป็นแล้วถ้า register นั้นไม่ live ต่อ
+        prog.replaceIR(out);
+        out = prog.getIR();
+        vector<unsigned> after = liveIn(out);
+        if (!(after[s.load + 1] >> s.callReg & 1)) {
+            vector<char> kill(out.size(), 0);
+            kill[s.load] = 1;
+            eraseIRLines(out, kill);
+            prog.replaceIR(out);
+        }
+        st.inlined++;
+        if (bestLink) st.linkKept++;
+        st.growth += int(prog.getIR().size()) - int(ir.size());
+    }
+    return st;
+}
@@ -0,0 +1,37 @@
+// inline.h
+// inline subroutine แบบ leaf ที่ถูกเรียกด้วย "lw 0 R ptr ... jalr R L" (ptr .fill ชี้ไปที่ label ของ routine)
+//   routine เป็น leaf เมื่อ:
+//     - code ที่ไปถึงได้จาก label (fall-through + beq) เป็นช่วงบรรทัดติดกันที่ไม่มี .fill และไม่ตกออกท้าย IR
+//     - jalr ในตัว routine มีแค่ return "jalr X 0" และ X ต้องเก็บ return address แน่นอน
+//       (ติดตาม return address ผ่าน register, add X 0 Y และ sw/lw 0 X label แบบ dataflow เช่น
+//        "sw 0 7 rtlink ... lw 0 7 rtlink / jalr 7 0" ใน programs/lib/lcrt.asm)
+//     - label ภายใน routine (ยกเว้นจุดเข้า) ถูกอ้างจาก beq ของ routine เองเท่านั้น
+//   ที่ call site:
+//     - jalr ถูกแทนด้วยสำเนาของ routine ที่ตั้งชื่อ label ภายในใหม่ และ return กลายเป็น "beq 0 0 <ถัดจาก call>"
+//       (return ที่เป็นบรรทัดสุดท้ายของสำเนาถูกตัดทิ้งเพราะไหลต่อได้เลย)
+//     - ถ้า routine ใช้ค่า link register นอกจากตอน return หรือ L ยัง live หลัง call จะใส่ "lw 0 L ptr" ที่ชี้ไป
+//       .fill ของ address ถัดจาก call ให้ L มีค่าเหมือนเดิม (rename การใช้ link register ไปยังค่าคงที่นั้น)
+//     - "lw 0 R ptr" ถูกลบถ้า R ไม่ live แล้วหลัง inline
+//   call site ใน loop ลึกกว่าได้ก่อน (หา loop จาก cfg.h) และหยุดเมื่อ image โตเกิน budget (word)
+// routine ต้นฉบับยังอยู่ (อาจมีผู้เรียกอื่นหรือ pointer อ้างอยู่) ให้ --dce ลบทีหลังถ้าไม่มีใครใช้แล้ว
+// routine ที่เรียก routine อื่นหรือเรียกตัวเอง (เช่น comb ใน programs/combination.asm) ไม่ใช่ leaf จึงไม่ถูก inline
+
+#ifndef INLINE_H
+#define INLINE_H
+
+#include "parser.h"
+
+#include <string>
+#include <vector>
+
+struct InlineStats {
+    int callSites = 0;       // call ที่หา target ได้
+    int inlined = 0;         // call ที่ถูกแทนด้วยสำเนา
+    int growth = 0;          // จำนวน word ที่ image โตขึ้น
+    int linkKept = 0;        // call ที่ต้องใส่ค่า link register ให้
+    std::vector<std::string> notes;   // เหตุผลที่ routine ไม่ถูก inline
+};
+
+InlineStats runInline(Parser &prog, int budget);
+
+#endif
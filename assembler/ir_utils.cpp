@@ -0,0 +1,215 @@
+// ir_utils.cpp — ดูคำอธิบายใน ir_utils.h
+
+#include "ir_utils.h"
+#include "lc_isa.h"
+
+#include <fstream>
+#include <iomanip>
+#include <stdexcept>
+#include <unordered_map>
+
+using namespace std;
+
+static const unordered_map<string,int> IR_OPCODES = {
+    {"add", OPC_ADD}, {"nand", OPC_NAND}, {"lw", OPC_LW}, {"sw", OPC_SW},
+    {"beq", OPC_BEQ}, {"jalr", OPC_JALR}, {"halt", OPC_HALT}, {"noop", OPC_NOOP}
+};
+
+int irOpcode(const IRLine &L) {
+    auto it = IR_OPCODES.find(L.instr);
+    return it == IR_OPCODES.end() ? -1 : it->second;
+}
+
+const string *irLabelRef(const IRLine &L) {
+    int op = irOpcode(L);
+    if (op == OPC_LW || op == OPC_SW || op == OPC_BEQ) return isNumber(L.f2) ? nullptr : &L.f2;
+    if (L.instr == ".fill") return isNumber(L.f0) ? nullptr : &L.f0;
+    if (L.instr == ".space" || L.instr == ".block")
+        return (L.f1.empty() || isNumber(L.f1)) ? nullptr : &L.f1;
+    return nullptr;
+}
+string *irLabelRef(IRLine &L) {
+    return const_cast<string*>(irLabelRef(static_cast<const IRLine&>(L)));
+}
+
+void setRType(IRLine &L, const string &mnemonic, int regA, int regB, int dest) {
+    L.instr = mnemonic;
+    L.f0 = to_string(regA);
+    L.f1 = to_string(regB);
+    L.f2 = to_string(dest);
+    L.regA = regA;
+    L.regB = regB;
+    L.dest = dest;
+    L.offset16 = 0;
+}
+
+// ---------------- LabelGen ----------------
+LabelGen::LabelGen(const vector<IRLine> &ir) {
+    for (const auto &L : ir)
+        if (!L.rawLabel.empty()) used.insert(L.rawLabel);
+}
+
+string LabelGen::next() {
+    // "L0".."L99999" ยาวไม่เกิน 6 ตัวอักษร ข้ามชื่อที่ผู้ใช้ใช้อยู่แล้ว
+    while (counter <= 99999) {
+        string name = "L" + to_string(counter++);
+        if (used.insert(name).second) return name;
+    }
+    throw runtime_error("out of generated label names");
+}
+
+string ensureLabel(vector<IRLine> &ir, size_t idx, LabelGen &gen) {
+    if (ir[idx].rawLabel.empty()) ir[idx].rawLabel = gen.next();
+    return ir[idx].rawLabel;
+}
+
+// ---------------- symbolizeIR ----------------
+int symbolizeIR(vector<IRLine> &ir, const vector<char> *liveRows) {
+    if (ir.empty()) return 0;
+    LabelGen gen(ir);
+    int changed = 0;
+
+    // address -> index ของบรรทัดที่เริ่มต้นที่ address นั้น (address กลางช่วง .space ไม่มีบรรทัด)
+    int imageSize = irImageSize(ir);
+    vector<int> rowAt(imageSize, -1);
+    unordered_map<string,size_t> labelRow;
+    for (size_t i = 0; i < ir.size(); ++i) {
+        rowAt[ir[i].address] = (int)i;
+        if (!ir[i].rawLabel.empty()) labelRow[ir[i].rawLabel] = i;
+    }
+    auto rowOf = [&](long addr) -> int {
+        return (addr >= 0 && addr < imageSize) ? rowAt[addr] : -1;
+    };
+
+    // 1) beq ตัวเลข และ lw/sw ฐาน r0 ที่ชี้เข้าใน image
+    for (size_t i = 0; i < ir.size(); ++i) {
+        IRLine &L = ir[i];
+        int op = irOpcode(L);
+        if (op == OPC_BEQ && isNumber(L.f2)) {
+            int row = rowOf((long)L.address + 1 + L.offset16);
+            if (row < 0) continue;
+            L.f2 = ensureLabel(ir, row, gen);
+            labelRow[L.f2] = row;
+            changed++;
+        } else if ((op == OPC_LW || op == OPC_SW) && L.regA == 0 && isNumber(L.f2)) {
+            int row = rowOf(L.offset16);
+            if (row < 0) continue;
+            L.f2 = ensureLabel(ir, row, gen);
+            labelRow[L.f2] = row;
+            changed++;
+        }
+    }
+
+    // 2) .fill ที่เป็น pointer ไปยัง code: หา "lw 0 R ptr" ก่อน "jalr R x" ในเส้นทางตรงเดียวกัน
+    for (size_t i = 0; i < ir.size(); ++i) {
+        if (irOpcode(ir[i]) != OPC_JALR || ir[i].regA == ir[i].regB) continue;
+        if (liveRows && !(*liveRows)[i]) continue;
+        int target = ir[i].regA;
+        for (size_t q = i; q-- > 0; ) {
+            const IRLine &P = ir[q];
+            int op = irOpcode(P);
+            if (op < 0 || op == OPC_BEQ || op == OPC_JALR || op == OPC_HALT) break;
+            bool writes = ((op == OPC_ADD || op == OPC_NAND) && P.dest == target)
+                       || (op == OPC_LW && P.regB == target);
+            if (writes) {
+                if (op == OPC_LW && P.regA == 0 && !isNumber(P.f2)) {
+                    auto it = labelRow.find(P.f2);
+                    if (it != labelRow.end()) {
+                        IRLine &F = ir[it->second];
+                        if (F.instr == ".fill" && isNumber(F.f0)) {
+                            int row = rowOf(F.fillValue);
+                            if (row >= 0 && irOpcode(ir[row]) >= 0) {
+                                F.f0 = ensureLabel(ir, row, gen);
+                                labelRow[F.f0] = row;
+                                changed++;
+                            }
+                        }
+                    }
+                }
+                break;
+            }
+            if (!P.rawLabel.empty()) break;   // มีทางเข้าจากที่อื่น ไม่รู้ค่าของ R แน่นอน
+        }
+    }
+    return changed;
+}
+
+// ---------------- eraseIRLines ----------------
+size_t eraseIRLines(vector<IRLine> &ir, vector<char> kill) {
+    kill.resize(ir.size(), 0);
+
+    // ถ้าบรรทัดท้าย ๆ ถูกลบหมดและมี label → เก็บบรรทัดสุดท้ายที่มี label ไว้ให้ label มีที่อยู่
+    for (size_t i = ir.size(); i-- > 0 && kill[i]; ) {
+        if (!ir[i].rawLabel.empty()) { kill[i] = 0; break; }
+    }
+
+    unordered_map<string,string> rename;
+    vector<string> pending;
+    vector<IRLine> out;
+    out.reserve(ir.size());
+    for (size_t i = 0; i < ir.size(); ++i) {
+        if (kill[i]) {
+            if (!ir[i].rawLabel.empty()) pending.push_back(ir[i].rawLabel);
+            continue;
+        }
+        IRLine L = ir[i];
+        for (const string &lab : pending) {
+            if (L.rawLabel.empty()) L.rawLabel = lab;
+            else rename[lab] = L.rawLabel;
+        }
+        pending.clear();
+        out.push_back(L);
+    }
+    size_t removed = ir.size() - out.size();
+
+    if (!rename.empty()) {
+        for (auto &L : out) {
+            string *ref = irLabelRef(L);
+            if (!ref) continue;
+            auto it = rename.find(*ref);
+            if (it != rename.end()) *ref = it->second;
+        }
+    }
+    ir.swap(out);
+    return removed;
+}
+
+int irImageSize(const vector<IRLine> &ir) {
+    return ir.empty() ? 0 : ir.back().address + ir.back().words;
+}
+
+// ---------------- encodeIR ----------------
+vector<int32_t> encodeIR(const vector<IRLine> &ir) {
+    vector<int32_t> words;
+    words.reserve(irImageSize(ir));
+    for (const auto &L : ir) {
+        int op = irOpcode(L);
+        uint32_t w = 0;
+        switch (op) {
+            case OPC_ADD: case OPC_NAND: w = packR(op, L.regA, L.regB, L.dest); break;
+            case OPC_LW: case OPC_SW: case OPC_BEQ: w = packI(op, L.regA, L.regB, L.offset16); break;
+            case OPC_JALR: w = packJ(op, L.regA, L.regB); break;
+            case OPC_HALT: case OPC_NOOP: w = packO(op); break;
+            default: w = uint32_t(L.fillValue); break;  // .fill / .space
+        }
+        words.insert(words.end(), L.words, int32_t(w));
+    }
+    return words;
+}
+
+// ---------------- writeAsmFile ----------------
+void writeAsmFile(const vector<IRLine> &ir, const string &outname) {
+    ofstream ofs(outname);
+    if (!ofs.is_open()) throw runtime_error("cannot write assembly file: " + outname);
+    for (const auto &L : ir) {
+        int op = irOpcode(L);
+        ofs << left << setw(8) << L.rawLabel;
+        if (op == OPC_HALT || op == OPC_NOOP) ofs << L.instr;
+        else ofs << setw(6) << L.instr;
+        if (L.instr == ".fill") ofs << L.f0;
+        else if (L.instr == ".space" || L.instr == ".block") ofs << " " << L.f0 << " " << L.f1;
+        else if (op == OPC_JALR) ofs << setw(4) << L.f0 << L.f1;
+        else if (op != OPC_HALT && op != OPC_NOOP) ofs << setw(4) << L.f0 << setw(4) << L.f1 << L.f2;
+        ofs << "\n";
+    }
+}
@@ -0,0 +1,65 @@
+// ir_utils.h
+// เครื่องมือช่วยแก้ IR (vector<IRLine>) สำหรับ pass ใน optimizer
+//   - symbolizeIR : เปลี่ยนการอ้าง address แบบตัวเลขให้เป็น label เพื่อให้ลบ/ย้ายบรรทัดได้ปลอดภัย
+//   - eraseIRLines: ลบบรรทัดแล้วย้าย label ไปบรรทัดถัดไป (แก้การอ้างถึงให้ด้วย)
+//   - encodeIR    : แปลง IR ที่ resolve แล้วเป็น machine code (ใช้วัดผลด้วย LcSim ของ Simulator/lc_sim.h)
+//   - writeAsmFile: เขียน IR กลับเป็นไฟล์ assembly ที่ parser อ่านได้
+
+#ifndef IR_UTILS_H
+#define IR_UTILS_H
+
+#include "parser.h"
+
+#include <cstdint>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+// opcode ของบรรทัด IR (0..7) หรือ -1 ถ้าเป็น data (.fill, .space/.block)
+int irOpcode(const IRLine &L);
+
+// บรรทัดนี้อ้าง label ในฟิลด์ไหน (f2 ของ lw/sw/beq, f0 ของ .fill, f1 ของ .space) คืน nullptr ถ้าไม่มี
+const string *irLabelRef(const IRLine &L);
+string *irLabelRef(IRLine &L);
+
+// ตั้งค่าบรรทัดให้เป็นคำสั่ง R-type ใหม่ (เช่นแทน lw ด้วย add ตอนรู้ค่าอยู่แล้ว)
+void setRType(IRLine &L, const string &mnemonic, int regA, int regB, int dest);
+
+// สร้างชื่อ label ใหม่ที่ไม่ซ้ำของเดิม (ยาวไม่เกิน 6 ตัวอักษรตามกติกา parser)
+class LabelGen {
+public:
+    explicit LabelGen(const vector<IRLine> &ir);
+    string next();
+    void reserve(const string &name) { used.insert(name); }
+private:
+    unordered_set<string> used;
+    int counter = 0;
+};
+
+// หา label ของบรรทัด idx ถ้าไม่มีให้สร้างใหม่
+string ensureLabel(vector<IRLine> &ir, size_t idx, LabelGen &gen);
+
+// เปลี่ยนตัวเลขที่เป็น address ภายใน image ให้เป็น label:
+//   - beq ที่ใช้ offset ตัวเลข (target อยู่ใน image)
+//   - lw/sw ที่ฐานเป็น r0 และ offset ตัวเลขชี้เข้าไปใน image
+//   - .fill ที่เก็บ address ของ code ที่ถูกเรียกผ่าน "lw 0 R ptr ... jalr R x"
+// คืนจำนวนจุดที่แก้ ต้องเรียกกับ IR ที่ resolve แล้ว (regA/offset16 ถูกต้อง)
+// ถ้าให้ liveRows มา จะหา pointer จาก jalr เฉพาะบรรทัดที่ liveRows[i] != 0 (ไม่ให้ code ที่ตายแล้วมาทำให้
+// ค่าคงที่กลายเป็น label)
+int symbolizeIR(vector<IRLine> &ir, const vector<char> *liveRows = nullptr);
+
+// ลบบรรทัดที่ kill[i] != 0 คืนจำนวนบรรทัดที่ลบจริง
+// label ของบรรทัดที่ถูกลบจะย้ายไปบรรทัดถัดไปที่เหลืออยู่ ถ้าบรรทัดนั้นมี label แล้วจะแก้การอ้างถึงไปใช้ label เดิมแทน
+// ถ้าไม่มีบรรทัดเหลือหลังจากนั้น บรรทัดสุดท้ายที่มี label จะไม่ถูกลบ (label ต้องมีที่อยู่)
+size_t eraseIRLines(vector<IRLine> &ir, vector<char> kill);
+
+// จำนวน word ทั้ง image (บรรทัด .space กินหลาย word จึงไม่เท่ากับ ir.size())
+int irImageSize(const vector<IRLine> &ir);
+
+// แปลง IR ที่ resolve แล้วเป็น word 32 บิต (.space ขยายเป็น N word)
+vector<int32_t> encodeIR(const vector<IRLine> &ir);
+
+// เขียน IR เป็น assembly (label, instr, field) ให้ parser อ่านกลับได้
+void writeAsmFile(const vector<IRLine> &ir, const string &outname);
+
+#endif
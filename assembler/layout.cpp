@@ -0,0 +1,187 @@
+// layout.cpp — ดูคำอธิบายใน layout.h
+
+#include "layout.h"
+#include "ir_utils.h"
+#include "lc_isa.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+using namespace std;
+
+struct LayoutBlock {
+    size_t first, last;
+    long count = 0;          // จำนวนครั้งที่ block ทำงาน (จากคำสั่งแรก)
+    int fall = -1;           // block ที่ไหลต่อไป (ทาง fall ของ beq มีเงื่อนไข หรือ block ที่จบเพราะ label)
+    long fallW = 0;
+    bool fixedFall = false;  // jalr: คำสั่งถัดไปต้องเป็นจุด return
+    int jump = -1;           // target ของ beq r r ในช่วงเดียวกัน
+    long jumpW = 0;
+};
+
+// จัด code ช่วง [r0, r1) แล้วต่อท้าย out (kill[k] = 1 สำหรับ jump ที่ไม่ต้องใช้แล้ว)
+static void layoutRegion(vector<IRLine> &ir, size_t r0, size_t r1, const ExecProfile &prof,
+                         const unordered_set<string> &referenced, const unordered_map<string, size_t> &labelRow,
+                         LabelGen &gen, vector<IRLine> &out, vector<char> &kill, LayoutStats &st) {
+    auto keep = [&]() {
+        for (size_t k = r0; k < r1; ++k) { out.push_back(ir[k]); kill.push_back(0); }
+    };
+    long total = 0;
+    for (size_t k = r0; k < r1; ++k) total += prof.at(ir[k].address);
+    if (total == 0) { keep(); return; }   // ไม่เคยทำงานเลย ไม่มีข้อมูลให้จัด
+
+    vector<LayoutBlock> blocks;
+    unordered_map<size_t, int> blockAt;   // บรรทัดแรกของ block → index
+    for (size_t i = r0; i < r1;) {
+        size_t e = i;
+        while (e < r1) {
+            int op = irOpcode(ir[e]);
+            if (e > i && !ir[e].rawLabel.empty() && referenced.count(ir[e].rawLabel)) break;
+            ++e;
+            if (op == OPC_BEQ || op == OPC_JALR || op == OPC_HALT) break;
+        }
+        blockAt[i] = (int)blocks.size();
+        LayoutBlock b;
+        b.first = i;
+        b.last = e - 1;
+        b.count = prof.at(ir[i].address);
+        blocks.push_back(b);
+        i = e;
+    }
+    const int nb = (int)blocks.size();
+
+    for (int b = 0; b < nb; ++b) {
+        LayoutBlock &B = blocks[b];
+        const IRLine &L = ir[B.last];
+        int op = irOpcode(L);
+        long c = prof.at(ir[B.last].address);
+        bool fallsOn = false;
+        if (op == OPC_BEQ) {
+            auto t = labelRow.find(L.f2);
+            int tb = -1;
+            if (t != labelRow.end() && blockAt.count(t->second)) tb = blockAt[t->second];
+            if (L.regA == L.regB) {
+                B.jump = tb;
+                B.jumpW = c;
+            } else {
+                long taken = 0;
+                if (t != labelRow.end())
+                    taken = prof.hasEdges ? prof.edge(ir[B.last].address, ir[t->second].address)
+                                          : max(0L, c - prof.at(ir[B.last].address + 1));
+                fallsOn = true;
+                B.fallW = max(0L, c - taken);
+            }
+        } else if (op == OPC_JALR) {
+            if (!(L.regB == 0 && L.regA != 0)) { fallsOn = true; B.fixedFall = true; }
+        } else if (op != OPC_HALT) {
+            fallsOn = true;
+            B.fallW = c;
+        }
+        if (fallsOn) {
+            if (b + 1 >= nb) { st.regionsSkipped++; keep(); return; }   // ไหลออกท้ายช่วงเข้า data
+            B.fall = b + 1;
+        }
+    }
+
+    // ต่อ chain: jalr ก่อน แล้วตาม edge ที่บ่อยสุด
+    vector<int> next(nb, -1), prev(nb, -1);
+    const int entry = (r0 == 0) ? 0 : -1;
+    auto headOf = [&](int b) { while (prev[b] >= 0) b = prev[b]; return b; };
+    auto link = [&](int a, int b) {
+        if (b == entry || next[a] >= 0 || prev[b] >= 0 || headOf(a) == b) return;
+        next[a] = b;
+        prev[b] = a;
+    };
+    for (int b = 0; b < nb; ++b)
+        if (blocks[b].fixedFall) link(b, blocks[b].fall);
+    vector<tuple<long, int, int>> edges;   // (-weight, from, to)
+    for (int b = 0; b < nb; ++b) {
+        if (blocks[b].fall >= 0 && !blocks[b].fixedFall) edges.push_back({-blocks[b].fallW, b, blocks[b].fall});
+        if (blocks[b].jump >= 0) edges.push_back({-blocks[b].jumpW, b, blocks[b].jump});
+    }
+    sort(edges.begin(), edges.end());
+    for (const auto &e : edges) link(get<1>(e), get<2>(e));
+
+    // เรียง chain: PC 0 → chain ที่เคยทำงาน → chain ที่ไม่เคยทำงาน (ตามตำแหน่งเดิมในแต่ละกลุ่ม)
+    vector<int> heads;
+    for (int b = 0; b < nb; ++b)
+        if (prev[b] < 0) heads.push_back(b);
+    auto hot = [&](int h) {
+        for (int b = h; b >= 0; b = next[b])
+            if (blocks[b].count > 0) return true;
+        return false;
+    };
+    stable_sort(heads.begin(), heads.end(), [&](int x, int y) {
+        int kx = x == entry ? 0 : hot(x) ? 1 : 2, ky = y == entry ? 0 : hot(y) ? 1 : 2;
+        return kx < ky;
+    });
+    vector<int> order;
+    for (int h : heads)
+        for (int b = h; b >= 0; b = next[b]) order.push_back(b);
+
+    // label ให้ block ที่ต้องมี jump เพิ่มมาหา
+    for (size_t k = 0; k < order.size(); ++k) {
+        const LayoutBlock &B = blocks[order[k]];
+        int after = k + 1 < order.size() ? order[k + 1] : -1;
+        if (B.fall >= 0 && B.fall != after) ensureLabel(ir, blocks[B.fall].first, gen);
+    }
+    for (size_t k = 0; k < order.size(); ++k) {
+        const LayoutBlock &B = blocks[order[k]];
+        int after = k + 1 < order.size() ? order[k + 1] : -1;
+        if (order[k] != (int)k) {
+            st.blocks++;
+            if (B.count == 0) st.coldBlocks++;
+        }
+        for (size_t i = B.first; i <= B.last; ++i) {
+            out.push_back(ir[i]);
+            bool dropJump = i == B.last && B.jump >= 0 && B.jump == after;
+            kill.push_back(dropJump);
+            if (dropJump) st.jumpsRemoved++;
+        }
+        if (B.fall >= 0 && B.fall != after) {
+            IRLine J;
+            J.instr = "beq";
+            J.f0 = "0";
+            J.f1 = "0";
+            J.f2 = ir[blocks[B.fall].first].rawLabel;
+            out.push_back(J);
+            kill.push_back(0);
+            st.jumpsAdded++;
+        }
+    }
+}
+
+LayoutStats runLayout(Parser &prog, const ExecProfile &profile) {
+    LayoutStats st;
+    vector<IRLine> ir = prog.getIR();
+    if ((long)profile.pcCount.size() > irImageSize(ir))
+        throw runtime_error("profile covers " + to_string(profile.pcCount.size()) + " word(s) but the program has " +
+                            to_string(irImageSize(ir)) + " (profile must come from the same program)");
+    symbolizeIR(ir);
+
+    unordered_set<string> referenced;
+    unordered_map<string, size_t> labelRow;
+    for (size_t i = 0; i < ir.size(); ++i) {
+        if (const string *ref = irLabelRef(ir[i])) referenced.insert(*ref);
+        if (!ir[i].rawLabel.empty()) labelRow[ir[i].rawLabel] = i;
+    }
+    LabelGen gen(ir);
+
+    vector<IRLine> out;
+    vector<char> kill;
+    size_t i = 0;
+    while (i < ir.size()) {
+        if (irOpcode(ir[i]) < 0) { out.push_back(ir[i++]); kill.push_back(0); continue; }
+        size_t r0 = i;
+        while (i < ir.size() && irOpcode(ir[i]) >= 0) ++i;
+        layoutRegion(ir, r0, i, profile, referenced, labelRow, gen, out, kill, st);
+    }
+    eraseIRLines(out, kill);
+    prog.replaceIR(out);
+    return st;
+}
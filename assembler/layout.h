@@ -0,0 +1,30 @@
+// layout.h
+// จัดวาง basic block ใหม่ตาม execution profile (profile.h) ให้ทางที่ทำงานบ่อยไหลต่อกันโดยไม่ต้องกระโดด
+//   - แบ่ง block แบบเดียวกับ schedule.h แล้วจัดเฉพาะภายในช่วง code ที่ติดกัน (.fill อยู่ที่เดิม)
+//   - edge ที่ไหลต่อได้: "beq r r X" (กระโดดแน่นอน), ทาง fall ของ beq มีเงื่อนไข และ block ที่จบเพราะ label
+//     ต่อ edge เรียงจากบ่อยสุด ต่อ chain เมื่อปลาย chain หนึ่งต่อหัวอีก chain ได้ (แบบ Pettis-Hansen)
+//   - jalr (call และ jalr a a) ต้องมีคำสั่งถัดไปเป็นจุด return เสมอ จึงถูกต่อ chain ก่อนทุก edge
+//   - chain ของ PC 0 อยู่แรก ตามด้วย chain ที่เคยทำงาน (ตามตำแหน่งเดิม) แล้วจึงเป็น chain ที่ไม่เคยทำงาน (cold)
+//   - หลังจัด: "beq r r X" ที่ X อยู่ถัดไปพอดีถูกลบ, block ที่ทาง fall ไม่ได้อยู่ถัดไปแล้วได้ "beq 0 0 <fall>" เพิ่ม
+// LC มีแค่ beq (ไม่มี bne) จึงกลับเงื่อนไขของ branch ไม่ได้: ทาง taken ของ beq มีเงื่อนไขยังกระโดดเหมือนเดิม
+// ที่ลดได้คือ jump ที่ไม่มีเงื่อนไขบนทางที่ร้อน และ cold block ที่ขวาง loop ถูกย้ายไปท้าย
+// profile ต้องเก็บจากโปรแกรมเดียวกับที่ parse ได้ (address ตรงกัน) จึงต้องรัน pass นี้ก่อน pass อื่น
+// ถ้า profile มีแค่จำนวนครั้งต่อ PC จะประมาณทาง taken ของ beq = count(beq) - count(คำสั่งถัดไป)
+
+#ifndef LAYOUT_H
+#define LAYOUT_H
+
+#include "parser.h"
+#include "profile.h"
+
+struct LayoutStats {
+    int blocks = 0;          // block ที่ย้ายตำแหน่ง
+    int coldBlocks = 0;      // block ที่ไม่เคยทำงานและถูกย้ายไปท้ายช่วง code
+    int jumpsRemoved = 0;    // beq r r ที่ไม่ต้องใช้แล้ว
+    int jumpsAdded = 0;      // beq 0 0 ที่เพิ่มให้ทาง fall ที่ถูกแยกออก
+    int regionsSkipped = 0;  // ช่วง code ที่ไหลออกท้ายช่วงเข้า data (ไม่แตะ)
+};
+
+LayoutStats runLayout(Parser &prog, const ExecProfile &profile);
+
+#endif
@@ -0,0 +1,218 @@
+// lc_diskcache.h
+// ส่วนที่ cache บนดิสก์ทั้งสองตัวใช้ร่วมกัน: build cache ของ assembler (buildcache.h) กับ JitCache (Simulator/lc_jitcache.h)
+//   - CacheKeyHash: hash 128 บิตแบบสอง lane อิสระกัน (FNV-1a 64, multiply-rotate + finalizer ของ splitmix64)
+//   - DiskCacheDir: ไดเรกทอรี <dir>/<key 2 หลักแรก>/<key ที่เหลือ><ext> (แตกเป็น 256 โฟลเดอร์ย่อย)
+//       เขียน: ไฟล์ชั่วคราวชื่อไม่ซ้ำในโฟลเดอร์เดียวกันแล้ว rename ทับ (atomic) หลาย process ใช้พร้อมกันได้โดยไม่ต้องล็อก
+//              คนอ่านเห็นแค่ entry ครบหรือไม่มี สอง process เขียน key เดียวกันได้เนื้อเดียวกัน ใครชนะก็ถูก
+//       eviction: LRU ตาม mtime (hit จะ touch) เกิน maxBytes ลบเก่าสุดจนเหลือ 90% ไฟล์ชั่วคราวค้างเกิน 1 ชั่วโมงถูกลบ
+//                 ไม่ไล่ไดเรกทอรีทุก store: นับขนาดรวมต่อเองจาก scan ครั้งแรก แล้ว evict เมื่อยอดนั้นเกิน
+//                 หรือครบทุก RESCAN_STORES ครั้ง (ให้ entry ที่ process อื่นเขียนเพิ่มเข้ามาอยู่ในยอดด้วย)
+//       PRIVATE (POSIX): ไดเรกทอรีต้องเป็นของ effective user และ group/others เขียนไม่ได้ (ไม่งั้น throw ตอนสร้าง)
+//                 ไดเรกทอรี/entry ที่สร้างเองถูกตัดสิทธิ์เขียนของ group/others ทิ้ง และ entry ที่จะอ่านต้องผ่านเกณฑ์เดียวกัน
+//                 ใช้กับ cache ที่เนื้อถูก execute (JitCache) — คนอื่นที่เขียนไดเรกทอรีได้ = ฉีดโค้ดเครื่องได้
+//                 Windows ใช้ ACL ไม่ได้ตรวจ
+
+#ifndef LC_DISKCACHE_H
+#define LC_DISKCACHE_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#if !defined(_WIN32)
+#  include <sys/stat.h>
+#  include <unistd.h>
+#endif
+
+struct CacheKeyHash {
+    uint64_t a = 1469598103934665603ULL;
+    uint64_t b = 0x9E3779B97F4A7C15ULL;
+
+    void mix(unsigned char c) {
+        a = (a ^ c) * 1099511628211ULL;
+        b = (b ^ c) * 0xBF58476D1CE4E5B9ULL;
+        b = (b << 27) | (b >> 37);
+    }
+    void mix(const void *p, size_t n) {
+        for (size_t i = 0; i < n; ++i) mix(static_cast<const unsigned char *>(p)[i]);
+    }
+    // hi = lane FNV, lo = lane multiply-rotate หลังผ่าน finalizer
+    void finish(uint64_t &hi, uint64_t &lo) const {
+        uint64_t x = b;
+        x ^= x >> 30; x *= 0xBF58476D1CE4E5B9ULL;
+        x ^= x >> 27; x *= 0x94D049BB133111EBULL;
+        x ^= x >> 31;
+        hi = a;
+        lo = x;
+    }
+    // key 32 ตัวอักษรฐานสิบหก (ใช้เป็นชื่อไฟล์)
+    static std::string hex(uint64_t hi, uint64_t lo) {
+        char buf[33];
+        snprintf(buf, sizeof buf, "%016llx%016llx", (unsigned long long)hi, (unsigned long long)lo);
+        return buf;
+    }
+};
+
+class DiskCacheDir {
+public:
+    static constexpr unsigned RESCAN_STORES = 64;
+    enum Access { SHARED, PRIVATE };
+
+    DiskCacheDir(const std::string &dir, const std::string &ext, uint64_t maxBytes, Access access)
+        : dir(dir), ext(ext), maxBytes(maxBytes), access(access) {
+        std::error_code ec;
+        const bool existed = std::filesystem::exists(dir, ec);
+        std::filesystem::create_directories(dir, ec);
+        if (!std::filesystem::is_directory(dir, ec)) throw std::runtime_error("cannot create cache directory: " + dir);
+        if (!existed) restrict(dir);
+        const char *why = untrustedReason();
+        if (why) throw std::runtime_error("refusing cache directory " + dir + ": " + why);
+    }
+
+    const std::string &directory() const { return dir; }
+
+    std::string entryPath(const std::string &hexKey) const {
+        return (std::filesystem::path(dir) / hexKey.substr(0, 2) / (hexKey.substr(2) + ext)).string();
+    }
+
+#if !defined(_WIN32)
+    // entry ที่เปิดไว้ (fd) อ่านได้ตามเกณฑ์ access ไหม เช็คบน fd จึงไม่มีช่องให้สลับไฟล์ระหว่างเช็คกับอ่าน
+    bool trustedEntry(int fd) const {
+        if (access == SHARED) return true;
+        struct stat st;
+        return fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_uid == geteuid() && !(st.st_mode & (S_IWGRP | S_IWOTH));
+    }
+#endif
+
+    // hit แล้ว touch ไว้ให้ eviction รู้ว่าเพิ่งใช้ (entry อาจถูกลบไปแล้ว ไม่เป็นไร)
+    static void touch(const std::string &path) {
+        std::error_code ec;
+        std::filesystem::last_write_time(path, std::filesystem::file_time_type::clock::now(), ec);
+    }
+
+    // เขียน entry ผ่าน write(ostream) ลงไฟล์ชั่วคราวแล้ว rename ทับ จากนั้น evict ถ้ายอดรวมเกิน
+    // เปิด/เขียนไฟล์ชั่วคราวไม่ได้ → throw runtime_error; rename ไม่ได้ (Windows: อีก process เปิด entry นั้นอยู่
+    // ซึ่งมีเนื้อเดียวกัน) → ทิ้งไฟล์ชั่วคราวเฉย ๆ
+    void write(const std::string &entry, const std::function<void(std::ostream &)> &body) {
+        namespace fs = std::filesystem;
+        const fs::path path(entry);
+        std::error_code ec;
+        if (!fs::is_directory(path.parent_path(), ec)) {
+            fs::create_directories(path.parent_path(), ec);
+            restrict(path.parent_path());
+        }
+        // ชื่อไฟล์ชั่วคราวไม่ซ้ำกันระหว่าง process (ไม่ใช้ pid เพื่อให้ใช้ได้ทั้ง Windows/Linux)
+        static std::mt19937_64 rng(std::random_device{}() ^
+                                   uint64_t(std::chrono::steady_clock::now().time_since_epoch().count()));
+        char suffix[24];
+        snprintf(suffix, sizeof suffix, ".tmp-%016llx", (unsigned long long)rng());
+        const fs::path tmp = path.parent_path() / (path.filename().string() + suffix);
+        {
+            std::ofstream ofs(tmp, std::ios::binary);
+            if (!ofs.is_open()) throw std::runtime_error("cannot write cache entry: " + tmp.string());
+            body(ofs);
+            ofs.close();
+            if (!ofs) {
+                fs::remove(tmp, ec);
+                throw std::runtime_error("write failed: " + tmp.string());
+            }
+        }
+        restrict(tmp);
+        fs::rename(tmp, path, ec);
+        if (ec) {
+            fs::remove(tmp, ec);
+            return;
+        }
+        const uint64_t size = fs::file_size(path, ec);
+        if (!ec) knownBytes += size;
+        if (!scanned || knownBytes > maxBytes || ++storesSinceScan >= RESCAN_STORES) evict();
+    }
+
+    // ไล่ทั้งไดเรกทอรีแล้วลบตามเกณฑ์ด้านบน คืนจำนวน entry ที่ลบ
+    size_t evict() {
+        namespace fs = std::filesystem;
+        struct Entry {
+            fs::file_time_type time;
+            uint64_t size;
+            fs::path path;
+        };
+        std::vector<Entry> entries;
+        uint64_t total = 0;
+        const auto now = fs::file_time_type::clock::now();
+        std::error_code ec;
+        for (fs::recursive_directory_iterator it(dir, ec), end; !ec && it != end; it.increment(ec)) {
+            std::error_code fec;
+            if (!it->is_regular_file(fec)) continue;
+            const fs::path p = it->path();
+            const auto t = fs::last_write_time(p, fec);
+            if (fec) continue;
+            if (p.filename().string().find(".tmp-") != std::string::npos) {
+                if (now - t > std::chrono::hours(1)) fs::remove(p, fec);   // process ตายกลางทาง
+                continue;
+            }
+            if (p.extension() != ext) continue;
+            const uint64_t size = fs::file_size(p, fec);
+            if (fec) continue;
+            entries.push_back({t, size, p});
+            total += size;
+        }
+        scanned = true;
+        storesSinceScan = 0;
+        knownBytes = total;
+        if (total <= maxBytes) return 0;
+
+        // เก่าสุดก่อน (process อื่นอาจลบตัวเดียวกันไปแล้ว ก็ข้าม)
+        std::sort(entries.begin(), entries.end(), [](const Entry &x, const Entry &y) { return x.time < y.time; });
+        const uint64_t target = maxBytes / 10 * 9;
+        size_t removed = 0;
+        for (const auto &e : entries) {
+            if (total <= target) break;
+            std::error_code rec;
+            if (fs::remove(e.path, rec)) removed++;
+            total -= e.size;
+        }
+        knownBytes = total;
+        return removed;
+    }
+
+private:
+    std::string dir, ext;
+    uint64_t maxBytes;
+    Access access;
+    bool scanned = false;        // knownBytes มาจากการ scan แล้วหรือยัง
+    uint64_t knownBytes = 0;     // ขนาดรวมของ entry ตาม scan ล่าสุด + ที่ write เองหลังจากนั้น
+    unsigned storesSinceScan = 0;
+
+    // ไดเรกทอรี/ไฟล์ที่สร้างเองภายใต้ umask แบบ 002 จะเขียนได้ทั้ง group → ตัดออกก่อนใช้ (PRIVATE เท่านั้น)
+    void restrict(const std::filesystem::path &p) const {
+        if (access != PRIVATE) return;
+        std::error_code ec;
+        std::filesystem::permissions(p, std::filesystem::perms::group_write | std::filesystem::perms::others_write,
+                                     std::filesystem::perm_options::remove, ec);
+    }
+
+    // nullptr = ใช้ไดเรกทอรีนี้ได้
+    const char *untrustedReason() const {
+#if defined(_WIN32)
+        return nullptr;
+#else
+        if (access == SHARED) return nullptr;
+        struct stat st;
+        if (stat(dir.c_str(), &st) != 0 || !S_ISDIR(st.st_mode)) return "cannot stat";
+        if (st.st_uid != geteuid()) return "not owned by the current user";
+        if (st.st_mode & (S_IWGRP | S_IWOTH)) return "writable by group or others";
+        return nullptr;
+#endif
+    }
+};
+
+#endif
@@ -0,0 +1,148 @@
+// lc_image.h
+// โหลดไฟล์ machine code (.mc) เข้าหน่วยความจำ
+// กติกาเดียวกับ loadFromFile ใน Simulator.java:
+//   - หนึ่งค่าต่อบรรทัด (เลขฐานสิบแบบ signed 32 บิต)
+//   - "*N value" = run-length record: N word ติดกันที่มีค่า value ทุก word (assembler เขียนจาก .space/.block)
+//   - ข้ามบรรทัดว่าง, สนใจแค่ token แรกของบรรทัด (ที่เหลือถือเป็น comment) ยกเว้น record ที่ใช้ token ที่สอง
+//   - image รวมต้องไม่เกิน 65536 word
+// อ่านทั้งไฟล์รวดเดียวแล้ว parse เองแบบไม่สร้าง string ต่อบรรทัด เพื่อให้ไฟล์หลาย MB โหลดได้เร็ว
+// loadSparseImage เก็บ record ไว้ตามเดิม (เวลา/หน่วยความจำตามขนาดไฟล์ ไม่ใช่ขนาดช่วงที่จอง)
+// ส่วน loadMachineCode ขยายเป็น vector เต็มสำหรับเครื่องมือที่ต้องการ word ทุกตัว
+
+#ifndef LC_IMAGE_H
+#define LC_IMAGE_H
+
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// ช่วง word ติดกันใน image: literal (words) หรือ run (count word ค่า value)
+struct ImageSegment {
+    int32_t start = 0;
+    int32_t count = 0;
+    bool run = false;
+    int32_t value = 0;              // ค่าของ run
+    std::vector<int32_t> words;     // word ของ literal
+};
+
+struct SparseImage {
+    static constexpr int32_t MAX_WORDS = 65536;
+
+    std::vector<ImageSegment> segments;
+    int32_t size = 0;               // จำนวน word ทั้ง image (= numMemory ของ simulator)
+
+    void push(int32_t w) {
+        if (segments.empty() || segments.back().run) segments.push_back({size, 0, false, 0, {}});
+        segments.back().words.push_back(w);
+        segments.back().count++;
+        size++;
+    }
+    void pushRun(int32_t count, int32_t value) {
+        segments.push_back({size, count, true, value, {}});
+        size += count;
+    }
+
+    // เขียนลง mem ที่เป็น 0 อยู่แล้ว: ข้าม run ที่เป็น 0 (ขยายแบบ lazy)
+    void copyTo(int32_t *mem) const {
+        for (const auto &s : segments) {
+            if (!s.run) std::copy(s.words.begin(), s.words.end(), mem + s.start);
+            else if (s.value != 0) std::fill(mem + s.start, mem + s.start + s.count, s.value);
+        }
+    }
+
+    std::vector<int32_t> expand() const {
+        std::vector<int32_t> words(size, 0);
+        copyTo(words.data());
+        return words;
+    }
+};
+
+// parse ข้อความรูปแบบ .mc (ใช้ทั้งกับไฟล์ .mc และ section ใน object file)
+inline SparseImage parseSparseImage(const std::string &buf) {
+    SparseImage img;
+    size_t i = 0, n = buf.size();
+    long lineNo = 0;
+    auto isBlank = [&](size_t q) { return buf[q] == ' ' || buf[q] == '\t' || buf[q] == '\r'; };
+    // อ่านเลข [+-]digits ที่ p (ต้องจบด้วย whitespace) คืน false ถ้าผิดรูปแบบหรือเกิน 32 บิต
+    auto number = [&](size_t &p, size_t eol, long long &out) {
+        size_t q = p;
+        bool neg = false;
+        if (q < eol && (buf[q] == '+' || buf[q] == '-')) { neg = (buf[q] == '-'); ++q; }
+        long long v = 0;
+        size_t digits = 0;
+        while (q < eol && buf[q] >= '0' && buf[q] <= '9') {
+            v = v * 10 + (buf[q] - '0');
+            if (v > 2147483648LL) break;
+            ++q; ++digits;
+        }
+        bool endOfToken = (q == eol || isBlank(q));
+        if (neg) v = -v;
+        p = q;
+        out = v;
+        return digits > 0 && endOfToken && v >= INT32_MIN && v <= INT32_MAX;
+    };
+    while (i < n) {
+        size_t eol = buf.find('\n', i);
+        if (eol == std::string::npos) eol = n;
+        ++lineNo;
+
+        // ข้าม whitespace หน้า token แรก
+        size_t p = i;
+        while (p < eol && isBlank(p)) ++p;
+        if (p < eol) {
+            auto bad = [&]() {
+                return std::runtime_error("error in reading address " + std::to_string(img.size) + " (line " +
+                                          std::to_string(lineNo) + ")");
+            };
+            long long v = 0;
+            if (buf[p] == '*') {
+                // record "*N value"
+                long long count = 0;
+                ++p;
+                if (!number(p, eol, count) || count < 1) throw bad();
+                while (p < eol && isBlank(p)) ++p;
+                if (!number(p, eol, v)) throw bad();
+                if (img.size + count > SparseImage::MAX_WORDS) throw bad();
+                img.pushRun(int32_t(count), int32_t(v));
+            } else {
+                if (!number(p, eol, v) || img.size >= SparseImage::MAX_WORDS) throw bad();
+                img.push(int32_t(v));
+            }
+        }
+        i = eol + 1;
+    }
+    return img;
+}
+
+inline SparseImage loadSparseImage(const std::string &path) {
+    std::ifstream ifs(path, std::ios::binary);
+    if (!ifs.is_open()) throw std::runtime_error("cannot open machine code file: " + path);
+    std::ostringstream ss;
+    ss << ifs.rdbuf();
+    return parseSparseImage(ss.str());
+}
+
+// เขียนกลับเป็นรูปแบบ .mc: literal บรรทัดละค่า, run เป็น "*N value" คืนจำนวนบรรทัดที่เขียน
+inline size_t writeImageRecords(std::ostream &os, const SparseImage &img) {
+    size_t lines = 0;
+    for (const auto &s : img.segments) {
+        if (s.run) {
+            os << '*' << s.count << ' ' << s.value << '\n';
+            lines++;
+        } else {
+            for (int32_t w : s.words) os << w << '\n';
+            lines += s.words.size();
+        }
+    }
+    return lines;
+}
+
+inline std::vector<int32_t> loadMachineCode(const std::string &path) {
+    return loadSparseImage(path).expand();
+}
+
+#endif
@@ -0,0 +1,205 @@
+// lc_isa.h
+// นิยามรูปแบบบิตของคำสั่ง LC (SMC) ที่ใช้ร่วมกันระหว่าง assembler, disassembler และ simulator
+//   - encode: packR / packI / packJ / packO (ย้ายมาจาก assembler.cpp)
+//   - decode: ตาราง DECODE_TABLE ที่คำนวณไว้ล่วงหน้า (index ด้วยบิต [24..16])
+//   - แยก code ออกจาก image: scanCode / findJalrTarget (ใช้ร่วมกันใน disassembler, cfg และ mc2cpp)
+// header-only: include แล้วใช้ได้เลย ไม่ต้องลิงก์ไฟล์เพิ่ม
+
+#ifndef LC_ISA_H
+#define LC_ISA_H
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+// รหัสคำสั่ง add=0, nand=1, lw=2, sw=3, beq=4, jalr=5, halt=6, noop=7
+constexpr int OPC_ADD  = 0;
+constexpr int OPC_NAND = 1;
+constexpr int OPC_LW   = 2;
+constexpr int OPC_SW   = 3;
+constexpr int OPC_BEQ  = 4;
+constexpr int OPC_JALR = 5;
+constexpr int OPC_HALT = 6;
+constexpr int OPC_NOOP = 7;
+
+// ชื่อ mnemonic ตาม opcode (ใช้ตอนพิมพ์กลับเป็น assembly)
+static const char* const LC_MNEMONIC[8] = {
+    "add", "nand", "lw", "sw", "beq", "jalr", "halt", "noop"
+};
+
+// -------------------- Bit layout ของคำสั่ง 32 บิต --------------------
+// เราใช้การ shift บิตเข้าตำแหน่งที่สเปกกำหนด:
+// [ opcode(3) | regA(3) | regB(3) | (ที่เหลือ 16 บิต/3 บิตขึ้นกับชนิด) ]
+constexpr int OPCODE_SHIFT = 22; //OPCODE_SHIFT=22
+constexpr int REGA_SHIFT   = 19; //REGA_SHIFT=19
+constexpr int REGB_SHIFT   = 16; //REGB_SHIFT=16
+//opcode อยู่บิต [24..22] (3 บิต)
+//regA บิต [21..19] (3 บิต)
+//regB บิต [18..16] (3 บิต)
+//แล้วที่เหลือขึ้นกับชนิดคำสั่ง
+
+// ฟังก์ชัน pack บิตสำหรับแต่ละฟอร์แมต (ลด duplicate โค้ด)
+inline uint32_t packR(int opcode, int rA, int rB, int dest) {
+    // R-type(add, nand) : ช่องท้ายสุดใช้เพียง 3 บิตสำหรับ destReg (3 บิตที่ [2..0]) ส่วน [15..3] เป็น 0)
+    return (uint32_t(opcode) << OPCODE_SHIFT)
+        | (uint32_t(rA)     << REGA_SHIFT)
+        | (uint32_t(rB)     << REGB_SHIFT)
+        | (uint32_t(dest) & 0x7u); //dest & 0x7u บังคับ 3 บิต
+}
+inline uint32_t packI(int opcode, int rA, int rB, int offset16) {
+    // I-type(lw, sw, beq): 16 บิตท้ายใช้เก็บ offset แบบ two's complement
+    return (uint32_t(opcode) << OPCODE_SHIFT)
+        | (uint32_t(rA)     << REGA_SHIFT)
+        | (uint32_t(rB)     << REGB_SHIFT)
+        | (uint32_t(offset16) & 0xFFFFu); // & 0xFFFFu เพื่อชัดเจนว่าตัดเหลือ 16 บิต
+}
+inline uint32_t packJ(int opcode, int rA, int rB) {
+    // J-type(jalr): ใช้แค่ opcode + regA + regB, ที่เหลือ (16 บิต[15..0]) เป็น 0
+    return (uint32_t(opcode) << OPCODE_SHIFT)
+        | (uint32_t(rA)     << REGA_SHIFT)
+        | (uint32_t(rB)     << REGB_SHIFT);
+}
+inline uint32_t packO(int opcode) {
+    // ใช้กับ halt, noop
+    // O-type: ใช้เฉพาะ opcode, ที่เหลือทั้งหมดเป็น 0
+    return (uint32_t(opcode) << OPCODE_SHIFT);
+}
+
+// -------------------- Decode --------------------
+// sign-extend 16 บิต -> 32 บิต (เหมือน convertNum ใน Simulator.java)
+inline int32_t signExtend16(uint32_t v) {
+    v &= 0xFFFFu;
+    return (v & 0x8000u) ? int32_t(v) - 0x10000 : int32_t(v);
+}
+
+// คำสั่งที่ถอดแล้ว: เก็บแบบกะทัดรัด 8 ไบต์ (imm ถูก sign-extend ไว้แล้ว)
+struct DecodedInstr {
+    uint8_t opcode;
+    uint8_t regA;
+    uint8_t regB;
+    uint8_t dest;   // R-type: บิต [2..0]
+    int32_t imm;    // I-type: offset 16 บิตที่ sign-extend แล้ว
+};
+
+// หนึ่งช่องของตาราง decode (index = บิต [24..16] = opcode|regA|regB)
+//   zeroMask: บิตใน 16 บิตล่างที่ assembler เราเติม 0 เสมอ ถ้าไม่เป็น 0 แปลว่าไม่ใช่ผลจาก packX
+//   canonical: 0 ถ้า opcode/reg ชุดนี้ไม่มีทางออกมาจาก assembler (เช่น halt ที่มี regA != 0)
+struct DecodeEntry {
+    uint8_t  opcode, regA, regB, canonical;
+    uint16_t zeroMask;
+};
+
+struct DecodeTable {
+    DecodeEntry e[512];
+    constexpr DecodeTable() : e() {
+        for (int i = 0; i < 512; ++i) {
+            int op = i >> 6, a = (i >> 3) & 7, b = i & 7;
+            uint16_t mask = 0;
+            bool ok = true;
+            switch (op) {
+                case OPC_ADD: case OPC_NAND: mask = 0xFFF8; break;       // R-type ใช้แค่ dest 3 บิต
+                case OPC_LW: case OPC_SW: case OPC_BEQ: mask = 0; break; // I-type ใช้ครบ 16 บิต
+                case OPC_JALR: mask = 0xFFFF; break;                     // J-type
+                default: mask = 0xFFFF; ok = (a == 0 && b == 0); break;  // O-type
+            }
+            e[i] = DecodeEntry{uint8_t(op), uint8_t(a), uint8_t(b), uint8_t(ok ? 1 : 0), mask};
+        }
+    }
+};
+inline constexpr DecodeTable DECODE_TABLE{};
+
+// ถอดคำสั่งแบบเดียวกับ simulator (ไม่สนบิตที่ไม่ได้ใช้)
+inline DecodedInstr decodeWord(int32_t word) {
+    uint32_t w = uint32_t(word);
+    const DecodeEntry &d = DECODE_TABLE.e[(w >> REGB_SHIFT) & 0x1FF];
+    return DecodedInstr{d.opcode, d.regA, d.regB, uint8_t(w & 0x7), signExtend16(w)};
+}
+
+// true ถ้า word นี้ pack กลับจาก DecodedInstr ได้ค่าเดิมทุกบิต (ใช้แยก code/data ตอน disassemble)
+inline bool isCanonicalWord(int32_t word) {
+    uint32_t w = uint32_t(word);
+    const DecodeEntry &d = DECODE_TABLE.e[(w >> REGB_SHIFT) & 0x1FF];
+    return (w & 0xFE000000u) == 0 && d.canonical && (w & d.zeroMask) == 0;
+}
+
+// -------------------- หา code จาก image --------------------
+// target ของ jalr ที่ pc หาจากรูปแบบ "lw 0 rs k ... jalr rs x" ในเส้นทางตรงก่อนหน้า
+// เส้นทางหยุดที่ joinPoint (จุดที่กระโดดเข้ามาได้) เพราะค่าใน rs อาจมาจากทางอื่นที่ไม่ผ่าน lw นั้น
+// คืน -1 ถ้าหาไม่ได้ ptrAddr = address ของ .fill ที่เก็บ target
+inline long findJalrTarget(const std::vector<int32_t> &words, const std::vector<uint8_t> &joinPoint,
+                           long pc, long &ptrAddr) {
+    const long n = (long)words.size();
+    const int rs = decodeWord(words[pc]).regA;
+    for (long q = pc - 1, steps = 0; q >= 0 && steps < 32; --q, ++steps) {
+        if (joinPoint[q + 1]) return -1;
+        const DecodedInstr d = decodeWord(words[q]);
+        if (d.opcode == OPC_BEQ || d.opcode == OPC_JALR || d.opcode == OPC_HALT) return -1;
+        if ((d.opcode == OPC_ADD || d.opcode == OPC_NAND) && d.dest == rs) return -1;
+        if (d.opcode == OPC_LW && d.regB == rs) {
+            if (d.regA != 0 || d.imm < 0 || d.imm >= n) return -1;
+            ptrAddr = d.imm;
+            const long target = words[d.imm];
+            return (target >= 0 && target < n) ? target : -1;
+        }
+    }
+    return -1;
+}
+
+struct CodeScan {
+    std::vector<uint8_t> isCode;     // 1 = ไปถึงได้จาก PC 0
+    std::vector<uint8_t> leader;     // 1 = ต้นของ basic block: 0, target ของ beq/jalr, คำสั่งถัดจาก beq/jalr/halt
+    std::vector<uint8_t> joinPoint;  // ชุดที่ใช้หยุด findJalrTarget (ครอบ leader) — ส่งให้ findJalrTarget ต่อได้เลย
+};
+
+// reachability จาก PC 0:
+//   beq → target และ PC+1 (beq r r ไปแค่ target), halt → หยุด
+//   jalr a b (a != b) → target ที่หาได้ และ PC+1 ถ้า b != 0 (จุดที่ callee return กลับมา)
+//   jalr a 0 = return / indirect jump ไม่กลับมาที่ PC+1, jalr a a = ไป PC+1 เสมอ
+// leader ที่เพิ่งเจอทำให้ target ของ jalr ที่หาไว้แล้วอาจผิด → เดินใหม่ด้วย joinPoint ที่โตขึ้นจนไม่เปลี่ยน
+// (ปกติ 2 รอบ ทุกรอบเชิงเส้นตามจำนวน word)
+inline CodeScan scanCode(const std::vector<int32_t> &words) {
+    const long n = (long)words.size();
+    auto inRange = [n](long a) { return a >= 0 && a < n; };
+    CodeScan c;
+    c.isCode.assign(n, 0);
+    c.leader.assign(n, 0);
+    c.joinPoint.assign(n, 0);
+    for (bool grew = true; grew;) {
+        std::fill(c.isCode.begin(), c.isCode.end(), 0);
+        std::fill(c.leader.begin(), c.leader.end(), 0);
+        std::vector<long> work;
+        if (n > 0) { work.push_back(0); c.leader[0] = 1; }
+        while (!work.empty()) {
+            long pc = work.back();
+            work.pop_back();
+            // เดินตรงไปเรื่อย ๆ จนกว่าจะเจอ word ที่เคยเดินแล้ว หรือคำสั่งที่ไม่ fall through
+            while (inRange(pc) && !c.isCode[pc]) {
+                c.isCode[pc] = 1;
+                const DecodedInstr d = decodeWord(words[pc]);
+                if (d.opcode == OPC_HALT) {
+                    if (inRange(pc + 1)) c.leader[pc + 1] = 1;
+                    break;
+                }
+                if (d.opcode == OPC_BEQ) {
+                    const long t = pc + 1 + d.imm;
+                    if (inRange(t)) { c.leader[t] = 1; work.push_back(t); }
+                    if (inRange(pc + 1)) c.leader[pc + 1] = 1;
+                    if (d.regA == d.regB) break;
+                } else if (d.opcode == OPC_JALR && d.regA != d.regB) {
+                    if (inRange(pc + 1)) c.leader[pc + 1] = 1;
+                    long ptr = -1;
+                    const long t = findJalrTarget(words, c.joinPoint, pc, ptr);
+                    if (t >= 0) { c.leader[t] = 1; work.push_back(t); }
+                    if (d.regB == 0) break;
+                }
+                ++pc;
+            }
+        }
+        grew = false;
+        for (long a = 0; a < n; ++a)
+            if (c.leader[a] && !c.joinPoint[a]) { c.joinPoint[a] = 1; grew = true; }
+    }
+    return c;
+}
+
+#endif
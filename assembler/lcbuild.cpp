@@ -0,0 +1,161 @@
+// lcbuild.cpp
+// parser + assembler ในคำสั่งเดียว (.asm → program.ir, program_symbols.txt, .mc) ผ่าน build cache (buildcache.h)
+// ไฟล์ต้นฉบับที่เคยประกอบแล้ว (byte เดียวกัน option เดียวกัน) เอาผลจาก cache เลย ไม่ parse/assemble ใหม่
+// ใช้กับงาน batch ที่ไฟล์ซ้ำกันเยอะ (งานนักศึกษาหลายพันไฟล์, โปรแกรมที่ generate ออกมา) รันหลาย process พร้อมกันได้
+//
+// Compile : g++ -std=c++17 -O2 -DPARSER_NO_MAIN -DASSEMBLER_NO_MAIN lcbuild.cpp buildcache.cpp parser.cpp assembler.cpp -o lcbuild
+// Run : .\lcbuild ..\programs\factorial.asm   (ได้ program.ir, program_symbols.txt, machineCode.mc เหมือน parser + assembler)
+//       .\lcbuild --cache D:\lccache ..\programs\*.asm   (หลายไฟล์: เขียนผลข้างไฟล์ต้นฉบับ <ชื่อ>.ir/_symbols.txt/.mc)
+
+#include "assembler.h"
+#include "buildcache.h"
+#include "parser.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <optional>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace std;
+namespace fs = std::filesystem;
+
+// เวอร์ชันใน cache key: เลขเวอร์ชัน + เวลาคอมไพล์ (คอมไพล์ parser/assembler ใหม่เมื่อไหร่ entry เก่าก็ไม่ถูกใช้)
+static const string TOOL_VERSION = string("lcbuild 1 ") + __DATE__ + " " + __TIME__;
+
+struct Outputs {
+    string ir, symbols, mc;
+};
+
+static string readBytes(const string &path) {
+    ifstream ifs(path, ios::binary);
+    if (!ifs.is_open()) throw runtime_error("cannot open file: " + path);
+    ostringstream ss;
+    ss << ifs.rdbuf();
+    return ss.str();
+}
+
+static void writeBytes(const string &path, const string &bytes) {
+    ofstream ofs(path, ios::binary);
+    if (!ofs.is_open()) throw runtime_error("cannot write file: " + path);
+    ofs.write(bytes.data(), (streamsize)bytes.size());
+    if (!ofs) throw runtime_error("write failed: " + path);
+}
+
+// ประกอบจริง: parseFile → เขียน IR/symbols → assembler อ่านกลับแล้วเขียน .mc (ทางเดียวกับ parser + assembler)
+// log ของ assembler ถูกเก็บไว้ ถ้า error ค่อยแนบข้อความไปกับ exception
+static BuildArtifacts build(const string &src, const Outputs &out, bool countBlankLines, const string &commentChars) {
+    Parser prog;
+    prog.parseFile(src, countBlankLines, commentChars);
+    prog.writeIRFile(out.ir);
+    prog.writeSymbolsFile(out.symbols);
+
+    ostringstream log, errors;
+    streambuf *oldOut = cout.rdbuf(log.rdbuf());
+    streambuf *oldErr = cerr.rdbuf(errors.rdbuf());
+    int code = 1;
+    auto irs = loadIR(out.ir);
+    if (!irs.empty()) code = assembleProgram(loadSymbolTable(out.symbols), irs, out.mc);
+    cout.rdbuf(oldOut);
+    cerr.rdbuf(oldErr);
+    if (code != 0) {
+        string msg = errors.str();
+        while (!msg.empty() && msg.back() == '\n') msg.pop_back();
+        throw runtime_error("assemble failed:\n" + msg);
+    }
+
+    // ไฟล์ที่ .include เข้ามาเก็บเป็น dep (path เทียบกับโฟลเดอร์ต้นฉบับ ต้นฉบับเดียวกันที่อื่นจึงหา include ของตัวเอง)
+    BuildArtifacts art{{}, readBytes(out.ir), readBytes(out.symbols), readBytes(out.mc)};
+    const fs::path base = fs::weakly_canonical(fs::absolute(src)).parent_path();
+    for (const string &inc : prog.getIncludes()) {
+        fs::path rel = fs::path(inc).lexically_relative(base);
+        art.deps.push_back({hashFileBytes(inc), (rel.empty() ? fs::path(inc) : rel).generic_string()});
+    }
+    return art;
+}
+
+static Outputs outputsNextTo(const string &src) {
+    size_t slash = src.find_last_of("/\\");
+    size_t dot = src.find_last_of('.');
+    string base = (dot == string::npos || (slash != string::npos && dot < slash)) ? src : src.substr(0, dot);
+    return {base + ".ir", base + "_symbols.txt", base + ".mc"};
+}
+
+static void usage(const char *prog) {
+    cerr << "usage: " << prog << " [options] <file.asm>...\n"
+         << "  -o out.mc          ไฟล์ machine code (ไฟล์เดียว ค่าเริ่มต้น machineCode.mc)\n"
+         << "  --ir F             ไฟล์ IR (ไฟล์เดียว ค่าเริ่มต้น program.ir)\n"
+         << "  --symbols F        ไฟล์ symbol table (ไฟล์เดียว ค่าเริ่มต้น program_symbols.txt)\n"
+         << "  --cache DIR        ไดเรกทอรี cache (ค่าเริ่มต้น $LCCACHE_DIR หรือ .lccache)\n"
+         << "  --cache-size MB    ขนาด cache สูงสุดก่อน evict (ค่าเริ่มต้น 256)\n"
+         << "  --no-cache         ประกอบใหม่เสมอและไม่เขียน cache\n"
+         << "  --blank-lines      นับบรรทัดว่างเป็น address (countBlankLines)\n"
+         << "  --comments CHARS   ตัวอักษรที่ขึ้นต้น comment (ค่าเริ่มต้น \"#;\")\n";
+}
+
+int main(int argc, char **argv) {
+    vector<string> inputs;
+    Outputs single{"program.ir", "program_symbols.txt", "machineCode.mc"};
+    bool namedOutput = false, useCache = true, countBlankLines = false;
+    string commentChars = "#;";
+    const char *envDir = getenv("LCCACHE_DIR");
+    string cacheDir = envDir && *envDir ? envDir : ".lccache";
+    long long cacheMB = 256;
+    try {
+        for (int i = 1; i < argc; ++i) {
+            string a = argv[i];
+            bool hasArg = i + 1 < argc;
+            if (a == "-o" && hasArg) { single.mc = argv[++i]; namedOutput = true; }
+            else if (a == "--ir" && hasArg) { single.ir = argv[++i]; namedOutput = true; }
+            else if (a == "--symbols" && hasArg) { single.symbols = argv[++i]; namedOutput = true; }
+            else if (a == "--cache" && hasArg) cacheDir = argv[++i];
+            else if (a == "--cache-size" && hasArg) cacheMB = stoll(argv[++i]);
+            else if (a == "--no-cache") useCache = false;
+            else if (a == "--blank-lines") countBlankLines = true;
+            else if (a == "--comments" && hasArg) commentChars = argv[++i];
+            else if (!a.empty() && a[0] == '-') { usage(argv[0]); return 1; }
+            else inputs.push_back(a);
+        }
+        if (inputs.empty() || (namedOutput && inputs.size() > 1)) { usage(argv[0]); return 1; }
+        if (cacheMB < 1) throw runtime_error("--cache-size must be >= 1");
+
+        auto t0 = chrono::steady_clock::now();
+        optional<BuildCache> cache;
+        if (useCache) cache.emplace(cacheDir, uint64_t(cacheMB) << 20);
+
+        int hits = 0, misses = 0;
+        for (const string &src : inputs) {
+            Outputs out = inputs.size() == 1 ? single : outputsNextTo(src);
+            string source = readBytes(src);
+            CacheKey key = makeCacheKey(source, countBlankLines, commentChars, TOOL_VERSION);
+            BuildArtifacts art;
+            if (cache && cache->lookup(key, art, fs::absolute(src).parent_path().string())) {
+                writeBytes(out.ir, art.ir);
+                writeBytes(out.symbols, art.symbols);
+                writeBytes(out.mc, art.machineCode);
+                cout << src << ": cache hit " << key.hex() << " -> " << out.mc << "\n";
+                hits++;
+                continue;
+            }
+            try {
+                art = build(src, out, countBlankLines, commentChars);
+            } catch (const exception &e) {
+                throw runtime_error(src + ": " + e.what());
+            }
+            if (cache) cache->store(key, art);
+            cout << src << ": assembled" << (cache ? ", stored " + key.hex() : "") << " -> " << out.mc << "\n";
+            misses++;
+        }
+        cout << hits << " cache hit(s), " << misses << " assembled in "
+             << chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count() << " ms\n";
+    } catch (const exception &e) {
+        cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,221 @@
+// lcrtbench.cpp
+// วัดจำนวนคำสั่งที่ execute ต่อการเรียก routine ใน programs/lib/lcrt.asm บนเครื่องจำลอง (LcSim ของ Simulator/lc_sim.h)
+// ลิงก์ harness (programs/lib/lcrtbench.asm) + ไลบรารีครั้งเดียว แล้วแก้ค่า argA/argB/argC/target ใน image
+// ก่อนรันแต่ละครั้ง ทุกผลลัพธ์ถูกตรวจกับค่าที่คำนวณใน C++ (ผิดแม้ครั้งเดียว → exit 1)
+// จำนวนคำสั่งที่รายงาน = คำสั่งที่ execute ทั้งหมด - 6 คำสั่งของ harness (lw x4, jalr, halt) คือนับตั้งแต่
+// คำสั่งแรกของ routine จนถึง jalr ที่ return
+//
+// Compile : g++ -std=c++17 -O2 -DPARSER_NO_MAIN lcrtbench.cpp parser.cpp ir_utils.cpp -o lcrtbench
+// Run : .\lcrtbench   หรือ   .\lcrtbench --samples 1000 --seed 7 ..\programs\lib\lcrt.asm ..\programs\lib\lcrtbench.asm
+
+#include "ir_utils.h"
+#include "parser.h"
+#include "../Simulator/lc_sim.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+
+static const int HARNESS_INSTRS = 6;
+static const int32_t SRC_BUF = 40000;   // buffer ของ memcpy (อยู่นอก image)
+static const int32_t DST_BUF = 50000;
+
+// LcSim ต้องมีที่เขียน output แต่ไม่ trace และ quiet จึงไม่มีอะไรถูกเขียนจริง
+static OutBuffer simOut(stdout);
+
+struct Bench {
+    vector<int32_t> image;
+    unordered_map<string, int> addr;
+
+    int at(const string &label) const {
+        auto it = addr.find(label);
+        if (it == addr.end()) throw runtime_error("label '" + label + "' not found in linked program");
+        return it->second;
+    }
+
+    // เรียก routine หนึ่งครั้ง คืนเครื่องหลังรัน (prep ใช้เตรียมหน่วยความจำเพิ่มเติม)
+    LcSim call(const string &routine, int32_t a, int32_t b, int32_t c,
+               const function<void(LcSim &)> &prep = nullptr) const {
+        vector<int32_t> img = image;
+        img[at("argA")] = a;
+        img[at("argB")] = b;
+        img[at("argC")] = c;
+        img[at("target")] = at(routine);
+        LcSim m(simOut);
+        m.quiet = true;
+        m.load(img);
+        if (prep) prep(m);
+        if (m.run<false>() != LcSim::Stop::HALT)
+            throw runtime_error(routine + "(" + to_string(a) + ", " + to_string(b) + ", " + to_string(c) +
+                                ") did not halt");
+        return m;
+    }
+};
+
+struct RangeStats {
+    string routine, range;
+    long calls = 0, minI = -1, maxI = 0, sum = 0;
+    void add(long n) {
+        calls++;
+        sum += n;
+        if (minI < 0 || n < minI) minI = n;
+        maxI = max(maxI, n);
+    }
+};
+
+static void check(bool ok, const string &what) {
+    if (!ok) throw runtime_error("wrong result: " + what);
+}
+
+int main(int argc, char **argv) {
+    string libPath = "../programs/lib/lcrt.asm";
+    string harnessPath = "../programs/lib/lcrtbench.asm";
+    int samples = 200;
+    unsigned seed = 1;
+    vector<string> files;
+    try {
+        for (int i = 1; i < argc; ++i) {
+            string a = argv[i];
+            if (a == "--samples" && i + 1 < argc) samples = stoi(argv[++i]);
+            else if (a == "--seed" && i + 1 < argc) seed = (unsigned)stoul(argv[++i]);
+            else if (!a.empty() && a[0] == '-') {
+                cerr << "usage: " << argv[0] << " [--samples N] [--seed S] [lcrt.asm [harness.asm]]\n";
+                return 1;
+            } else files.push_back(a);
+        }
+    } catch (const exception &e) {
+        cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+    if (files.size() >= 1) libPath = files[0];
+    if (files.size() >= 2) harnessPath = files[1];
+
+    try {
+        // harness ต้องมาก่อน (เริ่มที่ address 0) แล้วตามด้วยไลบรารี
+        Parser prog;
+        prog.parseFiles({harnessPath, libPath});
+        Bench bench;
+        bench.image = encodeIR(prog.getIR());
+        for (const auto &s : prog.getSymbols()) bench.addr[s.name] = s.address;
+
+        mt19937 rng(seed);
+        auto rnd = [&](uint32_t lo, uint32_t hi) {   // [lo, hi] แบบไม่คิดเครื่องหมาย
+            return uint32_t(uniform_int_distribution<uint64_t>(lo, hi)(rng));
+        };
+        vector<RangeStats> table;
+        auto range = [&](const string &routine, const string &text) -> RangeStats & {
+            table.push_back({routine, text});
+            return table.back();
+        };
+        auto steps = [](const LcSim &m) { return m.executed - HARNESS_INSTRS; };
+
+        // mul: จำนวนรอบขึ้นกับบิตสูงสุดของ r2
+        struct { const char *text; uint32_t lo, hi; } mulRanges[] = {
+            {"r2 in 0..15", 0, 15}, {"r2 in 0..255", 0, 255}, {"r2 in 0..65535", 0, 65535},
+            {"r2 in 0..2^31-1", 0, 0x7FFFFFFFu}, {"r2 < 0", 0x80000000u, 0xFFFFFFFFu},
+        };
+        for (auto &r : mulRanges) {
+            RangeStats &st = range("mul", r.text);
+            for (int i = 0; i < samples; ++i) {
+                int32_t a = int32_t(rnd(0, 0xFFFFFFFFu)), b = int32_t(rnd(r.lo, r.hi));
+                LcSim m = bench.call("mul", a, b, 0);
+                check(m.regs[3] == int32_t(uint32_t(a) * uint32_t(b)) && m.regs[1] == a && m.regs[2] == b,
+                      "mul(" + to_string(a) + ", " + to_string(b) + ") = " + to_string(m.regs[3]));
+                st.add(steps(m));
+            }
+        }
+
+        // div: ตัวตั้งไม่คิดเครื่องหมาย, ตัวหาร 0..2^31-1
+        struct { const char *text; uint32_t nlo, nhi, dlo, dhi; } divRanges[] = {
+            {"r1 < 2^8,  r2 in 1..15", 0, 255, 1, 15},
+            {"r1 < 2^16, r2 in 1..255", 0, 65535, 1, 255},
+            {"r1 < 2^32, r2 in 1..65535", 0, 0xFFFFFFFFu, 1, 65535},
+            {"r1 < 2^32, r2 < 2^31", 0, 0xFFFFFFFFu, 1, 0x7FFFFFFFu},
+            {"r2 = 0", 0, 0xFFFFFFFFu, 0, 0},
+        };
+        for (auto &r : divRanges) {
+            RangeStats &st = range("div", r.text);
+            for (int i = 0; i < samples; ++i) {
+                uint32_t n = rnd(r.nlo, r.nhi), d = rnd(r.dlo, r.dhi);
+                LcSim m = bench.call("div", int32_t(n), int32_t(d), 0);
+                uint32_t q = d ? n / d : 0xFFFFFFFFu, rem = d ? n % d : n;
+                check(uint32_t(m.regs[3]) == q && uint32_t(m.regs[4]) == rem &&
+                      m.regs[1] == int32_t(n) && m.regs[2] == int32_t(d),
+                      "div(" + to_string(n) + ", " + to_string(d) + ") = " + to_string(uint32_t(m.regs[3])) +
+                      " rem " + to_string(uint32_t(m.regs[4])));
+                st.add(steps(m));
+            }
+        }
+
+        // srl: ตามจำนวนบิตที่เลื่อน (ยิ่งเลื่อนมาก บิตที่ต้องย้ายยิ่งน้อย)
+        for (int lo = 0; lo < 32; lo += 8) {
+            RangeStats &st = range("srl", "r2 in " + to_string(lo) + ".." + to_string(lo + 7));
+            for (int i = 0; i < samples; ++i) {
+                uint32_t v = rnd(0, 0xFFFFFFFFu), s = rnd(lo, lo + 7);
+                LcSim m = bench.call("srl", int32_t(v), int32_t(s), 0);
+                check(uint32_t(m.regs[3]) == (v >> s) && m.regs[1] == int32_t(v),
+                      "srl(" + to_string(v) + ", " + to_string(s) + ") = " + to_string(uint32_t(m.regs[3])));
+                st.add(steps(m));
+            }
+        }
+
+        // cmp
+        struct { const char *text; int kind; } cmpRanges[] = {
+            {"random pairs", 0}, {"same sign", 1}, {"equal", 2},
+        };
+        for (auto &r : cmpRanges) {
+            RangeStats &st = range("cmp", r.text);
+            for (int i = 0; i < samples; ++i) {
+                int32_t a = int32_t(rnd(0, 0xFFFFFFFFu)), b = int32_t(rnd(0, 0xFFFFFFFFu));
+                if (r.kind == 1) b = (a < 0) ? int32_t(b | 0x80000000u) : int32_t(b & 0x7FFFFFFFu);
+                if (r.kind == 2) b = a;
+                LcSim m = bench.call("cmp", a, b, 0);
+                check(m.regs[3] == (a < b ? -1 : a == b ? 0 : 1),
+                      "cmp(" + to_string(a) + ", " + to_string(b) + ") = " + to_string(m.regs[3]));
+                st.add(steps(m));
+            }
+        }
+
+        // memcpy: buffer อยู่นอก image
+        struct { const char *text; uint32_t lo, hi; } cpyRanges[] = {
+            {"r3 in 0..3", 0, 3}, {"r3 in 4..63", 4, 63}, {"r3 in 64..1024", 64, 1024},
+        };
+        for (auto &r : cpyRanges) {
+            RangeStats &st = range("memcpy", r.text);
+            for (int i = 0; i < samples; ++i) {
+                int32_t n = int32_t(rnd(r.lo, r.hi));
+                vector<int32_t> data(n);
+                for (auto &w : data) w = int32_t(rnd(0, 0xFFFFFFFFu));
+                LcSim m = bench.call("memcpy", SRC_BUF, DST_BUF, n, [&](LcSim &mm) {
+                    copy(data.begin(), data.end(), mm.mem.begin() + SRC_BUF);
+                });
+                bool ok = equal(data.begin(), data.end(), m.mem.begin() + DST_BUF) && m.mem[DST_BUF + n] == 0 &&
+                          m.regs[1] == SRC_BUF + n && m.regs[2] == DST_BUF + n && m.regs[3] == 0;
+                check(ok, "memcpy of " + to_string(n) + " word(s)");
+                st.add(steps(m));
+            }
+        }
+
+        cout << left << setw(8) << "routine" << setw(28) << "inputs" << right << setw(8) << "calls"
+             << setw(8) << "min" << setw(10) << "avg" << setw(8) << "max" << "\n";
+        for (const auto &st : table) {
+            cout << left << setw(8) << st.routine << setw(28) << st.range << right << setw(8) << st.calls
+                 << setw(8) << st.minI << setw(10) << fixed << setprecision(1) << double(st.sum) / st.calls
+                 << setw(8) << st.maxI << "\n";
+        }
+        cout << "\nall " << table.size() << " input range(s) verified against reference results\n";
+    } catch (const exception &e) {
+        cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,192 @@
+// linker.cpp
+// รวม relocatable object (.o จาก objasm, ดู objfile.h) เป็นไฟล์ machine code (.mc) ไฟล์เดียว
+//   1) วาง section: code ของทุก object ตามลำดับบน command line (object แรกเริ่มที่ PC 0) แล้วตามด้วย data
+//   2) สร้าง symbol table รวมจาก export (ชื่อซ้ำ → error) แล้วเช็คว่า import ทุกตัวมีคน export
+//   3) แก้ field ตาม relocation แบ่งให้หลาย thread ทำพร้อมกัน (แต่ละ relocation เขียนคนละ word จึงไม่ชนกัน)
+//   4) เขียน .mc รูปแบบเดียวกับ assembler (.space ยังเป็น record "*N value") และ symbol table ถ้าขอ
+//
+// Compile : g++ -std=c++17 -O2 -pthread -DPARSER_NO_MAIN linker.cpp objfile.cpp parser.cpp ir_utils.cpp -o linker
+// Run : .\linker ..\programs\mullib.o ..\programs\lib\lcrt.o -o machineCode.mc   (--symbols F, --threads N)
+
+#include "objfile.h"
+#include "lc_isa.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+
+// relocation ที่ต่ำกว่านี้ทำ thread เดียว (สร้าง thread แพงกว่างาน)
+static const size_t PARALLEL_MIN_RELOCS = 4096;
+
+struct LinkResult {
+    SparseImage image;
+    vector<Label> symbols;
+    int32_t codeWords = 0;
+    size_t relocs = 0;
+    int threads = 1;
+};
+
+static LinkResult link(const vector<ObjectFile> &objs, const vector<string> &names, int threads) {
+    LinkResult res;
+    const size_t n = objs.size();
+
+    // 1) base address ของแต่ละ section
+    vector<array<int32_t, 2>> base(n);
+    long at = 0;
+    for (int s = 0; s < 2; ++s) {
+        if (s == SEC_DATA) res.codeWords = int32_t(at);
+        for (size_t o = 0; o < n; ++o) {
+            base[o][s] = int32_t(at);
+            at += objs[o].sections[s].size;
+        }
+    }
+    if (at > SparseImage::MAX_WORDS)
+        throw runtime_error("linked image has " + to_string(at) + " words (limit " +
+                            to_string(SparseImage::MAX_WORDS) + ")");
+    for (int s = 0; s < 2; ++s)
+        for (size_t o = 0; o < n; ++o)
+            for (const auto &seg : objs[o].sections[s].segments) {
+                ImageSegment copy = seg;
+                copy.start += base[o][s];
+                res.image.segments.push_back(move(copy));
+            }
+    res.image.size = int32_t(at);
+
+    // 2) symbol table รวม
+    unordered_map<string, pair<int32_t, size_t>> table;   // ชื่อ → (address, object ที่ export)
+    for (size_t o = 0; o < n; ++o)
+        for (const auto &e : objs[o].exports) {
+            int32_t addr = base[o][e.section] + e.offset;
+            auto ins = table.insert({e.name, {addr, o}});
+            if (!ins.second)
+                throw runtime_error("duplicate symbol '" + e.name + "' in " + names[ins.first->second.second] +
+                                    " and " + names[o]);
+            res.symbols.push_back({e.name, addr});
+        }
+    string undefined;
+    for (size_t o = 0; o < n; ++o)
+        for (const auto &name : objs[o].imports)
+            if (!table.count(name)) undefined += (undefined.empty() ? "" : ", ") + name + " (" + names[o] + ")";
+    if (!undefined.empty()) throw runtime_error("undefined symbol(s): " + undefined);
+
+    // 3) relocation
+    vector<pair<size_t, size_t>> work;   // (object, relocation)
+    for (size_t o = 0; o < n; ++o)
+        for (size_t r = 0; r < objs[o].relocs.size(); ++r) work.push_back({o, r});
+    res.relocs = work.size();
+    vector<ImageSegment> &segs = res.image.segments;
+    auto segmentAt = [&](int32_t addr) -> ImageSegment & {
+        auto it = upper_bound(segs.begin(), segs.end(), addr,
+                              [](int32_t a, const ImageSegment &s) { return a < s.start; });
+        return *(it - 1);
+    };
+    mutex errMutex;
+    string firstError;
+    auto apply = [&](size_t k) {
+        const ObjectFile &obj = objs[work[k].first];
+        const ObjReloc &r = obj.relocs[work[k].second];
+        int32_t where = base[work[k].first][r.section] + r.offset;
+        long long value = r.symbol.empty() ? base[work[k].first][r.targetSection] + r.targetOffset
+                                           : table.at(r.symbol).first;
+        auto fail = [&](const string &why) {
+            lock_guard<mutex> lock(errMutex);
+            if (firstError.empty())
+                firstError = names[work[k].first] + ": " + why + " at address " + to_string(where);
+        };
+        ImageSegment &seg = segmentAt(where);
+        if (r.kind == RelocKind::WORD) {
+            if (!seg.run) seg.words[where - seg.start] = int32_t(value);
+            else if (seg.start == where) seg.value = int32_t(value);
+            else fail("relocation inside a .space region");
+            return;
+        }
+        if (seg.run) { fail("instruction relocation on a .space region"); return; }
+        if (r.kind == RelocKind::BEQ) value -= where + 1;
+        if (value < -32768 || value > 32767) {
+            fail(string(r.kind == RelocKind::BEQ ? "beq offset" : "address") + " " + to_string(value) +
+                 " out of 16-bit range" + (r.symbol.empty() ? "" : " for '" + r.symbol + "'"));
+            return;
+        }
+        int32_t &w = seg.words[where - seg.start];
+        w = int32_t((uint32_t(w) & ~0xFFFFu) | (uint32_t(value) & 0xFFFFu));
+    };
+    res.threads = work.size() < PARALLEL_MIN_RELOCS ? 1 : max(1, threads);
+    if (res.threads == 1) {
+        for (size_t k = 0; k < work.size(); ++k) apply(k);
+    } else {
+        atomic<size_t> next{0};
+        const size_t chunk = 1024;
+        vector<thread> pool;
+        for (int t = 0; t < res.threads; ++t)
+            pool.emplace_back([&] {
+                for (size_t b; (b = next.fetch_add(chunk)) < work.size();)
+                    for (size_t k = b; k < min(work.size(), b + chunk); ++k) apply(k);
+            });
+        for (auto &th : pool) th.join();
+    }
+    if (!firstError.empty()) throw runtime_error(firstError);
+    return res;
+}
+
+static void usage(const char *prog) {
+    cerr << "usage: " << prog << " [-o out.mc] [--symbols file] [--threads N] <file.o>...\n";
+}
+
+int main(int argc, char **argv) {
+    vector<string> inputs;
+    string outPath = "machineCode.mc", symPath;
+    int threads = max(1u, thread::hardware_concurrency());
+    try {
+        for (int i = 1; i < argc; ++i) {
+            string a = argv[i];
+            if (a == "-o" && i + 1 < argc) outPath = argv[++i];
+            else if (a == "--symbols" && i + 1 < argc) symPath = argv[++i];
+            else if (a == "--threads" && i + 1 < argc) threads = stoi(argv[++i]);
+            else if (!a.empty() && a[0] == '-') { usage(argv[0]); return 1; }
+            else inputs.push_back(a);
+        }
+        if (inputs.empty()) { usage(argv[0]); return 1; }
+        if (threads < 1) throw runtime_error("--threads must be >= 1");
+
+        auto t0 = chrono::steady_clock::now();
+        vector<ObjectFile> objs;
+        for (const string &f : inputs) objs.push_back(ObjectFile::load(f));
+        auto t1 = chrono::steady_clock::now();
+        LinkResult res = link(objs, inputs, threads);
+        auto t2 = chrono::steady_clock::now();
+
+        ofstream ofs(outPath, ios::binary);
+        if (!ofs.is_open()) throw runtime_error("cannot write output file: " + outPath);
+        writeImageRecords(ofs, res.image);
+        if (!ofs) throw runtime_error("write failed: " + outPath);
+        if (!symPath.empty()) {
+            ofstream sym(symPath);
+            if (!sym.is_open()) throw runtime_error("cannot write symbols file: " + symPath);
+            sym << left << setw(10) << "LabelName" << setw(10) << "Address" << "\n";
+            for (const auto &s : res.symbols) sym << setw(10) << s.name << setw(10) << s.address << "\n";
+        }
+
+        cout << "linked " << objs.size() << " object(s): " << res.image.size << " word(s) (code " << res.codeWords
+             << ", data " << res.image.size - res.codeWords << "), " << res.symbols.size() << " symbol(s), "
+             << res.relocs << " relocation(s)\n";
+        cout << "time: load " << chrono::duration<double, milli>(t1 - t0).count() << " ms, link "
+             << chrono::duration<double, milli>(t2 - t1).count() << " ms using " << res.threads << " thread(s)\n";
+        cout << "Output written to: " << outPath << "\n";
+    } catch (const exception &e) {
+        cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
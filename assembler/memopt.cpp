@@ -0,0 +1,692 @@
+// memopt.cpp — ดูคำอธิบายใน memopt.h
+
+#include "memopt.h"
+#include "cfg.h"
+#include "ir_utils.h"
+#include "lc_isa.h"
+
+#include <algorithm>
+#include <map>
+#include <tuple>
+#include <vector>
+
+using namespace std;
+
+namespace {
+
+// register ที่คำสั่งเขียน (-1 ถ้าไม่มี) — jalr a a ก็เขียน a = PC+1 เหมือน simulator
+int writtenReg(const DecodedInstr &d) {
+    switch (d.opcode) {
+        case OPC_ADD: case OPC_NAND: return d.dest ? d.dest : -1;
+        case OPC_LW: case OPC_JALR: return d.regB ? d.regB : -1;
+        default: return -1;
+    }
+}
+
+struct SpState {
+    bool known = false;
+    int base = 0;          // 0 = ค่า SP ตอนเข้า procedure, q+1 = ค่าที่โหลดโดยคำสั่งที่ address q
+    int32_t delta = 0;
+    bool operator==(const SpState &o) const {
+        return known == o.known && (!known || (base == o.base && delta == o.delta));
+    }
+};
+
+struct RegState {
+    bool top = true;       // ยังไม่มีเส้นทางใดเข้ามา
+    uint8_t known = 1;     // bit r = รู้ค่าคงที่ของ r (r0 รู้เสมอ)
+    int32_t val[8] = {0};
+    SpState sp;
+};
+
+bool meetInto(RegState &dst, const RegState &src) {
+    if (src.top) return false;
+    if (dst.top) { dst = src; return true; }
+    bool changed = false;
+    for (int r = 1; r < 8; ++r) {
+        if (!(dst.known >> r & 1)) continue;
+        if (!(src.known >> r & 1) || src.val[r] != dst.val[r]) { dst.known &= uint8_t(~(1 << r)); changed = true; }
+    }
+    if (!(dst.sp == src.sp)) {
+        if (dst.sp.known) changed = true;
+        dst.sp.known = false;
+    }
+    return changed;
+}
+
+// ช่องหน่วยความจำ: ABS = address ใน image (ฐาน r0), SLOT = ช่อง stack (ฐาน SP, offset)
+struct MemKey {
+    enum Kind : uint8_t { ABS = 1, SLOT = 2 } kind;
+    int base;
+    int32_t off;
+};
+
+struct AvailState {
+    bool top = true;
+    vector<pair<int,int>> slots;   // (key, register ที่เก็บค่าเดียวกัน) เรียงตาม key
+    int find(int key) const {
+        auto it = lower_bound(slots.begin(), slots.end(), make_pair(key, -1));
+        return (it != slots.end() && it->first == key) ? it->second : -1;
+    }
+    void set(int key, int reg) {
+        auto it = lower_bound(slots.begin(), slots.end(), make_pair(key, -1));
+        if (it != slots.end() && it->first == key) it->second = reg;
+        else slots.insert(it, {key, reg});
+    }
+    template <class Pred> void eraseIf(Pred p) {
+        slots.erase(remove_if(slots.begin(), slots.end(), p), slots.end());
+    }
+};
+
+bool meetInto(AvailState &dst, const AvailState &src) {
+    if (src.top) return false;
+    if (dst.top) { dst = src; return true; }
+    size_t before = dst.slots.size();
+    dst.eraseIf([&](const pair<int,int> &e) { return src.find(e.first) != e.second; });
+    return dst.slots.size() != before;
+}
+
+struct LiveSet {
+    bool all = false;
+    vector<uint64_t> bits;
+    bool test(int k) const { return all || (bits[k >> 6] >> (k & 63) & 1); }
+    void set(int k) { bits[k >> 6] |= uint64_t(1) << (k & 63); }
+    void reset(int k) { bits[k >> 6] &= ~(uint64_t(1) << (k & 63)); }
+    void unite(const LiveSet &o) {
+        all = all || o.all;
+        for (size_t i = 0; i < bits.size(); ++i) bits[i] |= o.bits[i];
+    }
+    bool operator==(const LiveSet &o) const { return all == o.all && (all || bits == o.bits); }
+};
+
+struct ProcSummary {
+    uint8_t writes = 0;        // register ที่อาจถูกเขียน (รวม callee ของมัน) ไม่นับ SP
+    bool spBalanced = true;    // SP ตอน return เท่ากับตอนเข้า
+    bool frameSafe = true;     // ไม่เขียนต่ำกว่า SP ตอนเข้า และไม่มี sw ที่ไม่รู้ address
+    bool absStores = false;    // มี sw ฐาน r0
+    bool entryAll = false;     // liveness ตอนเข้า: อาจอ่านช่องใดก็ได้
+    vector<int32_t> entryLive; // offset (ฐาน 0) ที่ถูกอ่านก่อนเขียนหลังเข้า procedure (ติดลบ = frame ของผู้เรียก)
+};
+
+class MemOpt {
+public:
+    MemOpt(vector<IRLine> &ir_, const ControlFlowGraph &g_, MemOptStats &st_)
+        : ir(ir_), g(g_), st(st_), n(g_.imageSize()), B(g_.numBlocks()), rowAt(n, -1) {
+        for (size_t i = 0; i < ir.size(); ++i) rowAt[ir[i].address] = (int)i;
+    }
+
+    // kill[i] (ตามบรรทัด IR) = 1 สำหรับ lw/sw ที่ลบได้
+    bool run(vector<char> &kill);
+
+private:
+    vector<IRLine> &ir;
+    const ControlFlowGraph &g;
+    MemOptStats &st;
+    const int n, B;
+    vector<int> rowAt;                 // address → บรรทัด IR (.space กินหลาย word จึงไม่ตรงกับ index)
+
+    int sp = -1;
+    vector<DecodedInstr> code;
+    vector<int> proc, rootIndex, calleeOf;
+    vector<ProcSummary> sum;
+    vector<char> constAddr;            // address ที่ lw 0 X addr ได้ค่าคงที่ (.fill ที่ไม่มีใครเขียน)
+    int32_t stackFloor = 0;            // ฐาน stack ใน image ต้อง >= ค่านี้ (เหนือ code และทุก address ที่ lw/sw ฐาน r0 อ้าง)
+    bool stackInImage = false;         // มีฐาน stack ที่อยู่ใน image (.space) → ช่อง stack ปรากฏใน state สุดท้าย
+    vector<RegState> regIn;
+    vector<int> constSrc;              // lw 0 X k ที่ค่าคงที่อยู่ใน register นี้อยู่แล้ว (-1 = ไม่มี)
+    vector<char> jumpPtr;              // lw ที่โหลด target ของ jalr ใน block เดียวกัน (ห้ามแตะ)
+    vector<SpState> spBefore;          // SP ก่อนแต่ละคำสั่ง
+    vector<int> keyOf;                 // key ของ lw/sw (-1 = ไม่รู้ address)
+    vector<MemKey> keys;
+
+    void chooseStackPointer();
+    void findStackFloor();
+    void markJumpPointers();
+    void buildProcedures();
+    void transfer(int q, RegState &s) const;
+    void solveConstants();
+    void classifyAccesses();
+    void solveFrameSafety();
+    void transfer(int q, AvailState &s, vector<int> *redundant) const;
+    void findRedundantLoads(vector<int> &redundant);
+    LiveSet emptyLive() const { LiveSet l; l.bits.assign((keys.size() + 63) / 64, 0); return l; }
+    void addBelowSp(LiveSet &l, const SpState &s) const;
+    void addOtherBases(LiveSet &l, const SpState &s) const;
+    LiveSet liveOut(int b, const vector<LiveSet> &in) const;
+    LiveSet liveIn(int b, LiveSet l, vector<char> *dead) const;
+    void findDeadStores(vector<char> &dead);
+};
+
+void MemOpt::chooseStackPointer() {
+    int uses[8] = {0};
+    for (int q = 0; q < n; ++q) {
+        if (g.blockAt(q) < 0) continue;
+        const DecodedInstr &d = code[q];
+        if ((d.opcode == OPC_LW || d.opcode == OPC_SW) && d.regA != 0) uses[d.regA]++;
+    }
+    vector<int> order;
+    for (int r = 1; r < 8; ++r) if (uses[r]) order.push_back(r);
+    stable_sort(order.begin(), order.end(), [&](int a, int b) { return uses[a] > uses[b]; });
+    for (int r : order) {
+        bool ok = true;
+        for (int q = 0; q < n && ok; ++q) {
+            if (g.blockAt(q) < 0) continue;
+            const DecodedInstr &d = code[q];
+            if (writtenReg(d) != r) continue;
+            bool bump = d.opcode == OPC_ADD && (d.regA == r) != (d.regB == r);
+            bool load = d.opcode == OPC_LW && d.regA == 0;
+            ok = bump || load;
+        }
+        if (ok) { sp = r; return; }
+    }
+}
+
+// ฐาน stack ที่อยู่ใน image ได้ต้องอยู่เหนือ code และเหนือทุก address ที่ lw/sw ฐาน r0 อ้าง
+// (ช่อง ABS กับช่อง stack จึงไม่ชนกัน) ซึ่งก็คือช่วง .space ที่จองไว้ท้าย image
+void MemOpt::findStackFloor() {
+    stackFloor = 0;
+    for (int q = 0; q < n; ++q) {
+        if (g.blockAt(q) < 0) continue;
+        stackFloor = max(stackFloor, q + 1);
+        const DecodedInstr &d = code[q];
+        if ((d.opcode == OPC_LW || d.opcode == OPC_SW) && d.regA == 0 && d.imm >= 0 && d.imm < n)
+            stackFloor = max(stackFloor, d.imm + 1);
+    }
+    for (int q = 0; q < n; ++q) {
+        if (g.blockAt(q) < 0) continue;
+        const DecodedInstr &d = code[q];
+        if (d.opcode == OPC_LW && d.regA == 0 && d.regB == sp && d.imm >= 0 && d.imm < n && constAddr[d.imm] &&
+            g.word(d.imm) >= stackFloor && g.word(d.imm) < n)
+            stackInImage = true;
+    }
+}
+
+// cfg หา target ของ jalr จากรูปแบบ "lw 0 R k ... jalr R x" ใน block เดียวกัน (findJalrTarget ของ lc_isa.h)
+// ถ้า lw นั้นหายไป pass ถัดไป (หรือ memopt รอบสอง) จะเห็นเป็น call ที่ไม่รู้ target จึงคง lw นั้นไว้เสมอ
+void MemOpt::markJumpPointers() {
+    jumpPtr.assign(n, 0);
+    for (int b = 0; b < B; ++b) {
+        const BasicBlock &bb = g.block(b);
+        const DecodedInstr &j = code[bb.last];
+        if (j.opcode != OPC_JALR || j.regA == j.regB) continue;
+        for (int q = bb.last - 1; q >= bb.first; --q) {
+            if (writtenReg(code[q]) != j.regA) continue;
+            if (code[q].opcode == OPC_LW) jumpPtr[q] = 1;
+            break;
+        }
+    }
+}
+
+void MemOpt::buildProcedures() {
+    const vector<int> &roots = g.roots();
+    proc.assign(B, -1);
+    rootIndex.assign(B, -1);
+    for (size_t r = 0; r < roots.size(); ++r) rootIndex[roots[r]] = (int)r;
+    for (size_t r = 0; r < roots.size(); ++r) {
+        if (proc[roots[r]] >= 0) continue;
+        vector<int> work{roots[r]};
+        proc[roots[r]] = (int)r;
+        while (!work.empty()) {
+            int b = work.back();
+            work.pop_back();
+            for (int e = g.succBegin(b); e < g.succEnd(b); ++e) {
+                int s = g.succ(e);
+                if (g.succKind(e) == EDGE_CALL || proc[s] >= 0) continue;
+                proc[s] = (int)r;
+                work.push_back(s);
+            }
+        }
+    }
+    calleeOf.assign(B, -1);
+    for (int b = 0; b < B; ++b)
+        for (int e = g.succBegin(b); e < g.succEnd(b); ++e)
+            if (g.succKind(e) == EDGE_CALL) calleeOf[b] = rootIndex[g.succ(e)];
+
+    // register ที่แต่ละ procedure เขียน + sw ฐาน r0 (รวม callee แบบ fixpoint)
+    sum.assign(roots.size(), ProcSummary{});
+    for (int b = 0; b < B; ++b) {
+        if (proc[b] < 0) continue;
+        for (int q = g.block(b).first; q <= g.block(b).last; ++q) {
+            int w = writtenReg(code[q]);
+            if (w > 0 && w != sp) sum[proc[b]].writes |= uint8_t(1 << w);
+            if (code[q].opcode == OPC_SW && code[q].regA == 0) sum[proc[b]].absStores = true;
+        }
+    }
+    for (bool changed = true; changed; ) {
+        changed = false;
+        for (int b = 0; b < B; ++b) {
+            int c = calleeOf[b];
+            if (c < 0 || proc[b] < 0) continue;
+            ProcSummary &p = sum[proc[b]];
+            uint8_t w = p.writes | sum[c].writes;
+            bool a = p.absStores || sum[c].absStores;
+            if (w != p.writes || a != p.absStores) { p.writes = w; p.absStores = a; changed = true; }
+        }
+    }
+}
+
+void MemOpt::transfer(int q, RegState &s) const {
+    const DecodedInstr &d = code[q];
+    auto isConst = [&](int r) { return r != sp && (s.known >> r & 1); };
+    auto setConst = [&](int r, int32_t v) { s.known |= uint8_t(1 << r); s.val[r] = v; };
+    auto clear = [&](int r) { s.known &= uint8_t(~(1 << r)); };
+    switch (d.opcode) {
+        case OPC_ADD: case OPC_NAND: {
+            if (d.dest == 0) break;
+            if (d.dest == sp) {
+                int other = d.regA == sp ? d.regB : (d.regB == sp ? d.regA : -1);
+                if (d.opcode == OPC_ADD && s.sp.known && other >= 0 && other != sp && isConst(other))
+                    s.sp.delta = int32_t(uint32_t(s.sp.delta) + uint32_t(s.val[other]));
+                else s.sp.known = false;
+                break;
+            }
+            if (isConst(d.regA) && isConst(d.regB)) {
+                int32_t a = s.val[d.regA], b = s.val[d.regB];
+                setConst(d.dest, d.opcode == OPC_ADD ? int32_t(uint32_t(a) + uint32_t(b)) : ~(a & b));
+            } else clear(d.dest);
+            break;
+        }
+        case OPC_LW: {
+            if (d.regB == 0) break;
+            bool c = d.regA == 0 && d.imm >= 0 && d.imm < n && constAddr[d.imm];
+            if (d.regB == sp) {
+                // stack อยู่นอก image หรือในช่วง .space ท้าย image ที่ lw/sw ฐาน r0 ไม่แตะ
+                if (c && g.word(d.imm) >= stackFloor) s.sp = SpState{true, q + 1, 0};
+                else s.sp.known = false;
+            } else if (c) setConst(d.regB, g.word(d.imm));
+            else clear(d.regB);
+            break;
+        }
+        case OPC_JALR: {
+            int b = g.blockAt(q);
+            if (d.regA != d.regB && d.regB != 0 && calleeOf[b] >= 0) {
+                const ProcSummary &c = sum[calleeOf[b]];
+                for (int r = 1; r < 8; ++r) if (c.writes >> r & 1) clear(r);
+                if (!c.spBalanced) s.sp.known = false;
+            }
+            if (d.regB == 0) break;
+            if (d.regB == sp) s.sp.known = false;
+            else setConst(d.regB, q + 1);
+            break;
+        }
+        default: break;
+    }
+}
+
+// register ตอนเข้า procedure = meet ของ state ที่ทุกจุดเรียก (ค่าคงที่ที่ตรงกันทุกจุด เช่น r6/r7 หรือ address
+// ของ callee ใน register ที่ใช้ jalr) ส่วน SP ตอนเข้าเป็นฐาน 0 ถ้าทุกจุดเรียกรู้ตำแหน่ง SP
+// procedure ที่ไม่มีใครเรียก (root อื่น) เริ่มจากไม่รู้อะไรเลย
+void MemOpt::solveConstants() {
+    const vector<int> &roots = g.roots();
+    vector<char> called(roots.size(), 0);
+    for (int b = 0; b < B; ++b) if (calleeOf[b] >= 0) called[calleeOf[b]] = 1;
+    for (size_t iter = 0; iter <= roots.size() + 1; ++iter) {
+        regIn.assign(B, RegState{});
+        vector<int> work;
+        vector<char> queued(B, 0);
+        for (size_t p = 0; p < roots.size(); ++p) {
+            const int r = roots[p];
+            if (called[p] && g.block(r).first != 0) continue;   // รอ state จากจุดเรียก
+            RegState s;
+            s.top = false;
+            if (g.block(r).first == 0) {
+                // จุดเริ่มโปรแกรม: register ทุกตัวเป็น 0 (SP = 0 อยู่ใน image → ใช้เป็นฐาน stack ไม่ได้)
+                s.known = 0xFF;
+                s.sp.known = false;
+            } else {
+                s.sp = SpState{true, 0, 0};
+            }
+            regIn[r] = s;
+            work.push_back(r);
+            queued[r] = 1;
+        }
+        auto flow = [&](int t, const RegState &s) {
+            if (meetInto(regIn[t], s) && !queued[t]) { queued[t] = 1; work.push_back(t); }
+        };
+        while (!work.empty()) {
+            int b = work.back();
+            work.pop_back();
+            queued[b] = 0;
+            RegState s = regIn[b];
+            const BasicBlock &bb = g.block(b);
+            for (int q = bb.first; q < bb.last; ++q) transfer(q, s);
+            if (bb.exit == EXIT_CALL && calleeOf[b] >= 0) {
+                // state ที่ callee เห็น: หลัง jalr เขียน return address ลง regB (SP นับใหม่จากฐาน 0)
+                const DecodedInstr &d = code[bb.last];
+                RegState entry = s;
+                entry.sp = SpState{s.sp.known && d.regB != sp, 0, 0};
+                if (d.regB != 0 && d.regB != sp) { entry.known |= uint8_t(1 << d.regB); entry.val[d.regB] = bb.last + 1; }
+                flow(roots[calleeOf[b]], entry);
+            }
+            transfer(bb.last, s);
+            for (int e = g.succBegin(b); e < g.succEnd(b); ++e)
+                if (g.succKind(e) != EDGE_CALL) flow(g.succ(e), s);
+        }
+
+        // SP กลับมาเท่าตอนเข้าที่ทุกจุด return หรือไม่
+        bool changed = false;
+        vector<char> balanced(roots.size(), 1);
+        for (int b = 0; b < B; ++b) {
+            if (proc[b] < 0 || regIn[b].top || g.block(b).exit != EXIT_RETURN) continue;
+            RegState s = regIn[b];
+            for (int q = g.block(b).first; q <= g.block(b).last; ++q) transfer(q, s);
+            if (!(s.sp == SpState{true, 0, 0})) balanced[proc[b]] = 0;
+        }
+        for (size_t p = 0; p < roots.size(); ++p)
+            if (sum[p].spBalanced && !balanced[p]) { sum[p].spBalanced = false; changed = true; }
+        if (!changed) break;
+    }
+}
+
+void MemOpt::classifyAccesses() {
+    spBefore.assign(n, SpState{});
+    keyOf.assign(n, -1);
+    constSrc.assign(n, -1);
+    map<tuple<int,int,int32_t>,int> index;
+    auto keyId = [&](MemKey k) {
+        auto t = make_tuple(int(k.kind), k.base, k.off);
+        auto it = index.find(t);
+        if (it != index.end()) return it->second;
+        int id = (int)keys.size();
+        keys.push_back(k);
+        index[t] = id;
+        return id;
+    };
+    for (int b = 0; b < B; ++b) {
+        if (regIn[b].top) continue;
+        RegState s = regIn[b];
+        for (int q = g.block(b).first; q <= g.block(b).last; ++q) {
+            spBefore[q] = s.sp;
+            const DecodedInstr &d = code[q];
+            if (d.opcode == OPC_LW && d.regA == 0 && d.regB != 0 && d.regB != sp && d.imm >= 0 && d.imm < n &&
+                constAddr[d.imm]) {
+                // ค่าที่จะโหลดอยู่ใน register อยู่แล้ว (ตัวปลายทางเองก่อน)
+                const int32_t v = g.word(d.imm);
+                auto holds = [&](int x) { return x != sp && (s.known >> x & 1) && s.val[x] == v; };
+                if (holds(d.regB)) constSrc[q] = d.regB;
+                for (int x = 0; x < 8 && constSrc[q] < 0; ++x) if (holds(x)) constSrc[q] = x;
+            }
+            if (d.opcode == OPC_LW || d.opcode == OPC_SW) {
+                if (d.regA == 0 && d.imm >= 0 && d.imm < n) keyOf[q] = keyId(MemKey{MemKey::ABS, 0, d.imm});
+                else if (d.regA == sp && sp > 0 && s.sp.known)
+                    keyOf[q] = keyId(MemKey{MemKey::SLOT, s.sp.base, int32_t(uint32_t(s.sp.delta) + uint32_t(d.imm))});
+            }
+            transfer(q, s);
+        }
+    }
+}
+
+void MemOpt::solveFrameSafety() {
+    for (int b = 0; b < B; ++b) {
+        if (proc[b] < 0) continue;
+        for (int q = g.block(b).first; q <= g.block(b).last; ++q) {
+            if (code[q].opcode != OPC_SW) continue;
+            int k = keyOf[q];
+            bool safe = k >= 0 && (keys[k].kind == MemKey::ABS || (keys[k].base == 0 && keys[k].off >= 0));
+            if (!safe) sum[proc[b]].frameSafe = false;
+        }
+    }
+    for (bool changed = true; changed; ) {
+        changed = false;
+        for (int b = 0; b < B; ++b) {
+            int c = calleeOf[b];
+            if (c < 0 || proc[b] < 0) continue;
+            if (sum[proc[b]].frameSafe && !sum[c].frameSafe) { sum[proc[b]].frameSafe = false; changed = true; }
+        }
+    }
+}
+
+// ---------------- available values ----------------
+void MemOpt::transfer(int q, AvailState &s, vector<int> *redundant) const {
+    const DecodedInstr &d = code[q];
+    auto killReg = [&](int r) {
+        if (r > 0) s.eraseIf([r](const pair<int,int> &e) { return e.second == r; });
+    };
+    if (d.opcode == OPC_LW) {
+        int k = keyOf[q];
+        if (k >= 0 && redundant) {
+            int x = s.find(k);
+            if (x >= 0) (*redundant)[q] = x;
+        }
+        killReg(d.regB);
+        if (k >= 0 && d.regB != 0) s.set(k, d.regB);
+    } else if (d.opcode == OPC_SW) {
+        int k = keyOf[q];
+        if (k < 0) { s.slots.clear(); return; }
+        const MemKey &mk = keys[k];
+        // ช่อง stack ต่างฐานอาจเป็นที่เดียวกัน ส่วน ABS อยู่ใน image จึงไม่ชนกับ stack
+        s.eraseIf([&](const pair<int,int> &e) {
+            const MemKey &o = keys[e.first];
+            if (e.first == k) return true;
+            return o.kind == MemKey::SLOT && mk.kind == MemKey::SLOT && o.base != mk.base;
+        });
+        s.set(k, d.regB);
+    } else if (d.opcode == OPC_JALR) {
+        int b = g.blockAt(q);
+        if (d.regA != d.regB && d.regB != 0) {
+            int c = calleeOf[b];
+            SpState cur = spBefore[q];
+            s.eraseIf([&](const pair<int,int> &e) {
+                if (c < 0) return true;
+                const ProcSummary &p = sum[c];
+                if (e.second == d.regB || (p.writes >> e.second & 1)) return true;
+                if (e.second == sp && !p.spBalanced) return true;
+                const MemKey &mk = keys[e.first];
+                if (!p.frameSafe) return true;
+                if (mk.kind == MemKey::ABS) return p.absStores;
+                return !(cur.known && mk.base == cur.base && mk.off < cur.delta);
+            });
+        }
+        killReg(d.regB);
+    } else {
+        killReg(writtenReg(d));
+    }
+}
+
+void MemOpt::findRedundantLoads(vector<int> &redundant) {
+    vector<AvailState> in(B);
+    vector<int> work;
+    vector<char> queued(B, 0);
+    for (int r : g.roots()) { in[r].top = false; work.push_back(r); queued[r] = 1; }
+    while (!work.empty()) {
+        int b = work.back();
+        work.pop_back();
+        queued[b] = 0;
+        AvailState s = in[b];
+        for (int q = g.block(b).first; q <= g.block(b).last; ++q) transfer(q, s, nullptr);
+        for (int e = g.succBegin(b); e < g.succEnd(b); ++e) {
+            if (g.succKind(e) == EDGE_CALL) continue;
+            int t = g.succ(e);
+            if (meetInto(in[t], s) && !queued[t]) { queued[t] = 1; work.push_back(t); }
+        }
+    }
+    redundant.assign(n, -1);
+    for (int b = 0; b < B; ++b) {
+        if (in[b].top) continue;
+        AvailState s = in[b];
+        for (int q = g.block(b).first; q <= g.block(b).last; ++q) transfer(q, s, &redundant);
+    }
+}
+
+// ---------------- liveness ของช่อง stack ----------------
+// ช่องที่ต่ำกว่า SP (frame ที่ยังใช้อยู่) + ช่องของฐานอื่นทั้งหมด (ไม่รู้ว่าอยู่ตรงไหนเทียบกับ SP)
+void MemOpt::addBelowSp(LiveSet &l, const SpState &s) const {
+    for (size_t k = 0; k < keys.size(); ++k) {
+        if (keys[k].kind != MemKey::SLOT) continue;
+        if (keys[k].base != s.base || keys[k].off < s.delta) l.set((int)k);
+    }
+}
+
+void MemOpt::addOtherBases(LiveSet &l, const SpState &s) const {
+    for (size_t k = 0; k < keys.size(); ++k)
+        if (keys[k].kind == MemKey::SLOT && keys[k].base != s.base) l.set((int)k);
+}
+
+LiveSet MemOpt::liveOut(int b, const vector<LiveSet> &in) const {
+    LiveSet l = emptyLive();
+    const BasicBlock &bb = g.block(b);
+    bool hasIntra = false;
+    for (int e = g.succBegin(b); e < g.succEnd(b); ++e) {
+        if (g.succKind(e) == EDGE_CALL) continue;
+        hasIntra = true;
+        l.unite(in[g.succ(e)]);
+    }
+    switch (bb.exit) {
+        case EXIT_HALT: break;                    // stack นอก image ไม่ปรากฏใน state สุดท้าย (ใน image ไม่มาถึงตรงนี้)
+        case EXIT_END: l.all = true; break;
+        case EXIT_CALL: {
+            const SpState &s = spBefore[bb.last];
+            int c = calleeOf[b];
+            if (!s.known || c < 0 || sum[c].entryAll) { l.all = true; break; }
+            // callee ที่ไม่เขียนต่ำกว่า SP ตอนเข้า ปล่อยช่องของผู้เรียกผ่านไปถึง return site ตรง ๆ
+            // ช่องที่ live จึงมีแค่ที่ live ที่ return site + ที่ callee อ่านเอง (entryLive)
+            if (!sum[c].frameSafe) addBelowSp(l, s);
+            else addOtherBases(l, s);
+            for (int32_t o : sum[c].entryLive) {
+                for (size_t k = 0; k < keys.size(); ++k)
+                    if (keys[k].kind == MemKey::SLOT && keys[k].base == s.base && keys[k].off == s.delta + o)
+                        l.set((int)k);
+            }
+            break;
+        }
+        case EXIT_RETURN: {
+            if (hasIntra) break;
+            const SpState &s = spBefore[bb.last];
+            if (!s.known || s.base != 0) { l.all = true; break; }
+            // ช่อง >= SP ตอน return ว่างแล้ว (ธรรมเนียม stack) ส่วนช่องของผู้เรียกถูกนับที่จุด call แทน
+            // ยกเว้น procedure ที่เขียนลง frame ของผู้เรียกเอง ต้องถือว่าช่องใต้ SP ยังใช้อยู่
+            if (proc[b] < 0 || !sum[proc[b]].frameSafe) addBelowSp(l, s);
+            else addOtherBases(l, s);
+            break;
+        }
+        default: break;
+    }
+    return l;
+}
+
+LiveSet MemOpt::liveIn(int b, LiveSet l, vector<char> *dead) const {
+    const BasicBlock &bb = g.block(b);
+    for (int q = bb.last; q >= bb.first; --q) {
+        const DecodedInstr &d = code[q];
+        if (d.opcode == OPC_LW) {
+            int k = keyOf[q];
+            if (k < 0) l.all = true;
+            else if (keys[k].kind == MemKey::SLOT) l.set(k);
+        } else if (d.opcode == OPC_SW) {
+            int k = keyOf[q];
+            if (k < 0 || keys[k].kind != MemKey::SLOT || l.all) continue;
+            bool live = l.test(k);
+            // ช่องของฐานอื่นที่ยัง live อาจเป็นที่เดียวกัน → ลบไม่ได้
+            for (size_t o = 0; o < keys.size() && !live; ++o)
+                if (keys[o].kind == MemKey::SLOT && keys[o].base != keys[k].base && l.test((int)o)) live = true;
+            if (!live && dead) (*dead)[q] = 1;
+            l.reset(k);
+        }
+    }
+    return l;
+}
+
+void MemOpt::findDeadStores(vector<char> &dead) {
+    vector<LiveSet> in(B, emptyLive());
+    const vector<int> &roots = g.roots();
+    for (size_t iter = 0; iter <= roots.size() + 1; ++iter) {
+        for (bool changed = true; changed; ) {
+            changed = false;
+            for (int b = B - 1; b >= 0; --b) {
+                LiveSet l = liveIn(b, liveOut(b, in), nullptr);
+                if (!(l == in[b])) { in[b] = l; changed = true; }
+            }
+        }
+        // summary ตอนเข้า procedure: ช่องของผู้เรียกที่ถูกอ่านก่อนเขียน
+        bool changed = false;
+        for (size_t p = 0; p < roots.size(); ++p) {
+            const LiveSet &l = in[roots[p]];
+            vector<int32_t> offs;
+            for (size_t k = 0; k < keys.size(); ++k)
+                if (keys[k].kind == MemKey::SLOT && keys[k].base == 0 && l.test((int)k))
+                    offs.push_back(keys[k].off);
+            if (l.all != sum[p].entryAll || offs != sum[p].entryLive) {
+                sum[p].entryAll = l.all;
+                sum[p].entryLive = offs;
+                changed = true;
+            }
+        }
+        if (!changed) break;
+    }
+    dead.assign(n, 0);
+    for (int b = 0; b < B; ++b) liveIn(b, liveOut(b, in), &dead);
+}
+
+bool MemOpt::run(vector<char> &kill) {
+    code.resize(n);
+    for (int q = 0; q < n; ++q) code[q] = g.instr(q);
+
+    // .fill ที่ไม่มี sw ฐาน r0 เขียนถึง และไม่มี sw ฐานอื่นนอกจาก SP เลย → ค่าคงที่
+    chooseStackPointer();
+    st.spReg = sp;
+    constAddr.assign(n, 1);
+    bool wildStores = false;
+    for (int q = 0; q < n; ++q) {
+        if (g.blockAt(q) >= 0) constAddr[q] = 0;
+        const DecodedInstr &d = code[q];
+        if (g.blockAt(q) < 0 || d.opcode != OPC_SW) continue;
+        if (d.regA == 0) { if (d.imm >= 0 && d.imm < n) constAddr[d.imm] = 0; }
+        else if (d.regA != sp) wildStores = true;
+    }
+    if (wildStores) fill(constAddr.begin(), constAddr.end(), 0);
+    findStackFloor();
+    markJumpPointers();
+
+    buildProcedures();
+    solveConstants();
+    classifyAccesses();
+    solveFrameSafety();
+
+    vector<int> redundant;
+    findRedundantLoads(redundant);
+    vector<char> killAt(n, 0);
+    for (int q = 0; q < n; ++q) {
+        int x = redundant[q] >= 0 ? redundant[q] : constSrc[q];
+        if (x < 0 || jumpPtr[q]) continue;
+        int y = code[q].regB;
+        if (x == y || y == 0) { killAt[q] = 1; st.loadsRemoved++; }
+        else { setRType(ir[rowAt[q]], "add", x, 0, y); st.loadsToMoves++; }
+        code[q] = decodeWord(int32_t(packR(OPC_ADD, x, 0, y)));
+        keyOf[q] = -1;
+    }
+
+    // stack ใน image ปรากฏใน state สุดท้าย: sw ลงช่อง stack ต้องอยู่ครบเหมือน sw ฐาน r0
+    if (sp > 0 && !stackInImage) {
+        vector<char> dead;
+        findDeadStores(dead);
+        for (int q = 0; q < n; ++q)
+            if (dead[q]) { killAt[q] = 1; st.deadStores++; }
+    }
+    kill.assign(ir.size(), 0);
+    for (size_t i = 0; i < ir.size(); ++i) kill[i] = killAt[ir[i].address];
+    return st.loadsRemoved + st.loadsToMoves + st.deadStores > 0;
+}
+
+}  // namespace
+
+MemOptStats runMemOpt(Parser &prog) {
+    MemOptStats st;
+    vector<IRLine> ir = prog.getIR();
+    if (ir.empty()) return st;
+    symbolizeIR(ir);
+    ControlFlowGraph g = ControlFlowGraph::fromIR(ir);
+    for (int b = 0; b < g.numBlocks(); ++b) {
+        if (g.block(b).exit != EXIT_CALL) continue;
+        bool known = false;
+        for (int e = g.succBegin(b); e < g.succEnd(b); ++e)
+            if (g.succKind(e) == EDGE_CALL) known = true;
+        if (!known) { st.skipped = true; st.why = "call with unknown target"; return st; }
+    }
+
+    vector<char> kill;
+    MemOpt opt(ir, g, st);
+    if (!opt.run(kill)) return st;
+    eraseIRLines(ir, kill);
+    prog.replaceIR(ir);
+    return st;
+}
@@ -0,0 +1,44 @@
+// memopt.h
+// ลด lw/sw ที่ซ้ำซ้อนด้วยการวิเคราะห์ liveness ของ register และช่องหน่วยความจำบน CFG (cfg.h)
+// ออกแบบสำหรับโปรแกรมที่ใช้ stack แบบ programs/combination.asm:
+//     push:  sw  5 R 0 / add 5 6 5        (r6 = 1)
+//     pop :  add 5 7 5 / lw  5 R 0        (r7 = -1)
+//
+//   1) หา stack pointer (SP): register ที่ใช้เป็นฐานของ lw/sw บ่อยที่สุด และถูกเขียนด้วย "lw 0 SP label"
+//      หรือ "add SP k SP" เท่านั้น แล้วติดตาม SP เป็น (ฐาน, delta) ด้วย constant propagation
+//      ฐาน = ค่า SP ตอนเข้า procedure หรือค่าที่โหลดจาก .fill ซึ่งต้องชี้นอก image หรือเข้าช่วง .space ท้าย image
+//      ที่อยู่เหนือ code และเหนือทุก address ที่ lw/sw ฐาน r0 อ้าง (stack กับข้อมูลอื่นจึงไม่ชนกัน)
+//      register ตอนเข้า procedure = ค่าคงที่ที่ตรงกันทุกจุดเรียก (เช่น r6 = 1, r7 = -1, address ของ callee)
+//   2) ช่อง stack = (ฐาน, delta + offset) ส่วน lw/sw ฐาน r0 ที่ชี้เข้าใน image = ช่องแบบ absolute
+//      lw/sw ที่ฐานไม่ใช่ SP/r0 หรือรู้ค่า SP ไม่ได้ ถือว่าอ่าน/เขียนได้ทุกที่ (aliasing แบบ conservative)
+//   3) available values (forward): "lw Y slot" ที่ค่าของ slot ยังอยู่ใน register X
+//      → ลบทิ้ง (X == Y) หรือแทนด้วย "add X 0 Y" เช่นเดียวกับ "lw 0 Y k" ที่ค่าคงที่ของ k อยู่ใน X อยู่แล้ว
+//      ยกเว้น lw ที่โหลด target ของ jalr (cfg ใช้รูปแบบนั้นหา callee)
+//   4) liveness ของช่อง stack (backward): "sw SP R off" ที่ไม่มีใครอ่านช่องนั้นอีกก่อนถูกเขียนทับ → ลบ
+//      ที่ return (jalr a 0) ช่อง >= SP ตายแล้วตามธรรมเนียม stack ส่วนช่องของผู้เรียกนับที่จุด call:
+//      live หลัง call = live ที่ return site + ช่องที่ callee อ่านก่อนเขียน (summary แบบ fixpoint รองรับ recursion)
+//      ถ้า callee เขียนต่ำกว่า SP ตอนเข้า จะถือว่าช่องใต้ SP ทั้งหมดยังใช้อยู่
+//      ที่ halt ช่อง stack ทั้งหมดตาย (อยู่นอก image จึงไม่ปรากฏใน state สุดท้ายของ simulator)
+//      stack ที่อยู่ใน image (.space) ปรากฏใน state สุดท้าย จึงไม่ลบ sw ลงช่อง stack เลย
+// การเรียก procedure ใช้ summary ของ callee: register ที่เขียน, SP กลับมาเท่าเดิมไหม, เขียนทับ frame ของผู้เรียกไหม
+// sw ฐาน r0 ไม่ถูกลบเลย เพราะค่าในหน่วยความจำของ image ปรากฏใน state สุดท้าย
+
+#ifndef MEMOPT_H
+#define MEMOPT_H
+
+#include "parser.h"
+
+#include <string>
+
+struct MemOptStats {
+    int spReg = -1;          // register ที่ใช้เป็น stack pointer (-1 = ไม่พบ)
+    int loadsRemoved = 0;    // lw ที่ค่า (ในช่องหน่วยความจำหรือค่าคงที่) อยู่ใน register ปลายทางอยู่แล้ว
+    int loadsToMoves = 0;    // lw ที่แทนด้วย add X 0 Y
+    int deadStores = 0;      // sw ลงช่อง stack ที่ไม่มีใครอ่าน
+    bool skipped = false;    // ไม่ได้ทำอะไร (เหตุผลใน why)
+    std::string why;
+};
+
+MemOptStats runMemOpt(Parser &prog);
+
+#endif
@@ -0,0 +1,310 @@
+// mulc.h
+// ขยาย pseudo-instruction "mulc src dest K" (dest = src * K) เป็นลำดับ add/nand ความยาวคงที่ตอน assemble
+// แทน loop ที่วนตามค่าตัวคูณแบบ programs/multiply.asm
+//   - doubling:     add d d d          (d = 2d)
+//   - accumulate:   add d s d          (d = d + s)
+//   - ลบ (ใช้ nand): nand d d d / add d s d / nand d d d   (~(~d + s) = d - s)
+//   - ค่าลบ:        nand 0 0 t / add d t d / nand d d d    (~(d - 1) = -d)
+// ลองหลายวิธีแล้วเลือกลำดับที่สั้นที่สุด:
+//   binary  : ไล่บิตจากบนลงล่าง (Horner) ใช้เป็นค่าอ้างอิงใน report
+//   naf     : ตัวเลขแบบ signed digit (NAF) คุ้มเมื่อมีบิต 1 ติดกันยาว ๆ เช่น 2^n - 1
+//   factor  : K = a*b คูณ a ก่อนแล้วคูณ b ต่อในที่ (ต้องใช้ scratch เก็บ a*src)
+//   search  : ค้นแบบ iterative deepening ทุกลำดับ add ที่สั้นกว่า (ได้ลำดับที่สั้นที่สุดจริงสำหรับ K ไม่ใหญ่)
+// scratch register ประกาศด้วย ".scratch R" ในไฟล์ assembly และจะถูกเขียนทับ
+// src จะไม่ถูกแก้ (ยกเว้น src == dest) ค่าเป็นแบบ 32 บิต wrap-around เหมือนคำสั่ง add
+// header-only: include แล้วใช้ได้เลย
+
+#ifndef MULC_H
+#define MULC_H
+
+#include <cstdint>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+struct MulcOp {
+    bool nand = false;   // false = add
+    int a = 0, b = 0, d = 0;
+};
+
+struct MulcPlan {
+    std::vector<MulcOp> ops;
+    std::string method;   // วิธีที่ถูกเลือก
+    int binaryCost = 0;   // จำนวนคำสั่งถ้าใช้ binary shift-and-add ธรรมดา
+};
+
+namespace mulc_detail {
+
+// role ของ register ระหว่างวางแผน แปลงเป็นเลข register จริงตอนท้าย
+enum Role { RZ = 0, RS = 1, RD = 2, RT = 3 };
+
+struct Seq {
+    std::vector<MulcOp> ops;   // a/b/d เป็น Role
+    std::string method;
+    bool valid = false;
+    int cost() const { return valid ? (int)ops.size() : 1 << 30; }
+};
+
+inline void emitAdd(std::vector<MulcOp> &v, int a, int b, int d) { v.push_back({false, a, b, d}); }
+inline void emitNand(std::vector<MulcOp> &v, int a, int b, int d) { v.push_back({true, a, b, d}); }
+
+inline int bitLength(uint64_t m) {
+    int n = 0;
+    while (m) ++n, m >>= 1;
+    return n;
+}
+
+// dst = dst * m โดย src เก็บค่าตั้งต้น (dst == src ตอนเริ่ม ถ้า leading = true) หรือ dst = src * m (leading = false)
+// ไล่บิตจากบนลงล่าง: บิตบนสุดคือค่าตั้งต้น แล้ว double + accumulate
+inline void binaryOps(std::vector<MulcOp> &v, uint64_t m, int src, int dst, bool leading) {
+    int n = bitLength(m);
+    if (!leading) emitAdd(v, src, RZ, dst);
+    for (int i = n - 2; i >= 0; --i) {
+        emitAdd(v, dst, dst, dst);
+        if ((m >> i) & 1) emitAdd(v, dst, src, dst);
+    }
+}
+
+// แบบ NAF: หลักเป็น -1/0/+1 และไม่มีหลักที่ไม่ใช่ 0 ติดกัน
+inline void nafOps(std::vector<MulcOp> &v, uint64_t m, int src, int dst, bool leading) {
+    std::vector<int> digits;   // จากหลักต่ำไปสูง
+    for (uint64_t x = m; x; x >>= 1) {
+        int dgt = 0;
+        if (x & 1) {
+            dgt = 2 - int(x & 3);   // x mod 4 == 1 → +1, == 3 → -1
+            x -= dgt;               // ถ้า -1 ก็บวก 1 (wrap ไม่เกิดเพราะ m < 2^33)
+        }
+        digits.push_back(dgt);
+    }
+    if (!leading) emitAdd(v, src, RZ, dst);
+    for (int i = (int)digits.size() - 2; i >= 0; --i) {
+        emitAdd(v, dst, dst, dst);
+        if (digits[i] == 1) emitAdd(v, dst, src, dst);
+        else if (digits[i] == -1) {
+            emitNand(v, dst, dst, dst);
+            emitAdd(v, dst, src, dst);
+            emitNand(v, dst, dst, dst);
+        }
+    }
+}
+
+// ค้นหาลำดับ add ที่สั้นที่สุดไม่เกิน limit คำสั่ง (iterative deepening + ตัดกิ่งตามขนาดค่า)
+// val[role] = สัมประสิทธิ์ของ src ใน register นั้น (0 = ยังไม่ได้กำหนดค่า ยกเว้น RZ)
+struct Searcher {
+    uint64_t target;
+    bool useTmp;
+    uint64_t val[4];
+    std::vector<MulcOp> path;
+
+    bool dfs(int rem) {
+        if (val[RD] == target) return true;
+        if (rem == 0) return false;
+        uint64_t mx = val[RS] > val[RD] ? val[RS] : val[RD];
+        if (useTmp && val[RT] > mx) mx = val[RT];
+        if (rem < 63 && (mx << rem) < target) return false;   // double ทุกครั้งก็ยังไม่ถึง
+        static const int srcs[4] = {RZ, RS, RD, RT};
+        for (int w = RD; w <= (useTmp ? RT : RD); ++w) {
+            if (rem == 1 && w != RD) continue;
+            for (int i = 0; i < 4; ++i) {
+                int p = srcs[i];
+                if (p == RT && !useTmp) continue;
+                if (p != RZ && val[p] == 0) continue;
+                for (int j = i; j < 4; ++j) {
+                    int q = srcs[j];
+                    if (q == RT && !useTmp) continue;
+                    if (q != RZ && val[q] == 0) continue;
+                    uint64_t nv = val[p] + val[q];
+                    if (nv == 0 || nv > target || nv == val[w]) continue;
+                    if (rem == 1 && nv != target) continue;
+                    uint64_t old = val[w];
+                    val[w] = nv;
+                    path.push_back({false, p, q, w});
+                    if (dfs(rem - 1)) return true;
+                    path.pop_back();
+                    val[w] = old;
+                }
+            }
+        }
+        return false;
+    }
+};
+
+inline Seq searchOps(uint64_t m, bool useTmp, int limit) {
+    Seq s;
+    for (int depth = 1; depth <= limit; ++depth) {
+        Searcher sr{m, useTmp, {0, 1, 0, 0}, {}};
+        if (sr.dfs(depth)) {
+            s.ops = sr.path;
+            s.method = "search";
+            s.valid = true;
+            return s;
+        }
+    }
+    return s;
+}
+
+class Planner {
+public:
+    explicit Planner(bool useTmp) : useTmp(useTmp) {}
+
+    // ลำดับที่ดีที่สุดของ dst = src * m (m >= 2)
+    Seq best(uint64_t m) {
+        auto it = memo.find(m);
+        if (it != memo.end()) return it->second;
+
+        Seq res;
+        res.method = "binary";
+        binaryOps(res.ops, m, RS, RD, false);
+        res.valid = true;
+
+        Seq naf;
+        naf.method = "naf";
+        nafOps(naf.ops, m, RS, RD, false);
+        naf.valid = true;
+        if (naf.cost() < res.cost()) res = naf;
+
+        // ลำดับ add ล้วนที่สั้นกว่าที่มีอยู่ (จำกัดความลึกเพื่อไม่ให้ช้า)
+        int limit = res.cost() - 1;
+        if (limit > 7) limit = 7;
+        Seq sr = searchOps(m, useTmp, limit);
+        if (sr.valid && sr.cost() < res.cost()) res = sr;
+
+        // แยกตัวประกอบ: dst = src*a แล้ว tmp = dst, dst = dst*b (ใช้ tmp แทน src)
+        if (useTmp) {
+            for (uint64_t a = 2; a * a <= m; ++a) {
+                if (m % a) continue;
+                for (int side = 0; side < 2; ++side) {
+                    uint64_t first = side ? m / a : a, second = side ? a : m / a;
+                    Seq head = best(first);
+                    if (head.cost() + 2 >= res.cost()) continue;
+                    Seq tail;
+                    tail.valid = true;
+                    binaryOps(tail.ops, second, RT, RD, true);
+                    Seq tailNaf;
+                    nafOps(tailNaf.ops, second, RT, RD, true);
+                    if (tailNaf.ops.size() < tail.ops.size()) tail.ops = tailNaf.ops;
+                    if (head.cost() + 1 + tail.cost() < res.cost()) {
+                        Seq f;
+                        f.ops = head.ops;
+                        emitAdd(f.ops, RD, RZ, RT);
+                        f.ops.insert(f.ops.end(), tail.ops.begin(), tail.ops.end());
+                        f.method = "factor " + std::to_string(first) + "*" + std::to_string(second);
+                        f.valid = true;
+                        res = f;
+                    }
+                }
+            }
+        }
+        memo[m] = res;
+        return res;
+    }
+
+private:
+    bool useTmp;
+    std::map<uint64_t, Seq> memo;
+};
+
+// รันลำดับบนค่าตัวอย่างเพื่อยืนยันว่าได้ src * k จริง (role: RS, RD, RT)
+inline bool checkSeq(const std::vector<MulcOp> &ops, uint32_t k, bool srcIsDest) {
+    static const uint32_t samples[] = {0u, 1u, 2u, 3u, 7u, 12345u, 0x7FFFFFFFu, 0x80000000u, 0xFFFFFFFFu, 0x9E3779B9u};
+    for (uint32_t x : samples) {
+        uint32_t r[4] = {0, x, srcIsDest ? x : 0xDEADBEEFu, 0xCAFEBABEu};
+        for (const MulcOp &o : ops) {
+            uint32_t v = o.nand ? ~(r[o.a] & r[o.b]) : r[o.a] + r[o.b];
+            if (o.d != RZ) r[o.d] = v;
+        }
+        if (r[RD] != x * k) return false;
+        if (!srcIsDest && r[RS] != x) return false;
+    }
+    return true;
+}
+
+} // namespace mulc_detail
+
+// วางแผนการขยาย mulc: scratch = -1 ถ้าไม่มีการประกาศ .scratch
+// throw runtime_error ถ้าทำไม่ได้ (เช่น ต้องใช้ scratch แต่ไม่ได้ประกาศ)
+inline MulcPlan planMulc(int src, int dest, int scratch, int32_t k) {
+    using namespace mulc_detail;
+    if (src < 0 || src > 7 || dest < 1 || dest > 7)
+        throw std::runtime_error("mulc registers out of range (src 0..7, dest 1..7)");
+    if (scratch >= 0 && (scratch == src || scratch == dest))
+        throw std::runtime_error("mulc scratch register r" + std::to_string(scratch) + " must differ from src and dest");
+
+    const bool inPlace = (src == dest);
+    const bool haveTmp = scratch > 0;
+    const uint32_t uk = uint32_t(k);
+    Seq res;
+
+    if (uk == 0) {
+        emitAdd(res.ops, RZ, RZ, RD);
+        res.method = "zero";
+        res.valid = true;
+    } else if (src == 0) {
+        emitAdd(res.ops, RZ, RZ, RD);   // r0 * K = 0
+        res.method = "zero";
+        res.valid = true;
+    } else if (inPlace && (uk & (uk - 1)) == 0) {
+        // ยกกำลังสอง: double ในที่ ไม่ต้องใช้ scratch (K = 1 ได้ noop)
+        if (uk == 1) res.ops.push_back({false, RZ, RZ, RZ});
+        binaryOps(res.ops, uk, RD, RD, true);
+        res.method = "shift";
+        res.valid = true;
+    } else {
+        // src == dest: เก็บค่าเดิมไว้ใน scratch แล้วใช้เป็น src (ไม่เหลือ tmp ให้ใช้)
+        if (inPlace && !haveTmp)
+            throw std::runtime_error("mulc with src == dest needs a scratch register (declare .scratch R)");
+        bool tmpForPlan = haveTmp && !inPlace;
+        Planner planner(tmpForPlan);
+
+        // ทางเลือก 1: คิดเป็นเลขไม่ติดเครื่องหมาย 32 บิต (wrap-around ให้ผลเดียวกัน)
+        Seq pos = uk == 1 ? Seq{{{false, RS, RZ, RD}}, "copy", true} : planner.best(uk);
+        res = pos;
+        // ทางเลือก 2: k < 0 → คูณด้วย |k| แล้วกลับเครื่องหมาย (ใช้ scratch เก็บ -1)
+        if (k < 0 && tmpForPlan) {
+            uint64_t mag = uint64_t(-int64_t(k));
+            Seq neg = mag == 1 ? Seq{{{false, RS, RZ, RD}}, "copy", true} : planner.best(mag);
+            emitNand(neg.ops, RZ, RZ, RT);
+            emitAdd(neg.ops, RD, RT, RD);
+            emitNand(neg.ops, RD, RD, RD);
+            neg.method += ", negate";
+            if (neg.cost() < res.cost()) res = neg;
+        }
+        if (inPlace) {
+            // ย้าย src เดิมไป scratch แล้วให้ role RS หมายถึง scratch
+            std::vector<MulcOp> ops;
+            emitAdd(ops, RD, RZ, RT);
+            for (MulcOp o : res.ops) {
+                if (o.a == RS) o.a = RT;
+                if (o.b == RS) o.b = RT;
+                ops.push_back(o);
+            }
+            res.ops = ops;
+        }
+    }
+
+    // ยืนยันผลก่อนใช้จริง (role ยังไม่แปลง)
+    if (!checkSeq(res.ops, uk, inPlace))
+        throw std::logic_error("mulc expansion self-check failed for K = " + std::to_string(k));
+    for (const MulcOp &o : res.ops)
+        if ((o.a == RT || o.b == RT || o.d == RT) && !haveTmp)
+            throw std::logic_error("mulc expansion uses a scratch register that was not declared");
+
+    MulcPlan plan;
+    plan.method = res.method;
+    {
+        std::vector<MulcOp> ref;
+        if (uk > 1) binaryOps(ref, uk, RS, RD, false);
+        plan.binaryCost = uk > 1 ? (int)ref.size() + (inPlace ? 1 : 0) : (int)res.ops.size();
+    }
+    const int reg[4] = {0, src, dest, scratch};
+    for (MulcOp o : res.ops) {
+        o.a = reg[o.a];
+        o.b = reg[o.b];
+        o.d = reg[o.d];
+        plan.ops.push_back(o);
+    }
+    return plan;
+}
+
+#endif
@@ -0,0 +1,92 @@
+// objasm.cpp
+// ประกอบไฟล์ .asm แต่ละไฟล์เป็น relocatable object (.o ดู objfile.h) แยกกัน แล้วค่อยรวมด้วย linker
+// object ที่มีอยู่แล้วและ hash ของต้นฉบับ + ไฟล์ที่ .include ตรงกับที่เก็บไว้จะไม่ถูกประกอบซ้ำ (แก้ไฟล์เดียว = ประกอบใหม่ไฟล์เดียว)
+//
+// Compile : g++ -std=c++17 -O2 -DPARSER_NO_MAIN objasm.cpp objfile.cpp parser.cpp ir_utils.cpp -o objasm
+// Run : .\objasm ..\programs\mullib.asm ..\programs\lib\lcrt.asm   (ได้ mullib.o และ lcrt.o ข้างไฟล์ต้นฉบับ)
+
+#include "objfile.h"
+#include "parser.h"
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace std;
+namespace fs = std::filesystem;
+
+static string objectPathFor(const string &src) {
+    size_t slash = src.find_last_of("/\\");
+    size_t dot = src.find_last_of('.');
+    if (dot == string::npos || (slash != string::npos && dot < slash)) return src + ".o";
+    return src.substr(0, dot) + ".o";
+}
+
+static void usage(const char *prog) {
+    cerr << "usage: " << prog << " [--force] [-o out.o] <file.asm>...\n"
+         << "  -o out.o   ชื่อ object (ใช้ได้เมื่อมีไฟล์เดียว ค่าเริ่มต้น = ชื่อต้นฉบับ .o)\n"
+         << "  --force    ประกอบใหม่ทุกไฟล์แม้ต้นฉบับไม่เปลี่ยน\n";
+}
+
+int main(int argc, char **argv) {
+    vector<string> inputs;
+    string outPath;
+    bool force = false;
+    for (int i = 1; i < argc; ++i) {
+        string a = argv[i];
+        if (a == "-o" && i + 1 < argc) outPath = argv[++i];
+        else if (a == "--force") force = true;
+        else if (!a.empty() && a[0] == '-') { usage(argv[0]); return 1; }
+        else inputs.push_back(a);
+    }
+    if (inputs.empty() || (!outPath.empty() && inputs.size() > 1)) { usage(argv[0]); return 1; }
+
+    try {
+        auto t0 = chrono::steady_clock::now();
+        int built = 0, upToDate = 0;
+        for (const string &src : inputs) {
+            ifstream ifs(src, ios::binary);
+            if (!ifs.is_open()) throw runtime_error("cannot open input file: " + src);
+            ostringstream ss;
+            ss << ifs.rdbuf();
+            uint64_t h = hashSource(ss.str());
+            string out = outPath.empty() ? objectPathFor(src) : outPath;
+            const fs::path base = fs::weakly_canonical(fs::absolute(src)).parent_path();
+
+            if (!force && ObjectFile::upToDate(out, h, base.string())) {
+                cout << src << ": up to date (" << out << ")\n";
+                upToDate++;
+                continue;
+            }
+            Parser prog;
+            try {
+                prog.parseModule(src);
+            } catch (const exception &e) {
+                throw runtime_error(src + ": " + e.what());
+            }
+            ObjectFile obj = buildObject(prog);
+            obj.sourceHash = h;
+            // path ของ include เทียบกับโฟลเดอร์ต้นฉบับ (แบบ lcbuild) ย้ายทั้งโฟลเดอร์ไปที่อื่นแล้วยังเช็คได้
+            for (const string &inc : prog.getIncludes()) {
+                fs::path rel = fs::path(inc).lexically_relative(base);
+                obj.deps.push_back({hashSourceFile(inc), (rel.empty() ? fs::path(inc) : rel).generic_string()});
+            }
+            obj.save(out);
+            cout << src << " -> " << out << ": code " << obj.sections[SEC_CODE].size << ", data "
+                 << obj.sections[SEC_DATA].size << " word(s), " << obj.exports.size() << " export(s), "
+                 << obj.imports.size() << " import(s), " << obj.relocs.size() << " relocation(s)\n";
+            built++;
+        }
+        cout << built << " assembled, " << upToDate << " up to date in "
+             << chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count() << " ms\n";
+    } catch (const exception &e) {
+        cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
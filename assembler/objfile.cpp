@@ -0,0 +1,258 @@
+// objfile.cpp — ดูคำอธิบายใน objfile.h
+
+#include "objfile.h"
+#include "ir_utils.h"
+#include "lc_isa.h"
+
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+#include <unordered_map>
+#include <unordered_set>
+
+using namespace std;
+namespace fs = std::filesystem;
+
+static const char *SECTION_NAME[2] = {"code", "data"};
+static const char *RELOC_NAME[3] = {"beq", "abs16", "word"};
+
+uint64_t hashSource(const string &bytes) {
+    uint64_t h = 1469598103934665603ULL;
+    auto mix = [&](unsigned char c) { h = (h ^ c) * 1099511628211ULL; };
+    for (char c : "lcobj" + to_string(ObjectFile::VERSION)) mix((unsigned char)c);
+    for (char c : bytes) mix((unsigned char)c);
+    return h;
+}
+
+uint64_t hashSourceFile(const string &path) {
+    ifstream ifs(path, ios::binary);
+    if (!ifs.is_open()) return 0;
+    ostringstream ss;
+    ss << ifs.rdbuf();
+    return hashSource(ss.str());
+}
+
+// ---------------- buildObject ----------------
+ObjectFile buildObject(const Parser &prog) {
+    ObjectFile obj;
+    vector<IRLine> ir = prog.getIR();
+    obj.imports = prog.getImports();
+    unordered_set<string> importSet(obj.imports.begin(), obj.imports.end());
+    unordered_set<string> declared;
+    for (const auto &s : prog.getSymbols()) declared.insert(s.name);
+
+    // address ตัวเลขที่ชี้เข้าใน module → label ภายใน (ย้ายตาม section ได้) label ที่สร้างใหม่ไม่ export
+    symbolizeIR(ir);
+    for (const auto &L : ir)
+        if (!L.rawLabel.empty() && !declared.count(L.rawLabel) && importSet.count(L.rawLabel))
+            throw runtime_error("generated label '" + L.rawLabel + "' clashes with an imported symbol");
+
+    // แยก section: คำสั่ง → code, .fill/.space → data
+    vector<int> sec(ir.size());
+    vector<int32_t> off(ir.size());
+    int32_t size[2] = {0, 0};
+    unordered_map<string, size_t> row;
+    for (size_t i = 0; i < ir.size(); ++i) {
+        sec[i] = irOpcode(ir[i]) >= 0 ? SEC_CODE : SEC_DATA;
+        off[i] = size[sec[i]];
+        size[sec[i]] += ir[i].words;
+        if (!ir[i].rawLabel.empty()) row[ir[i].rawLabel] = i;
+    }
+    for (const auto &s : prog.getSymbols()) {
+        size_t r = row.at(s.name);
+        obj.exports.push_back({s.name, sec[r], off[r]});
+    }
+
+    auto addReloc = [&](size_t i, RelocKind kind, const string &name) {
+        ObjReloc r{sec[i], off[i], kind, ""};
+        auto it = row.find(name);
+        if (it == row.end()) {
+            r.symbol = name;
+        } else {
+            r.targetSection = sec[it->second];
+            r.targetOffset = off[it->second];
+        }
+        obj.relocs.push_back(r);
+    };
+
+    for (size_t i = 0; i < ir.size(); ++i) {
+        const IRLine &L = ir[i];
+        int op = irOpcode(L);
+        const string *ref = irLabelRef(L);
+        SparseImage &out = obj.sections[sec[i]];
+        if (op < 0) {
+            int32_t v = L.fillValue;
+            if (ref) { addReloc(i, RelocKind::WORD, *ref); v = 0; }
+            if (L.instr == ".fill") out.push(v);
+            else out.pushRun(L.words, v);
+            continue;
+        }
+        int imm = L.offset16;
+        if (ref && (op == OPC_LW || op == OPC_SW)) {
+            addReloc(i, RelocKind::ABS16, *ref);
+            imm = 0;
+        } else if (ref && op == OPC_BEQ) {
+            auto it = row.find(*ref);
+            if (it != row.end() && sec[it->second] == SEC_CODE) {
+                long long d = (long long)off[it->second] - (off[i] + 1);
+                if (d < -32768 || d > 32767)
+                    throw runtime_error("beq offset out of range for label '" + *ref + "' at address " +
+                                        to_string(L.address));
+                imm = (int)d;
+            } else {
+                addReloc(i, RelocKind::BEQ, *ref);
+                imm = 0;
+            }
+        }
+        uint32_t w = 0;
+        switch (op) {
+            case OPC_ADD: case OPC_NAND: w = packR(op, L.regA, L.regB, L.dest); break;
+            case OPC_LW: case OPC_SW: case OPC_BEQ: w = packI(op, L.regA, L.regB, imm); break;
+            case OPC_JALR: w = packJ(op, L.regA, L.regB); break;
+            default: w = packO(op); break;
+        }
+        out.push(int32_t(w));
+    }
+    return obj;
+}
+
+// ---------------- save / load ----------------
+void ObjectFile::save(const string &path) const {
+    ostringstream os;
+    os << "lcobj " << VERSION << "\n";
+    os << "source " << hex << setw(16) << setfill('0') << sourceHash << dec << setfill(' ') << "\n";
+    for (const auto &d : deps)
+        os << "dep " << hex << setw(16) << setfill('0') << d.hash << dec << setfill(' ') << " " << d.path << "\n";
+    for (const auto &e : exports) os << "export " << e.name << " " << SECTION_NAME[e.section] << " " << e.offset << "\n";
+    for (const auto &name : imports) os << "import " << name << "\n";
+    for (const auto &r : relocs) {
+        os << "reloc " << SECTION_NAME[r.section] << " " << r.offset << " " << RELOC_NAME[int(r.kind)] << " ";
+        if (r.symbol.empty()) os << "@" << SECTION_NAME[r.targetSection] << "+" << r.targetOffset << "\n";
+        else os << r.symbol << "\n";
+    }
+    for (int s = 0; s < 2; ++s) {
+        ostringstream body;
+        size_t lines = writeImageRecords(body, sections[s]);
+        os << SECTION_NAME[s] << " " << sections[s].size << " " << lines << "\n" << body.str();
+    }
+    ofstream ofs(path, ios::binary);
+    if (!ofs.is_open()) throw runtime_error("cannot write object file: " + path);
+    const string text = os.str();
+    ofs.write(text.data(), (streamsize)text.size());
+    if (!ofs) throw runtime_error("write failed: " + path);
+}
+
+static int sectionOf(const string &name) {
+    for (int s = 0; s < 2; ++s)
+        if (name == SECTION_NAME[s]) return s;
+    return -1;
+}
+
+ObjectFile ObjectFile::load(const string &path) {
+    ifstream ifs(path, ios::binary);
+    if (!ifs.is_open()) throw runtime_error("cannot open object file: " + path);
+    ObjectFile obj;
+    string line;
+    int lineno = 0;
+    auto bad = [&]() { return runtime_error("bad object file " + path + ":" + to_string(lineno)); };
+
+    if (!getline(ifs, line)) throw bad();
+    ++lineno;
+    {
+        istringstream is(line);
+        string magic;
+        int version = 0;
+        if (!(is >> magic >> version) || magic != "lcobj") throw bad();
+        if (version != VERSION)
+            throw runtime_error(path + ": object format version " + to_string(version) + " (expected " +
+                                to_string(VERSION) + ")");
+    }
+    bool seen[2] = {false, false};
+    while (getline(ifs, line)) {
+        ++lineno;
+        istringstream is(line);
+        string kind;
+        if (!(is >> kind)) continue;
+        if (kind == "source") {
+            if (!(is >> hex >> obj.sourceHash)) throw bad();
+        } else if (kind == "dep") {
+            ObjDep d;
+            if (!(is >> hex >> d.hash >> dec >> ws) || !getline(is, d.path) || d.path.empty()) throw bad();
+            obj.deps.push_back(move(d));
+        } else if (kind == "export") {
+            string name, s;
+            long off;
+            if (!(is >> name >> s >> off) || sectionOf(s) < 0 || off < 0) throw bad();
+            obj.exports.push_back({name, sectionOf(s), int32_t(off)});
+        } else if (kind == "import") {
+            string name;
+            if (!(is >> name)) throw bad();
+            obj.imports.push_back(name);
+        } else if (kind == "reloc") {
+            string s, k, target;
+            long off;
+            if (!(is >> s >> off >> k >> target) || sectionOf(s) < 0 || off < 0) throw bad();
+            ObjReloc r{sectionOf(s), int32_t(off), RelocKind::WORD, ""};
+            if (k == "beq") r.kind = RelocKind::BEQ;
+            else if (k == "abs16") r.kind = RelocKind::ABS16;
+            else if (k != "word") throw bad();
+            if (target[0] == '@') {
+                size_t plus = target.find('+');
+                if (plus == string::npos) throw bad();
+                r.targetSection = sectionOf(target.substr(1, plus - 1));
+                if (r.targetSection < 0 || !isNumber(target.substr(plus + 1))) throw bad();
+                r.targetOffset = stoi(target.substr(plus + 1));
+            } else {
+                r.symbol = target;
+            }
+            obj.relocs.push_back(r);
+        } else if (sectionOf(kind) >= 0) {
+            int s = sectionOf(kind);
+            long words, lines;
+            if (seen[s] || !(is >> words >> lines) || lines < 0) throw bad();
+            seen[s] = true;
+            string body;
+            for (long k = 0; k < lines; ++k) {
+                if (!getline(ifs, line)) throw bad();
+                ++lineno;
+                body += line;
+                body += '\n';
+            }
+            try {
+                obj.sections[s] = parseSparseImage(body);
+            } catch (const exception &e) {
+                throw runtime_error(path + ": " + SECTION_NAME[s] + " section: " + e.what());
+            }
+            if (obj.sections[s].size != words) throw bad();
+        } else {
+            throw bad();
+        }
+    }
+    for (const auto &r : obj.relocs)
+        if (r.offset >= obj.sections[r.section].size)
+            throw runtime_error(path + ": relocation outside its section");
+    return obj;
+}
+
+bool ObjectFile::upToDate(const string &path, uint64_t sourceHash, const string &baseDir) {
+    ifstream ifs(path, ios::binary);
+    string line, magic, kind;
+    int version = 0;
+    uint64_t h = 0;
+    if (!getline(ifs, line) || !(istringstream(line) >> magic >> version) || magic != "lcobj" || version != VERSION)
+        return false;
+    if (!getline(ifs, line) || !(istringstream(line) >> kind >> hex >> h) || kind != "source" || h != sourceHash)
+        return false;
+    // dep อยู่ต่อจาก source ทันที (save เขียนไว้ตรงนั้น) ไฟล์ที่ include เปลี่ยน → ต้องประกอบใหม่
+    while (getline(ifs, line) && line.compare(0, 4, "dep ") == 0) {
+        istringstream is(line.substr(4));
+        string dep;
+        if (!(is >> hex >> h >> ws) || !getline(is, dep)) return false;
+        fs::path p(dep);
+        if (p.is_relative()) p = fs::path(baseDir) / p;
+        if (hashSourceFile(p.string()) != h) return false;
+    }
+    return true;
+}
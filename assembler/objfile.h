@@ -0,0 +1,83 @@
+// objfile.h
+// relocatable object file (.o) ของ LC สำหรับประกอบแยกไฟล์แล้วค่อยลิงก์ (objasm.cpp → linker.cpp)
+//   - section code = คำสั่งทุกบรรทัด, section data = .fill/.space ทุกบรรทัด (ลำดับเดิมในแต่ละ section)
+//     linker วาง code ของทุก object ก่อน (object แรกเริ่มที่ PC 0) แล้วจึงเป็น data ของทุก object
+//   - export: label ทุกตัวที่ประกาศในไฟล์ (เหมือน parseFiles ที่ใช้ symbol table ร่วมกัน)
+//   - import: label ที่อ้างแต่ไม่ได้ประกาศในไฟล์ (Parser::parseModule)
+//   - relocation: field ที่ขึ้นกับตำแหน่งสุดท้าย
+//       beq   offset 16 บิต = target - (PC+1)   (beq ไป code ใน object เดียวกันคำนวณเสร็จตั้งแต่ตอนประกอบ)
+//       abs16 offset 16 บิตของ lw/sw = address ของ target
+//       word  ค่าทั้ง word ของ .fill (หรือทุก word ของ .space) = address ของ target
+//     target เป็นชื่อ import หรือตำแหน่งใน section ของตัวเอง (@code+N / @data+N)
+// ตัวเลขที่เขียนตรง ๆ ในโปรแกรม (address แบบ absolute) ไม่ถูกแก้ ยกเว้นที่ symbolizeIR แปลงเป็น label ได้
+//
+// รูปแบบไฟล์ (ข้อความ):
+//     lcobj 2
+//     source <hash ของไฟล์ต้นฉบับ 16 หลักฐานสิบหก>
+//     dep <hash 16 หลัก> <path>   ไฟล์ที่ .include เข้ามา (path เทียบกับโฟลเดอร์ของต้นฉบับ แบบ CacheDep ของ buildcache.h)
+//     export <name> code|data <offset>
+//     import <name>
+//     reloc code|data <offset> beq|abs16|word <name | @code+N | @data+N>
+//     code <words> <lines>      ตามด้วย <lines> บรรทัดรูปแบบ .mc (lc_image.h)
+//     data <words> <lines>
+
+#ifndef OBJFILE_H
+#define OBJFILE_H
+
+#include "lc_image.h"
+#include "parser.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+enum ObjSection { SEC_CODE = 0, SEC_DATA = 1 };
+enum class RelocKind { BEQ, ABS16, WORD };
+
+struct ObjSymbol {
+    string name;
+    int section;
+    int32_t offset;
+};
+
+struct ObjReloc {
+    int section;             // section ที่ต้องแก้
+    int32_t offset;          // word ใน section นั้น (ถ้าเป็น .space = word แรกของช่วง)
+    RelocKind kind;
+    string symbol;           // ชื่อ import (ว่าง = target อยู่ใน object นี้)
+    int targetSection = SEC_CODE;
+    int32_t targetOffset = 0;
+};
+
+// ไฟล์ที่ object ขึ้นอยู่ด้วยนอกจากตัวต้นฉบับ (.include)
+struct ObjDep {
+    uint64_t hash;           // hashSource ของเนื้อไฟล์
+    string path;
+};
+
+struct ObjectFile {
+    static constexpr int VERSION = 2;
+
+    uint64_t sourceHash = 0;
+    vector<ObjDep> deps;
+    SparseImage sections[2];
+    vector<ObjSymbol> exports;
+    vector<string> imports;
+    vector<ObjReloc> relocs;
+
+    void save(const string &path) const;
+    static ObjectFile load(const string &path);
+    // อ่านแค่ header: true = hash ของต้นฉบับตรงกับ sourceHash และทุก dep ยังมีเนื้อเดิม (baseDir = โฟลเดอร์ของต้นฉบับ)
+    // ไม่มีไฟล์ / อ่านไม่ได้ / คนละเวอร์ชัน = false ใช้เช็คว่าต้องประกอบใหม่มั้ย
+    static bool upToDate(const string &path, uint64_t sourceHash, const string &baseDir);
+};
+
+// FNV-1a 64 บิต ของ byte ทั้งไฟล์ (รวมเลขเวอร์ชันของรูปแบบ object ด้วย)
+uint64_t hashSource(const string &bytes);
+// hashSource ของเนื้อไฟล์ที่ path (0 ถ้าอ่านไม่ได้)
+uint64_t hashSourceFile(const string &path);
+
+// สร้าง object จาก Parser ที่ผ่าน parseModule แล้ว (throw runtime_error ถ้า beq ภายในไกลเกิน 16 บิต)
+ObjectFile buildObject(const Parser &prog);
+
+#endif
@@ -0,0 +1,224 @@
+// optimizer.cpp
+// ขั้น optimize (เลือกใช้ได้) ระหว่าง parser กับ assembler
+//   .asm → Parser → [passes บน IR] → <out>.ir + <out>_symbols.txt (ให้ assembler ใช้ต่อ) + <out>.asm
+// หลังจบจะรันโปรแกรมก่อน/หลัง optimize บน LcSim (Simulator/lc_sim.h) แล้วรายงานจำนวนคำสั่งที่ execute จริงที่ลดลง
+//
+// Compile : g++ -std=c++17 -O2 -DPARSER_NO_MAIN optimizer.cpp parser.cpp ir_utils.cpp peephole.cpp rewritedb.cpp constpool.cpp dce.cpp memopt.cpp inline.cpp layout.cpp schedule.cpp cfg.cpp -o optimizer
+// Run : .\optimizer --peephole ..\programs\combination.asm [-o program]
+//       .\optimizer --inline --peephole ..\programs\mullib.asm ..\programs\lib\lcrt.asm   (หลายไฟล์ = ลิงก์ก่อน)
+
+#include "parser.h"
+#include "ir_utils.h"
+#include "constpool.h"
+#include "dce.h"
+#include "inline.h"
+#include "layout.h"
+#include "memopt.h"
+#include "peephole.h"
+#include "pipeline.h"
+#include "profile.h"
+#include "schedule.h"
+#include "../Simulator/lc_sim.h"
+
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+static void usage(const char *argv0) {
+    cerr << "usage: " << argv0 << " [passes] [-o <outBase>] <input.asm> [more.asm ...]\n"
+         << "passes:\n"
+         << "  --layout PROF  จัดวาง basic block ตาม profile (ทำก่อน pass อื่น, PROF จาก --profile-out)\n"
+         << "  --inline       แทน call ไปยัง leaf subroutine ด้วยตัว routine (ทำก่อน pass อื่น)\n"
+         << "  --inline-budget N  ให้ image โตได้ไม่เกิน N word จากการ inline (ค่าเริ่มต้น 32, ใส่แล้วเปิด --inline)\n"
+         << "  --peephole     ลบ/แทนรูปแบบคำสั่งซ้ำซ้อนภายใน basic block\n"
+         << "  --rewrite-db F ใช้กฎจาก superoptimizer (ไฟล์ F ดู superopt.cpp) ร่วมกับ peephole\n"
+         << "  --constpool    รวม .fill ค่าคงที่ที่ซ้ำกัน (ใช้กับ lw 0 X label เท่านั้น)\n"
+         << "  --pool-place   (คู่กับ --constpool) ย้าย pool ไปไว้ต่อจาก code ที่ใช้มัน\n"
+         << "  --memopt       ลบ lw ที่ค่าอยู่ใน register แล้ว และ sw ลงช่อง stack ที่ไม่มีใครอ่าน\n"
+         << "  --dce          ลบ code ที่ไปไม่ถึงจาก PC 0 และ .fill ที่ไม่มีใครอ้างถึง\n"
+         << "  --schedule     จัดลำดับคำสั่งใน block ใหม่ลด load-use stall (ทำหลังสุด)\n"
+         << "  --hazard SPEC  latency ของแบบจำลอง pipeline เช่น \"lw=3,add=1,taken=1\" (ค่าเริ่มต้น lw=2 taken=1 อื่น ๆ = 1)\n"
+         << "  --profile-out F  เขียน profile (จำนวนครั้งต่อ PC และ edge) ของโปรแกรม input ลงไฟล์ F\n";
+}
+
+static const char *stopName(LcSim::Stop s) {
+    switch (s) {
+        case LcSim::Stop::HALT: return "halt";
+        case LcSim::Stop::STEP_LIMIT: return "step limit";
+        case LcSim::Stop::PC_OUT_OF_BOUNDS: return "pc out of bounds";
+        default: return "running";
+    }
+}
+
+struct RunStats {
+    long executed = 0;
+    long loads = 0;      // lw ที่ execute (รวมที่ address อยู่นอกหน่วยความจำ)
+    long stores = 0;     // sw ที่ execute
+    LcSim::Stop stop = LcSim::Stop::RUNNING;
+};
+
+// รันโปรแกรมบนเครื่องจำลองทีละ step แล้วคืนจำนวนคำสั่ง / lw / sw ที่ execute
+static RunStats simulate(const vector<IRLine> &ir) {
+    OutBuffer out(stdout);
+    LcSim sim(out);
+    sim.quiet = true;
+    sim.load(encodeIR(ir));
+    RunStats r;
+    while (r.stop == LcSim::Stop::RUNNING) {
+        const bool fetchable = sim.pc >= 0 && sim.pc < sim.numMemory;
+        const int op = fetchable ? decodeWord(sim.mem[sim.pc]).opcode : -1;
+        const long before = sim.executed;
+        sim.step(r.stop);
+        if (sim.executed == before) break;   // ชน guard / pc หลุดช่วง: ไม่มีคำสั่งไหนทำ
+        if (op == OPC_LW) r.loads++;
+        else if (op == OPC_SW) r.stores++;
+    }
+    r.executed = sim.executed;
+    return r;
+}
+
+int main(int argc, char **argv) {
+    bool doPeephole = false;
+    bool doConstPool = false, poolPlace = false;
+    bool doDce = false, doMemOpt = false;
+    bool doInline = false;
+    bool doSchedule = false;
+    HazardModel hazard;
+    int inlineBudget = 32;
+    string outBase = "program";
+    string rewriteDbPath;
+    string layoutProfile, profileOut;
+    vector<string> inputs;
+
+    try {
+        for (int i = 1; i < argc; ++i) {
+            string a = argv[i];
+            if (a == "--peephole") doPeephole = true;
+            else if (a == "--rewrite-db" && i + 1 < argc) { rewriteDbPath = argv[++i]; doPeephole = true; }
+            else if (a == "--inline") doInline = true;
+            else if (a == "--inline-budget" && i + 1 < argc) { inlineBudget = stoi(argv[++i]); doInline = true; }
+            else if (a == "--constpool") doConstPool = true;
+            else if (a == "--pool-place") poolPlace = true;
+            else if (a == "--memopt") doMemOpt = true;
+            else if (a == "--dce") doDce = true;
+            else if (a == "--schedule") doSchedule = true;
+            else if (a == "--layout" && i + 1 < argc) layoutProfile = argv[++i];
+            else if (a == "--profile-out" && i + 1 < argc) profileOut = argv[++i];
+            else if (a == "--hazard" && i + 1 < argc) hazard.parse(argv[++i]);
+            else if (a == "-o" && i + 1 < argc) outBase = argv[++i];
+            else if (!a.empty() && a[0] == '-') { usage(argv[0]); return 1; }
+            else inputs.push_back(a);
+        }
+    } catch (const exception &e) {
+        cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+    if (inputs.empty()) { usage(argv[0]); return 1; }
+
+    try {
+        Parser prog;
+        prog.parseFiles(inputs);
+        RunStats before = simulate(prog.getIR());
+        PipelineStats pipeBefore = runPipeline(encodeIR(prog.getIR()), hazard);
+        int sizeBefore = irImageSize(prog.getIR());
+
+        if (!profileOut.empty()) {
+            ExecProfile::collect(encodeIR(prog.getIR())).save(profileOut);
+            cout << "profile: written to " << profileOut << "\n";
+        }
+
+        if (!layoutProfile.empty()) {
+            ExecProfile prof;
+            prof.load(layoutProfile);
+            LayoutStats st = runLayout(prog, prof);
+            cout << "layout: " << st.blocks << " block(s) moved (" << st.coldBlocks << " cold), "
+                 << st.jumpsRemoved << " jump(s) removed, " << st.jumpsAdded << " jump(s) added";
+            if (st.regionsSkipped) cout << ", " << st.regionsSkipped << " code region(s) left as is";
+            cout << "\n";
+        }
+
+        if (doInline) {
+            InlineStats st = runInline(prog, inlineBudget);
+            cout << "inline: " << st.inlined << " of " << st.callSites << " call site(s) inlined, image +"
+                 << st.growth << " word(s)";
+            if (st.linkKept) cout << ", link register kept at " << st.linkKept;
+            cout << "\n";
+            for (const auto &note : st.notes) cout << "  not inlined: " << note << "\n";
+        }
+
+        if (doPeephole) {
+            RewriteDb db;
+            if (!rewriteDbPath.empty()) {
+                db.load(rewriteDbPath);
+                cout << "rewrite-db: " << db.size() << " rule(s), patterns up to " << db.maxLength()
+                     << " instruction(s) over " << db.maxRegs() << " register(s)\n";
+            }
+            PeepholeStats st = runPeephole(prog, rewriteDbPath.empty() ? nullptr : &db);
+            cout << "peephole: " << st.total() << " rewrite(s)"
+                 << " [beq-to-next " << st.branchToNext
+                 << ", noop " << st.noops
+                 << ", null add " << st.nullAdds
+                 << ", r0 write " << st.r0Writes
+                 << ", constant reload " << st.reloads
+                 << ", load-after-store " << st.storeLoads;
+            if (!rewriteDbPath.empty())
+                cout << ", dead write " << st.deadWrites << ", db rewrite " << st.dbRewrites
+                     << " (-" << st.dbSaved << " instr)";
+            cout << "]\n";
+        }
+
+        if (doConstPool) {
+            ConstPoolStats st = runConstPool(prog, poolPlace);
+            cout << "constpool: " << st.candidates << " constant(s), " << st.merged
+                 << " duplicate(s) merged, " << st.pooled << " pooled"
+                 << (st.placed ? ", pool placed after its users" : "") << "\n";
+        }
+
+        if (doMemOpt) {
+            MemOptStats st = runMemOpt(prog);
+            if (st.skipped) cout << "memopt: skipped (" << st.why << ")\n";
+            else cout << "memopt: stack pointer " << (st.spReg > 0 ? "r" + to_string(st.spReg) : string("not found"))
+                      << ", " << st.loadsRemoved << " load(s) removed, " << st.loadsToMoves
+                      << " load(s) turned into add, " << st.deadStores << " dead store(s) removed\n";
+        }
+
+        if (doDce) {
+            DceStats st = runDeadCodeElim(prog);
+            if (st.skipped) cout << "dce: skipped (call with unknown target)\n";
+            else cout << "dce: removed " << st.deadCode << " unreachable instruction(s), "
+                      << st.deadData << " unreferenced data word(s)\n";
+        }
+
+        if (doSchedule) {
+            ScheduleStats st = runScheduler(prog, hazard);
+            cout << "schedule: " << st.blocks << " block(s) reordered, " << st.moved << " instruction(s) moved, "
+                 << "static stalls " << st.stallsBefore << " -> " << st.stallsAfter << "\n";
+        }
+
+        RunStats after = simulate(prog.getIR());
+        PipelineStats pipeAfter = runPipeline(encodeIR(prog.getIR()), hazard);
+
+        prog.writeIRFile(outBase + ".ir");
+        prog.writeSymbolsFile(outBase + "_symbols.txt");
+        writeAsmFile(prog.getIR(), outBase + ".asm");
+
+        cout << "image size: " << sizeBefore << " -> " << irImageSize(prog.getIR()) << " word(s)\n";
+        cout << "dynamic instructions: " << before.executed << " -> " << after.executed
+             << " (saved " << (before.executed - after.executed) << ")"
+             << "  [stop: " << stopName(before.stop) << " / " << stopName(after.stop) << "]\n";
+        cout << "memory accesses: " << (before.loads + before.stores) << " -> " << (after.loads + after.stores)
+             << " (lw " << before.loads << " -> " << after.loads << ", sw " << before.stores << " -> " << after.stores << ")\n";
+        cout << "pipeline model: stalls " << pipeBefore.stalls << " -> " << pipeAfter.stalls
+             << ", taken branches " << pipeBefore.taken << " -> " << pipeAfter.taken
+             << ", cycles " << pipeBefore.cycles() << " -> " << pipeAfter.cycles() << "\n";
+        cout << "Output written to: " << outBase << ".ir, " << outBase << "_symbols.txt and "
+             << outBase << ".asm\n";
+    } catch (const exception &e) {
+        cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
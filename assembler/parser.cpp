@@ -1,7 +1,8 @@
 // Compile : g++ -std=c++17 parser.cpp -o parser 
-// Run : .\parser
+// Run : .\parser   หรือ   .\parser ..\programs\mullib.asm ..\programs\lib\lcrt.asm   (หลายไฟล์ = ลิงก์ต่อกัน)
 
 #include "parser.h"
+#include "mulc.h"
 #include <fstream>
 #include <sstream>
 #include <unordered_set>
@@ -11,14 +12,25 @@
 #include <iostream>
 #include <limits>
 #include <iomanip>
+#include <algorithm>
+#include <filesystem>
+#include <memory>
+#include <mutex>
 
 using namespace std;
+namespace fs = std::filesystem;
 
 // set ของ mnemonic ที่เก็บ opcode(ชื่อคำสั่ง) ที่ valid
 static const unordered_set<string> MNEMONICS = {
-    "add","nand","lw","sw","beq","jalr","halt","noop", ".fill"
+    "add","nand","lw","sw","beq","jalr","halt","noop", ".fill", ".space", ".block"
 };
 
+// pseudo-instruction/directive ที่ pass1 แปลงเป็นคำสั่งจริงไปแล้ว จึงไม่เหลือถึง pass2
+//   .scratch R       — ประกาศ register ที่ mulc ใช้เป็นที่พักค่าได้ (ไม่กิน address)
+//   mulc src dest K  — dest = src * K ขยายเป็นลำดับ add/nand (mulc.h)
+//   .include "file"  — แทรกโค้ดของไฟล์อื่นตรงนี้ (path เทียบกับโฟลเดอร์ของไฟล์ที่ include)
+static const unordered_set<string> PSEUDO = { "mulc", ".scratch", ".include" };
+
 // เช็คว่าค่าที่รับเข้ามาเป็นตัวเลขมั้ย
 bool isNumber(const string &s) {
     if (s.empty()) return false;
@@ -30,6 +42,16 @@ bool isNumber(const string &s) {
     return true;
 }
 
+// .space N [value] (หรือ .block) — จองหน่วยความจำ N word ติดกัน ทุก word มีค่า value (ไม่ใส่ = 0, เป็น label ได้)
+// กิน IR แค่บรรทัดเดียว (IRLine::words = N) และ assembler เขียนเป็น record เดียวในไฟล์ .mc (ดู lc_image.h)
+static bool isSpaceDirective(const string &m) { return m == ".space" || m == ".block"; }
+
+static int spaceWords(const IRLine &L, const string &at) {
+    if (!isNumber(L.f0) || L.f0.size() > 12 || stoll(L.f0) < 1 || stoll(L.f0) > 65536)
+        throw runtime_error(L.instr + " needs a size 1..65536 at " + at);
+    return stoi(L.f0);
+}
+
 // เช็คว่ารูปแบบของ label ถูกต้องตามเงื่อนไขมั้ย (LC-2K)
 static bool validLabelName(const string &s) {
     if (s.empty()) return false;
@@ -58,10 +80,12 @@ static vector<string> tokenize_ws(const string &s) {
 
 Parser::Parser() {}
 
-// อ่านไฟล์ assembly ทั้งหมดเก็บลง vector<string> rawLines
-// พร้อมกับลบ comment ที่เจอ (เช่น # หรือ ;)
+// อ่านไฟล์ assembly ทั้งหมดต่อท้าย vector<string> rawLines
+// พร้อมกับลบ comment ที่เจอ (เช่น # หรือ ;) และจำว่าแต่ละบรรทัดมาจากไฟล์ไหน บรรทัดที่เท่าไร
 void Parser::readAllLines(const string &filename, const string &commentChars) {
-    rawLines.clear();
+    int fileIdx = (int)sourceFiles.size();
+    sourceFiles.push_back(filename);
+    int n = 0;
     ifstream ifs(filename);
     if (!ifs.is_open()) throw runtime_error("cannot open input file: " + filename);
     string line;
@@ -82,20 +106,27 @@ void Parser::readAllLines(const string &filename, const string &commentChars) {
 
         // เก็บ raw line แม้ว่าจะป็น blank line หรือ whitespace (ไว้ใช้กรณีนับ address)
         rawLines.push_back(line);
+        lineFile.push_back(fileIdx);
+        lineNumber.push_back(++n);
     }
     ifs.close();
 }
 
 // - แปลงแต่ละบรรทัดเป็น IRLine (บรรทัดคำสั่ง)
 // - เก็บ label ที่เจอไว้ใน symbol table พร้อม address ของ label นั้นๆ
-void Parser::pass1_buildSymbolTable(bool countBlankLines) {
+void Parser::pass1_buildSymbolTable(bool countBlankLines, const string &commentChars) {
     ir.clear();
     symbols.clear();
+    mulcs.clear();
+    includes.clear();
     unordered_map<string,int> labelToAddr;
     int addr = 0;
+    int scratch = -1;   // register จาก .scratch ล่าสุด (-1 = ยังไม่ประกาศ)
 
     for (size_t lineno = 0; lineno < rawLines.size(); ++lineno) {
         string line = rawLines[lineno];
+        // .scratch มีผลเฉพาะในไฟล์ที่ประกาศ
+        if (lineno > 0 && lineFile[lineno] != lineFile[lineno-1]) scratch = -1;
         vector<string> toks = tokenize_ws(line);
         bool isBlank = toks.empty();
         IRLine L;
@@ -116,19 +147,19 @@ void Parser::pass1_buildSymbolTable(bool countBlankLines) {
         } else {        
             // เช็คว่า tokens ที่เก็บมาตัวแรกเป็น label หรือ mnemonic
             string first = toks[0];
-            bool firstIsMnemonic = (MNEMONICS.find(first) != MNEMONICS.end());
+            bool firstIsMnemonic = (MNEMONICS.find(first) != MNEMONICS.end() || PSEUDO.find(first) != PSEUDO.end());
             
             // ถ้าตัวแรกเป็น label ไม่ใช่ mnemonic
             if (!firstIsMnemonic) {   
 
                 // เช็ค validity ของ label ว่าถูกต้องมั้ย
                 if (!validLabelName(first)) {
-                    throw runtime_error("invalid label name '" + first + "' at source line " + to_string(lineno+1));
+                    throw runtime_error("invalid label name '" + first + "' at " + where(lineno));
                 }
 
                 // เช็คว่ามี label ซ้ำรึเปล่า
                 if (labelToAddr.find(first) != labelToAddr.end()) {
-                    throw runtime_error("duplicate label '" + first + "' at source line " + to_string(lineno+1));
+                    throw runtime_error("duplicate label '" + first + "' at " + where(lineno));
                 }
 
                 // บันทึก label และ address ลง symbol table
@@ -152,10 +183,163 @@ void Parser::pass1_buildSymbolTable(bool countBlankLines) {
             }
         }
 
+        // .include แทรก IR ของอีกไฟล์ (parse ไว้แล้วใน cache ของ process) ติด label ไม่ได้เหมือน .scratch
+        if (L.instr == ".include") {
+            if (!L.rawLabel.empty())
+                throw runtime_error(".include cannot have a label at " + where(lineno));
+            spliceInclude(lineno, addr, labelToAddr, countBlankLines, commentChars);
+            continue;
+        }
+
+        // .scratch ไม่สร้าง word ในหน่วยความจำ (จึงติด label ไม่ได้)
+        if (L.instr == ".scratch") {
+            if (!L.rawLabel.empty())
+                throw runtime_error(".scratch cannot have a label at " + where(lineno));
+            if (!isNumber(L.f0) || stoll(L.f0) < 1 || stoll(L.f0) > 7)
+                throw runtime_error(".scratch needs a register 1..7 at " + where(lineno));
+            scratch = stoi(L.f0);
+            continue;
+        }
+
+        // mulc ขยายเป็นหลายบรรทัด label ติดไปกับบรรทัดแรก
+        if (L.instr == "mulc") {
+            if (L.f0.empty() || L.f1.empty() || L.f2.empty())
+                throw runtime_error("mulc missing field at " + where(lineno));
+            if (!isNumber(L.f0) || !isNumber(L.f1) || !isNumber(L.f2))
+                throw runtime_error("mulc operands must be numeric at " + where(lineno));
+            if (L.f2.size() > 11 || stoll(L.f2) < numeric_limits<int>::min() || stoll(L.f2) > numeric_limits<int>::max())
+                throw runtime_error("mulc constant out of 32-bit range at " + where(lineno));
+            int src = stoi(L.f0), dest = stoi(L.f1), k = stoi(L.f2);
+            MulcPlan plan;
+            try {
+                plan = planMulc(src, dest, scratch, k);
+            } catch (const runtime_error &e) {
+                throw runtime_error(string(e.what()) + " at " + where(lineno));
+            }
+            mulcs.push_back({lineNumber[lineno], addr, src, dest, scratch, k,
+                             (int)plan.ops.size(), plan.binaryCost, plan.method});
+            for (size_t j = 0; j < plan.ops.size(); ++j) {
+                IRLine E;
+                E.address = addr++;
+                E.rawLabel = (j == 0) ? L.rawLabel : "";
+                E.instr = plan.ops[j].nand ? "nand" : "add";
+                E.f0 = to_string(plan.ops[j].a);
+                E.f1 = to_string(plan.ops[j].b);
+                E.f2 = to_string(plan.ops[j].d);
+                ir.push_back(E);
+            }
+            continue;
+        }
+
+        // .space กิน N word แต่ยังเป็น IR บรรทัดเดียว
+        if (isSpaceDirective(L.instr)) {
+            L.words = spaceWords(L, where(lineno));
+            if (addr + L.words > 65536)
+                throw runtime_error(L.instr + " reserves past the 65536-word memory at " + where(lineno));
+        }
+
         // เพิ่มบรรทัดเข้า IR และขยับ address ไปถัดไป
         ir.push_back(L);
-        addr++;
+        addr += L.words;
+    }
+}
+
+// ---------------- .include ----------------
+// ไฟล์ที่ถูก include parse (pass1) ครั้งเดียวต่อ process แล้วเก็บเป็น fragment ที่ address เริ่มจาก 0
+// ตอนแทรกแค่บวก address ฐานให้ทุกบรรทัด/label (relocatable) ไม่ต้องอ่านและ tokenize ไฟล์ใหม่
+// key = path เต็ม + option ของ parser, ใช้ซ้ำได้ตราบที่ mtime ของไฟล์นั้นและไฟล์ที่มัน include ต่อไม่เปลี่ยน
+// label ที่อ้างข้ามไฟล์ resolve ใน pass2 ของโปรแกรมที่รวมแล้ว เหมือน parseFiles
+struct IncludeFragment {
+    vector<IRLine> ir;
+    vector<Label> symbols;
+    vector<MulcExpansion> mulcs;
+    int words = 0;
+    vector<pair<string, fs::file_time_type>> files;   // ตัวมันเอง + ไฟล์ที่ include ซ้อน
+};
+
+static mutex includeCacheMutex;
+static unordered_map<string, shared_ptr<const IncludeFragment>> includeCache;
+
+static bool fragmentUpToDate(const IncludeFragment &f) {
+    for (const auto &file : f.files) {
+        error_code ec;
+        if (fs::last_write_time(file.first, ec) != file.second || ec) return false;
     }
+    return true;
+}
+
+void Parser::spliceInclude(size_t lineno, int &addr, unordered_map<string,int> &labelToAddr,
+                           bool countBlankLines, const string &commentChars) {
+    const string &line = rawLines[lineno];
+    size_t q1 = line.find('"'), q2 = line.rfind('"');
+    if (q1 == string::npos || q2 <= q1 + 1 || !tokenize_ws(line.substr(q2 + 1)).empty())
+        throw runtime_error(".include needs a quoted file name at " + where(lineno));
+
+    const string &from = sourceFiles[lineFile[lineno]];
+    fs::path target = fs::path(line.substr(q1 + 1, q2 - q1 - 1));
+    if (target.is_relative()) target = fs::path(from).parent_path() / target;
+    error_code ec;
+    fs::path full = fs::weakly_canonical(target, ec);
+    if (ec || !fs::is_regular_file(full, ec))
+        throw runtime_error("cannot open included file '" + target.string() + "' at " + where(lineno));
+    const string path = full.string();
+
+    // include วน: ไฟล์ปลายทางกำลังถูก parse อยู่ในสายเดียวกัน
+    vector<string> chain = includeStack;
+    chain.push_back(fs::weakly_canonical(fs::path(from), ec).string());
+    for (size_t k = 0; k < chain.size(); ++k)
+        if (chain[k] == path) {
+            string msg;
+            for (size_t j = k; j < chain.size(); ++j) msg += chain[j] + " -> ";
+            throw runtime_error("include cycle: " + msg + path + " at " + where(lineno));
+        }
+
+    const string key = path + '\n' + (countBlankLines ? "1" : "0") + commentChars;
+    shared_ptr<const IncludeFragment> frag;
+    {
+        lock_guard<mutex> lock(includeCacheMutex);
+        auto it = includeCache.find(key);
+        if (it != includeCache.end() && fragmentUpToDate(*it->second)) frag = it->second;
+    }
+    if (!frag) {
+        auto built = make_shared<IncludeFragment>();
+        built->files.push_back({path, fs::last_write_time(full, ec)});
+        Parser sub;
+        sub.includeStack = chain;
+        try {
+            sub.readAllLines(path, commentChars);
+            sub.pass1_buildSymbolTable(countBlankLines, commentChars);
+        } catch (const exception &e) {
+            throw runtime_error(string(e.what()) + " (in " + path + ", included at " + where(lineno) + ")");
+        }
+        for (const string &f : sub.includes) built->files.push_back({f, fs::last_write_time(f, ec)});
+        for (const auto &L : sub.ir) built->words += L.words;
+        built->ir = move(sub.ir);
+        built->symbols = move(sub.symbols);
+        built->mulcs = move(sub.mulcs);
+        frag = built;
+        lock_guard<mutex> lock(includeCacheMutex);
+        includeCache[key] = frag;
+    }
+
+    if (addr + frag->words > 65536)
+        throw runtime_error("included file '" + path + "' does not fit in the 65536-word memory at " + where(lineno));
+    for (const auto &s : frag->symbols) {
+        if (!labelToAddr.insert({s.name, addr + s.address}).second)
+            throw runtime_error("duplicate label '" + s.name + "' from included file '" + path + "' at " + where(lineno));
+        symbols.push_back({s.name, addr + s.address});
+    }
+    for (IRLine L : frag->ir) {
+        L.address += addr;
+        ir.push_back(move(L));
+    }
+    for (MulcExpansion m : frag->mulcs) {
+        m.address += addr;
+        mulcs.push_back(m);
+    }
+    for (const auto &f : frag->files)
+        if (find(includes.begin(), includes.end(), f.first) == includes.end()) includes.push_back(f.first);
+    addr += frag->words;
 }
 
 // ใช้ข้อมูลจาก pass1 เพื่อ resolve ค่า operand ให้สมบูรณ์ เช่น:
@@ -167,6 +351,20 @@ void Parser::pass2_resolve(bool countBlankLines) {
     unordered_map<string,int> labelToAddr;
     for (const auto &lab : symbols) labelToAddr[lab.name] = lab.address;
 
+    // หา address ของ label ถ้าไม่มีในไฟล์: parse แบบ module (parseModule) ถือเป็น import ให้ค่า 0 ไว้ก่อน
+    // (linker เป็นคนแก้ทีหลัง) ไม่งั้น throw เหมือนเดิม
+    imports.clear();
+    unordered_set<string> importSet;
+    auto resolve = [&](const string &name, const string &use, const IRLine &L, int &out) {
+        auto it = labelToAddr.find(name);
+        if (it != labelToAddr.end()) { out = it->second; return true; }
+        if (!allowImports)
+            throw runtime_error("undefined label '" + name + "' used in " + use + " at address " + to_string(L.address));
+        if (importSet.insert(name).second) imports.push_back(name);
+        out = 0;
+        return false;
+    };
+
     for (size_t i = 0; i < ir.size(); ++i) {
         IRLine &L = ir[i];
         string m = L.instr;
@@ -195,9 +393,20 @@ void Parser::pass2_resolve(bool countBlankLines) {
             // ถ้าเป็นชื่อ label ให้หา address ของ label น้้นๆ
             } else {
                 // ถ้าไม่มีใน list ของ label ที่เคยเก็บแสดงว่า error
-                if (labelToAddr.find(L.f0) == labelToAddr.end()) 
-                    throw runtime_error("undefined label '" + L.f0 + "' used in .fill at address " + to_string(L.address));
-                L.fillValue = labelToAddr[L.f0];
+                resolve(L.f0, ".fill", L, L.fillValue);
+            }
+            continue;
+        }
+
+        // .space/.block — ค่าของทุก word ในช่วง (จำนวน word คิดไว้แล้วใน pass1/replaceIR)
+        if (isSpaceDirective(m)) {
+            L.isFill = true;
+            if (L.f1.empty()) {
+                L.fillValue = 0;
+            } else if (isNumber(L.f1)) {
+                L.fillValue = static_cast<int>(stoll(L.f1));
+            } else {
+                resolve(L.f1, m, L, L.fillValue);
             }
             continue;
         }
@@ -242,10 +451,8 @@ void Parser::pass2_resolve(bool countBlankLines) {
                 L.offset16 = static_cast<int>(v);
             // ถ้า offset เป็น label ให้แทน label ด้วย addr แล้วเช็คว่า addr อยู่ในช่วง 16 บิต มั้ย้
             } else {
-                if (labelToAddr.find(L.f2) == labelToAddr.end()) 
-                    throw runtime_error("undefined label '" + L.f2 + "' used in lw/sw at address " + to_string(L.address));
-                int addrLabel = labelToAddr[L.f2];
-                if (addrLabel < -32768 || addrLabel > 32767) 
+                int addrLabel = 0;
+                if (resolve(L.f2, "lw/sw", L, addrLabel) && (addrLabel < -32768 || addrLabel > 32767))
                     throw runtime_error("label address out of 16-bit range for lw/sw at address " + to_string(L.address));
                 L.offset16 = addrLabel;
             }
@@ -274,9 +481,8 @@ void Parser::pass2_resolve(bool countBlankLines) {
                 L.offset16 = static_cast<int>(v);
             // ถ้า offset เป็น label ให้คำนวณ offset แบบ relative คือ address(label) - (address(ปัจจุบัน) + 1)
             } else {
-                if (labelToAddr.find(L.f2) == labelToAddr.end()) 
-                    throw runtime_error("undefined label '" + L.f2 + "' used in beq at address " + to_string(L.address));
-                int addrLabel = labelToAddr[L.f2];
+                int addrLabel = 0;
+                if (!resolve(L.f2, "beq", L, addrLabel)) continue;   // import: linker คำนวณ offset เอง
                 long long offset = static_cast<long long>(addrLabel) - (static_cast<long long>(L.address) + 1LL);
                 if (offset < -32768 || offset > 32767) 
                     throw runtime_error("beq offset out of range for label '" + L.f2 + "' at address " + to_string(L.address));
@@ -310,16 +516,75 @@ void Parser::pass2_resolve(bool countBlankLines) {
     }
 }
 
+// ตำแหน่งในไฟล์สำหรับข้อความ error ("source line N" หรือ "source line N of file" ถ้า parse หลายไฟล์)
+string Parser::where(size_t lineno) const {
+    string s = "source line " + to_string(lineNumber[lineno]);
+    if (sourceFiles.size() > 1) s += " of " + sourceFiles[lineFile[lineno]];
+    return s;
+}
+
 // parseFile() รวมทุกขั้นตอนการ parse: อ่านไฟล์, pass1, pass2
 void Parser::parseFile(const string &filename, bool countBlankLines, const string &commentChars) {
+    parseFiles({filename}, countBlankLines, commentChars);
+}
+
+// parseFiles() ลิงก์หลายไฟล์เป็นโปรแกรมเดียว: ต่อกันตามลำดับ (ไฟล์แรกเริ่มที่ address 0)
+// ใช้ symbol table ร่วมกัน จึงเรียก routine ข้ามไฟล์ผ่าน label ได้ เช่นโปรแกรม + programs/lib/lcrt.asm
+void Parser::parseFiles(const vector<string> &filenames, bool countBlankLines, const string &commentChars) {
+    allowImports = false;
+    rawLines.clear();
+    sourceFiles.clear();
+    lineFile.clear();
+    lineNumber.clear();
+    for (const string &f : filenames) readAllLines(f, commentChars);
+    pass1_buildSymbolTable(countBlankLines, commentChars);
+    pass2_resolve(countBlankLines);
+}
+
+// parseModule() parse ไฟล์เดียวเพื่อทำ object file (objfile.h): label ที่ไม่ได้ประกาศในไฟล์ไม่ error
+// แต่เก็บไว้ใน getImports() และให้ค่า 0 ไว้ก่อน (linker แก้ตาม relocation)
+void Parser::parseModule(const string &filename, bool countBlankLines, const string &commentChars) {
+    rawLines.clear();
+    sourceFiles.clear();
+    lineFile.clear();
+    lineNumber.clear();
     readAllLines(filename, commentChars);
-    pass1_buildSymbolTable(countBlankLines);
+    allowImports = true;
+    pass1_buildSymbolTable(countBlankLines, commentChars);
     pass2_resolve(countBlankLines);
 }
 
+// replaceIR() ใช้หลังจาก optimizer ลบ/แก้/ย้ายบรรทัดใน IR
+// label ยังติดอยู่กับบรรทัด (rawLabel) จึงแค่ไล่ address ใหม่ สร้าง symbol table ใหม่ แล้ว resolve ซ้ำ
+// ทำให้ offset ของ beq และ address ของ lw/sw/.fill ที่อ้าง label ถูกต้องตามตำแหน่งใหม่เสมอ
+void Parser::replaceIR(const vector<IRLine> &newIR) {
+    ir = newIR;
+    symbols.clear();
+    unordered_set<string> seen;
+    int addr = 0;
+    for (auto &L : ir) {
+        L.address = addr;
+        L.words = isSpaceDirective(L.instr) ? spaceWords(L, "address " + to_string(addr)) : 1;
+        addr += L.words;
+        L.isFill = false;
+        L.hasError = false;
+        L.errorMsg.clear();
+        L.regA = L.regB = L.dest = L.offset16 = L.fillValue = 0;
+        if (!L.rawLabel.empty()) {
+            if (!seen.insert(L.rawLabel).second)
+                throw runtime_error("duplicate label '" + L.rawLabel + "' after IR rewrite");
+            symbols.push_back({L.rawLabel, L.address});
+        }
+    }
+    pass2_resolve(false);
+}
+
 // ฟังก์ชันสำหรับดึงข้อมูล IR และ symbol ออกไปใช้งาน
 const vector<IRLine>& Parser::getIR() const { return ir; }
 const vector<Label>& Parser::getSymbols() const { return symbols; }
+const vector<MulcExpansion>& Parser::getMulcExpansions() const { return mulcs; }
+const vector<string>& Parser::getImports() const { return imports; }
+const vector<string>& Parser::getIncludes() const { return includes; }
 
 // เขียนข้อมูล IR (intermediate representation) ลงไฟล์ .ir
 // เพื่อใช้เป็น input ของ assembler
@@ -381,11 +646,24 @@ void Parser::writeSymbolsFile(const string &outname) const {
     ofs.close();
 }
 
-int main() {
+// main ของ parser แบบ standalone
+// เครื่องมืออื่นที่ลิงก์ parser.cpp เข้าไปด้วย (เช่น optimizer) ให้คอมไพล์พร้อม -DPARSER_NO_MAIN
+#ifndef PARSER_NO_MAIN
+int main(int argc, char **argv) {
     string inputFile = "test(assembly-language).asm";   // test(assembly-language).asm ไฟล์ assembly สำหรับเทส
                                                         // ../programs/factorial.asm , multiply.asm
+    // ถ้าระบุไฟล์มาทาง command line จะลิงก์ทุกไฟล์ต่อกัน เช่น .\parser prog.asm ..\programs\lib\lcrt.asm
+    vector<string> inputFiles;
+    for (int i = 1; i < argc; ++i) inputFiles.push_back(argv[i]);
+    if (inputFiles.empty()) inputFiles.push_back(inputFile);
+
     Parser parser;                   
-    parser.parseFile(inputFile);                        // เรียกฟังก์ชันหลักเพื่ออ่านและแยกข้อมูล
+    try {
+        parser.parseFiles(inputFiles);                  // เรียกฟังก์ชันหลักเพื่ออ่านและแยกข้อมูล
+    } catch (const exception &e) {
+        cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
 
     cout << "\nParsing...";
     cout << "\n-------------------------------------\n";
@@ -396,6 +674,17 @@ int main() {
              << "-> Address: " << sym.address << endl;
     }
 
+    if (!parser.getMulcExpansions().empty()) {
+        cout << "\nmulc expansions:\n";
+        for (auto &m : parser.getMulcExpansions()) {
+            cout << "  line " << m.sourceLine << ": mulc " << m.src << " " << m.dest << " " << m.k
+                 << " -> " << m.cost << " instr at address " << m.address << " (" << m.method
+                 << ", binary " << m.binaryCost << ")";
+            if (m.scratch >= 0) cout << ", scratch r" << m.scratch;
+            cout << endl;
+        }
+    }
+
     cout << "\nParsed Instructions:\n";
     auto insts = parser.getIR();
     for (auto &inst : insts) {
@@ -419,4 +708,4 @@ int main() {
 
     return 0;
 }
-
+#endif
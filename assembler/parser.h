@@ -2,6 +2,7 @@
 #define PARSER_H
 
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 using namespace std;
@@ -26,29 +27,64 @@ struct IRLine {
     int dest = 0;
     int offset16 = 0;      
     int fillValue = 0;     
+    int words = 1;         // จำนวน word ที่บรรทัดนี้กิน (.space/.block N = N, อื่น ๆ = 1)
 };
 
+// บันทึกการขยาย pseudo-instruction "mulc src dest K" (ดู mulc.h) ไว้รายงานต้นทุน
+struct MulcExpansion {
+    int sourceLine;     // บรรทัดในไฟล์ .asm (นับจาก 1)
+    int address;        // address ของคำสั่งแรกที่ขยายได้
+    int src, dest, scratch;
+    int k;
+    int cost;           // จำนวนคำสั่ง (= cycle เพราะ add/nand ใช้ 1 cycle)
+    int binaryCost;     // จำนวนคำสั่งถ้าใช้ binary shift-and-add ธรรมดา
+    string method;
+};
+
+// เช็คว่า token เป็นเลขฐานสิบ (มี +/- นำหน้าได้) หรือไม่ — ใช้ร่วมกับ pass ต่าง ๆ ใน optimizer
+bool isNumber(const string &s);
+
 class Parser {
 public:
     Parser();
     
     void parseFile(const string &filename, bool countBlankLines = false, const string &commentChars = "#;");
+    // ลิงก์หลายไฟล์ (เช่นโปรแกรม + ไลบรารี) เป็น image เดียว ไฟล์แรกเริ่มที่ address 0
+    void parseFiles(const vector<string> &filenames, bool countBlankLines = false, const string &commentChars = "#;");
+    // parse ไฟล์เดียวเป็น module แยก (ทำ object file): label ที่ไม่มีในไฟล์กลายเป็น import แทนการ error
+    void parseModule(const string &filename, bool countBlankLines = false, const string &commentChars = "#;");
 
     const vector<IRLine>& getIR() const;
     const vector<Label>& getSymbols() const;
+    const vector<MulcExpansion>& getMulcExpansions() const;
+    const vector<string>& getImports() const;   // label ที่ parseModule ไม่เจอในไฟล์ (ตามลำดับที่อ้างครั้งแรก)
+    const vector<string>& getIncludes() const;  // ไฟล์ที่ถูก .include (รวมที่ include ซ้อน, path เต็ม ไม่ซ้ำ)
 
     
     void writeIRFile(const string &outname = "program.ir") const;
     void writeSymbolsFile(const string &outname = "program_symbols.txt") const;
 
+    // ให้ pass ภายนอก (optimizer) ส่ง IR ที่แก้แล้วกลับมา: คำนวณ address, symbol table และ operand ใหม่ทั้งหมด
+    void replaceIR(const vector<IRLine> &newIR);
+
 private:
     vector<string> rawLines;
+    vector<string> sourceFiles;
+    vector<int> lineFile, lineNumber;   // ไฟล์และเลขบรรทัดของ rawLines[i]
     vector<IRLine> ir;
     vector<Label> symbols;
+    vector<MulcExpansion> mulcs;
+    vector<string> imports;
+    vector<string> includes;
+    vector<string> includeStack;        // ไฟล์ที่กำลัง include ซ้อนกันอยู่ (ไว้หา include วน)
+    bool allowImports = false;
 
     void readAllLines(const std::string &filename, const std::string &commentChars);
-    void pass1_buildSymbolTable(bool countBlankLines);
+    string where(size_t lineno) const;
+    void pass1_buildSymbolTable(bool countBlankLines, const string &commentChars);
     void pass2_resolve(bool countBlankLines);
+    void spliceInclude(size_t lineno, int &addr, unordered_map<string,int> &labelToAddr,
+                       bool countBlankLines, const string &commentChars);
 };
 
 #endif 
\ No newline at end of file
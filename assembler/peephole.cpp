@@ -0,0 +1,245 @@
+// peephole.cpp — ดูรายการกฎใน peephole.h
+
+#include "peephole.h"
+#include "ir_utils.h"
+#include "lc_isa.h"
+
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+using namespace std;
+
+// สถานะที่รู้ภายใน basic block ปัจจุบัน
+struct BlockFacts {
+    string constOf[8];        // constOf[r] = token L ถ้า r เก็บค่า mem[L] ที่โหลดด้วย lw 0 r L
+    bool   hasStore = false;  // sw ล่าสุดที่ยังใช้ได้
+    int    storeBase = 0, storeSrc = 0;
+    string storeOff;
+
+    void reset() {
+        for (auto &c : constOf) c.clear();
+        hasStore = false;
+    }
+    // มีการเขียน register r → ความรู้ที่ขึ้นกับ r ใช้ไม่ได้แล้ว
+    void clobber(int r) {
+        constOf[r].clear();
+        if (hasStore && (r == storeBase || r == storeSrc)) hasStore = false;
+    }
+};
+
+// register ที่คำสั่งเขียน (-1 ถ้าไม่เขียน)
+static int writtenReg(const IRLine &L) {
+    switch (irOpcode(L)) {
+        case OPC_ADD: case OPC_NAND: return L.dest;
+        case OPC_LW: case OPC_JALR:  return L.regB;
+        default: return -1;
+    }
+}
+
+// หนึ่งรอบของการไล่ IR: ทำเครื่องหมายบรรทัดที่ลบได้ และแก้บรรทัดที่เขียนใหม่ได้ คืน true ถ้ามีอะไรเปลี่ยน
+static bool peepholeRound(vector<IRLine> &ir, PeepholeStats &st) {
+    vector<char> kill(ir.size(), 0);
+    bool changed = false;
+    BlockFacts f;
+
+    // หลัง symbolizeIR ทุก target ของ beq เป็น label แล้ว → label ที่ไม่มีใครอ้างไม่ใช่จุดเริ่ม block
+    unordered_set<string> referenced;
+    for (const auto &L : ir)
+        if (const string *ref = irLabelRef(L)) referenced.insert(*ref);
+
+    for (size_t i = 0; i < ir.size(); ++i) {
+        IRLine &L = ir[i];
+        int op = irOpcode(L);
+        // บรรทัดที่มี label อาจถูกกระโดดมาจากที่อื่น → เริ่ม block ใหม่
+        if ((!L.rawLabel.empty() && referenced.count(L.rawLabel)) || op < 0) f.reset();
+        if (op < 0) continue;  // .fill
+
+        switch (op) {
+            case OPC_NOOP:
+                kill[i] = 1; st.noops++;
+                continue;
+            case OPC_BEQ:
+                // beq ไม่เขียน register: ทาง fall through (บรรทัดถัดไปที่ไม่มี label) ยังใช้ความรู้เดิมได้
+                if (L.offset16 == 0) { kill[i] = 1; st.branchToNext++; }
+                continue;
+            case OPC_ADD: case OPC_NAND:
+                if (L.dest == 0) { kill[i] = 1; st.r0Writes++; continue; }
+                if (op == OPC_ADD && ((L.regB == 0 && L.dest == L.regA) || (L.regA == 0 && L.dest == L.regB))) {
+                    kill[i] = 1; st.nullAdds++; continue;
+                }
+                break;
+            case OPC_LW: {
+                int x = L.regB;
+                // กฎ 6: อ่านช่องเดียวกับที่เพิ่ง sw ไป (base ยังไม่เปลี่ยน) → ค่าอยู่ใน storeSrc แล้ว
+                if (f.hasStore && L.regA == f.storeBase && L.f2 == f.storeOff) {
+                    int src = f.storeSrc;
+                    st.storeLoads++;
+                    changed = true;
+                    if (x == src) { kill[i] = 1; continue; }
+                    f.clobber(x);
+                    setRType(L, "add", src, 0, x);
+                    continue;
+                }
+                // กฎ 5: โหลดค่าคงที่ซ้ำ
+                if (L.regA == 0) {
+                    const string key = L.f2;
+                    if (f.constOf[x] == key) { kill[i] = 1; st.reloads++; continue; }
+                    for (int y = 1; y < 8; ++y) {
+                        if (y != x && f.constOf[y] == key) {
+                            f.clobber(x);
+                            setRType(L, "add", y, 0, x);
+                            f.constOf[x] = key;
+                            st.reloads++;
+                            changed = true;
+                            goto next_line;
+                        }
+                    }
+                    f.clobber(x);
+                    if (x != 0) f.constOf[x] = key;
+                    continue;
+                }
+                f.clobber(x);
+                continue;
+            }
+            case OPC_SW: {
+                // sw อาจเขียนทับช่องค่าคงที่ใดก็ได้ (ยกเว้นรู้ว่าเป็น r0 + label อื่น)
+                for (auto &c : f.constOf) {
+                    if (L.regA != 0 || c == L.f2) c.clear();
+                }
+                f.hasStore = true;
+                f.storeBase = L.regA;
+                f.storeSrc = L.regB;
+                f.storeOff = L.f2;
+                continue;
+            }
+            case OPC_JALR: case OPC_HALT:
+                f.reset();
+                continue;
+            default:
+                break;
+        }
+
+        // add/nand ที่เหลือ: อัปเดตความรู้ตาม register ที่ถูกเขียน
+        {
+            int w = writtenReg(L);
+            if (w >= 0) {
+                // add y 0 x คือการคัดลอก → x รู้ค่าเหมือน y
+                string copied = (op == OPC_ADD && L.regB == 0) ? f.constOf[L.regA] : string();
+                f.clobber(w);
+                if (!copied.empty() && w != 0) f.constOf[w] = copied;
+            }
+        }
+    next_line:;
+    }
+
+    size_t removed = eraseIRLines(ir, kill);
+    return changed || removed > 0;
+}
+
+// register ที่คำสั่งอ่าน (bit mask)
+static unsigned readMask(const IRLine &L) {
+    switch (irOpcode(L)) {
+        case OPC_ADD: case OPC_NAND: case OPC_SW: case OPC_BEQ: return (1u << L.regA) | (1u << L.regB);
+        case OPC_LW: case OPC_JALR: return 1u << L.regA;
+        default: return 0;
+    }
+}
+
+// register r ตายหลังบรรทัด j หรือไม่: ดูต่อใน block เดียวกันว่าถูกเขียนทับก่อนถูกอ่าน
+// ออกจาก block (label ที่มีคนอ้าง, beq, jalr, halt, .fill, จบโปรแกรม) ถือว่ายัง live
+static bool deadAfter(const vector<IRLine> &ir, size_t j, int r, const unordered_set<string> &referenced) {
+    for (size_t k = j + 1; k < ir.size(); ++k) {
+        const IRLine &L = ir[k];
+        int op = irOpcode(L);
+        if ((!L.rawLabel.empty() && referenced.count(L.rawLabel)) || op < 0) return false;
+        if (readMask(L) >> r & 1) return false;
+        if (op == OPC_BEQ || op == OPC_JALR || op == OPC_HALT) return false;
+        if (writtenReg(L) == r) return true;
+    }
+    return false;
+}
+
+// กฎ 7-9 หนึ่งรอบ คืน true ถ้ามีอะไรเปลี่ยน
+static bool rewriteDbRound(vector<IRLine> &ir, const RewriteDb &db, PeepholeStats &st) {
+    vector<char> kill(ir.size(), 0);
+    bool changed = false;
+    unordered_set<string> referenced;
+    for (const auto &L : ir)
+        if (const string *ref = irLabelRef(L)) referenced.insert(*ref);
+    auto isRType = [&](size_t i) { int op = irOpcode(ir[i]); return op == OPC_ADD || op == OPC_NAND; };
+
+    // 7) + 8)
+    for (size_t i = 0; i < ir.size(); ++i) {
+        if (!isRType(i)) continue;
+        IRLine &L = ir[i];
+        if (irOpcode(L) == OPC_NAND && (L.regA == 0) != (L.regB == 0)) {
+            setRType(L, "nand", 0, 0, L.dest);
+            changed = true;
+        }
+        if (L.dest != 0 && deadAfter(ir, i, L.dest, referenced)) { kill[i] = 1; st.deadWrites++; }
+    }
+    if (changed || eraseIRLines(ir, kill) > 0) return true;
+
+    // 9) ไล่แต่ละช่วงของ add/nand ที่ติดกัน (บรรทัดหลังบรรทัดแรกต้องไม่มี label ที่มีคนอ้าง)
+    const size_t maxLen = db.maxLength();
+    size_t s = 0;
+    while (s < ir.size()) {
+        size_t end = s;
+        while (end < ir.size() && end - s < maxLen && isRType(end) &&
+               (end == s || ir[end].rawLabel.empty() || !referenced.count(ir[end].rawLabel)))
+            ++end;
+        size_t next = s + 1;
+        for (size_t e = end; e > s; --e) {   // ลองช่วงยาวสุดก่อน
+            SoSeq window;
+            unsigned regs = 0;
+            for (size_t k = s; k < e; ++k) {
+                const IRLine &L = ir[k];
+                window.push_back({uint8_t(irOpcode(L) == OPC_NAND), uint8_t(L.regA), uint8_t(L.regB), uint8_t(L.dest)});
+                regs |= (1u << L.regA) | (1u << L.regB) | (1u << L.dest);
+            }
+            if (__builtin_popcount(regs & ~1u) > db.maxRegs()) continue;
+            int toConcrete[8];
+            const vector<RewriteRule> *rules = db.find(soCanonical(window, toConcrete));
+            if (!rules) continue;
+            uint8_t live = 0;
+            for (int a = 1; a < 8 && toConcrete[a] > 0; ++a)
+                if (!deadAfter(ir, e - 1, toConcrete[a], referenced)) live |= uint8_t(1 << a);
+            const RewriteRule *use = nullptr;
+            for (const RewriteRule &r : *rules)
+                if ((live & ~r.live) == 0) { use = &r; break; }
+            if (!use) continue;
+            for (size_t k = 0; k < e - s; ++k) {
+                if (k < use->replacement.size()) {
+                    const SoInstr &x = use->replacement[k];
+                    setRType(ir[s + k], x.nand ? "nand" : "add", toConcrete[x.a], toConcrete[x.b], toConcrete[x.d]);
+                } else {
+                    kill[s + k] = 1;
+                }
+            }
+            st.dbRewrites++;
+            st.dbSaved += int(e - s - use->replacement.size());
+            changed = true;
+            next = e;
+            break;
+        }
+        s = next;
+    }
+    eraseIRLines(ir, kill);
+    return changed;
+}
+
+PeepholeStats runPeephole(Parser &prog, const RewriteDb *db) {
+    PeepholeStats st;
+    vector<IRLine> ir = prog.getIR();
+    symbolizeIR(ir);
+    prog.replaceIR(ir);
+    while (true) {
+        ir = prog.getIR();
+        bool changed = peepholeRound(ir, st);
+        if (!changed && db) changed = rewriteDbRound(ir, *db, st);
+        if (!changed) break;
+        prog.replaceIR(ir);
+    }
+    return st;
+}
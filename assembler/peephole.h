@@ -0,0 +1,39 @@
+// peephole.h
+// Peephole optimizer ที่ทำงานบน IR ของ parser (ระหว่าง parse กับ encode)
+// ทุกกฎดูแค่ภายใน basic block เดียว และรักษาผลลัพธ์ของโปรแกรมเหมือนเดิม:
+//   1) beq ที่ target คือบรรทัดถัดไป           → ลบ (ไปที่เดียวกันทั้งสองทาง)
+//   2) noop                                   → ลบ
+//   3) add r 0 r / add 0 r r                  → ลบ (ค่าเท่าเดิม)
+//   4) add/nand ที่เขียนลง r0                  → ลบ (simulator บังคับ r0 = 0 อยู่แล้ว)
+//   5) lw 0 X L ซ้ำ ทั้งที่ X ยังเก็บ mem[L] อยู่ → ลบ (หรือใช้ add Y 0 X ถ้าค่าอยู่ใน Y)
+//   6) sw B R off ตามด้วย lw B X off           → แทน lw ด้วย add R 0 X (หรือลบถ้า X == R)
+// ถ้าให้ rewrite database (rewritedb.h, สร้างด้วย superopt) มาด้วย จะทำเพิ่มภายใน block:
+//   7) nand ที่มี r0 ตัวเดียว                   → nand 0 0 d (ค่า -1 เหมือนกัน ให้ตรงกับรูปใน database)
+//   8) add/nand ที่ผลถูกเขียนทับก่อนมีใครอ่าน    → ลบ
+//   9) ช่วง add/nand ติดกันที่ตรงกับ pattern ใน database และ register ที่ไม่อยู่ใน live mask ตายแล้ว
+//      → แทนด้วย replacement ที่สั้นกว่า (register ถือว่า live เมื่อออกจาก block / ที่ beq, jalr, halt)
+// หลังลบบรรทัด parser จะคำนวณ address และ offset ของ beq ใหม่ (Parser::replaceIR)
+
+#ifndef PEEPHOLE_H
+#define PEEPHOLE_H
+
+#include "parser.h"
+#include "rewritedb.h"
+
+struct PeepholeStats {
+    int branchToNext = 0;
+    int noops = 0;
+    int nullAdds = 0;
+    int r0Writes = 0;
+    int reloads = 0;
+    int storeLoads = 0;
+    int deadWrites = 0;      // กฎ 8
+    int dbRewrites = 0;      // กฎ 9: จำนวนช่วงที่แทน
+    int dbSaved = 0;         // กฎ 9: จำนวนคำสั่งที่ลดได้
+    int total() const { return branchToNext + noops + nullAdds + r0Writes + reloads + storeLoads + deadWrites + dbRewrites; }
+};
+
+// รัน peephole ซ้ำจนไม่มีอะไรเปลี่ยน แล้วเขียน IR ใหม่กลับเข้า prog (db = nullptr คือไม่ใช้กฎ 7-9)
+PeepholeStats runPeephole(Parser &prog, const RewriteDb *db = nullptr);
+
+#endif
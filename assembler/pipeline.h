@@ -0,0 +1,129 @@
+// pipeline.h
+// แบบจำลอง hazard ของ pipeline แบบ in-order ออกคำสั่งละ 1 cycle (ใช้ประเมิน stall ไม่ได้จำลองทุก stage)
+//   - latency[op] = จำนวน cycle จากที่คำสั่ง op ออกจนผลลัพธ์พร้อมให้คำสั่งถัดไปอ่าน
+//     ค่าเริ่มต้น lw = 2 คือ load-use hazard: "lw 5 1 0" ตามด้วย "add 3 1 3" ทันที → stall 1 cycle
+//     คำสั่งอื่น = 1 (forwarding ทัน ไม่ stall)
+//   - คำสั่งที่อ่าน register ที่ยังไม่พร้อมต้องรอ: stall = cycle ที่ register พร้อม - cycle ที่ควรได้ออก
+//   - branch ที่กระโดดจริง (beq ที่เงื่อนไขจริง, jalr) เสีย taken cycle (ค่าเริ่มต้น 1) เพราะ fetch ต่อจาก PC+1 ไปแล้ว
+// ใช้ได้ทั้งแบบ static (ไล่ลำดับคำสั่งใน block) และแบบ dynamic (runPipeline: รันจริงบน LcSim ของ Simulator/lc_sim.h)
+
+#ifndef PIPELINE_H
+#define PIPELINE_H
+
+#include "lc_isa.h"
+#include "../Simulator/lc_sim.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+struct HazardModel {
+    int latency[8] = {1, 1, 2, 1, 1, 1, 1, 1};   // add, nand, lw, sw, beq, jalr, halt, noop
+    int taken = 1;                               // cycle ที่เสียต่อ branch ที่กระโดดจริง
+
+    // แก้ค่าจากข้อความแบบ "lw=3,add=1,taken=2" (throw runtime_error ถ้าผิดรูปแบบ)
+    void parse(const std::string &spec) {
+        std::stringstream ss(spec);
+        std::string item;
+        while (std::getline(ss, item, ',')) {
+            size_t eq = item.find('=');
+            if (eq == std::string::npos) throw std::runtime_error("bad hazard spec '" + item + "' (expected op=latency)");
+            std::string name = item.substr(0, eq);
+            if (name == "taken") {
+                try {
+                    taken = std::stoi(item.substr(eq + 1));
+                } catch (const std::exception &) {
+                    throw std::runtime_error("bad taken-branch penalty in hazard spec: " + item);
+                }
+                if (taken < 0) throw std::runtime_error("negative taken-branch penalty: " + item);
+                continue;
+            }
+            int op = -1;
+            for (int i = 0; i < 8; ++i)
+                if (name == LC_MNEMONIC[i]) op = i;
+            if (op < 0) throw std::runtime_error("unknown opcode in hazard spec: " + name);
+            try {
+                latency[op] = std::stoi(item.substr(eq + 1));
+            } catch (const std::exception &) {
+                throw std::runtime_error("bad latency in hazard spec: " + item);
+            }
+            if (latency[op] < 1) throw std::runtime_error("latency must be at least 1: " + item);
+        }
+    }
+};
+
+// register ที่คำสั่งอ่าน / เขียน (bit mask, ไม่นับ r0)
+inline unsigned lcReadMask(const DecodedInstr &d) {
+    switch (d.opcode) {
+        case OPC_ADD: case OPC_NAND: case OPC_SW: case OPC_BEQ: return ((1u << d.regA) | (1u << d.regB)) & 0xFE;
+        case OPC_LW: case OPC_JALR: return (1u << d.regA) & 0xFE;
+        default: return 0;
+    }
+}
+inline unsigned lcWriteMask(const DecodedInstr &d) {
+    switch (d.opcode) {
+        case OPC_ADD: case OPC_NAND: return (1u << d.dest) & 0xFE;
+        case OPC_LW: case OPC_JALR: return (1u << d.regB) & 0xFE;
+        default: return 0;
+    }
+}
+
+// ตัวนับ cycle ตามลำดับคำสั่งที่ออก: issue() คืนจำนวน stall ของคำสั่งนั้น
+struct HazardTracker {
+    const HazardModel &model;
+    long cycle = 0;              // cycle ที่คำสั่งถัดไปออกได้เร็วสุด
+    long ready[8] = {0};         // cycle ที่ค่าของแต่ละ register พร้อม
+
+    explicit HazardTracker(const HazardModel &m) : model(m) {}
+
+    int issue(const DecodedInstr &d) {
+        long at = cycle;
+        unsigned reads = lcReadMask(d);
+        for (int r = 1; r < 8; ++r)
+            if (reads >> r & 1) at = std::max(at, ready[r]);
+        unsigned writes = lcWriteMask(d);
+        for (int r = 1; r < 8; ++r)
+            if (writes >> r & 1) ready[r] = at + model.latency[d.opcode & 7];
+        int stalls = int(at - cycle);
+        cycle = at + 1;
+        return stalls;
+    }
+};
+
+struct PipelineStats {
+    long executed = 0;
+    long stalls = 0;         // load-use (และ latency อื่น) stall
+    long taken = 0;          // branch ที่กระโดดจริง
+    long branchCycles = 0;   // taken x ค่าปรับ
+    long cycles() const { return executed + stalls + branchCycles; }
+};
+
+// รันโปรแกรมจนจบ (เหมือน LcSim::run) ทีละ step แล้วนับ stall ตามแบบจำลอง
+inline PipelineStats runPipeline(const std::vector<int32_t> &image, const HazardModel &model) {
+    PipelineStats st;
+    OutBuffer out(stdout);
+    LcSim sim(out);
+    sim.quiet = true;
+    sim.load(image);
+    HazardTracker h(model);
+    LcSim::Stop stop = LcSim::Stop::RUNNING;
+    while (stop == LcSim::Stop::RUNNING && sim.pc >= 0 && sim.pc < sim.numMemory) {
+        const DecodedInstr d = decodeWord(sim.mem[sim.pc]);
+        const int32_t pc = sim.pc;
+        sim.step(stop);
+        if (stop == LcSim::Stop::STEP_LIMIT) break;
+        st.stalls += h.issue(d);
+        if ((d.opcode == OPC_BEQ || d.opcode == OPC_JALR) && sim.pc != pc + 1) {
+            st.taken++;
+            h.cycle += model.taken;
+        }
+    }
+    st.executed = sim.executed;
+    st.branchCycles = st.taken * model.taken;
+    return st;
+}
+
+#endif
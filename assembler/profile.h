@@ -0,0 +1,92 @@
+// profile.h
+// execution profile ของโปรแกรม LC: จำนวนครั้งที่แต่ละ PC ทำงาน และจำนวนครั้งของแต่ละ edge (PC → PC ถัดไป)
+// ที่ไม่ใช่ PC+1 (branch ที่กระโดดจริง, jalr) เก็บจากการรันบน LcSim (Simulator/lc_sim.h) ทีละ step
+// รูปแบบไฟล์ (ข้อความ, # = comment):
+//     pc   <pc> <count>
+//     edge <from> <to> <count>
+// ไฟล์ที่มีแค่บรรทัด pc ก็ใช้ได้ (เช่นแปลงจาก simulator อื่น) ผู้ใช้ต้องประมาณ edge เอง (ดู layout.h)
+
+#ifndef PROFILE_H
+#define PROFILE_H
+
+#include "../Simulator/lc_sim.h"
+
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+struct ExecProfile {
+    std::vector<long> pcCount;                       // index = PC
+    std::map<std::pair<int, int>, long> edges;       // (from, to) → จำนวนครั้ง (เฉพาะที่ไม่ใช่ PC+1)
+    bool hasEdges = false;
+
+    long at(int pc) const { return (pc >= 0 && pc < (int)pcCount.size()) ? pcCount[pc] : 0; }
+    long edge(int from, int to) const {
+        auto it = edges.find({from, to});
+        return it == edges.end() ? 0 : it->second;
+    }
+
+    // รัน image บนเครื่องจำลองแล้วเก็บ profile
+    static ExecProfile collect(const std::vector<int32_t> &image) {
+        ExecProfile p;
+        p.pcCount.assign(image.size(), 0);
+        p.hasEdges = true;
+        OutBuffer out(stdout);
+        LcSim sim(out);
+        sim.quiet = true;
+        sim.load(image);
+        LcSim::Stop stop = LcSim::Stop::RUNNING;
+        while (stop == LcSim::Stop::RUNNING && sim.pc >= 0 && sim.pc < sim.numMemory) {
+            const int32_t pc = sim.pc;
+            sim.step(stop);
+            if (stop == LcSim::Stop::STEP_LIMIT) break;   // ชน guard ก่อน fetch: คำสั่งที่ pc ไม่ได้ทำ
+            p.pcCount[pc]++;
+            if (stop == LcSim::Stop::RUNNING && sim.pc != pc + 1) p.edges[{pc, sim.pc}]++;
+        }
+        return p;
+    }
+
+    void save(const std::string &filename) const {
+        std::ofstream ofs(filename);
+        if (!ofs.is_open()) throw std::runtime_error("cannot write profile: " + filename);
+        ofs << "# LC execution profile: pc <pc> <count> / edge <from> <to> <count>\n";
+        for (size_t pc = 0; pc < pcCount.size(); ++pc)
+            if (pcCount[pc]) ofs << "pc " << pc << " " << pcCount[pc] << "\n";
+        for (const auto &e : edges) ofs << "edge " << e.first.first << " " << e.first.second << " " << e.second << "\n";
+    }
+
+    void load(const std::string &filename) {
+        std::ifstream ifs(filename);
+        if (!ifs.is_open()) throw std::runtime_error("cannot open profile: " + filename);
+        pcCount.clear();
+        edges.clear();
+        hasEdges = false;
+        std::string line;
+        int lineno = 0;
+        while (std::getline(ifs, line)) {
+            ++lineno;
+            size_t hash = line.find('#');
+            if (hash != std::string::npos) line = line.substr(0, hash);
+            std::istringstream is(line);
+            std::string kind;
+            if (!(is >> kind)) continue;
+            long a, b, c;
+            if (kind == "pc" && (is >> a >> b) && a >= 0 && b >= 0) {
+                if ((long)pcCount.size() <= a) pcCount.resize(a + 1, 0);
+                pcCount[a] += b;
+            } else if (kind == "edge" && (is >> a >> b >> c) && c >= 0) {
+                edges[{int(a), int(b)}] += c;
+                hasEdges = true;
+            } else {
+                throw std::runtime_error("bad profile line at " + filename + ":" + std::to_string(lineno));
+            }
+        }
+    }
+};
+
+#endif
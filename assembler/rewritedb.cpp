@@ -0,0 +1,203 @@
+// rewritedb.cpp — ดูรูปแบบไฟล์และความหมายของกฎใน rewritedb.h
+
+#include "rewritedb.h"
+
+#include <algorithm>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+
+using namespace std;
+
+string soFormat(const SoSeq &s) {
+    if (s.empty()) return "-";
+    string out;
+    for (size_t i = 0; i < s.size(); ++i) {
+        if (i) out += ", ";
+        out += s[i].nand ? "nand " : "add ";
+        out += to_string(s[i].a) + " " + to_string(s[i].b) + " " + to_string(s[i].d);
+    }
+    return out;
+}
+
+SoSeq soParse(const string &text) {
+    SoSeq s;
+    string t = text;
+    t.erase(0, t.find_first_not_of(" \t"));
+    t.erase(t.find_last_not_of(" \t\r") + 1);
+    if (t == "-" || t.empty()) return s;
+    stringstream ss(t);
+    string part;
+    while (getline(ss, part, ',')) {
+        istringstream is(part);
+        string op;
+        int a, b, d;
+        if (!(is >> op >> a >> b >> d) || (op != "add" && op != "nand"))
+            throw runtime_error("bad instruction '" + part + "' in rewrite rule");
+        if (a < 0 || a > 7 || b < 0 || b > 7 || d < 1 || d > 7)
+            throw runtime_error("register out of range in '" + part + "'");
+        s.push_back({uint8_t(op == "nand"), uint8_t(a), uint8_t(b), uint8_t(d)});
+    }
+    return s;
+}
+
+int soNumRegs(const SoSeq &s) {
+    int k = 0;
+    for (const auto &x : s) k = max({k, int(x.a), int(x.b), int(x.d)});
+    return k;
+}
+
+static bool seqLess(const SoSeq &x, const SoSeq &y) {
+    for (size_t i = 0; i < x.size() && i < y.size(); ++i) {
+        auto tx = make_tuple(x[i].nand, x[i].a, x[i].b, x[i].d);
+        auto ty = make_tuple(y[i].nand, y[i].a, y[i].b, y[i].d);
+        if (tx != ty) return tx < ty;
+    }
+    return x.size() < y.size();
+}
+
+SoSeq soCanonical(const SoSeq &concrete, int toConcrete[8]) {
+    const size_t n = concrete.size();
+    vector<size_t> swappable;
+    for (size_t i = 0; i < n; ++i)
+        if (concrete[i].a != concrete[i].b) swappable.push_back(i);
+
+    SoSeq best;
+    bool have = false;
+    for (uint32_t m = 0; m < (1u << swappable.size()); ++m) {
+        SoSeq v = concrete;
+        for (size_t j = 0; j < swappable.size(); ++j)
+            if (m >> j & 1) swap(v[swappable[j]].a, v[swappable[j]].b);
+        int toAbs[8] = {0, -1, -1, -1, -1, -1, -1, -1}, back[8] = {0};
+        int next = 1;
+        auto rename = [&](uint8_t &r) {
+            if (toAbs[r] < 0) { toAbs[r] = next; back[next] = r; ++next; }
+            r = uint8_t(toAbs[r]);
+        };
+        for (auto &x : v) { rename(x.a); rename(x.b); rename(x.d); }
+        if (!have || seqLess(v, best)) {
+            best = v;
+            have = true;
+            for (int r = 0; r < 8; ++r) toConcrete[r] = r < next ? back[r] : -1;
+        }
+    }
+    if (!have) for (int r = 0; r < 8; ++r) toConcrete[r] = r == 0 ? 0 : -1;
+    return best;
+}
+
+void soRun(const SoSeq &s, uint32_t regs[8], int width) {
+    const uint32_t mask = width >= 32 ? 0xFFFFFFFFu : ((1u << width) - 1);
+    regs[0] = 0;
+    for (const auto &x : s) {
+        uint32_t v = x.nand ? ~(regs[x.a] & regs[x.b]) : regs[x.a] + regs[x.b];
+        if (x.d) regs[x.d] = v & mask;
+    }
+}
+
+static bool sameLive(const uint32_t *p, const uint32_t *r, uint8_t live) {
+    for (int k = 1; k < 8; ++k)
+        if ((live >> k & 1) && p[k] != r[k]) return false;
+    return true;
+}
+
+bool soEquivalent(const SoSeq &pattern, const SoSeq &replacement, uint8_t live) {
+    int k = max(soNumRegs(pattern), soNumRegs(replacement));
+    // 1) ค่าสุ่ม 32 บิต (ตัดคู่ที่ผิดออกเร็ว)
+    mt19937 rng(0x5eed);
+    for (int t = 0; t < 64; ++t) {
+        uint32_t p[8], r[8];
+        for (int j = 0; j < 8; ++j) p[j] = r[j] = (t < 4) ? uint32_t(t == 1 ? 1 : t == 2 ? -1 : t == 3 ? 0x80000000u : 0)
+                                                          : uint32_t(rng());
+        soRun(pattern, p);
+        soRun(replacement, r);
+        if (!sameLive(p, r, live)) return false;
+    }
+    // 2) ครบทุก input บนโดเมนที่ย่อ: k register x w บิต (k*w <= 16)
+    if (k == 0) return true;
+    const int w = 16 / k;
+    const uint32_t wmask = (1u << w) - 1;
+    const uint64_t total = 1ull << (w * k);
+    for (uint64_t x = 0; x < total; ++x) {
+        uint32_t p[8] = {0}, r[8] = {0};
+        for (int j = 1; j <= k; ++j) p[j] = r[j] = uint32_t(x >> ((j - 1) * w)) & wmask;
+        soRun(pattern, p, w);
+        soRun(replacement, r, w);
+        if (!sameLive(p, r, live)) return false;
+    }
+    return true;
+}
+
+void RewriteDb::add(const RewriteRule &r) {
+    auto &v = byPattern[soFormat(r.pattern)];
+    v.push_back(r);
+    stable_sort(v.begin(), v.end(), [](const RewriteRule &x, const RewriteRule &y) {
+        return x.replacement.size() < y.replacement.size();
+    });
+    ++count;
+    maxLen = max(maxLen, (int)r.pattern.size());
+    maxReg = max(maxReg, soNumRegs(r.pattern));
+}
+
+const vector<RewriteRule> *RewriteDb::find(const SoSeq &canonicalPattern) const {
+    auto it = byPattern.find(soFormat(canonicalPattern));
+    return it == byPattern.end() ? nullptr : &it->second;
+}
+
+// ตอนโหลดเช็คแค่ค่าสุ่ม 32 บิตกับรูป canonical (superopt ยืนยันแบบครบโดเมนไว้แล้วตอนสร้าง)
+void RewriteDb::load(const string &filename) {
+    ifstream ifs(filename);
+    if (!ifs.is_open()) throw runtime_error("cannot open rewrite database: " + filename);
+    string line;
+    int lineno = 0;
+    mt19937 rng(0xdb);
+    while (getline(ifs, line)) {
+        ++lineno;
+        size_t hash = line.find('#');
+        if (hash != string::npos) line = line.substr(0, hash);
+        if (line.find_first_not_of(" \t\r") == string::npos) continue;
+        const string where = filename + ":" + to_string(lineno);
+        size_t p1 = line.find('|'), p2 = line.find('|', p1 == string::npos ? 0 : p1 + 1);
+        if (p1 == string::npos || p2 == string::npos) throw runtime_error("expected 'pattern | live | replacement' at " + where);
+        RewriteRule r;
+        r.pattern = soParse(line.substr(0, p1));
+        r.replacement = soParse(line.substr(p2 + 1));
+        for (char c : line.substr(p1 + 1, p2 - p1 - 1)) {
+            if (c >= '1' && c <= '7') r.live |= uint8_t(1 << (c - '0'));
+            else if (c != ' ' && c != '\t' && c != '-') throw runtime_error("bad live mask at " + where);
+        }
+        int map[8];
+        if (r.pattern.empty() || r.replacement.size() >= r.pattern.size() || !(soCanonical(r.pattern, map) == r.pattern))
+            throw runtime_error("rule is not a shorter rewrite of a canonical pattern at " + where);
+        if (soNumRegs(r.replacement) > soNumRegs(r.pattern))
+            throw runtime_error("replacement uses registers outside the pattern at " + where);
+        for (int t = 0; t < 16; ++t) {
+            uint32_t a[8], b[8];
+            for (int j = 0; j < 8; ++j) a[j] = b[j] = uint32_t(rng());
+            soRun(r.pattern, a);
+            soRun(r.replacement, b);
+            if (!sameLive(a, b, r.live)) throw runtime_error("rule is not equivalent at " + where);
+        }
+        add(r);
+    }
+}
+
+void RewriteDb::save(const string &filename, const string &header) const {
+    ofstream ofs(filename);
+    if (!ofs.is_open()) throw runtime_error("cannot write rewrite database: " + filename);
+    if (!header.empty()) ofs << header;
+    vector<const RewriteRule *> all;
+    for (const auto &kv : byPattern)
+        for (const auto &r : kv.second) all.push_back(&r);
+    sort(all.begin(), all.end(), [](const RewriteRule *x, const RewriteRule *y) {
+        if (x->pattern.size() != y->pattern.size()) return x->pattern.size() < y->pattern.size();
+        if (!(x->pattern == y->pattern)) return seqLess(x->pattern, y->pattern);
+        return x->live < y->live;
+    });
+    for (const RewriteRule *r : all) {
+        string live;
+        for (int k = 1; k < 8; ++k)
+            if (r->live >> k & 1) live += char('0' + k);
+        ofs << soFormat(r->pattern) << " | " << (live.empty() ? "-" : live) << " | " << soFormat(r->replacement) << "\n";
+    }
+}
@@ -0,0 +1,70 @@
+// rewritedb.h
+// ฐานข้อมูล rewrite ของลำดับ add/nand สั้น ๆ ที่สร้างด้วย superoptimizer (superopt.cpp)
+// แต่ละกฎ: pattern (ลำดับคำสั่งที่ใช้ register นามธรรม 1..k และ r0) + live mask + replacement ที่สั้นกว่า
+//   - live mask = register นามธรรมที่ต้องมีค่าสุดท้ายเหมือน pattern หลังจบช่วง (ตัวที่ไม่อยู่ใน mask ต้องตายแล้ว)
+//   - pattern เก็บในรูป canonical (ดู soCanonical) ผู้ใช้แปลงช่วงคำสั่งจริงเป็น canonical แล้วค้นตรง ๆ ได้
+// รูปแบบไฟล์ (ข้อความ บรรทัดละกฎ, # = comment):
+//     add 1 0 2, add 2 1 2 | 12 | add 1 1 2
+//     pattern                live  replacement ("-" = ลบทิ้งได้ทั้งช่วง)
+
+#ifndef REWRITEDB_H
+#define REWRITEDB_H
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+struct SoInstr {
+    uint8_t nand = 0;      // 0 = add, 1 = nand
+    uint8_t a = 0, b = 0, d = 0;
+    bool operator==(const SoInstr &o) const { return nand == o.nand && a == o.a && b == o.b && d == o.d; }
+};
+using SoSeq = std::vector<SoInstr>;
+
+struct RewriteRule {
+    SoSeq pattern;
+    uint8_t live = 0;      // bit r = register นามธรรม r ยัง live หลังช่วง
+    SoSeq replacement;
+};
+
+// ข้อความ "add 1 0 2, nand 2 2 1" <-> SoSeq (throw runtime_error ถ้าผิดรูปแบบ)
+std::string soFormat(const SoSeq &s);
+SoSeq soParse(const std::string &text);
+
+// จำนวน register นามธรรมที่ใช้ (register สูงสุดที่ปรากฏ)
+int soNumRegs(const SoSeq &s);
+
+// แปลงลำดับคำสั่งจริงเป็นรูป canonical: ตั้งชื่อ register ใหม่ตามลำดับที่ปรากฏครั้งแรก (a, b, d ของแต่ละคำสั่ง)
+// โดยลองสลับ operand ของทุกคำสั่ง (add/nand สลับที่ได้) แล้วเลือกผลที่น้อยที่สุดตามลำดับพจนานุกรม
+// toConcrete[r] = register จริงของ register นามธรรม r (r0 → 0)
+SoSeq soCanonical(const SoSeq &concrete, int toConcrete[8]);
+
+// รันลำดับบน register 8 ตัว ค่าถูกตัดเหลือ width บิต (width = 32 คือเครื่องจริง)
+void soRun(const SoSeq &s, uint32_t regs[8], int width = 32);
+
+// ยืนยันว่า replacement ให้ค่าเดียวกับ pattern ทุก register ใน live:
+// ทดสอบค่าสุ่ม 32 บิต แล้วไล่ครบทุก input ในโดเมนที่ย่อเหลือรวม 16 บิต (k register x 16/k บิต)
+bool soEquivalent(const SoSeq &pattern, const SoSeq &replacement, uint8_t live);
+
+class RewriteDb {
+public:
+    // throw runtime_error ถ้าเปิดไฟล์ไม่ได้หรือบรรทัดผิดรูปแบบ (เช็ค soEquivalent ทุกกฎตอนโหลด)
+    void load(const std::string &filename);
+    void save(const std::string &filename, const std::string &header = "") const;
+
+    void add(const RewriteRule &r);
+    // กฎทั้งหมดของ pattern (canonical) เรียงตาม replacement สั้นสุดก่อน, nullptr ถ้าไม่มี
+    const std::vector<RewriteRule> *find(const SoSeq &canonicalPattern) const;
+
+    size_t size() const { return count; }
+    int maxLength() const { return maxLen; }
+    int maxRegs() const { return maxReg; }
+
+private:
+    std::unordered_map<std::string, std::vector<RewriteRule>> byPattern;
+    size_t count = 0;
+    int maxLen = 0, maxReg = 0;
+};
+
+#endif
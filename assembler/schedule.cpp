@@ -0,0 +1,151 @@
+// schedule.cpp — ดูคำอธิบายใน schedule.h
+
+#include "schedule.h"
+#include "ir_utils.h"
+#include "lc_isa.h"
+
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+using namespace std;
+
+static DecodedInstr decodeLine(const IRLine &L) {
+    DecodedInstr d;
+    d.opcode = uint8_t(irOpcode(L));
+    d.regA = uint8_t(L.regA);
+    d.regB = uint8_t(L.regB);
+    d.dest = uint8_t(L.dest);
+    d.imm = L.offset16;
+    return d;
+}
+
+static long blockStalls(const vector<DecodedInstr> &code, const vector<int> &order, const HazardModel &model) {
+    HazardTracker h(model);
+    long stalls = 0;
+    for (int k : order) stalls += h.issue(code[k]);
+    return stalls;
+}
+
+// จัดลำดับคำสั่ง code[0..n) (ตัวสุดท้ายอาจเป็นคำสั่งจบ block ที่ต้องอยู่ท้าย) คืนลำดับใหม่
+static vector<int> listSchedule(const vector<DecodedInstr> &code, const HazardModel &model) {
+    const int n = (int)code.size();
+    // edge[i] = (j, delay): j ต้องออกหลัง i อย่างน้อย delay cycle
+    vector<vector<pair<int, int>>> succ(n);
+    vector<int> npred(n, 0);
+    auto addEdge = [&](int i, int j, int delay) { succ[i].push_back({j, delay}); npred[j]++; };
+
+    vector<int> baseVersion(n, 0);     // จำนวนครั้งที่ฐานของ lw/sw ถูกเขียนก่อนหน้าใน block
+    int writes[8] = {0};
+    for (int j = 0; j < n; ++j) {
+        const DecodedInstr &b = code[j];
+        if (b.opcode == OPC_LW || b.opcode == OPC_SW) baseVersion[j] = writes[b.regA];
+        unsigned wb = lcWriteMask(b);
+        for (int r = 1; r < 8; ++r) if (wb >> r & 1) writes[r]++;
+    }
+    const bool lastIsExit = n > 0 && (code[n - 1].opcode == OPC_BEQ || code[n - 1].opcode == OPC_JALR ||
+                                      code[n - 1].opcode == OPC_HALT);
+    for (int j = 1; j < n; ++j) {
+        const DecodedInstr &b = code[j];
+        for (int i = 0; i < j; ++i) {
+            const DecodedInstr &a = code[i];
+            int delay = -1;
+            if (lcWriteMask(a) & lcReadMask(b)) delay = model.latency[a.opcode];
+            else if ((lcReadMask(a) & lcWriteMask(b)) || (lcWriteMask(a) & lcWriteMask(b))) delay = 1;
+            bool memA = a.opcode == OPC_LW || a.opcode == OPC_SW, memB = b.opcode == OPC_LW || b.opcode == OPC_SW;
+            if (memA && memB && (a.opcode == OPC_SW || b.opcode == OPC_SW)) {
+                bool disjoint = a.regA == b.regA && baseVersion[i] == baseVersion[j] && a.imm != b.imm;
+                if (!disjoint) delay = max(delay, 1);
+            }
+            if (lastIsExit && j == n - 1) delay = max(delay, 1);
+            if (delay >= 0) addEdge(i, j, delay);
+        }
+    }
+
+    // ความยาวทางวิกฤตจากแต่ละคำสั่งถึงท้าย block
+    vector<int> height(n, 1);
+    for (int i = n - 1; i >= 0; --i)
+        for (auto &e : succ[i]) height[i] = max(height[i], e.second + height[e.first]);
+
+    vector<long> earliest(n, 0);
+    vector<char> done(n, 0);
+    vector<int> order;
+    long cycle = 0;
+    for (int step = 0; step < n; ++step) {
+        int pick = -1;
+        for (int j = 0; j < n; ++j) {
+            if (done[j] || npred[j] > 0) continue;
+            if (pick < 0) { pick = j; continue; }
+            bool freeJ = earliest[j] <= cycle, freeP = earliest[pick] <= cycle;
+            if (freeJ != freeP) { if (freeJ) pick = j; continue; }
+            if (!freeJ && earliest[j] != earliest[pick]) { if (earliest[j] < earliest[pick]) pick = j; continue; }
+            if (height[j] > height[pick]) pick = j;
+        }
+        long at = max(cycle, earliest[pick]);
+        done[pick] = 1;
+        order.push_back(pick);
+        for (auto &e : succ[pick]) {
+            earliest[e.first] = max(earliest[e.first], at + e.second);
+            npred[e.first]--;
+        }
+        cycle = at + 1;
+    }
+    return order;
+}
+
+ScheduleStats runScheduler(Parser &prog, const HazardModel &model) {
+    ScheduleStats st;
+    vector<IRLine> ir = prog.getIR();
+    symbolizeIR(ir);
+    prog.replaceIR(ir);
+    ir = prog.getIR();
+
+    unordered_set<string> referenced;
+    for (const auto &L : ir)
+        if (const string *ref = irLabelRef(L)) referenced.insert(*ref);
+
+    vector<IRLine> out;
+    out.reserve(ir.size());
+    size_t i = 0;
+    while (i < ir.size()) {
+        if (irOpcode(ir[i]) < 0) { out.push_back(ir[i++]); continue; }
+        // หาขอบ block [i, e)
+        size_t e = i;
+        while (e < ir.size()) {
+            int op = irOpcode(ir[e]);
+            if (op < 0) break;
+            if (e > i && !ir[e].rawLabel.empty() && referenced.count(ir[e].rawLabel)) break;
+            ++e;
+            if (op == OPC_BEQ || op == OPC_JALR || op == OPC_HALT) break;
+        }
+        vector<DecodedInstr> code;
+        vector<int> original;
+        for (size_t k = i; k < e; ++k) {
+            code.push_back(decodeLine(ir[k]));
+            original.push_back(int(k - i));
+        }
+        vector<int> order = listSchedule(code, model);
+        long before = blockStalls(code, original, model), after = blockStalls(code, order, model);
+        if (after >= before) {
+            order = original;
+            after = before;
+        }
+        st.stallsBefore += before;
+        st.stallsAfter += after;
+        if (order != original) {
+            st.blocks++;
+            for (size_t k = 0; k < order.size(); ++k)
+                if (order[k] != (int)k) st.moved++;
+        }
+        const string blockLabel = ir[i].rawLabel;
+        for (size_t k = 0; k < order.size(); ++k) {
+            IRLine L = ir[i + order[k]];
+            if (order[k] == 0) L.rawLabel.clear();
+            if (k == 0) L.rawLabel = blockLabel;
+            out.push_back(L);
+        }
+        i = e;
+    }
+    prog.replaceIR(out);
+    return st;
+}
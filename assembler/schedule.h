@@ -0,0 +1,27 @@
+// schedule.h
+// list scheduler ภายใน basic block: จัดลำดับคำสั่งที่ไม่ขึ้นต่อกันใหม่ให้ผู้ผลิตค่า (โดยเฉพาะ lw) อยู่ห่างจาก
+// ผู้ใช้ค่า ตามแบบจำลอง hazard ใน pipeline.h
+//   - block เริ่มที่ label ที่มีคนอ้าง และจบที่ beq / jalr / halt (คำสั่งจบ block อยู่ท้ายเสมอ) หรือก่อน .fill
+//   - dependency: register (อ่านหลังเขียน / เขียนหลังอ่าน / เขียนหลังเขียน) และหน่วยความจำ:
+//     lw กับ lw สลับกันได้เสมอ ส่วนคู่ที่มี sw สลับได้เฉพาะเมื่อฐานเป็น register เดียวกันที่ไม่ถูกเขียนระหว่างนั้น
+//     และ offset ต่างกัน (เช่น sw 5 1 0 กับ lw 5 2 1)
+//   - เลือกคำสั่งที่ออกได้โดยไม่ stall ก่อน ถ้ามีหลายตัวเลือกตัวที่ทางวิกฤต (latency ถึงท้าย block) ยาวสุด
+//     เท่ากันคงลำดับเดิม ถ้า block ไหนจัดแล้ว stall ไม่ลดก็คงลำดับเดิมไว้
+// label ของบรรทัดแรกใน block อยู่ที่ตำแหน่งเดิม label อื่นใน block (ไม่มีใครอ้าง) ย้ายไปกับคำสั่งของมัน
+
+#ifndef SCHEDULE_H
+#define SCHEDULE_H
+
+#include "parser.h"
+#include "pipeline.h"
+
+struct ScheduleStats {
+    int blocks = 0;            // block ที่ถูกจัดลำดับใหม่
+    int moved = 0;             // คำสั่งที่เปลี่ยนตำแหน่ง
+    long stallsBefore = 0;     // stall แบบ static (นับทุก block ครั้งละหนึ่งรอบ)
+    long stallsAfter = 0;
+};
+
+ScheduleStats runScheduler(Parser &prog, const HazardModel &model);
+
+#endif
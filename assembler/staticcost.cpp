@@ -0,0 +1,473 @@
+// staticcost.cpp — ดูคำอธิบายใน staticcost.h
+
+#include "staticcost.h"
+
+#include <climits>
+#include <sstream>
+#include <stdexcept>
+
+using namespace std;
+
+void CostModel::parse(const string &spec) {
+    stringstream ss(spec);
+    string item;
+    while (getline(ss, item, ',')) {
+        size_t eq = item.find('=');
+        if (eq == string::npos) throw runtime_error("bad cost spec '" + item + "' (expected op=cycles)");
+        string name = item.substr(0, eq);
+        int op = -1;
+        for (int i = 0; i < 8; ++i)
+            if (name == LC_MNEMONIC[i]) op = i;
+        if (op < 0) throw runtime_error("unknown opcode in cost spec: " + name);
+        try {
+            cycles[op] = stoi(item.substr(eq + 1));
+        } catch (const exception &) {
+            throw runtime_error("bad cycle count in cost spec: " + item);
+        }
+        if (cycles[op] < 0) throw runtime_error("negative cycle count in cost spec: " + item);
+    }
+}
+
+// ---- เลขคณิตแบบอิ่มตัว: ค่าที่ใหญ่เกิน HUGE ถือว่า "ใหญ่มาก" แต่ยังเปรียบเทียบกับ --max-cost ได้ ----
+static const long long HUGE_COUNT = LLONG_MAX / 4;
+static long long satAdd(long long a, long long b) {
+    if (a < 0 || b < 0) return -1;
+    return (a > HUGE_COUNT - b) ? HUGE_COUNT : a + b;
+}
+static long long satMul(long long a, long long b) {
+    if (a < 0 || b < 0) return -1;
+    if (a == 0 || b == 0) return 0;
+    return (a > HUGE_COUNT / b) ? HUGE_COUNT : a * b;
+}
+
+static bool writesReg(const DecodedInstr &d, int reg) {
+    if (reg == 0) return false;
+    switch (d.opcode) {
+        case OPC_ADD: case OPC_NAND: return d.dest == reg;
+        case OPC_LW: return d.regB == reg;
+        case OPC_JALR: return d.regB == reg;   // jalr a a ก็เขียน a = PC+1
+        default: return false;
+    }
+}
+
+static SymVal constVal(int32_t c, const string &text) {
+    SymVal v;
+    v.kind = SymVal::CONST;
+    v.c = c;
+    v.text = text;
+    return v;
+}
+
+static SymVal unknownVal(const string &text) {
+    SymVal v;
+    v.text = text;
+    return v;
+}
+
+static bool sameVal(const SymVal &a, const SymVal &b) {
+    if (a.kind != b.kind || a.kind == SymVal::UNKNOWN) return false;
+    return a.c == b.c && (a.kind == SymVal::CONST || (a.step == b.step && a.loop == b.loop));
+}
+
+namespace {
+
+struct Analyzer {
+    ControlFlowGraph &g;
+    const CostModel &model;
+    const vector<string> &labelAt;
+    StaticCostReport &rep;
+
+    vector<int> headerLoop;         // loop ที่มี block นี้เป็น header (-1 ถ้าไม่ใช่)
+    vector<uint8_t> loopWrites;     // bitmask ของ register ที่ถูกเขียนใน loop (รวม loop ใน)
+    vector<uint8_t> storedTo;       // address ที่มี "sw 0 X addr" ในส่วน code
+
+    // memo ของค่าที่หาแล้ว (ล้างด้วยการเพิ่ม gen หลังวิเคราะห์ loop แต่ละตัว เพราะค่า IV เปลี่ยนได้)
+    // ป้องกันการไล่ย้อนซ้ำแบบ exponential ในโปรแกรมใหญ่ และวงวนผ่าน back edge (ค่าที่กำลังหาอยู่ = UNKNOWN)
+    enum : uint8_t { MEMO_NONE, MEMO_BUSY, MEMO_DONE };
+    int gen = 1;
+    vector<int> defGen, startGen;
+    vector<uint8_t> defState, startState;
+    vector<SymVal> defMemo, startMemo;
+
+    Analyzer(ControlFlowGraph &g_, const CostModel &m, const vector<string> &l, StaticCostReport &r)
+        : g(g_), model(m), labelAt(l), rep(r) {}
+
+    bool inLoop(int m, int b) const {
+        for (int l = g.innermostLoop(b); l >= 0; l = g.loops()[l].parent)
+            if (l == m) return true;
+        return false;
+    }
+
+    string memName(int addr) const {
+        if (addr >= 0 && addr < (int)labelAt.size() && !labelAt[addr].empty()) return labelAt[addr];
+        return "mem[" + to_string(addr) + "]";
+    }
+
+    // ---- ค่าของ register: ไล่ย้อนจากจุดที่ใช้ไปหาคำสั่งที่เขียน ----
+    SymVal scanBack(int b, int fromAddr, int reg, int depth) {
+        if (reg == 0) return constVal(0, "0");
+        if (depth > 64) return unknownVal("r" + to_string(reg));
+        for (int q = fromAddr; q >= g.block(b).first; --q)
+            if (writesReg(g.instr(q), reg)) return memoDef(q, reg, depth + 1);
+        return memoStart(b, reg, depth + 1);
+    }
+
+    SymVal memoDef(int q, int reg, int depth) {
+        if (defGen[q] != gen) { defGen[q] = gen; defState[q] = MEMO_NONE; }
+        if (defState[q] == MEMO_DONE) return defMemo[q];
+        if (defState[q] == MEMO_BUSY) return unknownVal("r" + to_string(reg));
+        defState[q] = MEMO_BUSY;
+        SymVal v = evalDef(q, reg, depth);
+        defState[q] = MEMO_DONE;
+        return defMemo[q] = v;
+    }
+
+    SymVal memoStart(int b, int reg, int depth) {
+        size_t k = size_t(b) * 8 + reg;
+        if (startGen[k] != gen) { startGen[k] = gen; startState[k] = MEMO_NONE; }
+        if (startState[k] == MEMO_DONE) return startMemo[k];
+        if (startState[k] == MEMO_BUSY) return unknownVal("r" + to_string(reg));
+        startState[k] = MEMO_BUSY;
+        SymVal v = atBlockStart(b, reg, depth);
+        startState[k] = MEMO_DONE;
+        return startMemo[k] = v;
+    }
+    SymVal before(int addr, int reg, int depth) { return scanBack(g.blockAt(addr), addr - 1, reg, depth); }
+    SymVal atEnd(int b, int reg, int depth) { return scanBack(b, g.block(b).last, reg, depth); }
+
+    SymVal atBlockStart(int b, int reg, int depth) {
+        int m = headerLoop[b];
+        if (m >= 0 && (loopWrites[m] >> reg & 1)) {
+            const LoopCost &lc = rep.loops[m];
+            if (lc.analyzed && lc.counter == reg && lc.init.kind == SymVal::CONST) {
+                SymVal v;
+                v.kind = SymVal::IV;
+                v.c = lc.init.c;
+                v.step = lc.step;
+                v.loop = m;
+                v.text = "r" + to_string(reg);
+                return v;
+            }
+            return unknownVal("r" + to_string(reg));
+        }
+        bool any = false;
+        SymVal acc;
+        for (int e = g.predBegin(b); e < g.predEnd(b); ++e) {
+            EdgeKind k = g.predKind(e);
+            if (k == EDGE_CALL) continue;
+            int p = g.pred(e);
+            if (m >= 0 && inLoop(m, p)) continue;   // reg ไม่ถูกเขียนใน loop → ใช้ค่าตอนเข้า loop
+            if (k == EDGE_RETURN_SITE) return unknownVal("r" + to_string(reg));   // callee อาจเขียนทับ
+            SymVal v = atEnd(p, reg, depth);
+            if (!any) { acc = v; any = true; }
+            else if (!sameVal(acc, v)) return unknownVal("r" + to_string(reg));
+        }
+        if (!any) {
+            // จุดเริ่มโปรแกรม: simulator ตั้ง register ทุกตัวเป็น 0
+            if (g.block(b).first == 0) return constVal(0, "0");
+            return unknownVal("r" + to_string(reg));
+        }
+        return acc;
+    }
+
+    SymVal evalDef(int q, int reg, int depth) {
+        const DecodedInstr &d = g.instr(q);
+        const int n = g.imageSize();
+        switch (d.opcode) {
+            case OPC_LW:
+                if (d.regA == 0 && d.imm >= 0 && d.imm < n && g.blockAt(d.imm) < 0 && !storedTo[d.imm])
+                    return constVal(g.word(d.imm), memName(d.imm));
+                return unknownVal("r" + to_string(reg));
+            case OPC_ADD: {
+                SymVal x = before(q, d.regA, depth), y = before(q, d.regB, depth);
+                if (x.kind == SymVal::CONST && x.c == 0 && d.regA == 0) return y;
+                if (y.kind == SymVal::CONST && y.c == 0 && d.regB == 0) return x;
+                string text = "(" + x.text + " + " + y.text + ")";
+                if (x.kind == SymVal::CONST && y.kind == SymVal::CONST)
+                    return constVal(int32_t(uint32_t(x.c) + uint32_t(y.c)), text);
+                if (x.kind == SymVal::IV && y.kind == SymVal::CONST) { x.c = int32_t(uint32_t(x.c) + uint32_t(y.c)); x.text = text; return x; }
+                if (y.kind == SymVal::IV && x.kind == SymVal::CONST) { y.c = int32_t(uint32_t(y.c) + uint32_t(x.c)); y.text = text; return y; }
+                return unknownVal(text);
+            }
+            case OPC_NAND: {
+                SymVal x = before(q, d.regA, depth), y = before(q, d.regB, depth);
+                string text = "nand(" + x.text + ", " + y.text + ")";
+                if (x.kind == SymVal::CONST && y.kind == SymVal::CONST) return constVal(~(x.c & y.c), text);
+                return unknownVal(text);
+            }
+            case OPC_JALR:
+                return constVal(q + 1, "ret@" + to_string(q));
+            default:
+                return unknownVal("r" + to_string(reg));
+        }
+    }
+
+    // ---- วิเคราะห์ counted loop ----
+    void analyzeLoop(int m) {
+        const NaturalLoop &L = g.loops()[m];
+        LoopCost &lc = rep.loops[m];
+        const int *body = g.loopBody(m);
+
+        vector<int> exiting;
+        for (int i = 0; i < L.bodyCount; ++i) {
+            int b = body[i];
+            uint8_t ex = g.block(b).exit;
+            if (ex == EXIT_HALT || ex == EXIT_RETURN || ex == EXIT_END) { lc.why = "loop body can leave through halt/return"; return; }
+            for (int e = g.succBegin(b); e < g.succEnd(b); ++e) {
+                if (g.succKind(e) == EDGE_CALL) continue;
+                if (!inLoop(m, g.succ(e))) { exiting.push_back(b); break; }
+            }
+        }
+        if (exiting.size() != 1) { lc.why = to_string(exiting.size()) + " exit blocks (need exactly 1)"; return; }
+        int eb = exiting[0];
+        if (g.block(eb).exit != EXIT_BRANCH) { lc.why = "exit is not a conditional beq"; return; }
+        int test = g.block(eb).last;
+        const DecodedInstr &t = g.instr(test);
+        int takenBlock = g.blockAt(test + 1 + t.imm);
+        if (takenBlock < 0 || inLoop(m, takenBlock)) { lc.why = "loop exits when beq is not taken"; return; }
+        for (int u : L.latches)
+            if (!g.dominates(eb, u)) { lc.why = "exit test does not run on every iteration"; return; }
+        lc.testAddr = test;
+
+        for (int side = 0; side < 2 && !lc.analyzed; ++side) {
+            int c = side == 0 ? t.regA : t.regB;
+            int o = side == 0 ? t.regB : t.regA;
+            if (c == 0) continue;
+            int update = -1, defs = 0;
+            for (int i = 0; i < L.bodyCount; ++i) {
+                const BasicBlock &bb = g.block(body[i]);
+                for (int q = bb.first; q <= bb.last; ++q)
+                    if (writesReg(g.instr(q), c)) { update = q; defs++; }
+            }
+            if (defs != 1) continue;
+            const DecodedInstr &u = g.instr(update);
+            if (u.opcode != OPC_ADD || u.dest != c || (u.regA == c) == (u.regB == c)) continue;
+            int s = (u.regA == c) ? u.regB : u.regA;
+            if (loopWrites[m] >> s & 1) continue;
+            int ub = g.blockAt(update);
+            if (g.innermostLoop(ub) != m) continue;
+
+            bool beforeTest;
+            if (ub == eb) beforeTest = update < test;
+            else if (g.dominates(ub, eb)) beforeTest = true;
+            else {
+                bool all = true;
+                for (int x : L.latches) all = all && g.dominates(ub, x);
+                if (!all) continue;
+                beforeTest = false;
+            }
+
+            SymVal step = before(update, s, 0);
+            SymVal bound = before(test, o, 0);
+            if (step.kind != SymVal::CONST || step.c == 0) { lc.why = "step r" + to_string(s) + " is not a known constant"; continue; }
+            if (bound.kind != SymVal::CONST) { lc.why = "bound r" + to_string(o) + " is not a known constant"; continue; }
+
+            // ค่าเริ่มต้น: ค่าของ c ที่ท้าย block นอก loop ทุกตัวที่เข้ามาที่ header
+            SymVal init;
+            bool any = false, agree = true;
+            for (int e = g.predBegin(L.header); e < g.predEnd(L.header); ++e) {
+                if (g.predKind(e) == EDGE_CALL || inLoop(m, g.pred(e))) continue;
+                SymVal v = (g.predKind(e) == EDGE_RETURN_SITE) ? unknownVal("r" + to_string(c))
+                                                                : atEnd(g.pred(e), c, 0);
+                if (!any) { init = v; any = true; }
+                else if (!sameVal(init, v)) agree = false;
+            }
+            if (!any || !agree || init.kind == SymVal::UNKNOWN) { lc.why = "initial value of r" + to_string(c) + " is unknown"; continue; }
+            if (init.kind == SymVal::IV && init.loop != L.parent) { lc.why = "initial value depends on a non-enclosing loop"; continue; }
+
+            long long diff = (long long)bound.c - init.c;
+            long long coef = (init.kind == SymVal::IV) ? init.step : 0;
+            if (diff % step.c != 0 || coef % step.c != 0) { lc.why = "counter steps over the bound"; continue; }
+            long long adj = beforeTest ? 0 : 1;
+            long long alpha = diff / step.c + adj;
+            long long beta = -coef / step.c;
+            if (alpha < 1) { lc.why = "counter moves away from the bound"; continue; }
+
+            lc.analyzed = true;
+            lc.why.clear();
+            lc.counter = c;
+            lc.stepReg = s;
+            lc.boundReg = o;
+            lc.updateAddr = update;
+            lc.updateBeforeTest = beforeTest;
+            lc.init = init;
+            lc.bound = bound;
+            lc.step = step.c;
+            lc.tripBase = alpha;
+            lc.tripPerOuter = beta;
+            string f = "(" + bound.text + " - " + init.text + ") / " + step.text + (adj ? " + 1" : "");
+            if (beta == 0) f += " = " + to_string(alpha);
+            else f += " = " + to_string(alpha) + (beta > 0 ? " + " : " - ") + to_string(beta > 0 ? beta : -beta) + "*k";
+            lc.tripText = f;
+        }
+        if (!lc.analyzed && lc.why.empty()) lc.why = "no counter of the form 'add c s c' with a single update";
+    }
+
+    // ---- จำนวนครั้งที่แต่ละ block ทำงาน ----
+    void computeCounts() {
+        const int B = g.numBlocks();
+        // procedure ของแต่ละ block: ไล่จาก root ตาม edge ภายใน
+        vector<int> proc(B, -1);
+        const vector<int> &roots = g.roots();
+        for (size_t r = 0; r < roots.size(); ++r) {
+            vector<int> work{roots[r]};
+            if (proc[roots[r]] >= 0) continue;
+            proc[roots[r]] = (int)r;
+            while (!work.empty()) {
+                int b = work.back();
+                work.pop_back();
+                for (int e = g.succBegin(b); e < g.succEnd(b); ++e) {
+                    if (g.succKind(e) == EDGE_CALL) continue;
+                    int s = g.succ(e);
+                    if (proc[s] < 0) { proc[s] = (int)r; work.push_back(s); }
+                }
+            }
+        }
+
+        vector<long long> procCount(roots.size(), -1);
+        if (!roots.empty()) procCount[0] = 1;
+        for (size_t round = 0; round <= roots.size(); ++round) {
+            for (int b = 0; b < B; ++b)
+                rep.blockCount[b] = (g.innermostLoop(b) < 0 && proc[b] >= 0) ? procCount[proc[b]] : -1;
+            for (size_t m = 0; m < g.loops().size(); ++m) loopCounts((int)m);
+            bool changed = false;
+            for (size_t r = 1; r < roots.size(); ++r) {
+                long long cnt = 0;
+                for (int e = g.predBegin(roots[r]); e < g.predEnd(roots[r]); ++e) {
+                    if (g.predKind(e) != EDGE_CALL) continue;
+                    int caller = g.pred(e);
+                    // เรียกตัวเอง (recursion) → ไม่รู้จำนวนครั้ง
+                    if (proc[caller] == (int)r) { cnt = -1; break; }
+                    cnt = satAdd(cnt, rep.blockCount[caller]);
+                }
+                if (cnt != procCount[r]) { procCount[r] = cnt; changed = true; }
+            }
+            if (!changed) break;
+        }
+    }
+
+    void loopCounts(int m) {
+        const NaturalLoop &L = g.loops()[m];
+        LoopCost &lc = rep.loops[m];
+        long long E = 0;
+        for (int e = g.predBegin(L.header); e < g.predEnd(L.header); ++e) {
+            if (g.predKind(e) == EDGE_CALL || inLoop(m, g.pred(e))) continue;
+            E = satAdd(E, rep.blockCount[g.pred(e)]);
+        }
+        lc.entries = E;
+        long long H = -1;
+        if (lc.analyzed && E >= 0) {
+            if (lc.tripPerOuter == 0) H = satMul(E, lc.tripBase);
+            else if (L.parent >= 0) {
+                const LoopCost &pc = rep.loops[L.parent];
+                if (pc.analyzed && pc.tripPerOuter == 0 && pc.entries > 0 && E % pc.entries == 0) {
+                    long long kc = E / pc.entries;   // จำนวนรอบของ loop นอกต่อการเข้า 1 ครั้ง
+                    long long last = lc.tripBase + lc.tripPerOuter * (kc - 1);
+                    if (last >= 1) {
+                        long long perEntry = satAdd(satMul(kc, lc.tripBase),
+                                                    lc.tripPerOuter * (kc * (kc - 1) / 2));
+                        H = satMul(pc.entries, perEntry);
+                    }
+                }
+            }
+        }
+        lc.headerRuns = H;
+
+        // block ที่อยู่ใน loop นี้โดยตรง: ก่อน test ทำ H ครั้ง หลัง test ทำ H - E ครั้ง
+        int eb = lc.analyzed ? g.blockAt(lc.testAddr) : -1;
+        lc.cyclesPerIter = 0;
+        for (int i = 0; i < L.bodyCount; ++i) {
+            int b = g.loopBody(m)[i];
+            if (g.innermostLoop(b) != m) continue;
+            lc.cyclesPerIter += rep.blockCycles[b];
+            if (H < 0) rep.blockCount[b] = -1;
+            else rep.blockCount[b] = g.dominates(b, eb) ? H : H - E;
+        }
+    }
+
+    void loopTotals() {
+        for (size_t m = 0; m < g.loops().size(); ++m) {
+            LoopCost &lc = rep.loops[m];
+            long long ins = 0, cyc = 0;
+            const NaturalLoop &L = g.loops()[m];
+            for (int i = 0; i < L.bodyCount; ++i) {
+                int b = g.loopBody((int)m)[i];
+                ins = satAdd(ins, satMul(rep.blockCount[b], rep.blockInstrs[b]));
+                cyc = satAdd(cyc, satMul(rep.blockCount[b], rep.blockCycles[b]));
+            }
+            lc.instrs = ins;
+            lc.cycles = cyc;
+        }
+    }
+
+    void run() {
+        const int B = g.numBlocks();
+        const int n = g.imageSize();
+        rep.blockInstrs.assign(B, 0);
+        rep.blockCycles.assign(B, 0);
+        rep.blockCount.assign(B, -1);
+        storedTo.assign(n, 0);
+        for (int b = 0; b < B; ++b) {
+            const BasicBlock &bb = g.block(b);
+            rep.blockInstrs[b] = bb.last - bb.first + 1;
+            for (int q = bb.first; q <= bb.last; ++q) {
+                const DecodedInstr &d = g.instr(q);
+                rep.blockCycles[b] += model.of(d.opcode);
+                if (d.opcode == OPC_SW && d.regA == 0 && d.imm >= 0 && d.imm < n) storedTo[d.imm] = 1;
+            }
+        }
+
+        const vector<NaturalLoop> &loops = g.loops();
+        rep.loops.assign(loops.size(), LoopCost{});
+        headerLoop.assign(B, -1);
+        loopWrites.assign(loops.size(), 0);
+        for (size_t m = 0; m < loops.size(); ++m) {
+            headerLoop[loops[m].header] = (int)m;
+            for (int i = 0; i < loops[m].bodyCount; ++i) {
+                const BasicBlock &bb = g.block(g.loopBody((int)m)[i]);
+                for (int q = bb.first; q <= bb.last; ++q)
+                    for (int r = 1; r < 8; ++r)
+                        if (writesReg(g.instr(q), r)) loopWrites[m] |= uint8_t(1 << r);
+            }
+        }
+        // loops() เรียงจาก loop นอกไป loop ใน: ค่า IV ของ loop นอกพร้อมใช้ตอนวิเคราะห์ loop ใน
+        defGen.assign(n, 0);
+        defState.assign(n, MEMO_NONE);
+        defMemo.assign(n, SymVal{});
+        startGen.assign(size_t(B) * 8, 0);
+        startState.assign(size_t(B) * 8, MEMO_NONE);
+        startMemo.assign(size_t(B) * 8, SymVal{});
+        for (size_t m = 0; m < loops.size(); ++m) {
+            analyzeLoop((int)m);
+            if (rep.loops[m].analyzed) gen++;
+        }
+
+        computeCounts();
+        loopTotals();
+
+        long long ins = 0, cyc = 0;
+        for (int b = 0; b < B; ++b) {
+            ins = satAdd(ins, satMul(rep.blockCount[b], rep.blockInstrs[b]));
+            cyc = satAdd(cyc, satMul(rep.blockCount[b], rep.blockCycles[b]));
+            // call ที่หา target ไม่ได้ (ไม่มี CALL edge): ไม่รู้ต้นทุนของ callee ยอดรวมเป็น upper bound ไม่ได้
+            if (g.block(b).exit == EXIT_CALL && rep.blockCount[b] != 0) {
+                bool resolved = false;
+                for (int e = g.succBegin(b); e < g.succEnd(b); ++e) resolved |= g.succKind(e) == EDGE_CALL;
+                if (!resolved) ins = cyc = -1;
+            }
+        }
+        rep.totalInstrs = ins;
+        rep.totalCycles = cyc;
+    }
+};
+
+}  // namespace
+
+StaticCostReport analyzeStaticCost(ControlFlowGraph &g, const CostModel &model, const vector<string> &labelAt) {
+    g.computeDominators();
+    g.findLoops();
+    StaticCostReport rep;
+    Analyzer a(g, model, labelAt, rep);
+    a.run();
+    return rep;
+}
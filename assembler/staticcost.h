@@ -0,0 +1,72 @@
+// staticcost.h
+// ประเมินต้นทุนของโปรแกรมแบบ static (ไม่ต้องรัน) จาก CFG (cfg.h) + ตารางต้นทุนต่อ opcode
+//   - ต้นทุนต่อ block = ผลรวม cycle ของคำสั่งใน block
+//   - จำนวนครั้งที่ block ทำงาน = 1 นอก loop, ภายใน loop คำนวณจาก trip count ของ loop แบบนับ (counted loop)
+//   - counted loop ที่รู้จัก: มีทางออกเดียวเป็น "beq c b exit" และ c ถูกแก้ใน loop ครั้งเดียวด้วย "add c s c"
+//     (s ไม่เปลี่ยนใน loop) เช่น loop ใน programs/multiply.asm:
+//         loop    beq  2   0   done
+//                 ...
+//                 add  2   5   2
+//     trip count = (bound - init) / step (+1 ถ้าแก้ c หลังการ test)
+//   - ค่าเริ่มต้นหาได้จาก "lw 0 r label" ที่ชี้ไป .fill ที่ไม่มีใคร sw ทับ และ add/nand ของค่าที่รู้แล้ว
+//     ถ้าค่าเริ่มต้นของ loop ในเป็น counter ของ loop นอก (เช่น factorial: counter = i) จะได้ trip แบบ
+//     α + β·k (k = รอบของ loop นอก) แล้วรวมเป็นผลบวกอนุกรมเลขคณิต
+// ผลเป็น upper bound: ทาง if/else ภายใน loop นับว่าทำงานทุกรอบ
+// loop ที่วิเคราะห์ไม่ได้ (หรือ callee ที่เรียกตัวเอง หรือ call ที่หา target ไม่ได้) ทำให้ยอดรวมเป็น "unknown"
+
+#ifndef STATICCOST_H
+#define STATICCOST_H
+
+#include "cfg.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// cycle ต่อ opcode (add, nand, lw, sw, beq, jalr, halt, noop)
+struct CostModel {
+    int cycles[8] = {1, 1, 2, 2, 1, 2, 1, 1};
+    int of(int opcode) const { return cycles[opcode & 7]; }
+    // แก้ค่าจากข้อความแบบ "lw=3,sw=3" (throw runtime_error ถ้าผิดรูปแบบ)
+    void parse(const std::string &spec);
+};
+
+// ค่าของ register ณ จุดหนึ่งในแบบ symbolic
+struct SymVal {
+    enum Kind : uint8_t { UNKNOWN, CONST, IV } kind = UNKNOWN;
+    int32_t c = 0;        // ค่าคงที่ หรือค่าเริ่มต้นของ IV
+    int32_t step = 0;     // IV: เพิ่มรอบละ step
+    int loop = -1;        // IV: loop ที่เป็นเจ้าของ
+    std::string text;     // รูปที่ใช้แสดงในรายงาน เช่น "mplier" หรือ "(nval + pos1)"
+};
+
+struct LoopCost {
+    bool analyzed = false;
+    std::string why;             // เหตุผลถ้าวิเคราะห์ไม่ได้
+    int counter = -1, stepReg = -1, boundReg = -1;
+    int updateAddr = -1, testAddr = -1;
+    bool updateBeforeTest = false;
+    SymVal init, bound;
+    int32_t step = 0;
+    long long tripBase = 0;      // จำนวนครั้งที่ test ต่อการเข้า loop หนึ่งครั้ง = tripBase + tripPerOuter·k
+    long long tripPerOuter = 0;
+    std::string tripText;
+    long long entries = -1;      // จำนวนครั้งที่เข้า loop ทั้งโปรแกรม (-1 = ไม่รู้)
+    long long headerRuns = -1;   // จำนวนครั้งที่ header ทำงานทั้งโปรแกรม
+    int cyclesPerIter = 0;       // cycle ของ block ที่อยู่ใน loop นี้โดยตรง (ไม่รวม loop ใน)
+    long long instrs = -1, cycles = -1;   // รวมทั้ง loop (รวม loop ใน)
+};
+
+struct StaticCostReport {
+    std::vector<int> blockInstrs, blockCycles;
+    std::vector<long long> blockCount;    // -1 = ไม่รู้
+    std::vector<LoopCost> loops;          // index เดียวกับ ControlFlowGraph::loops()
+    long long totalInstrs = -1, totalCycles = -1;
+};
+
+// g ต้องสร้างจาก image เดียวกับที่ต้องการวิเคราะห์ (จะเรียก computeDominators/findLoops ให้เอง)
+// labelAt[addr] = ชื่อ label ของ address นั้น (ไม่บังคับ ใช้แสดงผลแทน mem[addr])
+StaticCostReport analyzeStaticCost(ControlFlowGraph &g, const CostModel &model,
+                                   const std::vector<std::string> &labelAt = {});
+
+#endif
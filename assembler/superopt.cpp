@@ -0,0 +1,374 @@
+// superopt.cpp
+// superoptimizer แบบ offline: หาลำดับ add/nand ที่สั้นที่สุดของลำดับสั้น ๆ แล้วเขียนเป็น rewrite database (rewritedb.h)
+// ให้ optimizer --peephole --rewrite-db <file> นำไปใช้
+//   1) ตาราง: ไล่ทุกลำดับยาว 0..N-1 บน register นามธรรม 1..k (+ r0) รันบน input สุ่มชุดเดียวกันด้วย
+//      decode-and-execute loop แบบ native แล้วเก็บ "ลำดับที่สั้นที่สุด" ของแต่ละ fingerprint (ค่าสุดท้ายของ
+//      register ใน live mask) ตัดลำดับที่เขียนทับค่าที่ยังไม่มีใครอ่านทิ้งตั้งแต่ตอนค้น
+//   2) pattern: ไล่ทุกลำดับ canonical ยาว 1..N ที่ไม่มีช่วงย่อยไหนย่อได้อยู่แล้ว หา fingerprint ในตาราง
+//      ถ้าเจอลำดับที่สั้นกว่า = candidate แล้วยืนยันด้วย soEquivalent (สุ่ม 32 บิต + ครบโดเมน 16 บิต)
+//   3) เก็บเฉพาะกฎที่ไม่มีกฎของ live mask ที่ใหญ่กว่าดีเท่ากันอยู่แล้ว และสั้นกว่าการลบคำสั่งที่เขียนค่าทิ้งเฉย ๆ
+//      (peephole ลบ dead write เองได้)
+// งานแต่ละขั้นแบ่งตามคำสั่งแรกของลำดับให้หลาย thread ทำพร้อมกัน
+//
+// Compile : g++ -std=c++17 -O2 -pthread superopt.cpp rewritedb.cpp -o superopt
+// Run : .\superopt --regs 3 --len 3 -o rewrite.db   (--threads N, ค่าเริ่มต้น = จำนวน core)
+
+#include "rewritedb.h"
+#include "lc_isa.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+using namespace std;
+
+static const int NUM_TESTS = 8;
+static const int MAX_LEN = 5;
+
+// input ของการทดสอบแบบสุ่ม (ใช้ชุดเดียวกันทั้งตารางและ pattern)
+struct TestSet {
+    uint32_t in[NUM_TESTS][8];
+    TestSet() {
+        mt19937 rng(20240607);
+        for (int t = 0; t < NUM_TESTS; ++t) {
+            in[t][0] = 0;
+            for (int r = 1; r < 8; ++r) in[t][r] = uint32_t(rng());
+        }
+        // ค่าพิเศษที่มักแยกฟังก์ชันออกจากกันได้
+        in[0][1] = 0; in[0][2] = 0xFFFFFFFFu; in[0][3] = 1;
+        in[1][1] = 0x80000000u; in[1][2] = 1; in[1][3] = 0;
+    }
+};
+static const TestSet TESTS;
+
+// คำสั่งแต่ละตัวเก็บเป็น word ของ LC จริง แล้ว decode ตอนรัน
+static inline void execWord(uint32_t w, uint32_t regs[8]) {
+    DecodedInstr d = decodeWord(int32_t(w));
+    uint32_t v = d.opcode == OPC_NAND ? ~(regs[d.regA] & regs[d.regB]) : regs[d.regA] + regs[d.regB];
+    regs[d.dest] = v;
+    regs[0] = 0;
+}
+
+static SoInstr toSo(uint32_t w) {
+    DecodedInstr d = decodeWord(int32_t(w));
+    return {uint8_t(d.opcode == OPC_NAND), d.regA, d.regB, d.dest};
+}
+
+static SoSeq toSeq(const vector<uint32_t> &words) {
+    SoSeq s;
+    for (uint32_t w : words) s.push_back(toSo(w));
+    return s;
+}
+
+// fingerprint ของค่าสุดท้ายของ register ใน live mask ทุก test
+static uint64_t fingerprint(const uint32_t st[NUM_TESTS][8], uint8_t live) {
+    uint64_t h = 0x9E3779B97F4A7C15ull ^ live;
+    for (int t = 0; t < NUM_TESTS; ++t)
+        for (int r = 1; r < 8; ++r)
+            if (live >> r & 1) {
+                h ^= st[t][r] + 0x9E3779B97F4A7C15ull + (h << 6) + (h >> 2);
+                h *= 0xFF51AFD7ED558CCDull;
+            }
+    return h;
+}
+
+// ลำดับที่สั้นที่สุดของแต่ละ fingerprint: เทียบ (ความยาว, word) เพื่อให้ผลเหมือนเดิมทุกครั้งไม่ว่ากี่ thread
+struct Best {
+    vector<uint32_t> words;
+    bool better(const vector<uint32_t> &o) const {
+        return o.size() < words.size() || (o.size() == words.size() && o < words);
+    }
+};
+using Table = unordered_map<uint64_t, Best>;
+
+// คำสั่งที่ใช้สร้างตาราง (replacement): ตัดตัวที่ซ้ำความหมายออก
+static vector<uint32_t> tableAlphabet(int k) {
+    vector<uint32_t> out;
+    for (int op = 0; op < 2; ++op)
+        for (int a = 0; a <= k; ++a)
+            for (int b = a; b <= k; ++b)
+                for (int d = 1; d <= k; ++d) {
+                    if (op == OPC_ADD && a == 0 && b == d) continue;      // add 0 d d ไม่เปลี่ยนอะไร
+                    if (op == OPC_NAND && a == 0 && b != 0) continue;     // nand 0 x d = nand 0 0 d
+                    out.push_back(packR(op, a, b, d));
+                }
+    return out;
+}
+
+// คำสั่งที่ใช้ไล่ pattern: operand ทั้งสองลำดับ แต่ไม่รวมรูปที่ peephole ทำให้เป็นปกติก่อนค้นอยู่แล้ว
+// (add ที่ไม่เปลี่ยนอะไร, nand ที่มี r0 ตัวเดียว = nand 0 0 d)
+static vector<uint32_t> patternAlphabet(int k) {
+    vector<uint32_t> out;
+    for (int op = 0; op < 2; ++op)
+        for (int a = 0; a <= k; ++a)
+            for (int b = 0; b <= k; ++b)
+                for (int d = 1; d <= k; ++d) {
+                    if (op == OPC_ADD && ((a == 0 && b == d) || (b == 0 && a == d))) continue;
+                    if (op == OPC_NAND && (a == 0) != (b == 0)) continue;
+                    out.push_back(packR(op, a, b, d));
+                }
+    return out;
+}
+
+// ความยาวของ pattern หลังลบคำสั่งที่เขียน register ที่ไม่มีใครอ่านต่อ (peephole ทำเองได้โดยไม่ต้องมีกฎ)
+static size_t lengthWithoutDeadWrites(const SoSeq &s, uint8_t live) {
+    size_t n = 0;
+    uint8_t need = live;
+    for (size_t i = s.size(); i-- > 0;) {
+        if (!(need >> s[i].d & 1)) continue;
+        ++n;
+        need = uint8_t((need & ~(1 << s[i].d)) | (1 << s[i].a) | (1 << s[i].b));
+    }
+    return n;
+}
+
+// ไล่งานตาม index ด้วยหลาย thread (แต่ละ thread หยิบ index ถัดไปจาก atomic counter)
+template <class F>
+static void parallelFor(int n, int threads, F fn) {
+    atomic<int> next{0};
+    vector<thread> pool;
+    for (int t = 0; t < threads; ++t)
+        pool.emplace_back([&, t] {
+            for (int i; (i = next++) < n;) fn(t, i);
+        });
+    for (auto &th : pool) th.join();
+}
+
+class Superopt {
+public:
+    Superopt(int maxRegs, int maxLen, int threads) : K(maxRegs), N(maxLen), threads(threads) {}
+
+    void run(RewriteDb &db, ostream &log) {
+        tables.resize(K + 1);
+        for (int k = 1; k <= K; ++k) {
+            auto t0 = chrono::steady_clock::now();
+            buildTable(k);
+            log << "table r1..r" << k << ": " << tables[k].size() << " fingerprint(s), "
+                << tableSeqs << " sequence(s) in " << secondsSince(t0) << " s\n";
+        }
+        for (int len = 1; len <= N; ++len) {
+            for (int k = 1; k <= K; ++k) {
+                auto t0 = chrono::steady_clock::now();
+                size_t before = db.size();
+                long scanned = searchPatterns(len, k, db);
+                log << "length " << len << ", " << k << " register(s): " << scanned << " canonical pattern(s), "
+                    << (db.size() - before) << " rule(s) in " << secondsSince(t0) << " s\n";
+            }
+            // กฎ "ทุก register live" ของความยาวนี้ใช้ตัด pattern ที่ยาวกว่า
+            for (const auto &p : newlyReducible) reducible.insert(p);
+            newlyReducible.clear();
+        }
+    }
+
+private:
+    int K, N, threads;
+    vector<Table> tables;           // tables[k] = ตารางของลำดับที่ใช้ register 1..k
+    long tableSeqs = 0;
+    unordered_set<string> reducible, newlyReducible;
+    mutex mu;
+
+    static double secondsSince(chrono::steady_clock::time_point t0) {
+        return chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+    }
+
+    // ---------- 1) ตาราง ----------
+    void buildTable(int k) {
+        const vector<uint32_t> alpha = tableAlphabet(k);
+        vector<Table> local(threads);
+        atomic<long> seqs{0};
+        const int maxDepth = N - 1;
+
+        auto record = [&](Table &tab, const uint32_t st[NUM_TESTS][8], const vector<uint32_t> &words) {
+            for (int live = 2; live < (2 << k); live += 2) {
+                uint64_t h = fingerprint(st, uint8_t(live));
+                auto it = tab.find(h);
+                if (it == tab.end()) tab.emplace(h, Best{words});
+                else if (it->second.better(words)) it->second.words = words;
+            }
+        };
+
+        // ลำดับว่าง (identity)
+        {
+            uint32_t st[NUM_TESTS][8];
+            for (int t = 0; t < NUM_TESTS; ++t) copy(TESTS.in[t], TESTS.in[t] + 8, st[t]);
+            record(local[0], st, {});
+        }
+        if (maxDepth >= 1) {
+            parallelFor((int)alpha.size(), threads, [&](int th, int first) {
+                vector<uint32_t> words;
+                uint32_t st[MAX_LEN + 1][NUM_TESTS][8];
+                for (int t = 0; t < NUM_TESTS; ++t) copy(TESTS.in[t], TESTS.in[t] + 8, st[0][t]);
+                // pending[r] = เขียนแล้วแต่ยังไม่มีใครอ่าน (ถ้าเขียนทับอีก = ลำดับนี้ไม่มีทางสั้นที่สุด)
+                function<void(int, uint8_t)> dfs = [&](int depth, uint8_t pending) {
+                    seqs++;
+                    record(local[th], st[depth], words);
+                    if (depth == maxDepth) return;
+                    for (size_t i = 0; i < alpha.size(); ++i) {
+                        DecodedInstr d = decodeWord(int32_t(alpha[i]));
+                        uint8_t p = pending & uint8_t(~((1 << d.regA) | (1 << d.regB)));
+                        if (p >> d.dest & 1) continue;
+                        for (int t = 0; t < NUM_TESTS; ++t) {
+                            copy(st[depth][t], st[depth][t] + 8, st[depth + 1][t]);
+                            execWord(alpha[i], st[depth + 1][t]);
+                        }
+                        words.push_back(alpha[i]);
+                        dfs(depth + 1, uint8_t(p | (1 << d.dest)));
+                        words.pop_back();
+                    }
+                };
+                // ราก (depth 0) ถูกนับใน thread ของคำสั่งแรกแล้ว จึงเริ่มจากคำสั่งแรกโดยตรง
+                DecodedInstr d = decodeWord(int32_t(alpha[first]));
+                for (int t = 0; t < NUM_TESTS; ++t) {
+                    copy(st[0][t], st[0][t] + 8, st[1][t]);
+                    execWord(alpha[first], st[1][t]);
+                }
+                words.push_back(alpha[first]);
+                dfs(1, uint8_t(1 << d.dest));
+            });
+        }
+        tableSeqs = seqs + 1;
+        Table &out = tables[k];
+        for (auto &tab : local)
+            for (auto &kv : tab) {
+                auto it = out.find(kv.first);
+                if (it == out.end()) out.emplace(kv.first, kv.second);
+                else if (it->second.better(kv.second.words)) it->second = kv.second;
+            }
+    }
+
+    // ---------- 2) pattern ----------
+    long searchPatterns(int len, int k, RewriteDb &db) {
+        const vector<uint32_t> alpha = patternAlphabet(k);
+        const Table &table = tables[k];
+        atomic<long> scanned{0};
+        vector<RewriteRule> found;
+
+        parallelFor((int)alpha.size(), threads, [&](int, int first) {
+            vector<uint32_t> words;
+            vector<RewriteRule> mine;
+            vector<string> mineReducible;
+            long count = 0;
+            // next = register นามธรรมตัวถัดไปที่ยังไม่ถูกใช้ (บังคับตั้งชื่อตามลำดับที่ปรากฏ)
+            function<void(int)> dfs = [&](int next) {
+                if ((int)words.size() == len) {
+                    if (next != k + 1) return;   // ต้องใช้ครบ k register
+                    SoSeq seq = toSeq(words);
+                    int map[8];
+                    if (!(soCanonical(seq, map) == seq)) return;
+                    ++count;
+                    examine(seq, k, table, mine, mineReducible);
+                    return;
+                }
+                for (size_t i = 0; i < alpha.size(); ++i) {
+                    if (words.empty() && (int)i != first) continue;
+                    DecodedInstr d = decodeWord(int32_t(alpha[i]));
+                    int nx = next;
+                    bool ok = true;
+                    for (int r : {int(d.regA), int(d.regB), int(d.dest)}) {
+                        if (r == 0 || r < nx) continue;
+                        if (r == nx) ++nx;
+                        else { ok = false; break; }
+                    }
+                    if (!ok) continue;
+                    words.push_back(alpha[i]);
+                    dfs(nx);
+                    words.pop_back();
+                }
+            };
+            dfs(1);
+            scanned += count;
+            lock_guard<mutex> g(mu);
+            found.insert(found.end(), mine.begin(), mine.end());
+            newlyReducible.insert(mineReducible.begin(), mineReducible.end());
+        });
+        for (const auto &r : found) db.add(r);
+        return scanned;
+    }
+
+    void examine(const SoSeq &seq, int k, const Table &table, vector<RewriteRule> &out, vector<string> &red) {
+        const int len = (int)seq.size();
+        // ช่วงย่อยที่ย่อได้อยู่แล้ว → peephole จะย่อช่วงนั้นก่อน ไม่ต้องมีกฎของ pattern นี้
+        for (int i = 0; i < len; ++i)
+            for (int j = i + 1; j <= len; ++j) {
+                if (j - i == len) continue;
+                int map[8];
+                SoSeq sub = soCanonical(SoSeq(seq.begin() + i, seq.begin() + j), map);
+                if (reducible.count(soFormat(sub))) return;
+            }
+
+        uint32_t st[NUM_TESTS][8];
+        for (int t = 0; t < NUM_TESTS; ++t) {
+            copy(TESTS.in[t], TESTS.in[t] + 8, st[t]);
+            soRun(seq, st[t]);
+        }
+        const int full = (2 << k) - 2;
+        // live mask ใหญ่ก่อน: กฎของ mask เล็กที่ไม่ได้สั้นกว่ากฎของ mask ที่ครอบมันอยู่ไม่ต้องเก็บ
+        vector<int> masks;
+        for (int live = 2; live <= full; live += 2) masks.push_back(live);
+        stable_sort(masks.begin(), masks.end(), [](int a, int b) { return __builtin_popcount(a) > __builtin_popcount(b); });
+        vector<pair<int, size_t>> accepted;   // (mask, ความยาว replacement)
+        for (int live : masks) {
+            auto it = table.find(fingerprint(st, uint8_t(live)));
+            if (it == table.end() || (int)it->second.words.size() >= len) continue;
+            size_t rlen = it->second.words.size();
+            bool dominated = false;
+            for (auto &a : accepted)
+                if ((a.first & live) == live && a.second <= rlen) dominated = true;
+            if (dominated) continue;
+            SoSeq rep = toSeq(it->second.words);
+            if (!soEquivalent(seq, rep, uint8_t(live))) continue;
+            accepted.push_back({live, rlen});
+            if (live == full) red.push_back(soFormat(seq));
+            if (rlen < lengthWithoutDeadWrites(seq, uint8_t(live))) out.push_back({seq, uint8_t(live), rep});
+        }
+    }
+};
+
+int main(int argc, char **argv) {
+    int regs = 3, len = 3;
+    int threads = max(1u, thread::hardware_concurrency());
+    string out = "rewrite.db";
+    try {
+        for (int i = 1; i < argc; ++i) {
+            string a = argv[i];
+            if (a == "--regs" && i + 1 < argc) regs = stoi(argv[++i]);
+            else if (a == "--len" && i + 1 < argc) len = stoi(argv[++i]);
+            else if (a == "--threads" && i + 1 < argc) threads = stoi(argv[++i]);
+            else if (a == "-o" && i + 1 < argc) out = argv[++i];
+            else {
+                cerr << "usage: " << argv[0] << " [--regs 1..3] [--len 1.." << MAX_LEN << "] [--threads N] [-o rewrite.db]\n";
+                return 1;
+            }
+        }
+        if (regs < 1 || regs > 3) throw runtime_error("--regs must be 1..3");
+        if (len < 1 || len > MAX_LEN) throw runtime_error("--len must be 1.." + to_string(MAX_LEN));
+        if (threads < 1) throw runtime_error("--threads must be >= 1");
+
+        auto t0 = chrono::steady_clock::now();
+        RewriteDb db;
+        Superopt so(regs, len, threads);
+        so.run(db, cout);
+
+        ostringstream header;
+        header << "# LC rewrite database: สร้างด้วย superopt --regs " << regs << " --len " << len << "\n"
+               << "# pattern | live registers | replacement   (register 1.." << regs << " เป็นชื่อนามธรรม, 0 = r0)\n";
+        db.save(out, header.str());
+        cout << db.size() << " rule(s) written to " << out << " using " << threads << " thread(s) in "
+             << chrono::duration<double>(chrono::steady_clock::now() - t0).count() << " s\n";
+    } catch (const exception &e) {
+        cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
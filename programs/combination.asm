@@ -30,16 +30,16 @@ comb    beq  2   0   base       ; Base case: if r == 0, return 1
         lw   0   4   combAd  ; R4 = address of comb
         jalr 4   3           ; recursive call
         
-        ; Save result of first call
-        sw   5   3   0       ; push result1
-        add  5   6   5       ; sp++
-        
         ; Restore n and r for second call
         add  5   7   5       ; sp--
         lw   5   2   0       ; pop r
         add  5   7   5       ; sp--
         lw   5   1   0       ; pop n
         
+        ; Save result of first call
+        sw   5   3   0       ; push result1
+        add  5   6   5       ; sp++
+        
         ; Second recursive call: combination(n-1, r-1)
         add  1   7   1       ; n = n - 1
         add  2   7   2       ; r = r - 1
@@ -53,11 +53,12 @@ comb    beq  2   0   base       ; Base case: if r == 0, return 1
         
         ; Restore return address and return
         add  5   7   5       ; sp--
-        lw   5   3   0       ; pop return address
-        jalr 3   0           ; return
+        lw   5   4   0       ; pop return address
+        jalr 4   0           ; return
         
-base    lw   0   3   pos1    ; return 1
-        jalr 3   0           ; return
+base    add  3   0   4       ; R4 = return address
+        lw   0   3   pos1    ; return 1
+        jalr 4   0           ; return
 
 ; Data section
 n       .fill 5
@@ -65,5 +66,6 @@ r       .fill 2
 pos1    .fill 1
 neg1    .fill -1
 result  .fill 0
-stack   .fill 100
-combAd  .fill 8              ; address of comb function
\ No newline at end of file
+stack   .fill stkbuf         ; stack pointer starts at the reserved region below
+combAd  .fill comb           ; address of comb function
+stkbuf  .space 64            ; stack (grows upward)
\ No newline at end of file
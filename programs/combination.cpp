@@ -0,0 +1,124 @@
+// generated by mc2cpp from combination.mc (45 word(s), 3 block(s)) -- do not edit
+// output เหมือน "simulator --fast combination.mc" ทุก byte, --stats = จำนวนคำสั่งที่ต้องใช้ interpreter ทาง stderr
+// Compile : g++ -std=c++17 -O2 -I<ไดเรกทอรีของ lc_sim.h> <ไฟล์นี้> -o <ชื่อโปรแกรม>
+
+#include "lc_sim.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+static const int32_t LITERAL[] = {
+    8454182, 8519719, 8716331, 8781864, 8847401, 8650796, 23265280, 12779562, 25165824, 17825818, 17432601, 15400960,
+    3014661, 15269888, 3014661, 15335424, 3014661, 983041, 8650796, 23265280, 15400960, 3014661, 3080197, 11141120,
+    3080197, 11075584, 983041, 1507330, 8650796, 23265280, 3080197, 11075584, 1638403, 3080197, 11206656, 22544384,
+    8585256, 22544384, 5, 2, 1, -1, 0, 100, 8,
+};
+static const int32_t SEGMENTS[][3] = {
+    {45, 0, 0},
+};
+
+static const int32_t NUM_WORDS = 45;
+static const uint64_t CODE_BITS[] = {
+    511ull,
+};
+static const int32_t NUM_BLOCKS = 3;
+static const int32_t BLOCK_START[] = {
+    0, 7, 8,
+};
+
+static inline bool isCode(uint32_t a) { return a < uint32_t(NUM_WORDS) && (CODE_BITS[a >> 6] >> (a & 63) & 1); }
+
+static LcSim::Stop runCompiled(LcSim &sim, long &interpreted) {
+    int32_t *const m = sim.mem.data();
+    std::vector<unsigned char> dead(size_t(NUM_BLOCKS) + 1, 0);   // block ที่มี word ถูกเขียนทับ
+    int32_t r1, r2, r3, r4, r5, r6, r7, pc;
+    long steps;
+    LcSim::Stop stop;
+#define LOAD_STATE() do { r1 = sim.regs[1]; r2 = sim.regs[2]; r3 = sim.regs[3]; r4 = sim.regs[4]; r5 = sim.regs[5]; r6 = sim.regs[6]; r7 = sim.regs[7]; pc = sim.pc; steps = sim.steps; } while (0)
+#define SAVE_STATE() do { sim.regs[1] = r1; sim.regs[2] = r2; sim.regs[3] = r3; sim.regs[4] = r4; sim.regs[5] = r5; sim.regs[6] = r6; sim.regs[7] = r7; sim.pc = pc; sim.executed += steps - sim.steps; sim.steps = steps; } while (0)
+    LOAD_STATE();
+    goto dispatch;
+
+b0:
+    if (steps > LcSim::MAX_STEPS - 7 || dead[0]) { pc = 0; goto interp; }
+    steps += 7;
+    // 0: lw 0 1 38
+    r1 = m[38];
+    // 1: lw 0 2 39
+    r2 = m[39];
+    // 2: lw 0 5 43
+    r5 = m[43];
+    // 3: lw 0 6 40
+    r6 = m[40];
+    // 4: lw 0 7 41
+    r7 = m[41];
+    // 5: lw 0 4 44
+    r4 = m[44];
+    // 6: jalr 4 3
+    pc = r4;
+    r3 = 7;
+    goto dispatch;
+
+b7:
+    if (steps > LcSim::MAX_STEPS - 1 || dead[1]) { pc = 7; goto interp; }
+    steps += 1;
+    // 7: sw 0 3 42
+    m[42] = r3;
+    goto b8;
+
+b8:
+    if (steps > LcSim::MAX_STEPS - 1 || dead[2]) { pc = 8; goto interp; }
+    steps += 1;
+    // 8: halt
+    pc = 9; stop = LcSim::Stop::HALT; goto done;
+
+dispatch:
+    switch (pc) {
+        case 0: goto b0;
+        case 7: goto b7;
+        case 8: goto b8;
+        default: break;
+    }
+interp:
+    SAVE_STATE();
+    if (uint32_t(pc) < uint32_t(NUM_WORDS)) {
+        // sw ที่จะเปลี่ยนค่า code word → block ที่มี word นั้นกลับมาใช้ไม่ได้อีก
+        const DecodedInstr d = decodeWord(m[pc]);
+        const uint32_t a = uint32_t(sim.regs[d.regA]) + uint32_t(d.imm);
+        if (d.opcode == OPC_SW && isCode(a) && m[a] != sim.regs[d.regB])
+            dead[std::upper_bound(BLOCK_START, BLOCK_START + NUM_BLOCKS, int32_t(a)) - BLOCK_START - 1] = 1;
+    }
+    interpreted++;
+    if (!sim.step(stop)) return stop;
+    LOAD_STATE();
+    goto dispatch;
+done:
+    SAVE_STATE();
+    return stop;
+#undef LOAD_STATE
+#undef SAVE_STATE
+}
+
+int main(int argc, char **argv) {
+    const bool stats = argc > 1 && std::string(argv[1]) == "--stats";
+    SparseImage image;
+    const int32_t *lit = LITERAL;
+    for (const auto &s : SEGMENTS) {
+        if (s[1]) { if (s[0]) image.pushRun(s[0], s[2]); }
+        else for (int32_t k = 0; k < s[0]; ++k) image.push(*lit++);
+    }
+    OutBuffer out(stdout);
+    LcSim sim(out);
+    sim.load(image);
+    long interpreted = 0;
+    runCompiled(sim, interpreted);
+    sim.printState();
+    if (stats) {
+        out.flush();
+        fprintf(stderr, "executed %ld instruction(s), %ld step(s) through the interpreter\n", sim.executed, interpreted);
+    }
+    return 0;
+}
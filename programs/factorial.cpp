@@ -0,0 +1,159 @@
+// generated by mc2cpp from factorial.mc (20 word(s), 7 block(s)) -- do not edit
+// output เหมือน "simulator --fast factorial.mc" ทุก byte, --stats = จำนวนคำสั่งที่ต้องใช้ interpreter ทาง stderr
+// Compile : g++ -std=c++17 -O2 -I<ไดเรกทอรีของ lc_sim.h> <ไฟล์นี้> -o <ชื่อโปรแกรม>
+
+#include "lc_sim.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+static const int32_t LITERAL[] = {
+    8650769, 8716306, 8585235, 327681, 2949127, 6, 458754, 17825795, 3211270, 1245186, 16842748, 3145729,
+    3997703, 2424838, 20840449, 16842741, 25165824, 5, 1, -1,
+};
+static const int32_t SEGMENTS[][3] = {
+    {20, 0, 0},
+};
+
+static const int32_t NUM_WORDS = 20;
+static const uint64_t CODE_BITS[] = {
+    131071ull,
+};
+static const int32_t NUM_BLOCKS = 7;
+static const int32_t BLOCK_START[] = {
+    0, 5, 7, 8, 11, 15, 16,
+};
+
+static inline bool isCode(uint32_t a) { return a < uint32_t(NUM_WORDS) && (CODE_BITS[a >> 6] >> (a & 63) & 1); }
+
+static LcSim::Stop runCompiled(LcSim &sim, long &interpreted) {
+    int32_t *const m = sim.mem.data();
+    std::vector<unsigned char> dead(size_t(NUM_BLOCKS) + 1, 0);   // block ที่มี word ถูกเขียนทับ
+    int32_t r1, r2, r3, r4, r5, r6, r7, pc;
+    long steps;
+    LcSim::Stop stop;
+#define LOAD_STATE() do { r1 = sim.regs[1]; r2 = sim.regs[2]; r3 = sim.regs[3]; r4 = sim.regs[4]; r5 = sim.regs[5]; r6 = sim.regs[6]; r7 = sim.regs[7]; pc = sim.pc; steps = sim.steps; } while (0)
+#define SAVE_STATE() do { sim.regs[1] = r1; sim.regs[2] = r2; sim.regs[3] = r3; sim.regs[4] = r4; sim.regs[5] = r5; sim.regs[6] = r6; sim.regs[7] = r7; sim.pc = pc; sim.executed += steps - sim.steps; sim.steps = steps; } while (0)
+    LOAD_STATE();
+    goto dispatch;
+
+b0:
+    if (steps > LcSim::MAX_STEPS - 5 || dead[0]) { pc = 0; goto interp; }
+    steps += 5;
+    // 0: lw 0 4 17
+    r4 = m[17];
+    // 1: lw 0 5 18
+    r5 = m[18];
+    // 2: lw 0 3 19
+    r3 = m[19];
+    // 3: add 0 5 1
+    r1 = int32_t(uint32_t(0) + uint32_t(r5));
+    // 4: add 5 5 7
+    r7 = int32_t(uint32_t(r5) + uint32_t(r5));
+    goto b5;
+
+b5:
+    if (steps > LcSim::MAX_STEPS - 2 || dead[1]) { pc = 5; goto interp; }
+    steps += 2;
+    // 5: add 0 0 6
+    r6 = int32_t(uint32_t(0) + uint32_t(0));
+    // 6: add 0 7 2
+    r2 = int32_t(uint32_t(0) + uint32_t(r7));
+    goto b7;
+
+b7:
+    if (steps > LcSim::MAX_STEPS - 1 || dead[2]) { pc = 7; goto interp; }
+    steps += 1;
+    // 7: beq 2 0 3
+    if (r2 == 0) goto b11;
+    goto b8;
+
+b8:
+    if (steps > LcSim::MAX_STEPS - 3 || dead[3]) { pc = 8; goto interp; }
+    steps += 3;
+    // 8: add 6 1 6
+    r6 = int32_t(uint32_t(r6) + uint32_t(r1));
+    // 9: add 2 3 2
+    r2 = int32_t(uint32_t(r2) + uint32_t(r3));
+    // 10: beq 0 0 -4
+    goto b7;
+
+b11:
+    if (steps > LcSim::MAX_STEPS - 4 || dead[4]) { pc = 11; goto interp; }
+    steps += 4;
+    // 11: add 6 0 1
+    r1 = int32_t(uint32_t(r6) + uint32_t(0));
+    // 12: add 7 5 7
+    r7 = int32_t(uint32_t(r7) + uint32_t(r5));
+    // 13: add 4 5 6
+    r6 = int32_t(uint32_t(r4) + uint32_t(r5));
+    // 14: beq 7 6 1
+    if (r7 == r6) goto b16;
+    goto b15;
+
+b15:
+    if (steps > LcSim::MAX_STEPS - 1 || dead[5]) { pc = 15; goto interp; }
+    steps += 1;
+    // 15: beq 0 0 -11
+    goto b5;
+
+b16:
+    if (steps > LcSim::MAX_STEPS - 1 || dead[6]) { pc = 16; goto interp; }
+    steps += 1;
+    // 16: halt
+    pc = 17; stop = LcSim::Stop::HALT; goto done;
+
+dispatch:
+    switch (pc) {
+        case 0: goto b0;
+        case 5: goto b5;
+        case 7: goto b7;
+        case 8: goto b8;
+        case 11: goto b11;
+        case 15: goto b15;
+        case 16: goto b16;
+        default: break;
+    }
+interp:
+    SAVE_STATE();
+    if (uint32_t(pc) < uint32_t(NUM_WORDS)) {
+        // sw ที่จะเปลี่ยนค่า code word → block ที่มี word นั้นกลับมาใช้ไม่ได้อีก
+        const DecodedInstr d = decodeWord(m[pc]);
+        const uint32_t a = uint32_t(sim.regs[d.regA]) + uint32_t(d.imm);
+        if (d.opcode == OPC_SW && isCode(a) && m[a] != sim.regs[d.regB])
+            dead[std::upper_bound(BLOCK_START, BLOCK_START + NUM_BLOCKS, int32_t(a)) - BLOCK_START - 1] = 1;
+    }
+    interpreted++;
+    if (!sim.step(stop)) return stop;
+    LOAD_STATE();
+    goto dispatch;
+done:
+    SAVE_STATE();
+    return stop;
+#undef LOAD_STATE
+#undef SAVE_STATE
+}
+
+int main(int argc, char **argv) {
+    const bool stats = argc > 1 && std::string(argv[1]) == "--stats";
+    SparseImage image;
+    const int32_t *lit = LITERAL;
+    for (const auto &s : SEGMENTS) {
+        if (s[1]) { if (s[0]) image.pushRun(s[0], s[2]); }
+        else for (int32_t k = 0; k < s[0]; ++k) image.push(*lit++);
+    }
+    OutBuffer out(stdout);
+    LcSim sim(out);
+    sim.load(image);
+    long interpreted = 0;
+    runCompiled(sim, interpreted);
+    sim.printState();
+    if (stats) {
+        out.flush();
+        fprintf(stderr, "executed %ld instruction(s), %ld step(s) through the interpreter\n", sim.executed, interpreted);
+    }
+    return 0;
+}
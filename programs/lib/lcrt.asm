@@ -0,0 +1,251 @@
+; lcrt.asm — ไลบรารี routine เลขคณิตสำหรับ LC (มีแค่ add/nand) ลิงก์ต่อท้ายโปรแกรม:
+;     .\parser prog.asm ..\programs\lib\lcrt.asm
+;
+; calling convention:
+;     lw   0   6   mulAd     ; r6 = address ของ routine (ใช้ pointer word xxxAd ด้านล่าง)
+;     jalr 6   7             ; r7 = return address
+;   argument  : r1, r2 (memcpy ใช้ r3 ด้วย)
+;   ผลลัพธ์   : r3 (div ให้เศษใน r4)
+;   r1, r2 คงค่าเดิม (ยกเว้น memcpy), r4-r6 ถูกเขียนทับ (ถ้าผู้เรียกใช้ r5 เป็น stack pointer ต้องเก็บไว้เอง)
+;   ทุก routine เป็น leaf ไม่ใช้ stack (เก็บ link ไว้ใน rtlink) จึงเรียกซ้อนกันเองไม่ได้
+;   label ที่ขึ้นต้นด้วย rt และชื่อ routine/pointer ด้านล่างสงวนไว้สำหรับไลบรารี
+;
+;   mul    r3 = r1 * r2            shift-and-add ตามบิตของ r2 (หยุดเมื่อไม่เหลือบิต 1)
+;   div    r3 = r1 / r2, r4 = r1 % r2   restoring division แบบไม่คิดเครื่องหมาย
+;          r2 ต้องอยู่ในช่วง 0..2^31-1, r2 = 0 ได้ r3 = -1 และ r4 = r1
+;   srl    r3 = r1 >>> (r2 & 31)   logical right shift (เติม 0 ทางซ้าย)
+;   cmp    r3 = -1 / 0 / 1 เมื่อ r1 < r2 / r1 == r2 / r1 > r2 (มีเครื่องหมาย)
+;   memcpy คัดลอก r3 word จาก address r1 ไป r2 (ไปข้างหน้าทีละ word, r3 <= 0 ไม่ทำอะไร)
+;          กลับมาแล้ว r1, r2 ชี้ถัดจากช่วงที่คัดลอก และ r3 = 0
+;
+; วัดจำนวนคำสั่งต่อการเรียกด้วย assembler/lcrtbench
+
+; ---------------- mul ----------------
+mul     sw   0   7   rtlink     ; เก็บ link แล้วใช้ r7 เป็น register ทำงาน
+        add  0   0   3          ; r3 = 0 (ผลคูณ)
+        add  1   0   4          ; r4 = r1 << i
+        add  2   0   6          ; r6 = บิตของ r2 ที่ยังไม่ได้ใช้
+        lw   0   5   rtone      ; r5 = 1 << i
+rtm1    beq  6   0   rtm3       ; ไม่เหลือบิต 1 แล้ว
+        nand 6   5   7
+        nand 7   7   7          ; r7 = r6 & (1 << i)
+        beq  7   0   rtm2
+        add  3   4   3          ; ผล += r1 << i
+        nand 6   6   6          ; r6 -= 1 << i  (~(~r6 + x) = r6 - x)
+        add  6   5   6
+        nand 6   6   6
+rtm2    add  4   4   4
+        add  5   5   5
+        beq  0   0   rtm1
+rtm3    lw   0   7   rtlink
+        jalr 7   0
+
+; ---------------- div ----------------
+; r3 เก็บตัวตั้งที่เลื่อนซ้ายทีละบิต บิตของผลหารเข้ามาทางขวา (ครบ 32 รอบ r3 = ผลหาร)
+; เศษก่อนเลื่อน < d <= 2^31-1 จึงดูเครื่องหมายของ (เศษ - d) แทนการเทียบแบบไม่คิดเครื่องหมายได้
+div     beq  2   0   rtdz       ; หารด้วย 0
+        sw   0   7   rtlink
+        sw   0   1   rtsv1
+        sw   0   2   rtsv2
+        add  1   0   3          ; r3 = ตัวตั้ง / ผลหาร
+        add  0   0   4          ; r4 = เศษ
+        nand 2   2   5          ; r5 = ~d
+        lw   0   1   rtone      ; r1 = 1
+        add  5   1   5          ; r5 = -d
+        lw   0   7   rtsign     ; r7 = 0x80000000
+        lw   0   2   rtn32      ; r2 = -32 นับรอบขึ้นไปถึง 0
+        beq  3   0   rtd5       ; ตัวตั้ง = 0 → ผลหาร 0 เศษ 0
+        ; บิต 0 ข้างหน้าของตัวตั้งให้บิตผลหารเป็น 0 (เศษยังเป็น 0) ข้ามทีละ byte แล้วทีละบิต
+rtd1    lw   0   6   rtbyte
+        nand 3   6   6
+        nand 6   6   6          ; r6 = byte บนสุดของ r3
+        beq  6   0   rtdb       ; เป็น 0 ทั้ง byte
+rtd2    nand 3   7   6
+        nand 6   6   6          ; r6 = บิตบนสุดของ r3
+        beq  6   7   rtd3       ; เป็น 1 → เริ่มหารจริง
+        add  3   3   3
+        add  2   1   2
+        beq  0   0   rtd2
+rtdb    add  3   3   3          ; เลื่อน 8 บิต
+        add  3   3   3
+        add  3   3   3
+        add  3   3   3
+        add  3   3   3
+        add  3   3   3
+        add  3   3   3
+        add  3   3   3
+        lw   0   6   rt8
+        add  2   6   2
+        beq  0   0   rtd1
+rtd3    beq  2   0   rtd5       ; ครบทุกบิต
+        add  4   4   4          ; เศษ <<= 1
+        nand 3   7   6
+        nand 6   6   6          ; r6 = บิตบนสุดของตัวตั้ง
+        add  3   3   3          ; ตัวตั้ง/ผลหาร <<= 1
+        beq  6   0   rtd4
+        add  4   1   4          ; เศษ |= 1
+rtd4    add  2   1   2
+        add  4   5   6          ; r6 = เศษ - d
+        nand 6   7   6
+        nand 6   6   6
+        beq  6   7   rtd3       ; ติดลบ → เศษ < d บิตผลหาร = 0
+        add  4   5   4          ; เศษ -= d
+        add  3   1   3          ; บิตผลหาร = 1
+        beq  0   0   rtd3
+rtd5    lw   0   1   rtsv1
+        lw   0   2   rtsv2
+        lw   0   7   rtlink
+        jalr 7   0
+rtdz    nand 0   0   3          ; r3 = -1
+        add  1   0   4          ; r4 = r1
+        jalr 7   0
+
+; ---------------- srl ----------------
+; ตัดบิตล่าง n บิตของ r1 ทิ้ง แล้วย้ายบิตที่เหลือลงมาทีละบิต (หยุดเมื่อไม่เหลือบิต 1)
+srl     sw   0   7   rtlink
+        lw   0   6   rt31
+        nand 2   6   4
+        nand 4   4   4          ; r4 = n = r2 & 31
+        lw   4   5   rtpow      ; r5 = 1 << n (จากตาราง)
+        nand 0   0   7          ; r7 = -1
+        add  5   7   6          ; r6 = (1 << n) - 1
+        nand 6   6   6          ; r6 = ~((1 << n) - 1) = บิตที่ n ขึ้นไป
+        nand 1   6   6
+        nand 6   6   6          ; r6 = r1 ที่ตัดบิตล่างทิ้งแล้ว
+        add  0   0   3          ; r3 = 0
+        lw   0   4   rtone      ; r4 = บิตปลายทาง (1 << (i - n))
+rts1    beq  6   0   rts3       ; ไม่เหลือบิต 1 แล้ว
+        nand 6   5   7
+        nand 7   7   7          ; r7 = r6 & (1 << i)
+        beq  7   0   rts2
+        add  3   4   3          ; ผล |= 1 << (i - n)
+        nand 6   6   6          ; r6 -= 1 << i
+        add  6   5   6
+        nand 6   6   6
+rts2    add  5   5   5
+        add  4   4   4
+        beq  0   0   rts1
+rts3    lw   0   7   rtlink
+        jalr 7   0
+
+; ---------------- cmp ----------------
+; เครื่องหมายต่างกัน: ตัวที่ติดลบน้อยกว่า / เครื่องหมายเดียวกัน: ดูเครื่องหมายของ r1 + ~r2 = r1 - r2 - 1 (ไม่ล้น)
+cmp     beq  1   2   rtc3       ; เท่ากัน
+        lw   0   5   rtsign
+        nand 1   5   4
+        nand 4   4   4          ; r4 = บิตเครื่องหมายของ r1
+        nand 2   5   6
+        nand 6   6   6          ; r6 = บิตเครื่องหมายของ r2
+        beq  4   6   rtc1
+        beq  4   0   rtc2       ; r1 >= 0 > r2
+        nand 0   0   3          ; r3 = -1
+        jalr 7   0
+rtc1    nand 2   2   6          ; r6 = ~r2
+        add  1   6   6          ; r6 = r1 - r2 - 1
+        nand 6   5   6
+        nand 6   6   6
+        beq  6   0   rtc2       ; r1 - r2 - 1 >= 0 → r1 > r2
+        nand 0   0   3          ; r3 = -1
+        jalr 7   0
+rtc2    lw   0   3   rtone      ; r3 = 1
+        jalr 7   0
+rtc3    add  0   0   3          ; r3 = 0
+        jalr 7   0
+
+; ---------------- memcpy ----------------
+; คัดลอกเศษ 1 และ 2 word ก่อน แล้ววนทีละ 4 word (unroll)
+memcpy  sw   0   7   rtlink
+        lw   0   5   rtsign
+        nand 3   5   6
+        nand 6   6   6
+        beq  6   0   rtp1       ; r3 >= 0
+        add  0   0   3          ; r3 < 0 → ไม่คัดลอก
+        beq  0   0   rtp4
+rtp1    lw   0   5   rtone      ; r5 = 1
+        nand 0   0   7          ; r7 = -1
+        nand 3   5   6
+        nand 6   6   6          ; r6 = r3 & 1
+        beq  6   0   rtp2
+        lw   1   4   0
+        sw   2   4   0
+        add  1   5   1
+        add  2   5   2
+        add  3   7   3
+rtp2    add  5   5   5          ; r5 = 2
+        nand 3   5   6
+        nand 6   6   6          ; r6 = r3 & 2
+        beq  6   0   rtp3
+        lw   1   4   0
+        sw   2   4   0
+        lw   1   4   1
+        sw   2   4   1
+        add  1   5   1
+        add  2   5   2
+        add  3   7   3
+        add  3   7   3
+rtp3    add  5   5   5          ; r5 = 4
+        add  7   7   7
+        add  7   7   7          ; r7 = -4
+rtp5    beq  3   0   rtp4
+        lw   1   4   0
+        sw   2   4   0
+        lw   1   4   1
+        sw   2   4   1
+        lw   1   4   2
+        sw   2   4   2
+        lw   1   4   3
+        sw   2   4   3
+        add  1   5   1
+        add  2   5   2
+        add  3   7   3
+        beq  0   0   rtp5
+rtp4    lw   0   7   rtlink
+        jalr 7   0
+
+; ---------------- data ----------------
+mulAd   .fill mul
+divAd   .fill div
+srlAd   .fill srl
+cmpAd   .fill cmp
+mcpyAd  .fill memcpy
+rtlink  .fill 0
+rtsv1   .fill 0
+rtsv2   .fill 0
+rtone   .fill 1
+rt8     .fill 8
+rt31    .fill 31
+rtn32   .fill -32
+rtsign  .fill -2147483648
+rtbyte  .fill -16777216         ; 0xFF000000
+rtpow   .fill 1                 ; rtpow + n = 1 << n
+        .fill 2
+        .fill 4
+        .fill 8
+        .fill 16
+        .fill 32
+        .fill 64
+        .fill 128
+        .fill 256
+        .fill 512
+        .fill 1024
+        .fill 2048
+        .fill 4096
+        .fill 8192
+        .fill 16384
+        .fill 32768
+        .fill 65536
+        .fill 131072
+        .fill 262144
+        .fill 524288
+        .fill 1048576
+        .fill 2097152
+        .fill 4194304
+        .fill 8388608
+        .fill 16777216
+        .fill 33554432
+        .fill 67108864
+        .fill 134217728
+        .fill 268435456
+        .fill 536870912
+        .fill 1073741824
+        .fill -2147483648
@@ -0,0 +1,11 @@
+; harness ของ assembler/lcrtbench: ลิงก์กับ lcrt.asm แล้ว bench จะแก้ค่า argA/argB/argC/target ก่อนรันแต่ละครั้ง
+        lw   0   1   argA
+        lw   0   2   argB
+        lw   0   3   argC
+        lw   0   6   target
+        jalr 6   7
+        halt
+argA    .fill 0
+argB    .fill 0
+argC    .fill 0
+target  .fill mul
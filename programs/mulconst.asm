@@ -0,0 +1,7 @@
+        lw   0   1   mcand   ; R1 = multiplicand (32766)
+        .scratch 4           ; mulc ใช้ R4 พักค่าได้
+        mulc 1   3   10383   ; R3 = R1 * 10383 (ลำดับ add คงที่แทน loop ใน multiply.asm)
+        halt
+
+; Data
+mcand   .fill 32766
@@ -0,0 +1,11 @@
+; multiply.asm แบบเรียก mul จากไลบรารี (ลิงก์กับ programs/lib/lcrt.asm)
+;     .\assembler\parser .\programs\mullib.asm .\programs\lib\lcrt.asm
+        lw   0   1   mcand   ; R1 = multiplicand (32766)
+        lw   0   2   mplier  ; R2 = multiplier (10383)
+        lw   0   6   mulAd   ; R6 = address ของ mul
+        jalr 6   7           ; R3 = R1 * R2
+        halt
+
+; Data
+mcand   .fill 32766
+mplier  .fill 10383
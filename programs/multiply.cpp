@@ -0,0 +1,128 @@
+// generated by mc2cpp from multiply.mc (15 word(s), 4 block(s)) -- do not edit
+// output เหมือน "simulator --fast multiply.mc" ทุก byte, --stats = จำนวนคำสั่งที่ต้องใช้ interpreter ทาง stderr
+// Compile : g++ -std=c++17 -O2 -I<ไดเรกทอรีของ lc_sim.h> <ไฟล์นี้> -o <ชื่อโปรแกรม>
+
+#include "lc_sim.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+static const int32_t LITERAL[] = {
+    8454154, 8519691, 8585228, 8650765, 8716302, 17825795, 1638403, 1376258, 16842748, 25165824, 32766, 10383,
+    0, 1, -1,
+};
+static const int32_t SEGMENTS[][3] = {
+    {15, 0, 0},
+};
+
+static const int32_t NUM_WORDS = 15;
+static const uint64_t CODE_BITS[] = {
+    1023ull,
+};
+static const int32_t NUM_BLOCKS = 4;
+static const int32_t BLOCK_START[] = {
+    0, 5, 6, 9,
+};
+
+static inline bool isCode(uint32_t a) { return a < uint32_t(NUM_WORDS) && (CODE_BITS[a >> 6] >> (a & 63) & 1); }
+
+static LcSim::Stop runCompiled(LcSim &sim, long &interpreted) {
+    int32_t *const m = sim.mem.data();
+    std::vector<unsigned char> dead(size_t(NUM_BLOCKS) + 1, 0);   // block ที่มี word ถูกเขียนทับ
+    int32_t r1, r2, r3, r4, r5, r6, r7, pc;
+    long steps;
+    LcSim::Stop stop;
+#define LOAD_STATE() do { r1 = sim.regs[1]; r2 = sim.regs[2]; r3 = sim.regs[3]; r4 = sim.regs[4]; r5 = sim.regs[5]; r6 = sim.regs[6]; r7 = sim.regs[7]; pc = sim.pc; steps = sim.steps; } while (0)
+#define SAVE_STATE() do { sim.regs[1] = r1; sim.regs[2] = r2; sim.regs[3] = r3; sim.regs[4] = r4; sim.regs[5] = r5; sim.regs[6] = r6; sim.regs[7] = r7; sim.pc = pc; sim.executed += steps - sim.steps; sim.steps = steps; } while (0)
+    LOAD_STATE();
+    goto dispatch;
+
+b0:
+    if (steps > LcSim::MAX_STEPS - 5 || dead[0]) { pc = 0; goto interp; }
+    steps += 5;
+    // 0: lw 0 1 10
+    r1 = m[10];
+    // 1: lw 0 2 11
+    r2 = m[11];
+    // 2: lw 0 3 12
+    r3 = m[12];
+    // 3: lw 0 4 13
+    r4 = m[13];
+    // 4: lw 0 5 14
+    r5 = m[14];
+    goto b5;
+
+b5:
+    if (steps > LcSim::MAX_STEPS - 1 || dead[1]) { pc = 5; goto interp; }
+    steps += 1;
+    // 5: beq 2 0 3
+    if (r2 == 0) goto b9;
+    goto b6;
+
+b6:
+    if (steps > LcSim::MAX_STEPS - 3 || dead[2]) { pc = 6; goto interp; }
+    steps += 3;
+    // 6: add 3 1 3
+    r3 = int32_t(uint32_t(r3) + uint32_t(r1));
+    // 7: add 2 5 2
+    r2 = int32_t(uint32_t(r2) + uint32_t(r5));
+    // 8: beq 0 0 -4
+    goto b5;
+
+b9:
+    if (steps > LcSim::MAX_STEPS - 1 || dead[3]) { pc = 9; goto interp; }
+    steps += 1;
+    // 9: halt
+    pc = 10; stop = LcSim::Stop::HALT; goto done;
+
+dispatch:
+    switch (pc) {
+        case 0: goto b0;
+        case 5: goto b5;
+        case 6: goto b6;
+        case 9: goto b9;
+        default: break;
+    }
+interp:
+    SAVE_STATE();
+    if (uint32_t(pc) < uint32_t(NUM_WORDS)) {
+        // sw ที่จะเปลี่ยนค่า code word → block ที่มี word นั้นกลับมาใช้ไม่ได้อีก
+        const DecodedInstr d = decodeWord(m[pc]);
+        const uint32_t a = uint32_t(sim.regs[d.regA]) + uint32_t(d.imm);
+        if (d.opcode == OPC_SW && isCode(a) && m[a] != sim.regs[d.regB])
+            dead[std::upper_bound(BLOCK_START, BLOCK_START + NUM_BLOCKS, int32_t(a)) - BLOCK_START - 1] = 1;
+    }
+    interpreted++;
+    if (!sim.step(stop)) return stop;
+    LOAD_STATE();
+    goto dispatch;
+done:
+    SAVE_STATE();
+    return stop;
+#undef LOAD_STATE
+#undef SAVE_STATE
+}
+
+int main(int argc, char **argv) {
+    const bool stats = argc > 1 && std::string(argv[1]) == "--stats";
+    SparseImage image;
+    const int32_t *lit = LITERAL;
+    for (const auto &s : SEGMENTS) {
+        if (s[1]) { if (s[0]) image.pushRun(s[0], s[2]); }
+        else for (int32_t k = 0; k < s[0]; ++k) image.push(*lit++);
+    }
+    OutBuffer out(stdout);
+    LcSim sim(out);
+    sim.load(image);
+    long interpreted = 0;
+    runCompiled(sim, interpreted);
+    sim.printState();
+    if (stats) {
+        out.flush();
+        fprintf(stderr, "executed %ld instruction(s), %ld step(s) through the interpreter\n", sim.executed, interpreted);
+    }
+    return 0;
+}
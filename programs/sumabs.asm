@@ -0,0 +1,43 @@
+; sumabs.asm — ผลรวมค่าสัมบูรณ์ของ array ด้วยการเรียก routine abs ใน loop
+; ใช้ดูผลของ optimizer --inline: abs เป็น leaf สั้น ๆ ค่า call/return (lw + jalr + jalr) จึงแพงพอ ๆ กับตัว routine
+;     .\assembler\optimizer --inline --dce .\programs\sumabs.asm
+        lw   0   2   count   ; R2 = จำนวนสมาชิก (นับถอยหลังเป็น index)
+        lw   0   6   pos1    ; R6 = 1
+        add  0   0   4       ; R4 = ผลรวม
+loop    beq  2   0   done
+        nand 2   2   2       ; R2 = R2 - 1  (~(~R2 + 1))
+        add  2   6   2
+        nand 2   2   2
+        lw   2   1   arr     ; R1 = arr[R2]
+        lw   0   5   absAd   ; R5 = address ของ abs
+        jalr 5   7           ; R3 = |R1|
+        add  4   3   4
+        beq  0   0   loop
+done    sw   0   4   result
+        halt
+
+; abs: R3 = |R1| (ใช้ R6 = 1, return ด้วย jalr 7 0)
+abs     lw   0   3   sign
+        nand 1   3   3
+        nand 3   3   3       ; R3 = R1 & 0x80000000
+        beq  3   0   absp
+        nand 1   1   3       ; R3 = -R1 = ~R1 + 1
+        add  3   6   3
+        jalr 7   0
+absp    add  1   0   3
+        jalr 7   0
+
+; Data
+count   .fill 8
+pos1    .fill 1
+sign    .fill -2147483648
+result  .fill 0
+absAd   .fill abs
+arr     .fill 5
+        .fill -7
+        .fill 12
+        .fill -1
+        .fill 0
+        .fill -100
+        .fill 33
+        .fill -2